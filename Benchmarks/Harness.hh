@@ -0,0 +1,189 @@
+#ifndef G_BENCHMARK_HARNESS_H
+#define G_BENCHMARK_HARNESS_H
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "Garfield/Component.hh"
+
+namespace Garfield {
+
+/// Figures of merit of a benchmark run.
+struct BenchmarkResult {
+  std::string name;
+  unsigned int seed = 0;
+  unsigned long events = 0;
+  double wallTime = 0.;
+  double setupTime = 0.;
+  unsigned long fieldEvaluations = 0;
+  unsigned long weightingFieldEvaluations = 0;
+  unsigned long collisions = 0;
+  unsigned long electrons = 0;
+  double nullCollisionFraction = 0.;
+};
+
+/// Wall-clock stopwatch.
+class Stopwatch {
+ public:
+  Stopwatch() : m_start(std::chrono::steady_clock::now()) {}
+  void Reset() { m_start = std::chrono::steady_clock::now(); }
+  /// Elapsed time [s] since construction or the last reset.
+  double Elapsed() const {
+    const auto now = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(now - m_start).count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point m_start;
+};
+
+/// Peak resident set size [kB] of the process.
+inline long PeakRss() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+/// Print the result as a single line of JSON.
+inline void PrintResult(const BenchmarkResult& r) {
+  const double t = r.wallTime > 0. ? r.wallTime : 1.e-9;
+  std::printf("{\"benchmark\": \"%s\", \"seed\": %u, \"events\": %lu, "
+              "\"setup_s\": %.6f, \"wall_s\": %.6f, \"events_per_s\": %.6g, "
+              "\"field_evaluations\": %lu, \"field_evaluations_per_s\": %.6g, "
+              "\"weighting_field_evaluations\": %lu, "
+              "\"collisions\": %lu, \"collisions_per_s\": %.6g, "
+              "\"null_collision_fraction\": %.4f, "
+              "\"electrons\": %lu, \"peak_rss_kb\": %ld}\n",
+              r.name.c_str(), r.seed, r.events, r.setupTime, r.wallTime,
+              r.events / t, r.fieldEvaluations, r.fieldEvaluations / t,
+              r.weightingFieldEvaluations, r.collisions, r.collisions / t,
+              r.nullCollisionFraction, r.electrons, PeakRss());
+  std::fflush(stdout);
+}
+
+/// Component wrapper counting the number of field evaluations
+/// requested from the underlying component.
+class ComponentCounter : public Component {
+ public:
+  ComponentCounter(Component* cmp) : Component("Counter"), m_cmp(cmp) {
+    m_ready = true;
+  }
+
+  unsigned long GetFieldEvaluations() const { return m_nField; }
+  unsigned long GetWeightingFieldEvaluations() const { return m_nWeighting; }
+  void ResetCounters() { m_nField = m_nWeighting = 0; }
+
+  Medium* GetMedium(const double x, const double y, const double z) override {
+    return m_cmp->GetMedium(x, y, z);
+  }
+  void ElectricField(const double x, const double y, const double z,
+                     double& ex, double& ey, double& ez, Medium*& m,
+                     int& status) override {
+    ++m_nField;
+    m_cmp->ElectricField(x, y, z, ex, ey, ez, m, status);
+  }
+  void ElectricField(const double x, const double y, const double z,
+                     double& ex, double& ey, double& ez, double& v,
+                     Medium*& m, int& status) override {
+    ++m_nField;
+    m_cmp->ElectricField(x, y, z, ex, ey, ez, v, m, status);
+  }
+  using Component::ElectricField;
+  double ElectricPotential(const double x, const double y,
+                           const double z) override {
+    ++m_nField;
+    return m_cmp->ElectricPotential(x, y, z);
+  }
+  bool GetVoltageRange(double& vmin, double& vmax) override {
+    return m_cmp->GetVoltageRange(vmin, vmax);
+  }
+  void WeightingField(const double x, const double y, const double z,
+                      double& wx, double& wy, double& wz,
+                      const std::string& label) override {
+    ++m_nWeighting;
+    m_cmp->WeightingField(x, y, z, wx, wy, wz, label);
+  }
+  double WeightingPotential(const double x, const double y, const double z,
+                            const std::string& label) override {
+    ++m_nWeighting;
+    return m_cmp->WeightingPotential(x, y, z, label);
+  }
+  void DelayedWeightingField(const double x, const double y, const double z,
+                             const double t, double& wx, double& wy,
+                             double& wz, const std::string& label) override {
+    ++m_nWeighting;
+    m_cmp->DelayedWeightingField(x, y, z, t, wx, wy, wz, label);
+  }
+  double DelayedWeightingPotential(const double x, const double y,
+                                   const double z, const double t,
+                                   const std::string& label) override {
+    ++m_nWeighting;
+    return m_cmp->DelayedWeightingPotential(x, y, z, t, label);
+  }
+  void DelayedWeightingFields(const double x, const double y, const double z,
+                              const std::vector<double>& ts,
+                              std::vector<std::array<double, 3> >& ws,
+                              const std::string& label) override {
+    ++m_nWeighting;
+    m_cmp->DelayedWeightingFields(x, y, z, ts, ws, label);
+  }
+  void DelayedWeightingPotentials(const double x, const double y,
+                                  const double z,
+                                  const std::vector<double>& ts,
+                                  std::vector<double>& ps,
+                                  const std::string& label) override {
+    ++m_nWeighting;
+    m_cmp->DelayedWeightingPotentials(x, y, z, ts, ps, label);
+  }
+  void MagneticField(const double x, const double y, const double z,
+                     double& bx, double& by, double& bz, int& status) override {
+    m_cmp->MagneticField(x, y, z, bx, by, bz, status);
+  }
+  bool IsReady() override { return m_cmp->IsReady(); }
+  bool GetBoundingBox(double& xmin, double& ymin, double& zmin,
+                      double& xmax, double& ymax, double& zmax) override {
+    return m_cmp->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax);
+  }
+  bool GetElementaryCell(double& xmin, double& ymin, double& zmin,
+                         double& xmax, double& ymax, double& zmax) override {
+    return m_cmp->GetElementaryCell(xmin, ymin, zmin, xmax, ymax, zmax);
+  }
+  bool CrossedWire(const double x0, const double y0, const double z0,
+                   const double x1, const double y1, const double z1,
+                   double& xc, double& yc, double& zc,
+                   const bool centre, double& rc) override {
+    return m_cmp->CrossedWire(x0, y0, z0, x1, y1, z1, xc, yc, zc, centre, rc);
+  }
+  bool InTrapRadius(const double q0, const double x0, const double y0,
+                    const double z0, double& xw, double& yw,
+                    double& rw) override {
+    return m_cmp->InTrapRadius(q0, x0, y0, z0, xw, yw, rw);
+  }
+  bool CrossedPlane(const double x0, const double y0, const double z0,
+                    const double x1, const double y1, const double z1,
+                    double& xc, double& yc, double& zc) override {
+    return m_cmp->CrossedPlane(x0, y0, z0, x1, y1, z1, xc, yc, zc);
+  }
+  bool HasMagneticField() const override { return m_cmp->HasMagneticField(); }
+  double StepSizeHint() override { return m_cmp->StepSizeHint(); }
+
+ protected:
+  void Reset() override {}
+  void UpdatePeriodicity() override {}
+
+ private:
+  Component* m_cmp = nullptr;
+  unsigned long m_nField = 0;
+  unsigned long m_nWeighting = 0;
+};
+
+}  // namespace Garfield
+
+#endif
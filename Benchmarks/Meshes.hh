@@ -0,0 +1,270 @@
+#ifndef G_BENCHMARK_MESHES_H
+#define G_BENCHMARK_MESHES_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace Garfield {
+
+/** Write a parallel-plate field map in Ansys (SOLID187) format.
+  * The box [0, l] x [0, l] x [0, h] (in cm) is divided into n x n x m cubes,
+  * each of which is split into six quadratic tetrahedra. The potential
+  * rises linearly from 0 at z = 0 to v0 at z = h.
+  * Files written: ELIST.lis, NLIST.lis, MPLIST.lis, PRNSOL.lis.
+  */
+inline bool WriteAnsys123Box(const unsigned int n, const unsigned int m,
+                             const double l, const double h, const double v0) {
+  // Corner and mid-side nodes live on a grid with half the mesh spacing.
+  const unsigned int nx = 2 * n + 1;
+  const unsigned int nz = 2 * m + 1;
+  auto node = [&](const int i, const int j, const int k) {
+    return (k * nx + j) * nx + i + 1;
+  };
+  const double dx = l / (2 * n);
+  const double dz = h / (2 * m);
+
+  FILE* f = std::fopen("MPLIST.lis", "w");
+  if (!f) return false;
+  std::fprintf(f, " LIST MATERIALS       1 TO       1 BY       1\n\n");
+  std::fprintf(f, " MATERIAL NUMBER       1\n\n");
+  std::fprintf(f, "      TEMP        PERX\n                1.000000\n");
+  std::fclose(f);
+
+  f = std::fopen("NLIST.lis", "w");
+  if (!f) return false;
+  std::fprintf(f, " LIST ALL SELECTED NODES.\n\n    NODE        X             Y"
+                  "             Z\n");
+  for (unsigned int k = 0; k < nz; ++k) {
+    for (unsigned int j = 0; j < nx; ++j) {
+      for (unsigned int i = 0; i < nx; ++i) {
+        std::fprintf(f, "%u %.10e %.10e %.10e\n",
+                     node(i, j, k), i * dx, j * dx, k * dz);
+      }
+    }
+  }
+  std::fclose(f);
+
+  f = std::fopen("PRNSOL.lis", "w");
+  if (!f) return false;
+  std::fprintf(f, " PRINT VOLT NODAL SOLUTION PER NODE\n\n    NODE       VOLT\n");
+  for (unsigned int k = 0; k < nz; ++k) {
+    for (unsigned int j = 0; j < nx; ++j) {
+      for (unsigned int i = 0; i < nx; ++i) {
+        std::fprintf(f, "%u %.10e\n", node(i, j, k), v0 * k * dz / h);
+      }
+    }
+  }
+  std::fclose(f);
+
+  f = std::fopen("ELIST.lis", "w");
+  if (!f) return false;
+  std::fprintf(f, " LIST ALL SELECTED ELEMENTS.\n\n    ELEM MAT TYP REL ESY SEC"
+                  "        NODES\n");
+  const std::array<std::array<int, 3>, 6> perms = {{
+    {0, 1, 2}, {0, 2, 1}, {1, 0, 2}, {1, 2, 0}, {2, 0, 1}, {2, 1, 0}}};
+  // Ansys node order: 4 corners, then the mid-side nodes of the edges
+  // IJ, JK, KI, IL, JL, KL.
+  const std::array<std::array<int, 2>, 6> edges = {{
+    {0, 1}, {1, 2}, {2, 0}, {0, 3}, {1, 3}, {2, 3}}};
+  unsigned int iElement = 0;
+  for (unsigned int a = 0; a < n; ++a) {
+    for (unsigned int b = 0; b < n; ++b) {
+      for (unsigned int c = 0; c < m; ++c) {
+        for (const auto& p : perms) {
+          // Kuhn (path) tetrahedra: conforming across neighbouring cubes.
+          std::array<std::array<int, 3>, 4> v;
+          v[0] = {int(2 * a), int(2 * b), int(2 * c)};
+          for (unsigned int s = 0; s < 3; ++s) {
+            v[s + 1] = v[s];
+            v[s + 1][p[s]] += 2;
+          }
+          // Make sure L is on the positive side of the face IJK.
+          const auto& v0 = v[0];
+          const int ax = v[1][0] - v0[0], ay = v[1][1] - v0[1];
+          const int az = v[1][2] - v0[2], bx = v[2][0] - v0[0];
+          const int by = v[2][1] - v0[1], bz = v[2][2] - v0[2];
+          const int cx = v[3][0] - v0[0], cy = v[3][1] - v0[1];
+          const int cz = v[3][2] - v0[2];
+          const int det = ax * (by * cz - bz * cy) - ay * (bx * cz - bz * cx) +
+                          az * (bx * cy - by * cx);
+          if (det < 0) std::swap(v[1], v[2]);
+          std::array<unsigned int, 10> nodes;
+          for (unsigned int s = 0; s < 4; ++s) {
+            nodes[s] = node(v[s][0], v[s][1], v[s][2]);
+          }
+          for (unsigned int s = 0; s < 6; ++s) {
+            const auto& p0 = v[edges[s][0]];
+            const auto& p1 = v[edges[s][1]];
+            nodes[s + 4] = node((p0[0] + p1[0]) / 2, (p0[1] + p1[1]) / 2,
+                                (p0[2] + p1[2]) / 2);
+          }
+          ++iElement;
+          std::fprintf(f, "%u 1 1 1 0 1 %u %u %u %u %u %u %u %u\n%u %u\n",
+                       iElement, nodes[0], nodes[1], nodes[2], nodes[3],
+                       nodes[4], nodes[5], nodes[6], nodes[7],
+                       nodes[8], nodes[9]);
+        }
+      }
+    }
+  }
+  std::fclose(f);
+  return true;
+}
+
+/** Write a two-dimensional planar silicon sensor in DF-ISE format.
+  * The sensor extends from 0 to w in x and from 0 to d in y (in micron)
+  * and is meshed with 2 x nx x ny triangles. The bias voltage vb is applied
+  * at y = d. A second data file contains the potential with an additional
+  * voltage dv applied to a strip of width a centred at x = w / 2, y = d.
+  * If ve is non-zero, <prefix>.dat also contains a uniform electron drift
+  * velocity ve [cm / s] along y.
+  * Files written: <prefix>.grd, <prefix>.dat, <prefix>_w.dat.
+  */
+inline bool WriteTcad2dSensor(const std::string& prefix,
+                              const unsigned int nx, const unsigned int ny,
+                              const double w, const double d, const double a,
+                              const double vb, const double dv,
+                              const double ve = 0.) {
+  const unsigned int nVertices = (nx + 1) * (ny + 1);
+  auto vertex = [&](const unsigned int i, const unsigned int j) {
+    return j * (nx + 1) + i;
+  };
+  // Edges: horizontal, vertical, diagonal.
+  const unsigned int nH = nx * (ny + 1);
+  const unsigned int nV = (nx + 1) * ny;
+  const unsigned int nD = nx * ny;
+  auto hEdge = [&](const unsigned int i, const unsigned int j) {
+    return int(j * nx + i);
+  };
+  auto vEdge = [&](const unsigned int i, const unsigned int j) {
+    return int(nH + j * (nx + 1) + i);
+  };
+  auto dEdge = [&](const unsigned int i, const unsigned int j) {
+    return int(nH + nV + j * nx + i);
+  };
+  const unsigned int nElements = 2 * nx * ny;
+
+  FILE* f = std::fopen((prefix + ".grd").c_str(), "w");
+  if (!f) return false;
+  std::fprintf(f, "DF-ISE text\n\nInfo {\n  version = 1.0\n  type    = grid\n"
+                  "  dimension   = 2\n  nb_vertices = %u\n  nb_edges    = %u\n"
+                  "  nb_faces    = 0\n  nb_elements = %u\n  nb_regions  = 1\n"
+                  "  regions     = [ \"bulk\" ]\n"
+                  "  materials   = [ Silicon ]\n}\n\nData {\n\n",
+               nVertices, nH + nV + nD, nElements);
+  std::fprintf(f, "  Vertices (%u) {\n", nVertices);
+  for (unsigned int j = 0; j <= ny; ++j) {
+    for (unsigned int i = 0; i <= nx; ++i) {
+      std::fprintf(f, " %.15e %.15e\n", i * w / nx, j * d / ny);
+    }
+  }
+  std::fprintf(f, "  }\n\n  Edges (%u) {\n", nH + nV + nD);
+  for (unsigned int j = 0; j <= ny; ++j) {
+    for (unsigned int i = 0; i < nx; ++i) {
+      std::fprintf(f, " %u %u\n", vertex(i, j), vertex(i + 1, j));
+    }
+  }
+  for (unsigned int j = 0; j < ny; ++j) {
+    for (unsigned int i = 0; i <= nx; ++i) {
+      std::fprintf(f, " %u %u\n", vertex(i, j), vertex(i, j + 1));
+    }
+  }
+  for (unsigned int j = 0; j < ny; ++j) {
+    for (unsigned int i = 0; i < nx; ++i) {
+      std::fprintf(f, " %u %u\n", vertex(i, j), vertex(i + 1, j + 1));
+    }
+  }
+  std::fprintf(f, "  }\n\n  Elements (%u) {\n", nElements);
+  for (unsigned int j = 0; j < ny; ++j) {
+    for (unsigned int i = 0; i < nx; ++i) {
+      // Negative indices denote edges traversed in reverse order.
+      std::fprintf(f, " 2 %d %d %d\n", hEdge(i, j), vEdge(i + 1, j),
+                   -dEdge(i, j) - 1);
+      std::fprintf(f, " 2 %d %d %d\n", dEdge(i, j), -hEdge(i, j + 1) - 1,
+                   -vEdge(i, j) - 1);
+    }
+  }
+  std::fprintf(f, "  }\n\n  Region (\"bulk\") {\n    material = Silicon\n"
+                  "    Elements (%u) {\n", nElements);
+  for (unsigned int k = 0; k < nElements; ++k) {
+    std::fprintf(f, " %u%s", k, (k + 1) % 10 == 0 ? "\n" : "");
+  }
+  std::fprintf(f, "\n    }\n  }\n\n}\n");
+  std::fclose(f);
+
+  // Weighting potential of a strip in a parallel-plate geometry.
+  constexpr double pi = 3.14159265358979323846;
+  auto wpot = [&](const double x, const double y) {
+    if (y >= d) return std::abs(x - 0.5 * w) <= 0.5 * a ? 1. : 0.;
+    const double t = std::tan(0.5 * pi * y / d);
+    const double u1 = std::tanh(0.5 * pi * (x - 0.5 * w + 0.5 * a) / d);
+    const double u2 = std::tanh(0.5 * pi * (x - 0.5 * w - 0.5 * a) / d);
+    return (std::atan(t * u1) - std::atan(t * u2)) / pi;
+  };
+  // Field values are given in V / cm, coordinates are in micron.
+  const double ey = -1.e4 * vb / d;
+  for (unsigned int iw = 0; iw < 2; ++iw) {
+    const std::string suffix = iw == 0 ? ".dat" : "_w.dat";
+    f = std::fopen((prefix + suffix).c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "DF-ISE text\n\nInfo {\n  version = 1.0\n"
+                    "  type    = dataset\n  dimension   = 2\n"
+                    "  nb_vertices = %u\n}\n\nData {\n\n", nVertices);
+    std::fprintf(f, "  Dataset (\"ElectrostaticPotential\") {\n"
+                    "    function  = ElectrostaticPotential\n"
+                    "    type      = scalar\n    dimension = 1\n"
+                    "    location  = vertex\n    validity  = [ \"bulk\" ]\n"
+                    "    Values (%u) {\n", nVertices);
+    for (unsigned int j = 0; j <= ny; ++j) {
+      for (unsigned int i = 0; i <= nx; ++i) {
+        const double x = i * w / nx;
+        const double y = j * d / ny;
+        double v = vb * y / d;
+        if (iw > 0) v += dv * wpot(x, y);
+        std::fprintf(f, " %.12e\n", v);
+      }
+    }
+    std::fprintf(f, "    }\n  }\n\n  Dataset (\"ElectricField\") {\n"
+                    "    function  = ElectricField\n"
+                    "    type      = vector\n    dimension = 2\n"
+                    "    location  = vertex\n    validity  = [ \"bulk\" ]\n"
+                    "    Values (%u) {\n", 2 * nVertices);
+    // Step size [micron] for differentiating the weighting potential.
+    const double hd = 1.e-3 * d / ny;
+    for (unsigned int j = 0; j <= ny; ++j) {
+      for (unsigned int i = 0; i <= nx; ++i) {
+        const double x = i * w / nx;
+        const double y = std::min(j * d / ny, d - hd);
+        double fx = 0., fy = ey;
+        if (iw > 0) {
+          fx -= 1.e4 * dv * (wpot(x + hd, y) - wpot(x - hd, y)) / (2 * hd);
+          fy -= 1.e4 * dv * (wpot(x, y + hd) - wpot(x, y - hd)) / (2 * hd);
+        }
+        std::fprintf(f, " %.12e %.12e\n", fx, fy);
+      }
+    }
+    std::fprintf(f, "    }\n  }\n\n");
+    if (iw == 0 && ve != 0.) {
+      std::fprintf(f, "  Dataset (\"eDriftVelocity\") {\n"
+                      "    function  = eDriftVelocity\n"
+                      "    type      = vector\n    dimension = 2\n"
+                      "    location  = vertex\n    validity  = [ \"bulk\" ]\n"
+                      "    Values (%u) {\n", 2 * nVertices);
+      for (unsigned int k = 0; k < nVertices; ++k) {
+        std::fprintf(f, " %.12e %.12e\n", 0., ve);
+      }
+      std::fprintf(f, "    }\n  }\n\n");
+    }
+    std::fprintf(f, "}\n");
+    std::fclose(f);
+  }
+  return true;
+}
+
+}  // namespace Garfield
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef G_AVALANCHE_HYBRID_H
+#define G_AVALANCHE_HYBRID_H
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "AvalancheMC.hh"
+#include "AvalancheMicroscopic.hh"
+#include "GarfieldConstants.hh"
+#include "Sensor.hh"
+
+namespace Garfield {
+
+/// Electron avalanches combining microscopic tracking (in high-field
+/// regions) and Monte Carlo drift line integration (in drift regions).
+
+class AvalancheHybrid {
+ public:
+  /// Constructor
+  AvalancheHybrid(Sensor* sensor, AvalancheMicroscopic* mic, AvalancheMC* mc);
+  /// Destructor
+  ~AvalancheHybrid() {}
+
+  /// Set the sensor (used by both transport classes).
+  void SetSensor(Sensor* s);
+  /// Set the microscopic tracking engine.
+  void SetMicroscopic(AvalancheMicroscopic* mic);
+  /// Set the Monte Carlo drift line engine.
+  void SetMC(AvalancheMC* mc);
+
+  /** Set the reduced electric field |E|/N [Td] above which electrons are
+   * tracked microscopically (default: 100 Td). */
+  void SetReducedFieldThreshold(const double eOverN);
+  /** Set the relative width of the band around the reduced field threshold
+   * in which electrons keep their current transport method (default: 0.05).
+   * Electrons are handed over to microscopic tracking above (1 + h) times
+   * the threshold, and back to Monte Carlo drift below (1 - h) times the
+   * threshold. */
+  void SetHysteresis(const double h);
+  /** Set the max. number of handovers of an electron (default: 100).
+   * Electrons exceeding it are stopped (status StatusCalculationAbandoned).
+   */
+  void SetMaxNumberOfHandovers(const unsigned int n) { m_maxHandovers = n; }
+  /// Track electrons microscopically inside a given box, irrespective
+  /// of the electric field.
+  void AddMicroscopicRegion(const double xmin, const double ymin,
+                            const double zmin, const double xmax,
+                            const double ymax, const double zmax);
+  /// Remove all microscopic tracking regions.
+  void ClearMicroscopicRegions() { m_regions.clear(); }
+  /** Set the energy [eV] assigned to electrons handed over from Monte Carlo
+   * drift to microscopic tracking (default: 0.1 eV). */
+  void SetHandoverEnergy(const double e);
+
+  /** Simulate an avalanche initiated by an electron at a given point.
+   * \param x,y,z,t coordinates and time of the initial electron
+   * \param e initial energy [eV]
+   * \param dx,dy,dz initial direction (random if zero)
+   */
+  bool AvalancheElectron(const double x, const double y, const double z,
+                         const double t, const double e,
+                         const double dx = 0., const double dy = 0.,
+                         const double dz = 0.);
+
+  /// Return the number of electrons and ions in the last avalanche.
+  void GetAvalancheSize(unsigned int& ne, unsigned int& ni) const {
+    ne = m_nElectrons;
+    ni = m_nIons;
+  }
+  /// Return the number of handovers between the two transport methods.
+  unsigned int GetNumberOfHandovers() const { return m_nHandovers; }
+
+  /// Return the number of electron trajectories in the last avalanche.
+  size_t GetNumberOfElectronEndpoints() const { return m_endPoints.size(); }
+  /** Return the creation point and the end point of an electron.
+   * \param i index of the electron
+   * \param x0,y0,z0,t0 coordinates and time of the starting point
+   * \param x1,y1,z1,t1 coordinates and time of the end point
+   * \param status status code (see GarfieldConstants.hh)
+   */
+  void GetElectronEndpoint(const size_t i, double& x0, double& y0,
+                           double& z0, double& t0, double& x1, double& y1,
+                           double& z1, double& t1, int& status) const;
+
+  /// Switch debugging messages on/off (default: off).
+  void EnableDebugging(const bool on = true) { m_debug = on; }
+
+ private:
+  std::string m_className = "AvalancheHybrid";
+
+  Sensor* m_sensor = nullptr;
+  AvalancheMicroscopic* m_mic = nullptr;
+  AvalancheMC* m_mc = nullptr;
+
+  // Reduced field threshold [Td].
+  double m_eOverN = 100.;
+  // Relative width of the hysteresis band around the threshold.
+  double m_hysteresis = 0.05;
+  // Max. number of handovers of an electron.
+  unsigned int m_maxHandovers = 100;
+  // Boxes (xmin, ymin, zmin, xmax, ymax, zmax) with microscopic tracking.
+  std::vector<std::array<double, 6> > m_regions;
+  // Initial energy of electrons handed over to microscopic tracking.
+  double m_energy = 0.1;
+
+  struct EndPoint {
+    std::array<double, 4> p0;
+    std::array<double, 4> p1;
+    int status;
+  };
+  std::vector<EndPoint> m_endPoints;
+
+  unsigned int m_nElectrons = 0;
+  unsigned int m_nIons = 0;
+  unsigned int m_nHandovers = 0;
+
+  bool m_debug = false;
+
+  bool IsMicroscopic(const double x, const double y, const double z,
+                     const double emag, Medium* medium,
+                     const double scale = 1.) const;
+};
+}  // namespace Garfield
+
+#endif
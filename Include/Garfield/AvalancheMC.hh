@@ -2,9 +2,12 @@
 #define G_AVALANCHE_MC_H
 
 #include <array>
+#include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
+#include "ComponentSpaceCharge.hh"
 #include "FundamentalConstants.hh"
 #include "GarfieldConstants.hh"
 #include "Sensor.hh"
@@ -167,6 +170,25 @@ class AvalancheMC {
   /// Return the currently set avalanche size limit.
   int GetAvalancheSizeLimit() const { return m_sizeCut; }
 
+  /** Take into account the field of the charges in the avalanche.
+   * \param sc space-charge component (which has to be added to the sensor)
+   * \param dt time interval [ns] between updates of the charges
+   *
+   * For dt > 0, the electrons are transported in time slices of length dt.
+   * At the start of each slice, the charges are updated using the current
+   * positions of the electrons in flight and the points where holes/ions
+   * were produced. For dt = 0, the charges are updated at the start of
+   * each generation of the avalanche. The field seen by a particle does
+   * not include its own charge.
+   */
+  void EnableSpaceCharge(ComponentSpaceCharge* sc, const double dt = 0.);
+  /// Do not take into account the field of the avalanche charges.
+  void DisableSpaceCharge() { m_spaceCharge = nullptr; }
+  /// Get the space-charge component (null if not enabled).
+  ComponentSpaceCharge* GetSpaceCharge() const { return m_spaceCharge; }
+  /// Get the time interval between updates of the space charge.
+  double GetSpaceChargeInterval() const { return m_spaceChargeInterval; }
+
   /// Use fixed-time steps (default 20 ps).
   void SetTimeSteps(const double d = 0.02);
   /// Use fixed distance steps (default 10 um).
@@ -195,6 +217,19 @@ class AvalancheMC {
     ni = std::max(m_nIons, m_nHoles);
   }
 
+  /** Set a function (of position, electric field magnitude and medium)
+   * which is evaluated after every step of an electron drift line. If it
+   * returns true, the electron is stopped with status StatusHandedOver,
+   * e. g. for continuing its transport with AvalancheMicroscopic.
+   */
+  void SetExitCondition(
+      std::function<bool(const double x, const double y, const double z,
+                         const double emag, Medium* m)> f) {
+    m_exitCondition = f;
+  }
+  /// Remove the exit condition.
+  void UnsetExitCondition() { m_exitCondition = nullptr; }
+
   /// Switch debugging messages on/off (default: off).
   void EnableDebugging(const bool on = true) { m_debug = on; }
 
@@ -221,6 +256,10 @@ class AvalancheMC {
   /// User function returning the step size
   double (*m_fStep)(double x, double y, double z) = nullptr;
 
+  // User function for stopping electron drift lines.
+  std::function<bool(const double, const double, const double, const double,
+                     Medium*)> m_exitCondition;
+
   /// Flag whether a time window should be used.
   bool m_hasTimeWindow = false;
   /// Lower limit of the time window.
@@ -231,6 +270,12 @@ class AvalancheMC {
   /// Max. avalanche size.
   unsigned int m_sizeCut = 0;
 
+  /// Space-charge component and time interval between updates.
+  ComponentSpaceCharge* m_spaceCharge = nullptr;
+  double m_spaceChargeInterval = 0.;
+  // End of the current time slice (for electrons).
+  double m_tStop = std::numeric_limits<double>::max();
+
   /// Number of electrons produced
   unsigned int m_nElectrons = 0;
   /// Number of holes produced
@@ -335,6 +380,13 @@ class AvalancheMC {
                        std::vector<double>& alphas,
                        std::vector<double>& etas) const;
   bool Equilibrate(std::vector<double>& alphas) const;
+  static double Charge(const Particle particle) {
+    if (particle == Particle::Electron ||
+        particle == Particle::NegativeIon) {
+      return -1.;
+    }
+    return 1.;
+  }
   /// Compute the induced signal for the current drift line.
   void ComputeSignal(const Particle particle, const double q,
                      const std::vector<Point>& path) const;
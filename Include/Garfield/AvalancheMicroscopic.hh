@@ -1,11 +1,15 @@
 #ifndef G_AVALANCHE_MICROSCOPIC_H
 #define G_AVALANCHE_MICROSCOPIC_H
 
+#include <array>
+#include <functional>
+#include <limits>
 #include <string>
 #include <vector>
 
 #include <TH1.h>
 
+#include "ComponentSpaceCharge.hh"
 #include "GarfieldConstants.hh"
 #include "Sensor.hh"
 #include "ViewDrift.hh"
@@ -61,10 +65,14 @@ class AvalancheMicroscopic {
   void EnableElectronEnergyHistogramming(TH1* histo);
   /// Stop histogramming the electron energy distribution.
   void DisableElectronEnergyHistogramming() { m_histElectronEnergy = nullptr; }
+  /// Get the histogram of the electron energy distribution (if any).
+  TH1* GetElectronEnergyHistogram() const { return m_histElectronEnergy; }
   /// Fill a histogram with the hole energy distribution.
   void EnableHoleEnergyHistogramming(TH1* histo);
   /// Stop histogramming the hole energy distribution.
   void DisableHoleEnergyHistogramming() { m_histHoleEnergy = nullptr; }
+  /// Get the histogram of the hole energy distribution (if any).
+  TH1* GetHoleEnergyHistogram() const { return m_histHoleEnergy; }
 
   /** Fill histograms of the distance between successive collisions.
    * \param histo
@@ -79,10 +87,17 @@ class AvalancheMicroscopic {
   void DisableDistanceHistogramming(const int type);
   /// Stop filling distance distribution histograms.
   void DisableDistanceHistogramming();
+  /// Get the distance histogram (if any) and its direction.
+  TH1* GetDistanceHistogram(char& opt) const {
+    opt = m_distanceOption;
+    return m_histDistance;
+  }
   /// Fill histograms of the energy of electrons emitted in ionising collisions.
   void EnableSecondaryEnergyHistogramming(TH1* histo);
   /// Stop histogramming the secondary electron energy distribution.
   void DisableSecondaryEnergyHistogramming() { m_histSecondary = nullptr; }
+  /// Get the histogram of the secondary electron energy distribution.
+  TH1* GetSecondaryEnergyHistogram() const { return m_histSecondary; }
 
   /// Switch on storage of drift lines (default: off).
   void EnableDriftLines(const bool on = true) { m_storeDriftLines = on; }
@@ -100,6 +115,20 @@ class AvalancheMicroscopic {
   void EnableNullCollisionSteps(const bool on = true) {
     m_useNullCollisionSteps = on;
   }
+  /** Use null-collision rates tabulated in energy windows instead of 
+    * the maximum over the full energy range (default: on). 
+    * Not used for stepping in a magnetic field.
+    */
+  void EnableNullCollisionRateWindows(const bool on = true) {
+    m_useNullCollisionWindows = on;
+  }
+  /// Get the fraction of sampled free flights which ended 
+  /// with a null collision.
+  double GetNullCollisionFraction() const {
+    return m_nFlights > 0 ? double(m_nNullCollisions) / m_nFlights : 0.;
+  }
+  /// Reset the counters of free flights and null collisions.
+  void ResetNullCollisionCounters() { m_nFlights = m_nNullCollisions = 0; }
 
   /** Set a (lower) energy threshold for electron transport.
    * This can be useful for simulating delta electrons. */
@@ -120,6 +149,36 @@ class AvalancheMicroscopic {
   /// Retrieve the currently set size limit.
   int GetAvalancheSizeLimit() const { return m_sizeCut; }
 
+  /** Limit the number of electrons/holes to be tracked in each generation
+   * of the avalanche. Beyond this number, the secondaries of a generation
+   * are thinned by Russian roulette and the surviving ones are given
+   * a correspondingly larger statistical weight, which is applied to the
+   * induced signal, the histograms and the weighted avalanche size.
+   * Mean values (signal, gain) are unbiased; fluctuations are not.
+   */
+  void EnableSuperparticles(const unsigned int size) { m_superSize = size; }
+  /// Track all electrons/holes individually.
+  void DisableSuperparticles() { m_superSize = 0; }
+
+  /** Take into account the field of the charges in the avalanche.
+   * \param sc space-charge component (which has to be added to the sensor)
+   * \param dt time interval [ns] between updates of the charges
+   *
+   * For dt > 0, the avalanche is transported in time slices of length dt.
+   * At the start of each slice, the charges are updated using the current
+   * positions of the electrons/holes in flight and the points where ions
+   * were produced. For dt = 0, the charges are updated at the start of
+   * each generation of the avalanche. The field seen by a particle does
+   * not include its own charge.
+   */
+  void EnableSpaceCharge(ComponentSpaceCharge* sc, const double dt = 0.);
+  /// Do not take into account the field of the avalanche charges.
+  void DisableSpaceCharge() { m_spaceCharge = nullptr; }
+  /// Get the space-charge component (null if not enabled).
+  ComponentSpaceCharge* GetSpaceCharge() const { return m_spaceCharge; }
+  /// Get the time interval between updates of the space charge.
+  double GetSpaceChargeInterval() const { return m_spaceChargeInterval; }
+
   /// Switch on/off using the magnetic field in the stepping algorithm.
   void EnableMagneticField(const bool on = true) { 
     m_useBfieldAuto = false;
@@ -144,6 +203,13 @@ class AvalancheMicroscopic {
     nh = m_nHoles;
     ni = m_nIons;
   }
+  /// Return the number of electrons, holes and ions in the avalanche,
+  /// weighted by the statistical weights of the tracked particles.
+  void GetWeightedAvalancheSize(double& ne, double& nh, double& ni) const {
+    ne = m_wElectrons;
+    nh = m_wHoles;
+    ni = m_wIons;
+  }
 
   struct Point {
     double x, y, z;    ///< Coordinates.
@@ -157,6 +223,7 @@ class AvalancheMicroscopic {
     int status = 0;                ///< Status.
     std::vector<Point> path;       ///< Drift line.
     double pathLength = 0.;        ///< Path length.
+    double weight = 1.;            ///< Statistical weight.
   };
 
   const std::vector<Electron>& GetElectrons() const { return m_electrons; }
@@ -256,6 +323,19 @@ class AvalancheMicroscopic {
   /// Deactivate the user handle called at every ionisation.
   void UnsetUserHandleIonisation() { m_userHandleIonisation = nullptr; }
 
+  /** Set a function (of position, electric field magnitude and medium)
+   * which is evaluated after every free flight of an electron. If it
+   * returns true, the electron is stopped with status StatusHandedOver,
+   * e. g. for continuing its transport with AvalancheMC.
+   */
+  void SetExitCondition(
+      std::function<bool(const double x, const double y, const double z,
+                         const double emag, Medium* m)> f) {
+    m_exitCondition = f;
+  }
+  /// Remove the exit condition.
+  void UnsetExitCondition() { m_exitCondition = nullptr; }
+
   /// Switch on debugging messages.
   void EnableDebugging() { m_debug = true; }
   void DisableDebugging() { m_debug = false; }
@@ -282,6 +362,10 @@ class AvalancheMicroscopic {
   int m_nHoles = 0;
   /// Number of ions produced
   int m_nIons = 0;
+  /// Weighted number of electrons, holes and ions produced
+  double m_wElectrons = 0.;
+  double m_wHoles = 0.;
+  double m_wIons = 0.;
 
   ViewDrift* m_viewer = nullptr;
   bool m_plotExcitations = true;
@@ -306,6 +390,7 @@ class AvalancheMicroscopic {
   bool m_usePhotons = false;
   bool m_useBandStructure = true;
   bool m_useNullCollisionSteps = false;
+  bool m_useNullCollisionWindows = true;
   bool m_useBfieldAuto = true;
   bool m_useBfield = false;
 
@@ -315,10 +400,22 @@ class AvalancheMicroscopic {
 
   // Max. avalanche size
   unsigned int m_sizeCut = 0;
+  // Max. number of electrons/holes per generation (superparticle mode)
+  unsigned int m_superSize = 0;
+
+  // Space-charge component and time interval between updates.
+  ComponentSpaceCharge* m_spaceCharge = nullptr;
+  double m_spaceChargeInterval = 0.;
+  // End of the current time slice.
+  double m_tStop = std::numeric_limits<double>::max();
 
   size_t m_nCollSkip = 100;
   size_t m_nCollPlot = 100;
 
+  // Number of sampled free flights and null collisions.
+  size_t m_nFlights = 0;
+  size_t m_nNullCollisions = 0;
+
   bool m_hasTimeWindow = false;
   double m_tMin = 0.;
   double m_tMax = 0.;
@@ -337,24 +434,35 @@ class AvalancheMicroscopic {
                                 int type, int level, Medium* m) = nullptr;
   void (*m_userHandleIonisation)(double x, double y, double z, double t,
                                  int type, int level, Medium* m) = nullptr;
+  std::function<bool(const double, const double, const double, const double,
+                     Medium*)> m_exitCondition;
 
   // Switch on/off debugging messages
   bool m_debug = false;
 
   bool TransportElectrons(std::vector<std::pair<Point, Particle> >& stack,
-                          const bool aval);
-  int TransportElectron(const Point& p0, const bool hole, 
+                          std::vector<double>& weights, const bool aval);
+  bool UpdateSpaceCharge(
+      const std::vector<std::pair<Point, Particle> >& particles,
+      const std::vector<double>& weights,
+      const std::vector<std::array<double, 4> >& ions, double& tLast);
+  void ThinParticles(std::vector<std::pair<Point, Particle> >& stack,
+                     std::vector<double>& weights,
+                     std::vector<int>& lines) const;
+  int TransportElectron(const Point& p0, const double w, const bool hole, 
                         const bool aval, const bool signal, 
                         std::vector<Point>& path,
                         std::vector<std::pair<Point, Particle> >& newParticles,
                         double& pathLength);
-  int TransportElectronBfield(const Point& p0, const bool hole, 
+  int TransportElectronBfield(const Point& p0, const double w,
+                        const bool hole, 
                         const bool aval, 
                         const bool signal, 
                         std::vector<Point>& path,
                         std::vector<std::pair<Point, Particle> >& newParticles,
                         double& pathLength);
-  int TransportElectronSc(const Point& p0, const bool hole, 
+  int TransportElectronSc(const Point& p0, const double w,
+                        const bool hole, 
                         const bool aval, 
                         const bool signal, 
                         std::vector<Point>& path,
@@ -367,7 +475,7 @@ class AvalancheMicroscopic {
   void AddSignal(const double x0, const double y0, const double z0, 
                  const double t0,
                  const double x1, const double y1, const double z1, 
-                 const double t1, const bool hole) const;
+                 const double t1, const bool hole, const double w) const;
 
   void Terminate(double x0, double y0, double z0, double t0, double& x1,
                  double& y1, double& z1, double& t1) const;
@@ -377,7 +485,8 @@ class AvalancheMicroscopic {
                      size_t& nCollPlot) const;
   void FillDistanceHistogram(const int cstype,
                              const double x, const double y, const double z,
-                             double& xLast, double& yLast, double& zLast) const;
+                             double& xLast, double& yLast, double& zLast,
+                             const double w) const;
 };
 }
 
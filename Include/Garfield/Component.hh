@@ -3,6 +3,7 @@
 
 #include <array>
 #include <string>
+#include <vector>
 
 #include "Geometry.hh"
 
@@ -97,6 +98,31 @@ class Component {
                                            const double z, const double t,
                                            const std::string& label);
 
+  /** Calculate the delayed weighting field at a given point for a list 
+   * of times and for a given electrode.
+   * \param x,y,z coordinates [cm].
+   * \param ts times [ns].
+   * \param ws delayed weighting field [1/cm] at each of the times.
+   * \param label name of the electrode
+   */
+  virtual void DelayedWeightingFields(const double x, const double y,
+                                      const double z,
+                                      const std::vector<double>& ts,
+                                      std::vector<std::array<double, 3> >& ws,
+                                      const std::string& label);
+  /** Calculate the delayed weighting potential at a given point for a 
+   * list of times and for a given electrode.
+   * \param x,y,z coordinates [cm].
+   * \param ts times [ns].
+   * \param ps delayed weighting potential at each of the times.
+   * \param label name of the electrode
+   */
+  virtual void DelayedWeightingPotentials(const double x, const double y,
+                                          const double z,
+                                          const std::vector<double>& ts,
+                                          std::vector<double>& ps,
+                                          const std::string& label);
+
   /** Calculate the magnetic field at a given point.
    *
    * \param x,y,z coordinates [cm].
@@ -111,6 +137,27 @@ class Component {
   /// Ready for use?
   virtual bool IsReady() { return m_ready; }
 
+  /** Complete any deferred initialisation (e.g. solving for the charges,
+   * setting up weighting fields or search structures), such that
+   * subsequent queries do not modify the component.
+   * \return false if the component cannot be used.
+   */
+  virtual bool Prepare() { return true; }
+  /** Prepare the component and switch to read-only mode. While frozen,
+   * field, potential and map queries leave the component unchanged and
+   * can be made concurrently from several threads. Modifying the
+   * component ends the read-only mode.
+   */
+  bool Freeze();
+  /// Leave read-only mode.
+  void Unfreeze() { m_frozen = false; }
+  /// Is the component in read-only mode?
+  bool IsFrozen() const { return m_frozen; }
+  /// Report modifications of the component while it is frozen.
+  void EnableFreezeCheck(const bool on = true) { m_checkFrozen = on; }
+  /// Get a counter that is incremented whenever the component is modified.
+  unsigned int GetRevision() const { return m_revision; }
+
   /// Get the bounding box coordinates.
   virtual bool GetBoundingBox(double& xmin, double& ymin, double& zmin,
                               double& xmax, double& ymax, double& zmax);
@@ -203,16 +250,19 @@ class Component {
   /// Enable simple periodicity in the \f$x\f$ direction.
   void EnablePeriodicityX(const bool on = true) {
     m_periodic[0] = on;
+    CheckFrozen("EnablePeriodicityX");
     UpdatePeriodicity();
   }
   /// Enable simple periodicity in the \f$y\f$ direction.
   void EnablePeriodicityY(const bool on = true) {
     m_periodic[1] = on;
+    CheckFrozen("EnablePeriodicityY");
     UpdatePeriodicity();
   }
   /// Enable simple periodicity in the \f$z\f$ direction.
   void EnablePeriodicityZ(const bool on = true) {
     m_periodic[2] = on;
+    CheckFrozen("EnablePeriodicityZ");
     UpdatePeriodicity();
   }
   /// Return periodicity flags.
@@ -225,16 +275,19 @@ class Component {
   /// Enable mirror periodicity in the \f$x\f$ direction.
   void EnableMirrorPeriodicityX(const bool on = true) {
     m_mirrorPeriodic[0] = on;
+    CheckFrozen("EnableMirrorPeriodicityX");
     UpdatePeriodicity();
   }
   /// Enable mirror periodicity in the \f$y\f$ direction.
   void EnableMirrorPeriodicityY(const bool on = true) {
     m_mirrorPeriodic[1] = on;
+    CheckFrozen("EnableMirrorPeriodicityY");
     UpdatePeriodicity();
   }
   /// Enable mirror periodicity in the \f$y\f$ direction.
   void EnableMirrorPeriodicityZ(const bool on = true) {
     m_mirrorPeriodic[2] = on;
+    CheckFrozen("EnableMirrorPeriodicityZ");
     UpdatePeriodicity();
   }
   /// Return mirror periodicity flags.
@@ -247,16 +300,19 @@ class Component {
   /// Enable axial periodicity in the \f$x\f$ direction.
   void EnableAxialPeriodicityX(const bool on = true) {
     m_axiallyPeriodic[0] = on;
+    CheckFrozen("EnableAxialPeriodicityX");
     UpdatePeriodicity();
   }
   /// Enable axial periodicity in the \f$y\f$ direction.
   void EnableAxialPeriodicityY(const bool on = true) {
     m_axiallyPeriodic[1] = on;
+    CheckFrozen("EnableAxialPeriodicityY");
     UpdatePeriodicity();
   }
   /// Enable axial periodicity in the \f$z\f$ direction.
   void EnableAxialPeriodicityZ(const bool on = true) {
     m_axiallyPeriodic[2] = on;
+    CheckFrozen("EnableAxialPeriodicityZ");
     UpdatePeriodicity();
   }
   /// Return axial periodicity flags.
@@ -269,16 +325,19 @@ class Component {
   /// Enable rotation symmetry around the \f$x\f$ axis.
   void EnableRotationSymmetryX(const bool on = true) {
     m_rotationSymmetric[0] = on;
+    CheckFrozen("EnableRotationSymmetryX");
     UpdatePeriodicity();
   }
   /// Enable rotation symmetry around the \f$y\f$ axis.
   void EnableRotationSymmetryY(const bool on = true) {
     m_rotationSymmetric[1] = on;
+    CheckFrozen("EnableRotationSymmetryY");
     UpdatePeriodicity();
   }
   /// Enable rotation symmetry around the \f$z\f$ axis.
   void EnableRotationSymmetryZ(const bool on = true) {
     m_rotationSymmetric[2] = on;
+    CheckFrozen("EnableRotationSymmetryZ");
     UpdatePeriodicity();
   }
   /// Return rotation symmetry flags.
@@ -302,6 +361,9 @@ class Component {
   virtual bool HasAttachmentMap() const { return false; }
   /// Does the component have velocity maps?
   virtual bool HasVelocityMap() const { return false; }
+  /// Is the field of the component only added to that of the other
+  /// components (without defining the medium)?
+  virtual bool IsOverlay() const { return false; }
 
   /// Get the electron attachment coefficient.
   virtual bool ElectronAttachment(const double /*x*/, const double /*y*/,
@@ -367,6 +429,13 @@ class Component {
   /// Ready for use?
   bool m_ready = false;
 
+  /// Read-only mode?
+  bool m_frozen = false;
+  /// Report modifications in read-only mode?
+  bool m_checkFrozen = false;
+  /// Number of modifications (incremented in CheckFrozen).
+  unsigned int m_revision = 0;
+
   /// Switch on/off debugging messages
   bool m_debug = false;
 
@@ -383,6 +452,9 @@ class Component {
   virtual void Reset() = 0;
   /// Verify periodicities.
   virtual void UpdatePeriodicity() = 0;
+  /// Count a modification and leave read-only mode (and report it,
+  /// if requested).
+  void CheckFrozen(const std::string& fcn);
  private:
 
   double IntegrateFluxParallelogram(
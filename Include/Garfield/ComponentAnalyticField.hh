@@ -408,6 +408,9 @@ class ComponentAnalyticField : public Component {
 
   double StepSizeHint() override;
 
+  /// Set up the cell and the weighting fields of the readout groups.
+  bool Prepare() override;
+
  private:
   std::mutex m_mutex;
 
@@ -591,7 +594,7 @@ class ComponentAnalyticField : public Component {
   }
 
   void CellInit();
-  bool Prepare();
+  bool PrepareCell();
   bool CellCheck();
   bool WireCheck() const;
   bool CellType();
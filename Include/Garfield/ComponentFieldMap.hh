@@ -10,7 +10,7 @@
 #include "Component.hh"
 #include "TMatrixD.h"
 #include "TVectorD.h"
-#include "TetrahedralTree.hh"
+#include "LinearTree.hh"
 
 namespace Garfield {
 
@@ -31,6 +31,10 @@ class ComponentFieldMap : public Component {
   /// Show x, y, z, V and angular ranges
   void PrintRange();
 
+  /// Check that a field map has been loaded (the element bounding boxes
+  /// and the search tree are set up when reading the map).
+  bool Prepare() override;
+
   /// List all currently defined materials
   void PrintMaterials();
   /// Flag a field map material as a drift medium.
@@ -78,6 +82,9 @@ class ComponentFieldMap : public Component {
   void EnableTetrahedralTreeForElementSearch(const bool on = true) {
     m_useTetrahedralTree = on;
   }
+  /// Set the max. number of mesh nodes in a cell of the search tree
+  /// (default: 10).
+  void SetTreeLeafSize(const unsigned int n) { m_treeLeafSize = n; }
 
   /// Enable or disable warnings that the calculation of the local
   /// coordinates did not achieve the requested precision.
@@ -235,7 +242,8 @@ class ComponentFieldMap : public Component {
   // Reset the component.
   void Reset() override;
 
-  void Prepare();
+  // Set up the ranges, bounding boxes and search tree of a new mesh.
+  void PrepareMesh();
 
   // Calculate x, y, z, V and angular ranges.
   virtual void SetRange();
@@ -327,7 +335,8 @@ class ComponentFieldMap : public Component {
 
   // Tetrahedral tree
   bool m_useTetrahedralTree = true;
-  std::unique_ptr<TetrahedralTree> m_octree;
+  unsigned int m_treeLeafSize = 10;
+  std::unique_ptr<LinearTree> m_octree;
 
   /// Flag to check if bounding boxes of elements are cached
   bool m_cacheElemBoundingBoxes = false;
@@ -403,6 +412,11 @@ class ComponentFieldMap : public Component {
   /// Initialize the tetrahedral tree.
   bool InitializeTetrahedralTree();
 
+  /// Get the elements whose bounding box is intersected by the plane
+  /// fx * x + fy * y + fz * z = d.
+  void GetElementsInPlane(const double fx, const double fy, const double fz,
+                          const double d, std::vector<size_t>& elems) const;
+
 };
 }  // namespace Garfield
 
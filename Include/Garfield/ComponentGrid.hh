@@ -1,6 +1,8 @@
 #ifndef G_COMPONENT_GRID_H
 #define G_COMPONENT_GRID_H
 
+#include <array>
+#include <functional>
 #include <vector>
 
 #include "Component.hh"
@@ -31,7 +33,10 @@ class ComponentGrid : public Component {
                double& xmin, double& xmax, double& ymin, double& ymax,
                double& zmin, double& zmax) const;
   /// Use Cartesian coordinates (default).
-  void SetCartesianCoordinates() { m_coordinates = Coordinates::Cartesian; }
+  void SetCartesianCoordinates() {
+    CheckFrozen("SetCartesianCoordinates");
+    m_coordinates = Coordinates::Cartesian;
+  }
   /// Use cylindrical coordinates.
   void SetCylindricalCoordinates();
 
@@ -51,7 +56,11 @@ class ComponentGrid : public Component {
    * Format types are:
    *  - "xy", "xz", "xyz": nodes are specified by their coordinates
    *  - "ij", "ik", "ijk": nodes are specified by their indices
+   *  - "bin": binary file written by @ref SaveElectricField
+   *    (see @ref GridFile for a description of the format)
    * 
+   * Text files are converted in parallel if OpenMP is enabled.
+   *
    * If cylindrical coordinates are used, the first coordinate (x)
    * corresponds to the radial distance and the second coordinate (y)
    * corresponds to the azimuth (in radian).
@@ -80,17 +89,20 @@ class ComponentGrid : public Component {
   bool LoadMagneticField(const std::string& filename, const std::string& format,
                          const double scaleX = 1., const double scaleB = 1.);
 
-  /** Export the electric field and potential of a component to a text file.
+  /** Export the electric field and potential of a component to a file.
    * \param cmp Component object for which to export the field/potential
-   * \param filename name of the text file
+   * \param filename name of the output file
    * \param fmt format string, see @ref LoadElectricField
+   *
+   * With format "bin", the map is written to a binary file which can be
+   * read back much faster than a text file.
    */
   bool SaveElectricField(Component* cmp, const std::string& filename,
                          const std::string& fmt);
-  /** Export the weighting field and potential of a component to a text file.
+  /** Export the weighting field and potential of a component to a file.
    * \param cmp Component object for which to export the field/potential
    * \param id identifier of the weighting field
-   * \param filename name of the text file
+   * \param filename name of the output file
    * \param fmt format string, see @ref LoadElectricField
    */
   bool SaveWeightingField(Component* cmp, const std::string& id,
@@ -199,7 +211,8 @@ class ComponentGrid : public Component {
     IJ,
     IK,
     IJK,
-    YXZ
+    YXZ,
+    Binary
   };
   enum class Coordinates {
     Cartesian,
@@ -260,6 +273,19 @@ class ComponentGrid : public Component {
                 const double scaleX,
                 std::vector<std::vector<std::vector<double> > >& tab,
                 const unsigned int col);
+  /// Read field and potential from a binary file.
+  bool LoadBinary(const std::string& filename, const bool withPotential,
+                  const bool withFlag, const double scaleX,
+                  const double scaleF, const double scaleP,
+                  std::vector<std::vector<std::vector<Node> > >& field);
+
+  /// Function returning the field and potential at a node.
+  typedef std::function<void(const double, const double, const double,
+                             double&, double&, double&, double&)>
+      FieldFunction;
+  /// Write a map to a text or binary file.
+  bool Save(const std::string& filename, const Format fmt, FieldFunction field,
+            const std::string& fcn);
 
   void Reset() override;
   void UpdatePeriodicity() override;
@@ -281,6 +307,13 @@ class ComponentGrid : public Component {
   void Initialise(std::vector<std::vector<std::vector<Node> > >& fields);
   /// Decode a format string.
   Format GetFormat(std::string fmt);
+  /// Get the number of coordinate columns of a format and the
+  /// corresponding axes.
+  static void GetColumns(const Format fmt, unsigned int& nCoordinates,
+                         bool& indices, std::array<unsigned int, 3>& axes);
+  /// Get the indices of the node corresponding to a line in a file.
+  void GetIndices(const Format fmt, const double* val, const double scaleX,
+                  std::array<unsigned int, 3>& index) const;
 };
 }  // namespace Garfield
 #endif
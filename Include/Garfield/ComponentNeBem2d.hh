@@ -52,6 +52,8 @@ class ComponentNeBem2d : public Component {
  
   /// Discretise the geometry and compute the solution.
   bool Initialise();
+  /// Compute the solution, unless this has been done already.
+  bool Prepare() override { return m_ready || Initialise(); }
 
   /// Set the default number of elements per segment.
   void SetNumberOfDivisions(const unsigned int ndiv);
@@ -1,6 +1,7 @@
 #ifndef G_COMPONENT_NEBEM_3D_H
 #define G_COMPONENT_NEBEM_3D_H
 
+#include <array>
 #include <map>
 
 #include "Component.hh"
@@ -57,6 +58,8 @@ class ComponentNeBem3d : public Component {
   /// Retrieve surface panels, remove contacts and cut polygons to rectangles
   /// and right-angle triangles.
   bool Initialise();
+  /// Compute the solution, unless this has been done already.
+  bool Prepare() override { return m_ready || Initialise(); }
 
   /// Set the default value of the target linear size of the elements
   /// produced by neBEM's discretisation process.
@@ -143,6 +146,31 @@ class ComponentNeBem3d : public Component {
   // Charging up options
   void SetChargingUpOptions(const unsigned int OptChargingUp);
 
+  /** Deposit a charge on a dielectric surface, for use in a charging-up
+   * simulation. The charge is assigned to the nearest element of a
+   * dielectric interface when UpdateChargingUp is called.
+   * Charges deposited before Initialise are included in the solution.
+   * \param x,y,z position [cm]
+   * \param q charge [in units of the elementary charge]
+   */
+  void AddSurfaceCharge(const double x, const double y, const double z,
+                        const double q);
+  /// Discard the surface charges which have not yet been applied.
+  void ClearSurfaceCharges() { m_surfaceCharges.clear(); }
+  /** Add the surface charges deposited since the last call to the solution.
+   * The inverted influence matrix is reused, so the cost of an update
+   * is that of computing the influence of the new charges and of a
+   * matrix-vector product, instead of a new solution.
+   */
+  bool UpdateChargingUp();
+  /// Set the relative change of potential and field below which the
+  /// nodes of the fast volume are not recomputed after a charging-up
+  /// update (default: 1.e-3; zero or negative: recompute all nodes).
+  void SetChargingUpTolerance(const double tol) { m_chargingUpTolerance = tol; }
+  /// Recompute all nodes of the fast volume from the current solution
+  /// (e. g. after a series of charging-up updates).
+  bool RebuildFastVolume();
+
   /// Invert the influence matrix using lower-upper (LU) decomposition.
   void UseLUInversion() { m_inversion = Inversion::LU; }
   /// Invert the influence matrix using singular value decomposition.
@@ -160,6 +188,13 @@ class ComponentNeBem3d : public Component {
     ny = m_nCopiesY;
     nz = m_nCopiesZ;
   }
+  /** Include the periodic copies beyond those set by SetPeriodicCopies
+   * using an Ewald sum (default: off). This applies to simple periodicity
+   * in one or two directions. Since the Ewald sum converges exponentially,
+   * a small number of explicit copies (e. g. 1) is then sufficient.
+   * For cells with a net charge, the potential is defined up to a constant.
+   */
+  void EnableEwaldSummation(const bool on = true) { m_ewald = on; }
   /// Set the periodic length [cm] in the x-direction.
   void SetPeriodicityX(const double s);
   /// Set the periodic length [cm] in the y-direction.
@@ -327,6 +362,10 @@ class ComponentNeBem3d : public Component {
 
   // Charging up options
   unsigned int m_optChargingUp = 0;
+  // Surface charges (x, y, z [cm], q) not yet added to the solution.
+  std::vector<std::array<double, 4> > m_surfaceCharges;
+  // Relative tolerance for updating the fast volume after charging up.
+  double m_chargingUpTolerance = 1.e-3;
 
   // Number of threads to be used by neBEM.
   unsigned int m_nThreads = 1;
@@ -359,6 +398,8 @@ class ComponentNeBem3d : public Component {
   unsigned int m_nCopiesY = 5;
   /// Number of periodic copies along z.
   unsigned int m_nCopiesZ = 5;
+  /// Use an Ewald sum for the remaining periodic copies.
+  bool m_ewald = false;
 
   enum class Inversion { LU = 0, SVD };
   Inversion m_inversion = Inversion::LU;
@@ -367,12 +408,15 @@ class ComponentNeBem3d : public Component {
   std::map<std::string, int> m_wfields;
 
   void InitValues();
+  /// Assign the pending surface charges to the nearest dielectric elements
+  /// and compute the charge densities [C / m2] of elements 1 ... NbElements.
+  bool SurfaceChargeDensities(double* assigned, const std::string& fcn);
   /// Reduce panels to the basic period.
   void ShiftPanels(std::vector<Panel>& panels) const;
   /// Isolate the parts of polygon 1 that are not hidden by 2 and vice versa.
   bool EliminateOverlaps(const Panel& panel1, const Panel& panel2,
                          std::vector<Panel>& panelsOut,
-                         std::vector<int>& itypo);
+                         std::vector<int>& itypo) const;
 
   bool TraceEnclosed(const std::vector<double>& xl1,
                      const std::vector<double>& yl1,
@@ -0,0 +1,113 @@
+#ifndef G_COMPONENT_SPACE_CHARGE_H
+#define G_COMPONENT_SPACE_CHARGE_H
+
+#include <array>
+#include <vector>
+
+#include "Component.hh"
+
+namespace Garfield {
+
+/// Electric field of a set of point charges (e. g. the electrons and ions
+/// of an avalanche), evaluated using a Barnes-Hut octree.
+/// The component does not define a medium; its field is added to that
+/// of the other components in a Sensor.
+
+class ComponentSpaceCharge : public Component {
+ public:
+  /// Constructor
+  ComponentSpaceCharge();
+  /// Destructor
+  ~ComponentSpaceCharge() {}
+
+  /// Add a point charge (in units of the elementary charge) at (x, y, z).
+  void AddCharge(const double x, const double y, const double z,
+                 const double q);
+  /// Remove all charges.
+  void ClearCharges();
+  /// Return the number of charges.
+  size_t GetNumberOfCharges() const { return m_charges.size(); }
+  /// (Re)build the octree after adding or removing charges.
+  bool Update();
+  /** Leave out a point charge (e. g. that of the particle being transported,
+   * at the position where it was added) when evaluating the field. */
+  void ExcludeCharge(const double x, const double y, const double z,
+                     const double q);
+  /// Evaluate the field of all charges again.
+  void IncludeAllCharges() { m_hasExcluded = false; }
+
+  /** Set the opening angle criterion (ratio of cell size and distance)
+   * below which a cell is represented by its centres of charge
+   * (default: 0.5). */
+  void SetOpeningAngle(const double theta);
+  /// Set the length [cm] by which the charges are smeared (default: 1 um).
+  void SetSmoothingLength(const double eps);
+  /// Set the max. number of charges in a cell of the tree (default: 16).
+  void SetMaxChargesPerCell(const unsigned int n);
+  /// Set the number of threads used for building the tree.
+  void SetNumberOfThreads(const unsigned int n) { m_nThreads = n > 0 ? n : 1; }
+
+  void ElectricField(const double x, const double y, const double z, double& ex,
+                     double& ey, double& ez, Medium*& m, int& status) override;
+  void ElectricField(const double x, const double y, const double z, double& ex,
+                     double& ey, double& ez, double& v, Medium*& m,
+                     int& status) override;
+  using Component::ElectricField;
+  bool GetVoltageRange(double& vmin, double& vmax) override;
+  bool IsOverlay() const override { return true; }
+  /// Build the octree, if charges have been added or removed.
+  bool Prepare() override { return !m_changed || Update(); }
+
+ private:
+  // Charges (x, y, z, q).
+  std::vector<std::array<double, 4> > m_charges;
+
+  struct Node {
+    // Centre and edge length of the cell.
+    std::array<double, 3> centre;
+    double size;
+    // Positive and negative charge in the cell and their centres.
+    double qp, qn;
+    std::array<double, 3> cp, cn;
+    // Daughter cells (-1 if empty).
+    std::array<int, 8> children;
+    // Range of charges in the cell.
+    size_t begin, end;
+    bool leaf;
+  };
+  std::vector<Node> m_nodes;
+
+  // Sub-tree to be built in parallel.
+  struct Task {
+    int parent;
+    unsigned int octant;
+    size_t begin, end;
+    std::array<double, 3> centre;
+    double size;
+  };
+
+  double m_theta = 0.5;
+  double m_eps = 1.e-4;
+  unsigned int m_leafSize = 16;
+  unsigned int m_nThreads = 1;
+
+  // Did the set of charges change since the last update?
+  bool m_changed = false;
+
+  // Charge (x, y, z, q) to be left out.
+  std::array<double, 4> m_excluded;
+  bool m_hasExcluded = false;
+
+  void Reset() override;
+  void UpdatePeriodicity() override;
+
+  int BuildTree(std::vector<Node>& nodes, const size_t begin,
+                const size_t end, const std::array<double, 3>& centre,
+                const double size, const unsigned int depth,
+                std::vector<Task>* tasks);
+  void Evaluate(const double x, const double y, const double z, double& ex,
+                double& ey, double& ez, double& v) const;
+};
+}  // namespace Garfield
+
+#endif
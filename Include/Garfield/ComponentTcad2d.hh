@@ -4,7 +4,7 @@
 #include <memory>
 
 #include "ComponentTcadBase.hh"
-#include "QuadTree.hh"
+#include "LinearTree.hh"
 
 namespace Garfield {
 
@@ -57,7 +57,7 @@ class ComponentTcad2d : public ComponentTcadBase<2> {
   bool m_hasRangeZ = false;
 
   // Tetrahedral tree.
-  std::unique_ptr<QuadTree> m_tree;
+  std::unique_ptr<LinearTree> m_tree;
 
   void Reset() override {
     Cleanup();
@@ -86,6 +86,9 @@ class ComponentTcad2d : public ComponentTcadBase<2> {
                    const std::vector<std::array<double, 2> >& field, 
                    double& fx, double& fy, double& fz) override;
   void FillTree() override;
+  size_t Locate(const double x, const double y, const double z,
+                std::array<double, nMaxVertices>& w,
+                std::array<bool, 2>& mirr) const override;
 };
 }
 #endif
@@ -4,7 +4,7 @@
 #include <memory>
 
 #include "ComponentTcadBase.hh"
-#include "TetrahedralTree.hh"
+#include "LinearTree.hh"
 
 namespace Garfield {
 
@@ -49,7 +49,7 @@ class ComponentTcad3d : public ComponentTcadBase<3> {
  private:
 
   // Tetrahedral tree.
-  std::unique_ptr<TetrahedralTree> m_tree;
+  std::unique_ptr<LinearTree> m_tree;
 
   void Reset() override {
     Cleanup();
@@ -94,6 +94,9 @@ class ComponentTcad3d : public ComponentTcadBase<3> {
                    const std::vector<std::array<double, 3> >& field, 
                    double& fx, double& fy, double& fz) override;
   void FillTree() override;
+  size_t Locate(const double x, const double y, const double z,
+                std::array<double, nMaxVertices>& w,
+                std::array<bool, 3>& mirr) const override;
 
 };
 }
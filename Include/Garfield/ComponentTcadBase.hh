@@ -3,6 +3,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 
 #include "Component.hh"
 
@@ -30,6 +33,17 @@ class ComponentTcadBase : public Component {
     */
   bool Initialise(const std::string& gridfilename,
                   const std::string& datafilename);
+  /** Keep a binary copy of the mesh and field map imported by Initialise
+    * (in a file named after the .dat file, with suffix ".cache") 
+    * and use it in subsequent calls as long as the .grd and .dat files 
+    * are unchanged.
+    */
+  void EnableBinaryCache(const bool on = true) { m_useBinaryCache = on; }
+  /// Write the mesh, field map and prompt weighting fields to a binary file.
+  bool SaveSnapshot(const std::string& filename) const;
+  /// Import mesh, field map and prompt weighting fields from a binary file
+  /// written by SaveSnapshot.
+  bool LoadSnapshot(const std::string& filename);
 
   /** Import field maps defining the prompt weighting field and potential.
     * \param datfile1 .dat file containing the field map at nominal bias.
@@ -57,6 +71,28 @@ class ComponentTcadBase : public Component {
   bool SetWeightingField(const std::string& datfile1,
                          const std::string& datfile2, const double dv,
                          const double t, const std::string& label);
+  /** Store the delayed weighting fields/potentials in node-major order,
+    * i. e. with all time slices of a vertex next to each other.
+    * \param on flag to switch the node-major layout on/off
+    * \param compress store the maps in single precision
+    * \param stride keep only every n-th time slice (and the last one)
+    *
+    * The maps are rearranged at the first evaluation of a delayed 
+    * weighting field/potential, after which no further time slices 
+    * can be added.
+    */
+  void EnableNodeMajorDelayedWeighting(const bool on = true, 
+                                       const bool compress = false,
+                                       const unsigned int stride = 1);
+  /// Read the maps of delayed weighting fields/potentials only when 
+  /// they are first needed (default: off).
+  void EnableLazyLoading(const bool on = true) {
+    CheckFrozen("EnableLazyLoading");
+    m_lazyLoading = on;
+  }
+  /// Set the max. number of mesh nodes in a cell of the search tree
+  /// (default: 10).
+  void SetTreeLeafSize(const unsigned int n) { m_treeLeafSize = n; }
 
   /// List all currently defined regions.
   void PrintRegions() const;
@@ -99,10 +135,16 @@ class ComponentTcadBase : public Component {
                    const double hxsec, const double concentration);
 
   /// Switch use of the imported impact ionisation map on/off.
-  void EnableAlphaMap(const bool on) { m_useAlphaMap = on; }
+  void EnableAlphaMap(const bool on) {
+    CheckFrozen("EnableAlphaMap");
+    m_useAlphaMap = on;
+  }
 
   /// Switch use of the imported trapping map on/off.
-  void EnableAttachmentMap(const bool on) { m_useAttachmentMap = on; }
+  void EnableAttachmentMap(const bool on) {
+    CheckFrozen("EnableAttachmentMap");
+    m_useAttachmentMap = on;
+  }
 
   /// Get the electron mobility at a given point in the mesh.
   bool GetElectronMobility(const double x, const double y, const double z, 
@@ -123,6 +165,14 @@ class ComponentTcadBase : public Component {
   double DelayedWeightingPotential(const double x, const double y,
                                    const double z, const double t,
                                    const std::string& label) override;
+  void DelayedWeightingFields(const double x, const double y, const double z,
+                              const std::vector<double>& ts,
+                              std::vector<std::array<double, 3> >& ws,
+                              const std::string& label) override;
+  void DelayedWeightingPotentials(const double x, const double y,
+                                  const double z, const std::vector<double>& ts,
+                                  std::vector<double>& ps,
+                                  const std::string& label) override;
 
   bool GetVoltageRange(double& vmin, double& vmax) override;
   
@@ -217,9 +267,40 @@ class ComponentTcadBase : public Component {
   // Delayed weighting field and potential.
   std::vector<std::vector<std::array<double, N> > > m_dwf;
   std::vector<std::vector<double> > m_dwp; 
+  // Flags indicating which (lazily loaded) time slices are available.
+  std::vector<std::atomic<bool> > m_dwfLoaded;
+  std::vector<std::atomic<bool> > m_dwpLoaded;
+  // Flags indicating which time slices could not be read.
+  std::vector<std::atomic<bool> > m_dwfFailed;
+  std::vector<std::atomic<bool> > m_dwpFailed;
   // Times corresponding to the delayed weighting fields/potentials.
   std::vector<double> m_dwtf;
   std::vector<double> m_dwtp;
+  // Files from which the delayed weighting fields/potentials are read.
+  struct DelayedMapFiles {
+    std::string file1;
+    std::string file2;
+    double dv;
+  };
+  std::vector<DelayedMapFiles> m_dwfFiles;
+  std::vector<DelayedMapFiles> m_dwpFiles;
+  bool m_lazyLoading = false;
+  // Delayed weighting field and potential in node-major layout.
+  bool m_dwNodeMajor = false;
+  bool m_dwSinglePrecision = false;
+  unsigned int m_dwStride = 1;
+  std::atomic<bool> m_dwPacked{false};
+  std::atomic<bool> m_dwPackFailed{false};
+  std::vector<double> m_dwfNodeMajor;
+  std::vector<double> m_dwpNodeMajor;
+  std::vector<float> m_dwfNodeMajorF;
+  std::vector<float> m_dwpNodeMajorF;
+  std::mutex m_dwMutex;
+  // Most recently imported reference map (typically shared by 
+  // several weighting fields/potentials).
+  std::string m_wfCacheFile;
+  std::vector<std::array<double, N> > m_wfCacheField;
+  std::vector<double> m_wfCachePot;
 
   // Velocities [cm / ns]
   std::vector<std::array<double, N> > m_eVelocity; 
@@ -257,15 +338,28 @@ class ComponentTcadBase : public Component {
   bool m_useAttachmentMap = false;
   // Use impact ionisation map or not.
   bool m_useAlphaMap = false;
+  // Cache the imported mesh and field map in a binary file or not.
+  bool m_useBinaryCache = false;
 
   // Bounding box.
   std::array<double, 3> m_bbMin = {{0., 0., 0.}};
   std::array<double, 3> m_bbMax = {{0., 0., 0.}};
+  // Max. number of mesh nodes in a cell of the search tree.
+  unsigned int m_treeLeafSize = 10;
   
   // Voltage range
   double m_pMin = 0.;
   double m_pMax = 0.;
 
+  // Element type of a simplex (triangle in 2D, tetrahedron in 3D).
+  static constexpr unsigned int SimplexType = N == 2 ? 2 : 5;
+  // Neighbouring simplices of each simplex, across the facet opposite
+  // to each vertex (-1 if there is none).
+  std::vector<std::array<int, N + 1> > m_neighbours;
+  // Inverse of the edge matrix (v1 - v0, ..., vN - v0) of each simplex,
+  // used for computing barycentric coordinates.
+  std::vector<std::array<double, N * N> > m_barycentric;
+
   void UpdatePeriodicity() override;
 
   void Cleanup();
@@ -279,6 +373,17 @@ class ComponentTcadBase : public Component {
                            const std::vector<std::array<double, N> >& field,
                            double& fx, double& fy, double& fz) = 0;
   virtual void FillTree() = 0;
+  // Find the element containing a point (after mapping it onto the 
+  // elementary cell) and compute the shape functions. Returns the 
+  // number of elements if the point is outside the mesh.
+  virtual size_t Locate(const double x, const double y, const double z,
+                        std::array<double, nMaxVertices>& w,
+                        std::array<bool, N>& mirr) const = 0;
+  // Determine the time slices bracketing a given time and the 
+  // corresponding interpolation weights.
+  static bool TimeInterpolation(const std::vector<double>& times, 
+                                const double t, size_t& i0, double& f0, 
+                                double& f1);
 
   size_t FindRegion(const std::string& name) const;
   void MapCoordinates(std::array<double, N>& x, 
@@ -291,12 +396,47 @@ class ComponentTcadBase : public Component {
   }
   void UpdateAttachment();
 
+  // Set up the element adjacency graph and the barycentric coordinate 
+  // tables of the simplices in the mesh.
+  void FillNeighbours();
+  // Check whether a point is inside a given simplex and compute the
+  // barycentric coordinates if it is.
+  bool InSimplex(const size_t i, const std::array<double, N>& x,
+                 std::array<double, nMaxVertices>& w) const;
+  // Starting from a given simplex, walk through the neighbouring
+  // simplices towards a point. Returns the number of elements if the 
+  // point could not be reached within a few steps.
+  size_t Walk(size_t i, const std::array<double, N>& x,
+              std::array<double, nMaxVertices>& w) const;
+  // Element found in the previous search by the calling thread.
+  size_t& LastElement() const;
+
+  bool Finalise();
+  bool WriteSnapshot(const std::string& filename,
+                     const std::array<int64_t, 4>& stamps) const;
+  bool ReadSnapshot(const std::string& filename,
+                    const std::array<int64_t, 4>* stamps);
   bool LoadGrid(const std::string& gridfilename);
   bool LoadData(const std::string& datafilename); 
   bool ReadDataset(std::ifstream& datafile, const std::string& dataset);
   bool LoadWeightingField(const std::string& datafilename,
                           std::vector<std::array<double, N> >& wf,
-                          std::vector<double>& wp);
+                          std::vector<double>& wp, const bool cache = false);
+  bool ReadDelayedWeightingField(const std::string& datfile1,
+                                 const std::string& datfile2, const double dv,
+                                 std::vector<std::array<double, N> >& wf);
+  bool ReadDelayedWeightingPotential(const std::string& datfile1,
+                                     const std::string& datfile2,
+                                     const double dv, std::vector<double>& wp);
+  bool LoadDelayedWeightingField(const size_t i);
+  bool LoadDelayedWeightingPotential(const size_t i);
+  bool PackDelayedWeightingMaps();
+  bool DelayedField(const Element& element, 
+                    const std::array<double, nMaxVertices>& w,
+                    const double t, std::array<double, N>& f);
+  bool DelayedPotential(const Element& element, 
+                        const std::array<double, nMaxVertices>& w,
+                        const double t, double& p);
 
   bool GetOffset(const std::string& label, 
                  double& dx, double& dy, double& dz) const;
@@ -15,7 +15,10 @@ class ComponentVoxel : public Component {
   ~ComponentVoxel() {}
 
   /// Interpolate between field values at the element centres.
-  void EnableInterpolation(const bool on = true) { m_interpolate = on; }
+  void EnableInterpolation(const bool on = true) {
+    CheckFrozen("EnableInterpolation");
+    m_interpolate = on;
+  }
 
   /** Define the grid.
     * \param nx,ny,nz number of bins along x, y, z.
@@ -42,6 +45,7 @@ class ComponentVoxel : public Component {
     * Format types are:
     *  - "xy", "xyz": elements are specified by the coordinates of their centres
     *  - "ij", "ijk": elements are specified by their indices
+    *  - "bin": binary file with the same mesh (see @ref GridFile)
     */
   bool LoadElectricField(const std::string& filename, const std::string& format,
                          const bool withPotential, const bool withRegion,
@@ -160,6 +164,11 @@ class ComponentVoxel : public Component {
                 const bool withPotential, const bool withRegion,
                 const double scaleX, const double scaleF, const double scaleP,
                 std::vector<std::vector<std::vector<Element> > >& field);
+  /// Read data from a binary file.
+  bool LoadBinary(const std::string& filename, const bool withPotential,
+                  const bool withRegion, const double scaleF,
+                  const double scaleP,
+                  std::vector<std::vector<std::vector<Element> > >& field);
 
   void Reset() override;
   void UpdatePeriodicity() override;
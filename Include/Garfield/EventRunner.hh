@@ -0,0 +1,166 @@
+#ifndef G_EVENT_RUNNER_H
+#define G_EVENT_RUNNER_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <TH1.h>
+
+#include "AvalancheMC.hh"
+#include "AvalancheMicroscopic.hh"
+#include "ComponentSpaceCharge.hh"
+#include "DriftLineRKF.hh"
+#include "RandomEngineRoot.hh"
+#include "Sensor.hh"
+#include "Track.hh"
+
+namespace Garfield {
+
+/// Run events in parallel, using per-thread copies of the transport engines
+/// and tracks on top of a shared (frozen) set of components.
+/// Space-charge components used by the transport engines are not shared;
+/// each thread gets its own (initially empty) copy.
+/// Each thread has its own sensor for accumulating the signals. At the end
+/// of each batch the signals and histograms of the threads are added to
+/// those of the main sensor/histograms, in a fixed order. This includes
+/// the histograms filled by the AvalancheMicroscopic object (energy,
+/// distance and secondary energy distributions), which are replaced by
+/// per-thread copies in the threads. Plotting of drift lines is switched
+/// off in the threads.
+/// The random number generator of a thread is re-seeded at the start of
+/// each event, using the global seed and the event number, such that the
+/// result of an event does not depend on which thread processes it.
+
+class EventRunner {
+ public:
+  /// End points of the drift lines in the transport engines.
+  struct Endpoints {
+    std::vector<AvalancheMicroscopic::Electron> electrons;
+    std::vector<AvalancheMicroscopic::Electron> holes;
+    std::vector<AvalancheMC::EndPoint> mcElectrons;
+    std::vector<AvalancheMC::EndPoint> mcHoles;
+    std::vector<AvalancheMC::EndPoint> mcIons;
+  };
+  /// Per-thread state.
+  struct Worker {
+    /// Index of the thread.
+    unsigned int index = 0;
+    /// Sensor with the same components and electrodes as the main sensor.
+    Sensor sensor;
+    /// Copies of the transport engines (if set), attached to the sensor.
+    std::unique_ptr<AvalancheMC> mc;
+    std::unique_ptr<AvalancheMicroscopic> microscopic;
+    std::unique_ptr<DriftLineRKF> driftLineRKF;
+    /// Copies of the space-charge components used by the transport engines.
+    /// They replace the shared components in the sensor.
+    std::vector<std::unique_ptr<ComponentSpaceCharge> > spaceCharge;
+    /// Track created by the track factory (if set).
+    std::unique_ptr<Track> track;
+    /// Copies of the histograms registered with AddHistogram.
+    std::vector<std::unique_ptr<TH1> > histograms;
+    /// Copies of the histograms of the AvalancheMicroscopic object.
+    std::vector<std::unique_ptr<TH1> > engineHistograms;
+    /// End points collected after each event of the current batch.
+    std::vector<Endpoints> endpoints;
+    /// Random number generator.
+    RandomEngineRoot rng;
+  };
+  /// Function to be called for each event.
+  typedef std::function<void(const size_t event, Worker& worker)> EventFunction;
+
+  /// Constructor
+  EventRunner(Sensor* sensor);
+  /// Destructor
+  ~EventRunner() {}
+
+  /// Set the number of threads (default: max. number of OpenMP threads).
+  void SetNumberOfThreads(const unsigned int n);
+  /// Get the number of threads.
+  unsigned int GetNumberOfThreads() const { return m_nThreads; }
+  /// Set the seed from which the seeds of the individual events are derived.
+  void SetSeed(const unsigned long long seed) { m_seed = seed; }
+  /// Set the number of events per thread between two reductions (default: 1).
+  void SetEventsPerBatch(const unsigned int n) {
+    m_eventsPerBatch = n > 0 ? n : 1;
+  }
+
+  /// Set the AvalancheMC object to be copied to each thread.
+  void SetAvalancheMC(AvalancheMC* mc) { m_mc = mc; }
+  /// Set the AvalancheMicroscopic object to be copied to each thread.
+  void SetAvalancheMicroscopic(AvalancheMicroscopic* aval) {
+    m_microscopic = aval;
+  }
+  /// Set the DriftLineRKF object to be copied to each thread.
+  void SetDriftLineRKF(DriftLineRKF* drift) { m_driftLineRKF = drift; }
+  /// Set a function creating a new track for each thread.
+  /// The runner takes ownership of the tracks.
+  void SetTrackFactory(std::function<Track*()> f) { m_trackFactory = f; }
+  /// Set a function to be called once for each thread after its setup.
+  void SetWorkerSetup(std::function<void(Worker&)> f) { m_workerSetup = f; }
+  /// Set a function to be called (sequentially, in the order of the threads)
+  /// for each thread at the end of a batch, before the signals are reduced.
+  void SetBatchFunction(std::function<void(Worker&)> f) { m_batchFunction = f; }
+
+  /// Add a medium to be frozen during the run.
+  void AddMedium(Medium* medium);
+  /// Add a histogram to be filled by the threads (using their copies).
+  void AddHistogram(TH1* histogram);
+
+  /** Collect the end points of the transport engines after each event
+   * (default: off). Only the drift lines of the last call to a transport
+   * method in an event are available. The end points of all events are
+   * stored in the order of the events.
+   */
+  void EnableEndpointCollection(const bool on = true) {
+    m_collectEndpoints = on;
+  }
+  /// Get the end points collected in the last run.
+  const Endpoints& GetEndpoints() const { return m_endpoints; }
+
+  /** Process a given number of events.
+   * The function fcn is called (concurrently) for each event.
+   * It must only modify the worker passed to it.
+   */
+  bool Run(const size_t nEvents, EventFunction fcn);
+
+  /// Switch debugging messages on/off.
+  void EnableDebugging(const bool on = true) { m_debug = on; }
+
+ private:
+  std::string m_className = "EventRunner";
+
+  Sensor* m_sensor = nullptr;
+  unsigned int m_nThreads = 1;
+  unsigned long long m_seed = 0;
+  unsigned int m_eventsPerBatch = 1;
+
+  AvalancheMC* m_mc = nullptr;
+  AvalancheMicroscopic* m_microscopic = nullptr;
+  DriftLineRKF* m_driftLineRKF = nullptr;
+  std::function<Track*()> m_trackFactory;
+  std::function<void(Worker&)> m_workerSetup;
+  std::function<void(Worker&)> m_batchFunction;
+
+  std::vector<Medium*> m_media;
+  std::vector<TH1*> m_histograms;
+  // Histograms of the AvalancheMicroscopic object.
+  std::vector<TH1*> m_engineHistograms;
+
+  bool m_collectEndpoints = false;
+  Endpoints m_endpoints;
+
+  std::vector<std::unique_ptr<Worker> > m_workers;
+
+  bool m_debug = false;
+
+  bool Freeze(std::vector<Component*>& components,
+              std::vector<Medium*>& media);
+  void CreateWorkers();
+  void CollectEndpoints(Worker& worker) const;
+  void Reduce(const size_t nEvents);
+};
+}  // namespace Garfield
+
+#endif
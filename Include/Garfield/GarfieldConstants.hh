@@ -43,6 +43,7 @@ static const int StatusSharpKink = -8;
 static const int StatusHitPlane = -11;
 static const int StatusBelowTransportCut = -16;
 static const int StatusOutsideTimeWindow = -17;
+static const int StatusHandedOver = -18;
 static const double Small = 1.e-20;
 
 static const double BoundaryDistance = 1.e-8;
@@ -0,0 +1,134 @@
+#ifndef G_GRID_FILE_H
+#define G_GRID_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Garfield {
+
+/**
+
+\brief Helper class for reading and writing field maps on regular meshes.
+
+Binary files (version 1) consist of a header followed by one array per
+quantity. All numbers are stored in native (little-endian) byte order.
+
+| Offset | Type        | Content                                          |
+|--------|-------------|--------------------------------------------------|
+|      0 | char[8]     | "GGRIDBIN"                                       |
+|      8 | uint32      | version                                          |
+|     12 | uint32      | coordinates (0: Cartesian, 1: cylindrical)       |
+|     16 | uint32[3]   | number of nodes nx, ny, nz                       |
+|     28 | uint32      | content (bit 0: potential, bit 1: region flags)  |
+|     32 | double[6]   | xmin, xmax, ymin, ymax, zmin, zmax               |
+|     80 | double[3]   | scaling factors for coordinates, field, potential|
+|    104 | uint64      | number of nodes n = nx * ny * nz                 |
+|    112 | double[n]   | x (or r) components of the field                 |
+|        | double[n]   | y (or theta) components of the field             |
+|        | double[n]   | z components of the field                        |
+|        | double[n]   | potentials (if bit 0 is set)                     |
+|        | int32[n]    | region flags (if bit 1 is set)                   |
+
+Node (i, j, k) is stored at position (i * ny + j) * nz + k. The scaling
+factors convert the stored values to cm, V/cm and V. Binary files are
+memory-mapped for reading.
+
+Text files are read in blocks, which are split into chunks that are
+converted in parallel (if OpenMP is available). The lines are then passed
+in their original order to a user function.
+
+*/
+
+class GridFile {
+ public:
+  /// Mesh and content of a binary file.
+  struct Header {
+    std::array<uint32_t, 3> n = {{1, 1, 1}};
+    std::array<double, 3> xmin = {{0., 0., 0.}};
+    std::array<double, 3> xmax = {{0., 0., 0.}};
+    bool cylindrical = false;
+    bool withPotential = false;
+    bool withFlag = false;
+    double scaleX = 1.;
+    double scaleF = 1.;
+    double scaleP = 1.;
+  };
+
+  /// Function called for each data line of a text file, with the line
+  /// number, the values and the number of values that could be read.
+  /// Returning false stops the reading.
+  typedef std::function<bool(const size_t, const double*, const unsigned int)>
+      RowFunction;
+  /// Function called for each comment line of a text file.
+  typedef std::function<void(const size_t, const std::string&)>
+      CommentFunction;
+
+  /// Constructor
+  GridFile() = default;
+  GridFile(const GridFile&) = delete;
+  GridFile& operator=(const GridFile&) = delete;
+  /// Destructor
+  ~GridFile() { Close(); }
+
+  /// Map a binary file.
+  bool Open(const std::string& filename);
+  /// Return the mesh and content of the file.
+  const Header& GetHeader() const { return m_header; }
+  /// Return the number of nodes.
+  size_t GetNumberOfNodes() const {
+    return size_t(m_header.n[0]) * m_header.n[1] * m_header.n[2];
+  }
+  /// Get the values of a quantity (0 - 2: field components, 3: potential).
+  const double* GetValues(const unsigned int q) const;
+  /// Get the region flags.
+  const int32_t* GetFlags() const;
+
+  /// Create a binary file with a given header.
+  bool Create(const std::string& filename, const Header& header);
+  /// Write the values of a quantity for the nodes [first, first + n).
+  bool Write(const unsigned int q, const size_t first,
+             const std::vector<double>& values);
+  /// Write the region flags for the nodes [first, first + n).
+  bool Write(const size_t first, const std::vector<int32_t>& flags);
+
+  /// Unmap or close the file.
+  bool Close();
+
+  /** Read a table of white-space separated numbers from a text file.
+   * Empty lines are skipped, as are lines starting with # or //
+   * (which are passed to the comment function, if any).
+   * \param filename name of the text file
+   * \param nColumns number of values to read from each line
+   * \param nIndices number of leading columns to be read as integers
+   * \param row function to be called for each data line
+   * \param comment function to be called for each comment line
+   * \return false if the file could not be opened or the row function
+   *         stopped the reading.
+   */
+  static bool ReadTable(const std::string& filename,
+                        const unsigned int nColumns,
+                        const unsigned int nIndices, RowFunction row,
+                        CommentFunction comment = nullptr);
+
+ private:
+  Header m_header;
+
+  // Mapped (or, as a fallback, buffered) contents of a binary file.
+  const char* m_data = nullptr;
+  size_t m_size = 0;
+  bool m_mapped = false;
+  std::vector<char> m_buffer;
+
+  // Binary file being written.
+  std::fstream m_out;
+
+  size_t GetOffset(const unsigned int q) const;
+};
+}  // namespace Garfield
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef G_INSTRUMENTATION_H
+#define G_INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+
+namespace Garfield {
+
+/** Counters and timers for the hot paths of the library.
+  *
+  * The instrumentation points are compiled in only if the library is
+  * built with the option WITH_INSTRUMENTATION (which defines
+  * GARFIELD_INSTRUMENTATION); otherwise the macros below expand to nothing
+  * and the counters stay at zero. Counters are updated atomically and
+  * can be used from multiple threads.
+  */
+namespace Instrumentation {
+
+enum class Counter : unsigned int {
+  SensorElectricField = 0,
+  SensorMagneticField,
+  SensorWeightingField,
+  SensorWeightingPotential,
+  SensorAddSignal,
+  FieldMapFindElement,
+  FieldMapCandidates,
+  FieldMapNotFound,
+  NewtonSolves,
+  NewtonIterations,
+  NewtonFailures,
+  TcadFindElement,
+  TcadWalkHits,
+  TcadCandidates,
+  ElectronVelocity,
+  ElectronCollision,
+  FreeFlights,
+  NullCollisions,
+  NumberOfCounters
+};
+
+enum class Timer : unsigned int {
+  CrossSectionTables = 0,
+  TcadInitialise,
+  NeBemInitialise,
+  TrackHeed,
+  DriftLineMC,
+  DriftLineRKF,
+  MicroscopicTransport,
+  SignalConvolution,
+  NumberOfTimers
+};
+
+constexpr size_t nCounters = static_cast<size_t>(Counter::NumberOfCounters);
+constexpr size_t nTimers = static_cast<size_t>(Timer::NumberOfTimers);
+
+extern std::array<std::atomic<unsigned long long>, nCounters> counters;
+extern std::array<std::atomic<unsigned long long>, nTimers> timerCalls;
+extern std::array<std::atomic<unsigned long long>, nTimers> timerNanoseconds;
+
+/// Return true if the library was built with instrumentation.
+bool Enabled();
+/// Set all counters and timers to zero.
+void Reset();
+/// Return the current value of a counter.
+unsigned long long Get(const Counter c);
+/// Return the accumulated time [s] of a timer.
+double GetTime(const Timer t);
+/// Return the counters, derived ratios and timers as a JSON object.
+std::string Json();
+/// Write the counters and timers to a JSON file.
+bool WriteJson(const std::string& filename);
+/// Print the counters and timers.
+void Print();
+
+inline void Count(const Counter c, const unsigned long long n = 1) {
+  counters[static_cast<size_t>(c)].fetch_add(n, std::memory_order_relaxed);
+}
+
+/// Accumulate the time spent in a scope.
+class ScopedTimer {
+ public:
+  ScopedTimer(const Timer t)
+      : m_timer(static_cast<size_t>(t)),
+        m_start(std::chrono::steady_clock::now()) {}
+  ~ScopedTimer() {
+    const auto dt = std::chrono::steady_clock::now() - m_start;
+    const auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(dt).count();
+    timerCalls[m_timer].fetch_add(1, std::memory_order_relaxed);
+    timerNanoseconds[m_timer].fetch_add(ns, std::memory_order_relaxed);
+  }
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+ private:
+  size_t m_timer;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace Instrumentation
+}  // namespace Garfield
+
+#ifdef GARFIELD_INSTRUMENTATION
+#define GARFIELD_COUNT(c) \
+  Garfield::Instrumentation::Count(Garfield::Instrumentation::Counter::c)
+#define GARFIELD_COUNT_N(c, n) \
+  Garfield::Instrumentation::Count(Garfield::Instrumentation::Counter::c, (n))
+#define GARFIELD_TIME(t)                                       \
+  Garfield::Instrumentation::ScopedTimer garfieldScopedTimer_( \
+      Garfield::Instrumentation::Timer::t)
+#else
+#define GARFIELD_COUNT(c) \
+  do {                    \
+  } while (0)
+#define GARFIELD_COUNT_N(c, n) \
+  do {                         \
+  } while (0)
+#define GARFIELD_TIME(t) \
+  do {                   \
+  } while (0)
+#endif
+
+#endif
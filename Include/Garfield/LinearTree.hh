@@ -0,0 +1,108 @@
+#ifndef G_LINEAR_TREE_H
+#define G_LINEAR_TREE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Garfield {
+
+/**
+
+\brief Helper class for searches in field maps.
+
+Pointer-free quadtree (2D) or octree (3D) of the mesh nodes. The cells
+are subdivided until they contain at most a given number of mesh nodes.
+The tree is stored as a flat array of cells, the children of a cell
+being stored contiguously in Morton (z-curve) order. The indices of the
+elements overlapping with each leaf cell are stored in a single
+contiguous array, with an offset table per leaf.
+
+*/
+
+class LinearTree {
+ public:
+  /// Range of element indices in a leaf cell.
+  class Span {
+   public:
+    Span() = default;
+    Span(const int* first, const int* last) : m_first(first), m_last(last) {}
+    explicit Span(const std::vector<int>& v)
+        : m_first(v.data()), m_last(v.data() + v.size()) {}
+    const int* begin() const { return m_first; }
+    const int* end() const { return m_last; }
+    size_t size() const { return m_last - m_first; }
+    bool empty() const { return m_first == m_last; }
+
+   private:
+    const int* m_first = nullptr;
+    const int* m_last = nullptr;
+  };
+
+  /// Constructor (dimension 2: quadtree, 3: octree).
+  explicit LinearTree(const unsigned int dim = 3);
+  /// Destructor
+  ~LinearTree() {}
+
+  /// Set the max. number of mesh nodes in a leaf cell (default: 10).
+  void SetLeafSize(const unsigned int n) { m_leafSize = n > 0 ? n : 1; }
+
+  /** Build the tree.
+   * \param xmin,xmax corners of the box to be covered by the tree
+   * \param points coordinates of the mesh nodes
+   * \param bbMin,bbMax lower and upper corners of the element bounding boxes
+   */
+  bool Build(const std::array<double, 3>& xmin,
+             const std::array<double, 3>& xmax,
+             const std::vector<std::array<double, 3> >& points,
+             const std::vector<std::array<double, 3> >& bbMin,
+             const std::vector<std::array<double, 3> >& bbMax);
+
+  /// Get the elements overlapping with the leaf cell containing a point.
+  Span GetElementsInBlock(const double x, const double y,
+                          const double z = 0.) const;
+
+  /// Get all elements linked to cells intersected by the plane
+  /// fx * x + fy * y + fz * z = d. Elements can appear more than once.
+  void GetElementsInPlane(const double fx, const double fy, const double fz,
+                          const double d, std::vector<int>& elems) const;
+
+  /// Return the number of cells in the tree.
+  size_t GetNumberOfCells() const { return m_cells.size(); }
+  /// Return the number of leaf cells in the tree.
+  size_t GetNumberOfLeaves() const {
+    return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+  }
+  /// Return the memory [bytes] occupied by the tree.
+  size_t GetMemoryUsage() const;
+
+ private:
+  unsigned int m_dim = 3;
+  // Number of children per cell.
+  unsigned int m_nChildren = 8;
+  // Max. depth of the tree.
+  unsigned int m_maxDepth = 21;
+  unsigned int m_leafSize = 10;
+
+  // Lower corner and size of the root cell.
+  std::array<double, 3> m_xmin = {{0., 0., 0.}};
+  std::array<double, 3> m_size = {{0., 0., 0.}};
+  // Conversion factors to grid units at the max. depth.
+  std::array<double, 3> m_scale = {{0., 0., 0.}};
+
+  // Index of the first child of a cell or, if negative, -(leaf index + 1).
+  std::vector<int> m_cells;
+  // Element lists of the leaf cells.
+  std::vector<size_t> m_offsets;
+  std::vector<int> m_elements;
+
+  std::array<uint32_t, 3> Quantise(const std::array<double, 3>& x) const;
+  uint64_t Encode(const std::array<uint32_t, 3>& ix) const;
+  template <typename F>
+  void VisitLeaves(const std::array<uint32_t, 3>& lo,
+                   const std::array<uint32_t, 3>& hi, F f) const;
+};
+}  // namespace Garfield
+
+#endif
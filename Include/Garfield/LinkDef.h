@@ -11,6 +11,7 @@
 
 #pragma link C++ class Garfield::AvalancheMicroscopic;
 #pragma link C++ class Garfield::AvalancheMC;
+#pragma link C++ class Garfield::AvalancheHybrid;
 #pragma link C++ class Garfield::DriftLineRKF;
 
 #pragma link C++ class Garfield::Medium;
@@ -50,11 +51,13 @@
 #pragma link C++ class Garfield::ComponentNeBem2d;
 #pragma link C++ class Garfield::ComponentNeBem3d;
 #pragma link C++ class Garfield::ComponentParallelPlate;
+#pragma link C++ class Garfield::ComponentSpaceCharge;
 #pragma link C++ class Garfield::ComponentTcad2d;
 #pragma link C++ class Garfield::ComponentTcad3d;
 #pragma link C++ class Garfield::ComponentUser;
 
 #pragma link C++ class Garfield::Sensor;
+#pragma link C++ class Garfield::EventRunner;
 
 #pragma link C++ class Garfield::ViewCell;
 #pragma link C++ class Garfield::ViewDrift;
@@ -71,8 +74,16 @@
 #pragma link C++ class Garfield::TrackBichsel;
 
 #pragma link C++ function Garfield::RndmUniform();
+#pragma link C++ function Garfield::SetThreadRandomEngine;
 #pragma link C++ function Garfield::SetDefaultStyle();
 #pragma link C++ function Garfield::SetSerif();
 #pragma link C++ function Garfield::SetSansSerif();
 
+#pragma link C++ namespace Garfield::Instrumentation;
+#pragma link C++ function Garfield::Instrumentation::Enabled();
+#pragma link C++ function Garfield::Instrumentation::Reset();
+#pragma link C++ function Garfield::Instrumentation::Json();
+#pragma link C++ function Garfield::Instrumentation::WriteJson(const std::string&);
+#pragma link C++ function Garfield::Instrumentation::Print();
+
 #endif
@@ -1,6 +1,8 @@
 #ifndef G_MEDIUM_H
 #define G_MEDIUM_H
 
+#include <cmath>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -31,6 +33,24 @@ class Medium {
   /// Is this medium a conductor?
   virtual bool IsConductor() const { return false; }
 
+  /** Compute the tables which would otherwise be set up on first use
+   * (e.g. transport parameters or collision rates).
+   * \return false if the medium cannot be used.
+   */
+  virtual bool Prepare() { return true; }
+  /** Prepare the medium and switch to read-only mode. While frozen,
+   * transport and collision queries leave the medium unchanged and can
+   * be made concurrently from several threads. Modifying the medium
+   * ends the read-only mode.
+   */
+  bool Freeze();
+  /// Leave read-only mode.
+  void Unfreeze() { m_frozen = false; }
+  /// Is the medium in read-only mode?
+  bool IsFrozen() const { return m_frozen; }
+  /// Report modifications of the medium while it is frozen.
+  void EnableFreezeCheck(const bool on = true) { m_checkFrozen = on; }
+
   /// Set the temperature [K].
   void SetTemperature(const double t);
   /// Get the temperature [K].
@@ -148,6 +168,16 @@ class Medium {
 
   /// Null-collision rate [ns-1]
   virtual double GetElectronNullCollisionRate(const int band = 0);
+  /** Null-collision rate [ns-1] valid within the energy window
+    * containing a given electron energy.
+    * \param e electron energy [eV]
+    * \param band band index
+    * \param emin,emax boundaries [eV] of the energy window
+    */
+  virtual double GetElectronNullCollisionRateWindow(const double e, 
+                                                    const int band,
+                                                    double& emin,
+                                                    double& emax);
   /// Collision rate [ns-1] for given electron energy
   virtual double GetElectronCollisionRate(const double e, const int band = 0);
   /// Sample the collision type. Update energy and direction vector.
@@ -521,6 +551,14 @@ class Medium {
                                   double& e1, double& ctheta, int& nsec,
                                   double& esec);
 
+  /** Tabulate the field dependence of the analytic mobility and impact
+    * ionisation models (semiconductors) on a logarithmic grid in |E|
+    * instead of evaluating them at each call.
+    * \param on flag to switch the tables on or off
+    * \param tol tolerance on the relative interpolation error
+    */
+  void EnableFieldTables(const bool on = true, const double tol = 1.e-4);
+
   /// Switch on/off debugging  messages
   void EnableDebugging() { m_debug = true; }
   void DisableDebugging() { m_debug = false; }
@@ -562,6 +600,11 @@ class Medium {
   // Update flag
   bool m_isChanged = true;
 
+  // Read-only mode
+  bool m_frozen = false;
+  // Report modifications in read-only mode?
+  bool m_checkFrozen = false;
+
   // Switch on/off debugging messages
   bool m_debug = false;
 
@@ -629,6 +672,29 @@ class Medium {
   unsigned int m_intpMob = 2;
   unsigned int m_intpDis = 2;
 
+  // Table of a function of the electric field magnitude, 
+  // with nodes equally spaced in log |E|.
+  struct FieldTable {
+    double eMin = 0.;
+    double eMax = 0.;
+    double lnMin = 0.;
+    // Number of intervals per unit of log |E|
+    double scale = 0.;
+    std::vector<double> values;
+    // Intervals containing a discontinuity of the function
+    std::vector<size_t> gaps;
+  };
+  // Use tables for the field dependence of the analytic models?
+  bool m_useFieldTables = false;
+  // Tolerance on the relative interpolation error
+  double m_fieldTableTol = 1.e-4;
+
+  // Leave read-only mode (and report it, if requested) on modification.
+  void CheckFrozen(const std::string& fcn);
+  // Can pending changes be applied in the query function fcn? Not while
+  // the medium is frozen; the existing tables are used instead.
+  bool UpdateAllowed(const std::string& fcn) const;
+
   bool Velocity(const double ex, const double ey, const double ez,
                 const double bx, const double by, const double bz,
                 const std::vector<std::vector<std::vector<double> > >& velE,
@@ -665,6 +731,30 @@ class Medium {
                    double& y, const unsigned int intp,
                    const std::pair<unsigned int, unsigned int>& extr) const;
 
+  /// Set up a table of f(|E|), refining the grid until the 
+  /// interpolation error is below m_fieldTableTol. Fields at which
+  /// f is discontinuous can be specified in breaks.
+  void FillFieldTable(const std::function<double(double)>& f,
+                      FieldTable& tab,
+                      const std::vector<double>& breaks = {}) const;
+  /// Interpolate in a field table. Returns false if the table is empty, 
+  /// or if |E| is outside its range or next to a discontinuity.
+  static bool LookupFieldTable(const FieldTable& tab, const double emag,
+                               double& f) {
+    if (tab.values.empty() || !(emag > tab.eMin && emag < tab.eMax)) {
+      return false;
+    }
+    const double u = (std::log(emag) - tab.lnMin) * tab.scale;
+    size_t i = static_cast<size_t>(u);
+    if (i + 1 >= tab.values.size()) i = tab.values.size() - 2;
+    for (const auto gap : tab.gaps) {
+      if (gap == i) return false;
+    }
+    const double w = u - i;
+    f = tab.values[i] + w * (tab.values[i + 1] - tab.values[i]);
+    return true;
+  }
+
   double Interpolate1D(const double e, const std::vector<double>& table,
                        const std::vector<double>& fields,
                        const unsigned int intpMeth,
@@ -15,6 +15,8 @@ class MediumCdTe : public Medium {
   virtual ~MediumCdTe() {}
 
   bool IsSemiconductor() const override { return true; }
+  /// Compute the transport parameters.
+  bool Prepare() override;
 
   void GetComponent(const unsigned int i, std::string& label, 
                     double& f) override;
@@ -17,6 +17,8 @@ class MediumDiamond : public Medium {
   virtual ~MediumDiamond() {}
 
   bool IsSemiconductor() const override { return true; }
+  /// Compute the transport parameters.
+  bool Prepare() override;
 
   void GetComponent(const unsigned int i, std::string& label, 
                     double& f) override;
@@ -15,6 +15,8 @@ class MediumGaAs : public Medium {
   virtual ~MediumGaAs() {}
 
   bool IsSemiconductor() const override { return true; }
+  /// Compute the transport parameters.
+  bool Prepare() override;
 
   void GetComponent(const unsigned int i, std::string& label, 
                     double& f) override;
@@ -63,8 +65,18 @@ class MediumGaAs : public Medium {
   double m_eImpactB = 5.75e5;
   double m_hImpactB = 6.57e5;
 
+  // Tables of the field-dependent mobility and impact ionisation
+  FieldTable m_eMobilityTable;
+  FieldTable m_hMobilityTable;
+  FieldTable m_eAlphaTable;
+  FieldTable m_hAlphaTable;
+
   bool m_userMobility = false;
   void UpdateTransportParameters();
+  double ElectronMobility(const double emag) const;
+  double ElectronAlpha(const double emag) const;
+  double HoleMobility(const double emag) const;
+  double HoleAlpha(const double emag) const;
 };
 }
 
@@ -15,6 +15,8 @@ class MediumGaN : public Medium {
   virtual ~MediumGaN() {}
 
   bool IsSemiconductor() const override { return true; }
+  /// Compute the transport parameters.
+  bool Prepare() override;
 
   void GetComponent(const unsigned int i, std::string& label, 
                     double& f) override;
@@ -71,7 +73,21 @@ class MediumGaN : public Medium {
   double m_hImpactB = 1.46e7;
 
   bool m_userMobility = false;
+  // Tables of the field-dependent mobility and impact ionisation
+  FieldTable m_eMobilityTable;
+  FieldTable m_hMobilityTable;
+  FieldTable m_eAlphaTable;
+  FieldTable m_hAlphaTable;
+
   void UpdateTransportParameters();
+  double ElectronMobility(const double emag) const;
+  double HoleMobility(const double emag) const;
+  double ElectronAlpha(const double emag) const {
+    return emag > Small ? m_eImpactA * exp(-m_eImpactB / emag) : 0.;
+  }
+  double HoleAlpha(const double emag) const {
+    return emag > Small ? m_hImpactA * exp(-m_hImpactB / emag) : 0.;
+  }
 };
 }
 
@@ -38,8 +38,15 @@ class MediumMagboltz : public MediumGas {
   /// Get the highest photon energy in the table of scattering rates.
   double GetMaxPhotonEnergy() const { return m_eFinalGamma; }
 
+  /** Compute the table of scattering rates. The energy range has to be
+   * set beforehand; in read-only mode (see Medium::Freeze) the table is
+   * not extended and the rates of the last bin are used above the range.
+   */
+  bool Prepare() override { return Update(); }
+
   /// Switch on/off anisotropic scattering (enabled by default)
   void EnableAnisotropicScattering(const bool on = true) {
+    CheckFrozen("EnableAnisotropicScattering");
     m_useAnisotropic = on;
     m_isChanged = true;
   }
@@ -54,11 +61,27 @@ class MediumMagboltz : public MediumGas {
   /// Switch on (microscopic) de-excitation handling.
   void EnableDeexcitation();
   /// Switch off (microscopic) de-excitation handling.
-  void DisableDeexcitation() { m_useDeexcitation = false; }
+  void DisableDeexcitation() {
+    CheckFrozen("DisableDeexcitation");
+    m_useDeexcitation = false;
+  }
   /// Switch on discrete photoabsorption levels.
   void EnableRadiationTrapping();
   /// Switch off discrete photoabsorption levels.
-  void DisableRadiationTrapping() { m_useRadTrap = false; }
+  void DisableRadiationTrapping() {
+    CheckFrozen("DisableRadiationTrapping");
+    m_useRadTrap = false;
+  }
+  /** Sample the complete de-excitation cascade of a level (sequence of
+    * transitions and products) in one draw from precomputed tables,
+    * instead of transition by transition. The cascades are only
+    * enumerated if this option and de-excitation handling are switched on.
+    */
+  void EnableDeexcitationCascades(const bool on = true) {
+    CheckFrozen("EnableDeexcitationCascades");
+    if (on && !m_useDxcCascades && m_useDeexcitation) m_isChanged = true;
+    m_useDxcCascades = on;
+  }
 
   bool EnablePenningTransfer() override;
   bool EnablePenningTransfer(const double r, const double lambda) override;
@@ -82,6 +105,10 @@ class MediumMagboltz : public MediumGas {
 
   /// Get the overall null-collision rate [ns-1].
   double GetElectronNullCollisionRate(const int band) override;
+  /// Get the null-collision rate [ns-1] in the energy window around e [eV].
+  double GetElectronNullCollisionRateWindow(const double e, const int band,
+                                            double& emin, 
+                                            double& emax) override;
   /// Get the (real) collision rate [ns-1] at a given electron energy e [eV].
   double GetElectronCollisionRate(const double e, const int band) override;
   /// Get the collision rate [ns-1] for a specific level.
@@ -182,6 +209,10 @@ class MediumMagboltz : public MediumGas {
   static int GetGasNumberMagboltz(const std::string& input);
  private:
   static constexpr int nEnergyStepsLog = 1000;
+  /// Number of energy windows for the null-collision frequency
+  /// in the linear and logarithmic parts of the collision rate tables.
+  static constexpr unsigned int nNullWindows = 64;
+  static constexpr unsigned int nNullWindowsLog = 20;
   static constexpr int nEnergyStepsGamma = 5000;
   static constexpr int nCsTypes = 7;
   static constexpr int nCsTypesGamma = 4;
@@ -257,6 +288,10 @@ class MediumMagboltz : public MediumGas {
   std::vector<double> m_cfTotLog;
   /// Null-collision frequency
   double m_cfNull = 0.;
+  /// Upper edges of the energy windows for the null-collision frequency.
+  std::vector<double> m_eNullWindow;
+  /// Null-collision frequency in each energy window.
+  std::vector<double> m_cfNullWindow;
   // Collision frequencies
   std::vector<std::vector<double> > m_cf;
   std::vector<std::vector<double> > m_cfLog;
@@ -332,6 +367,37 @@ class MediumMagboltz : public MediumGas {
   };
   std::vector<dxcProd> m_dxcProducts;
 
+  // Tables for sampling the de-excitation channels (alias method),
+  // entries m_dxcOffset[i] to m_dxcOffset[i + 1] belong to level i.
+  std::vector<unsigned int> m_dxcOffset;
+  std::vector<double> m_dxcProb;
+  std::vector<unsigned int> m_dxcAlias;
+  // Inverse cumulative distributions of the line shape (Voigt profile)
+  // for radiative decays to the ground state.
+  static constexpr unsigned int nDxcLineShape = 256;
+  std::vector<double> m_dxcLineShape;
+
+  // Sample complete de-excitation cascades?
+  bool m_useDxcCascades = false;
+  // Max. number of transitions in a tabulated cascade
+  static constexpr unsigned int nMaxDxcSteps = 64;
+  struct DxcCascade {
+    // Levels decaying along the cascade
+    std::vector<int> levels;
+    // Products (t holds the index of the step in which they are emitted)
+    std::vector<dxcProd> products;
+    // Line shape to be applied to the last product (-1 if none)
+    int line;
+    // Final level
+    int final;
+  };
+  std::vector<DxcCascade> m_dxcCascades;
+  // Tables for sampling the cascades of a level (alias method),
+  // entries m_dxcCascadeOffset[i] to m_dxcCascadeOffset[i + 1].
+  std::vector<unsigned int> m_dxcCascadeOffset;
+  std::vector<double> m_dxcCascadeProb;
+  std::vector<unsigned int> m_dxcCascadeAlias;
+
   /// Ionisation potentials of each component
   std::array<double, m_nMaxGases> m_ionPot;
   /// Minimum ionisation potential
@@ -380,6 +446,13 @@ class MediumMagboltz : public MediumGas {
   double RateConstantHardSphere(const double r1, const double r2,
                                 const int igas1, const int igas2) const;
   void ComputeDeexcitationInternal(int iLevel, int& fLevel);
+  void ComputeDeexcitationSamplingTables();
+  bool ListDeexcitationCascades(const int iLevel, const double p,
+                                DxcCascade& cascade,
+                                std::vector<DxcCascade>& cascades,
+                                std::vector<double>& weights) const;
+  bool SampleDeexcitationCascade(const int iLevel, int& fLevel);
+  double SampleDeexcitationLineShape(const int iLevel) const;
   bool ComputePhotonCollisionTable(const bool verbose);
 };
 }
@@ -18,6 +18,8 @@ class MediumSilicon : public Medium {
   virtual ~MediumSilicon() {}
 
   bool IsSemiconductor() const override { return true; }
+  /// Compute the transport parameters.
+  bool Prepare() override;
 
   /// Set doping concentration [cm-3] and type ('i', 'n', 'p').
   void SetDoping(const char type, const double c);
@@ -122,6 +124,10 @@ class MediumSilicon : public Medium {
 
   // Get the null-collision rate [ns-1]
   double GetElectronNullCollisionRate(const int band) override;
+  // Get the null-collision rate [ns-1] in the energy window containing e
+  double GetElectronNullCollisionRateWindow(const double e, const int band,
+                                            double& emin,
+                                            double& emax) override;
   // Get the (real) collision rate [ns-1] at a given electron energy
   double GetElectronCollisionRate(const double e, const int band) override;
   // Sample the collision type
@@ -219,6 +225,12 @@ class MediumSilicon : public Medium {
   double m_hImpactB0 = 2.036e6;
   double m_hImpactB1 = 1.693e6;
 
+  // Tables of the field-dependent mobility and impact ionisation
+  FieldTable m_eMobilityTable;
+  FieldTable m_hMobilityTable;
+  FieldTable m_eAlphaTable;
+  FieldTable m_hAlphaTable;
+
   // Models
   bool m_hasUserMobility = false;
   bool m_hasUserSaturationVelocity = false;
@@ -244,6 +256,8 @@ class MediumSilicon : public Medium {
   static const int nEnergyStepsXL = 2000;
   static const int nEnergyStepsG = 2000;
   static const int nEnergyStepsV = 2000;
+  // Number of energy steps per null-collision rate window
+  static const int nStepsNullWindow = 40;
 
   // Number of scattering terms
   int m_nLevelsX = 0;
@@ -266,6 +280,8 @@ class MediumSilicon : public Medium {
   std::vector<double> m_cfTotElectronsX;
   std::vector<double> m_cfTotElectronsL;
   std::vector<double> m_cfTotElectronsG;
+  // Scattering rates of the individual processes (only kept while
+  // the tables are being filled)
   std::vector<std::vector<double> > m_cfElectronsX;
   std::vector<std::vector<double> > m_cfElectronsL;
   std::vector<std::vector<double> > m_cfElectronsG;
@@ -285,6 +301,29 @@ class MediumSilicon : public Medium {
   // Cross-section type
   std::vector<int> m_scatTypeHoles;
 
+  /// Flat (energy-major) table for sampling the scattering process
+  /// at a given energy step with the alias method.
+  struct AliasTable {
+    unsigned int nLevels = 0;
+    std::vector<double> prob;
+    std::vector<unsigned int> alias;
+    /// Sample a level at energy step iE using a random number in [0, 1).
+    unsigned int Sample(const int iE, const double r) const {
+      const double u = r * nLevels;
+      unsigned int j = static_cast<unsigned int>(u);
+      if (j >= nLevels) j = nLevels - 1;
+      const size_t k = iE * nLevels + j;
+      return u - j < prob[k] ? j : alias[k];
+    }
+  };
+  AliasTable m_aliasElectronsX;
+  AliasTable m_aliasElectronsL;
+  AliasTable m_aliasElectronsG;
+  // Null-collision rates in windows of nStepsNullWindow energy steps
+  std::vector<double> m_cfNullWindowElectronsX;
+  std::vector<double> m_cfNullWindowElectronsL;
+  std::vector<double> m_cfNullWindowElectronsG;
+
   // Collision counters
   unsigned int m_nCollElectronAcoustic = 0;
   unsigned int m_nCollElectronOptical = 0;
@@ -317,6 +356,7 @@ class MediumSilicon : public Medium {
 
   void UpdateImpactIonisation();
 
+  void UpdateFieldTables();
   double ElectronMobility(const double e) const;
   double ElectronAlpha(const double e) const;
 
@@ -337,6 +377,11 @@ class MediumSilicon : public Medium {
   bool ElectronImpurityScatteringRates();
 
   bool HoleScatteringRates();
+  static void SetupAliasTable(const std::vector<std::vector<double> >& cf,
+                              const std::vector<double>& cfTot,
+                              const int nLevels, AliasTable& table);
+  static void SetupNullWindows(const std::vector<double>& cfTot,
+                               const int iMin, std::vector<double>& cfNull);
   bool HoleAcousticScatteringRates();
   bool HoleOpticalScatteringRates();
   bool HoleIonisationRates();
@@ -10,8 +10,34 @@ namespace Garfield {
 /// Random number generator
 extern RandomEngineRoot randomEngine;
 
+/// Random number generator of a thread and second variate of the last
+/// Box-Muller pair drawn by RndmGaussian in the thread.
+struct ThreadRandomState {
+  RandomEngine* engine = nullptr;
+  bool gaussianCached = false;
+  double gaussianValue = 0.;
+};
+// With __thread (static initialisation only, no guard call) and the
+// initial-exec model, an access is a single load relative to the thread
+// pointer, which keeps the inline draws below as cheap as a global.
+#if defined(__GNUC__) || defined(__clang__)
+extern __thread ThreadRandomState threadRandomState
+    __attribute__((tls_model("initial-exec")));
+#else
+extern thread_local ThreadRandomState threadRandomState;
+#endif
+
+/** Set the random number generator used by the calling thread
+ * (null pointer: randomEngine). Any Gaussian variate cached by
+ * RndmGaussian is discarded.
+ */
+void SetThreadRandomEngine(RandomEngine* engine);
+
 /// Draw a random number uniformly distributed in the range [0, 1).
-inline double RndmUniform() { return randomEngine.Draw(); }
+inline double RndmUniform() {
+  RandomEngine* engine = threadRandomState.engine;
+  return engine ? engine->Draw() : randomEngine.Draw();
+}
 
 /// Draw a random number uniformly distributed in the range (0, 1).
 inline double RndmUniformPos() {
@@ -22,24 +48,27 @@ inline double RndmUniformPos() {
 
 /// Draw a Gaussian random variate with mean zero and standard deviation one.
 inline double RndmGaussian() {
-  static bool cached = false;
-  static double u = 0.;
-  if (cached) {
-    cached = false;
-    return u;
+  ThreadRandomState& state = threadRandomState;
+  if (state.gaussianCached) {
+    state.gaussianCached = false;
+    return state.gaussianValue;
   }
   // Box-Muller algorithm
-  u = 2. * RndmUniform() - 1.;
-  double v = 2. * RndmUniform() - 1.;
+  RandomEngine* engine = state.engine;
+  auto draw = [engine]() {
+    return engine ? engine->Draw() : randomEngine.Draw();
+  };
+  double u = 2. * draw() - 1.;
+  double v = 2. * draw() - 1.;
   double r2 = u * u + v * v;
   while (r2 > 1.) {
-    u = 2. * RndmUniform() - 1.;
-    v = 2. * RndmUniform() - 1.;
+    u = 2. * draw() - 1.;
+    v = 2. * draw() - 1.;
     r2 = u * u + v * v;
   }
   const double p = sqrt(-2. * log(r2) / r2);
-  u *= p;
-  cached = true;
+  state.gaussianValue = u * p;
+  state.gaussianCached = true;
   return v * p;
 }
 
@@ -19,6 +19,8 @@ class RandomEngineRoot : public RandomEngine {
   double Draw() override { return m_rng.Rndm(); }
   /// Initialise the random number generator.
   void Seed(const unsigned int s) override;
+  /// Initialise the random number generator without printing the seed.
+  void SetSeed(const unsigned int s) { m_rng.SetSeed(s); }
   /// Print information about the generator used and the seed. 
   void Print() override;
 
@@ -1,6 +1,8 @@
 #ifndef G_SENSOR_H
 #define G_SENSOR_H
 
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <functional>
 #include <mutex>
@@ -35,7 +37,35 @@ class Sensor {
   /// Activate/deactivate use of the magnetic field of a given component.
   void EnableMagneticField(const unsigned int i, const bool on);
   /// Does the sensor have a non-zero magnetic field?
-  bool HasMagneticField() const;
+  bool HasMagneticField();
+
+  /// Does any of the active components have velocity maps?
+  bool HasVelocityMap();
+  /// Does any of the active components have attachment maps?
+  bool HasAttachmentMap();
+  /// Does any of the active components have Townsend coefficient maps?
+  bool HasTownsendMap();
+  /** Get the electron drift velocity at (x, y, z) from the velocity map of
+   * the first active component covering the point.
+   * \return false if none of the velocity maps provides a value.
+   */
+  bool ElectronVelocity(const double x, const double y, const double z,
+                        double& vx, double& vy, double& vz);
+  /// Get the hole drift velocity at (x, y, z) from a velocity map.
+  bool HoleVelocity(const double x, const double y, const double z,
+                    double& vx, double& vy, double& vz);
+  /// Get the electron attachment coefficient at (x, y, z) from a map.
+  bool ElectronAttachment(const double x, const double y, const double z,
+                          double& eta);
+  /// Get the hole attachment coefficient at (x, y, z) from a map.
+  bool HoleAttachment(const double x, const double y, const double z,
+                      double& eta);
+  /// Get the electron Townsend coefficient at (x, y, z) from a map.
+  bool ElectronTownsend(const double x, const double y, const double z,
+                        double& alpha);
+  /// Get the hole Townsend coefficient at (x, y, z) from a map.
+  bool HoleTownsend(const double x, const double y, const double z,
+                    double& alpha);
 
   /// Add an electrode.
   void AddElectrode(Component* comp, const std::string& label);
@@ -43,6 +73,11 @@ class Sensor {
   size_t GetNumberOfElectrodes() const { return m_electrodes.size(); }
   /// Remove all components, electrodes and reset the sensor.
   void Clear();
+  /** Copy the components, electrodes, time window and user area of another
+   * sensor (e. g. for use in a worker thread). The signals are not copied,
+   * the transfer function and noise settings are left unchanged.
+   */
+  void CopySettings(const Sensor& other);
 
   /// Get the drift field and potential at (x, y, z).
   void ElectricField(const double x, const double y, const double z, double& ex,
@@ -96,6 +131,11 @@ class Sensor {
   void NewSignal() { ++m_nEvents; }
   /// Reset signals and induced charges of all electrodes.
   void ClearSignal();
+  /** Add the signals, induced charges and event count of another sensor
+   * with the same electrodes and time window (e. g. a worker sensor
+   * set up using CopySettings).
+   */
+  bool AddSignals(const Sensor& other);
 
   /** Set the time window and binning for the signal calculation.
    * \param tstart start time [ns]
@@ -288,6 +328,26 @@ class Sensor {
   /// Components
   std::vector<std::tuple<Component*, bool, bool> > m_components;
 
+  // Active components with a given capability, and their bounding boxes.
+  struct ComponentRegion {
+    Component* comp;
+    std::array<double, 3> xmin;
+    std::array<double, 3> xmax;
+    bool Contains(const double x, const double y, const double z) const {
+      return x >= xmin[0] && x <= xmax[0] && y >= xmin[1] && y <= xmax[1] &&
+             z >= xmin[2] && z <= xmax[2];
+    }
+  };
+  std::vector<ComponentRegion> m_velocityMaps;
+  std::vector<ComponentRegion> m_attachmentMaps;
+  std::vector<ComponentRegion> m_townsendMaps;
+  // Active components contributing to the magnetic field.
+  std::vector<Component*> m_magneticComponents;
+  // Do the component lists need to be rebuilt?
+  std::atomic<bool> m_componentsChanged{true};
+  // Revisions of the components when the lists were last built.
+  std::vector<unsigned int> m_componentRevisions;
+
   struct Electrode {
     Component* comp;
     std::string label;
@@ -336,10 +396,26 @@ class Sensor {
   // Switch on/off debugging messages
   bool m_debug = false;
 
+  // Have components been added, switched on/off or modified since the
+  // component lists were last built?
+  bool ComponentListsOutdated() const;
+  // Sort the active components by capability.
+  void UpdateComponentLists();
+  template <typename F>
+  bool FromMap(const std::vector<ComponentRegion>& maps, const double x,
+               const double y, const double z, F f);
+
   // Return the current sensor size
   bool GetBoundingBox(double& xmin, double& ymin, double& zmin, double& xmax,
                       double& ymax, double& zmax);
 
+  // Integrate the delayed weighting field over a drift line segment
+  // for each of the delayed signal times.
+  void DelayedCurrents(const Electrode& electrode, const double q,
+                       const double dt, const std::array<double, 3>& x0,
+                       const std::array<double, 3>& x1,
+                       const std::array<double, 3>& v, 
+                       std::vector<double>& id);
   void FillSignal(Electrode& electrode, const double q,
                   const std::vector<double>& ts, const std::vector<double>& is,
                   const int navg, const bool delayed = false);
@@ -1,9 +1,11 @@
 #ifndef G_VIEW_FE_MESH
 #define G_VIEW_FE_MESH
 
+#include <array>
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
 
 #include <TArrayD.h>
 #include <TGaxis.h>
@@ -111,6 +113,9 @@ class ViewFEMesh : public ViewBase {
   std::vector<TGeoMedium*> m_media;
   std::unique_ptr<TGeoManager> m_geoManager;
 
+  // Polygon in planar coordinates.
+  using Polygon = std::vector<std::array<double, 2> >;
+
   // Element plotting methods
   void DrawElements2d();
   void DrawElements3d();
@@ -132,6 +137,9 @@ class ViewFEMesh : public ViewBase {
   bool OnLine(double x1, double y1, double x2, double y2, double u,
               double v) const;
   void RemoveCrossings(std::vector<double>& x, std::vector<double>& y);
+  /// Merge the edges shared between polygons and chain them to polylines.
+  void MergeEdges(const std::vector<Polygon>& polygons,
+                  std::vector<std::vector<std::array<double, 2> > >& lines) const;
   bool PlaneCut(double x1, double y1, double z1, double x2, double y2,
                 double z2, TMatrixD& xMat);
   void ClipToView(std::vector<double>& px, std::vector<double>& py,
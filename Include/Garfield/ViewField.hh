@@ -1,6 +1,10 @@
 #ifndef G_VIEW_FIELD
 #define G_VIEW_FIELD
 
+#include <array>
+#include <string>
+#include <vector>
+
 #include <Rtypes.h>
 
 #include "ViewBase.hh"
@@ -108,6 +112,17 @@ class ViewField : public ViewBase {
     m_samplePotential = samplePotential; 
   }
 
+  /// Evaluate the field on the plotting grid, compute field lines and 
+  /// integrate fluxes using multiple threads (default: off). 
+  /// The sensor/component must be thread-safe.
+  void EnableParallelSampling(const bool on = true) { m_parallel = on; }
+  /// Keep the field values sampled for a 2D plot and reuse them in 
+  /// subsequent plots of the same quantity and area (default: off).
+  void EnableSampleCache(const bool on = true) {
+    m_useSampleCache = on;
+    if (!on) m_samples.clear();
+  }
+
   /** Make use (or not) of the status flag returned by the sensor/component.
     * \param on Take status flag into account (true) or ignore it (false).
     * \param v0 Value to be used for regions with status != 0.
@@ -153,6 +168,35 @@ class ViewField : public ViewBase {
   bool m_samplePotential = true;
   bool m_useStatus = false;
   double m_vBkg = 0.;
+  bool m_parallel = false;
+  bool m_useSampleCache = false;
+
+  // Settings for which the current 2D samples were computed.
+  struct SampleSettings {
+    const void* source;
+    Parameter par;
+    bool wfield;
+    bool bfield;
+    std::string electrode;
+    double t;
+    std::array<double, 4> area;
+    std::array<std::array<double, 3>, 3> proj;
+    unsigned int nx;
+    unsigned int ny;
+    bool useStatus;
+    double vBkg;
+    bool operator==(const SampleSettings& rhs) const {
+      return source == rhs.source && par == rhs.par && 
+             wfield == rhs.wfield && bfield == rhs.bfield &&
+             electrode == rhs.electrode && t == rhs.t && 
+             area == rhs.area && proj == rhs.proj && 
+             nx == rhs.nx && ny == rhs.ny &&
+             useStatus == rhs.useStatus && vBkg == rhs.vBkg;
+    }
+  };
+  SampleSettings m_sampleSettings;
+  // Field values at the centres of the 2D plotting grid.
+  std::vector<double> m_samples;
 
   // Sensor
   Sensor* m_sensor = nullptr;
@@ -172,6 +216,24 @@ class ViewField : public ViewBase {
   unsigned int m_nSamples2dY = 200;
 
   bool SetPlotLimits();
+  const std::vector<double>& Sample2d(const Parameter par, const bool wfield,
+                                      const bool bfield, 
+                                      const std::string& electrode,
+                                      const double t);
+  void Sample1d(const std::vector<std::array<double, 3> >& points, 
+                const Parameter par, const bool wfield, const bool bfield,
+                const std::string& electrode, std::vector<double>& values);
+  void SegmentFluxes(const double x0, const double y0, const double z0,
+                     const double dx, const double dy, const double dz,
+                     const double xp, const double yp, const double zp,
+                     const unsigned int nV, const int isign,
+                     std::vector<double>& q) const;
+  double Evaluate(const double x, const double y, const double z,
+                  const Parameter par, const bool wfield, const bool bfield,
+                  const std::string& electrode, const double t) const {
+    return wfield ? Wfield(x, y, z, par, electrode, t) :
+           bfield ? Bfield(x, y, z, par) : Efield(x, y, z, par);
+  }
   void Draw2d(const std::string& option, const bool contour,
               const bool wfield, const std::string& electrode,
               const std::string& drawopt, const double t = 0.);
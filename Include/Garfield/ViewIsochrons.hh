@@ -63,6 +63,9 @@ class ViewIsochrons : public ViewBase {
   /// Fractional distance over which isochron segments are connected
   /// (default: 0.2).
   void SetConnectionThreshold(const double thr);
+  /// Compute the drift lines using multiple threads (default: off).
+  /// The sensor/component must be thread-safe.
+  void EnableParallelDriftLines(const bool on = true) { m_parallel = on; }
 
  private:
   Sensor* m_sensor = nullptr;
@@ -80,6 +83,7 @@ class ViewIsochrons : public ViewBase {
   double m_loopThreshold = 0.2;
   double m_connectionThreshold = 0.2;
   bool m_checkCrossings = true;
+  bool m_parallel = false;
 
   bool SetPlotLimits();
 
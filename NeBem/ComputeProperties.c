@@ -11,6 +11,7 @@
 #include <omp.h>
 #endif
 
+#include "Ewald.h"
 #include "Isles.h"
 #include "NR.h"
 #include "Vector.h"
@@ -1016,6 +1017,23 @@ int ElePFAtPoint(Point3D *globalP, double *Potential, Vector3D *globalF) {
       plFx[primsrc] = tmpF.X;
       plFy[primsrc] = tmpF.Y;
       plFz[primsrc] = tmpF.Z;
+
+      // Periodic copies that are not summed explicitly (GCS)
+      if (OptEwald && EwaldPeriodicity(primsrc) > 0) {
+        const int eleMin = ElementBgn[primsrc];
+        const int eleMax = ElementEnd[primsrc];
+        for (int ele = eleMin; ele <= eleMax; ++ele) {
+          double ewPot;
+          Vector3D ewF;
+          EwaldElePF(ele, globalP, &ewPot, &ewF);
+          const double qel =
+              (EleArr + ele - 1)->Solution + (EleArr + ele - 1)->Assigned;
+          pPot[primsrc] += qel * ewPot;
+          plFx[primsrc] += qel * ewF.X;
+          plFy[primsrc] += qel * ewF.Y;
+          plFz[primsrc] += qel * ewF.Z;
+        }
+      }
     }  // for all primitives: basic device, mirror reflections and repetitions
   }    // pragma omp parallel
 
@@ -2127,6 +2145,405 @@ int CreateFastVolElePF(void) {
   return 0;
 }  // CreateFastVolElePF ends
 
+// Potential and field due to the charge changes currently stored in the
+// elements, added to one node of a fast volume table.
+static void AddFastVolNode(double ****pot, double ****fx, double ****fy,
+                           double ****fz, int block, int i, int j, int k,
+                           double x, double y, double z, double *dpot,
+                           double *dfield) {
+  Point3D point;
+  point.X = x;
+  point.Y = y;
+  point.Z = z;
+  for (int omit = 1; omit <= FastVol.NbOmitVols; ++omit) {
+    if ((point.X > OmitVolCrnrX[omit]) &&
+        (point.X < OmitVolCrnrX[omit] + OmitVolLX[omit]) &&
+        (point.Y > OmitVolCrnrY[omit]) &&
+        (point.Y < OmitVolCrnrY[omit] + OmitVolLY[omit]) &&
+        (point.Z > OmitVolCrnrZ[omit]) &&
+        (point.Z < OmitVolCrnrZ[omit] + OmitVolLZ[omit])) {
+      *dpot = *dfield = 0.0;
+      return;
+    }
+  }  // loop over omitted volumes
+  double potential = 0.0;
+  Vector3D field;
+  field.X = field.Y = field.Z = 0.0;
+  if (ElePFAtPoint(&point, &potential, &field) != 0) {
+    neBEMMessage("wrong ElePFAtPoint return value in UpdateFastVolPF.\n");
+  }
+  pot[block][i][j][k] += potential;
+  fx[block][i][j][k] += field.X;
+  fy[block][i][j][k] += field.Y;
+  fz[block][i][j][k] += field.Z;
+  *dpot = fabs(potential);
+  *dfield = sqrt(field.X * field.X + field.Y * field.Y + field.Z * field.Z);
+}  // AddFastVolNode ends
+
+// Bookkeeping of the fast volume updates after charging up.
+// The changes of potential and field are computed on a coarse lattice of
+// nodes at every update. The remaining nodes of a coarse cell are only
+// recomputed once the change at its corners, accumulated since the last
+// refresh of the cell, exceeds the tolerance, or after FASTVOL_MAX_LAG
+// updates. They are then brought up to date with the sum of the charge
+// changes since the last refresh, so no increment is lost.
+#define FASTVOL_MAX_LAG 16
+
+typedef struct {
+  // Coarse lattice.
+  int ncx, ncy, ncz;
+  int *cx, *cy, *cz;
+  // Number of coarse cells.
+  int ncells;
+  // Last update included in the nodes inside a cell.
+  int *lastUpdate;
+  // Number of updates to catch up with in the current update (0: none).
+  int *lag;
+  // Accumulated change at the corners since the last refresh.
+  double *accPot;
+  double *accField;
+} FastVolCells;
+
+// Coarse cells of the basic and staggered fast volume (indexed by block).
+static FastVolCells *FastVolCellTab[2] = {NULL, NULL};
+static int FastVolCellBlocks = 0;
+// Number of updates since the fast volume was computed.
+static int NbFastVolUpdates = 0;
+// Charge changes of the most recent updates (ring buffer).
+static double *FastVolDSolution[FASTVOL_MAX_LAG];
+static double *FastVolDAssigned[FASTVOL_MAX_LAG];
+static int FastVolNbUnknowns = 0, FastVolNbElements = 0;
+
+static const int FastVolStride = 4;
+
+void ResetFastVolUpdates(void) {
+  for (int set = 0; set < 2; ++set) {
+    FastVolCells *tab = FastVolCellTab[set];
+    if (!tab) continue;
+    for (int block = 1; block <= FastVolCellBlocks; ++block) {
+      FastVolCells *cells = &tab[block];
+      free_ivector(cells->cx, 1, cells->ncx);
+      free_ivector(cells->cy, 1, cells->ncy);
+      free_ivector(cells->cz, 1, cells->ncz);
+      free_ivector(cells->lastUpdate, 0, cells->ncells - 1);
+      free_ivector(cells->lag, 0, cells->ncells - 1);
+      free_dvector(cells->accPot, 0, cells->ncells - 1);
+      free_dvector(cells->accField, 0, cells->ncells - 1);
+    }
+    free(tab);
+    FastVolCellTab[set] = NULL;
+  }
+  FastVolCellBlocks = 0;
+  if (FastVolNbUnknowns > 0) {
+    for (int slot = 0; slot < FASTVOL_MAX_LAG; ++slot) {
+      free_dvector(FastVolDSolution[slot], 1, FastVolNbUnknowns);
+      free_dvector(FastVolDAssigned[slot], 1, FastVolNbElements);
+    }
+  }
+  FastVolNbUnknowns = FastVolNbElements = 0;
+  NbFastVolUpdates = 0;
+}  // ResetFastVolUpdates ends
+
+static FastVolCells *CreateFastVolCells(void) {
+  FastVolCells *tab =
+      (FastVolCells *)malloc((FastVol.NbBlocks + 1) * sizeof(FastVolCells));
+  for (int block = 1; block <= FastVol.NbBlocks; ++block) {
+    FastVolCells *cells = &tab[block];
+    const int nx = BlkNbXCells[block] + 1;
+    const int ny = BlkNbYCells[block] + 1;
+    const int nz = BlkNbZCells[block] + 1;
+    // Coarse lattice (always including the last node).
+    cells->ncx = (nx - 2) / FastVolStride + 2;
+    cells->ncy = (ny - 2) / FastVolStride + 2;
+    cells->ncz = (nz - 2) / FastVolStride + 2;
+    cells->cx = ivector(1, cells->ncx);
+    cells->cy = ivector(1, cells->ncy);
+    cells->cz = ivector(1, cells->ncz);
+    for (int a = 1; a < cells->ncx; ++a) {
+      cells->cx[a] = 1 + (a - 1) * FastVolStride;
+    }
+    for (int a = 1; a < cells->ncy; ++a) {
+      cells->cy[a] = 1 + (a - 1) * FastVolStride;
+    }
+    for (int a = 1; a < cells->ncz; ++a) {
+      cells->cz[a] = 1 + (a - 1) * FastVolStride;
+    }
+    cells->cx[cells->ncx] = nx;
+    cells->cy[cells->ncy] = ny;
+    cells->cz[cells->ncz] = nz;
+    cells->ncells = (cells->ncx - 1) * (cells->ncy - 1) * (cells->ncz - 1);
+    cells->lastUpdate = ivector(0, cells->ncells - 1);
+    cells->lag = ivector(0, cells->ncells - 1);
+    cells->accPot = dvector(0, cells->ncells - 1);
+    cells->accField = dvector(0, cells->ncells - 1);
+    for (int n = 0; n < cells->ncells; ++n) {
+      cells->lastUpdate[n] = 0;
+      cells->lag[n] = 0;
+      cells->accPot[n] = cells->accField[n] = 0.0;
+    }
+  }
+  return tab;
+}  // CreateFastVolCells ends
+
+// Set the element charge densities (and the derived averages) used by
+// ElePFAtPoint to the given values.
+static void SetElementCharges(double solution[], double assigned[]) {
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    (EleArr + ele - 1)->Solution = solution[ele];
+    (EleArr + ele - 1)->Assigned = assigned[ele];
+  }
+  for (int prim = 1; prim <= NbPrimitives; ++prim) {
+    double area = 0.0;
+    AvChDen[prim] = AvAsgndChDen[prim] = 0.0;
+    for (int ele = ElementBgn[prim]; ele <= ElementEnd[prim]; ++ele) {
+      const double dA = (EleArr + ele - 1)->G.dA;
+      area += dA;
+      AvChDen[prim] += solution[ele] * dA;
+      AvAsgndChDen[prim] += assigned[ele] * dA;
+    }
+    AvChDen[prim] /= area;
+    AvAsgndChDen[prim] /= area;
+  }
+  VSystemChargeZero = OptSystemChargeZero ? solution[NbSystemChargeZero] : 0.;
+}  // SetElementCharges ends
+
+// Add the change due to the current element charges to the coarse nodes of
+// one set of fast volume tables (basic or staggered) and flag the cells
+// whose remaining nodes need to be recomputed.
+static void UpdateFastVolCoarse(FastVolCells *tab, double ****pot,
+                                double ****fx, double ****fy, double ****fz,
+                                double startX, double startY, double tol) {
+  for (int block = 1; block <= FastVol.NbBlocks; ++block) {
+    FastVolCells *cells = &tab[block];
+    const int ncx = cells->ncx, ncy = cells->ncy, ncz = cells->ncz;
+    const int *cx = cells->cx, *cy = cells->cy, *cz = cells->cz;
+    const double startZ = BlkCrnrZ[block];
+    const double delX = FastVol.LX / BlkNbXCells[block];
+    const double delY = FastVol.LY / BlkNbYCells[block];
+    const double delZ = BlkLZ[block] / BlkNbZCells[block];
+    // Changes at the coarse nodes.
+    const int ncoarse = ncx * ncy * ncz;
+    double *dpot = dvector(0, ncoarse - 1);
+    double *dfield = dvector(0, ncoarse - 1);
+    int n;
+#ifdef _OPENMP
+#pragma omp parallel for private(n) schedule(dynamic)
+#endif
+    for (n = 0; n < ncoarse; ++n) {
+      const int a = n / (ncy * ncz) + 1;
+      const int b = (n / ncz) % ncy + 1;
+      const int c = n % ncz + 1;
+      AddFastVolNode(pot, fx, fy, fz, block, cx[a], cy[b], cz[c],
+                     startX + (cx[a] - 1) * delX, startY + (cy[b] - 1) * delY,
+                     startZ + (cz[c] - 1) * delZ, &dpot[n], &dfield[n]);
+    }
+    // Coarse cells with significant accumulated changes.
+    for (n = 0; n < cells->ncells; ++n) {
+      const int a = n / ((ncy - 1) * (ncz - 1)) + 1;
+      const int b = (n / (ncz - 1)) % (ncy - 1) + 1;
+      const int c = n % (ncz - 1) + 1;
+      double maxdpot = 0.0, maxdfield = 0.0, maxpot = 0.0, maxfield = 0.0;
+      for (int corner = 0; corner < 8; ++corner) {
+        const int ia = a + (corner & 1);
+        const int ib = b + ((corner >> 1) & 1);
+        const int ic = c + ((corner >> 2) & 1);
+        const int m = ((ia - 1) * ncy + (ib - 1)) * ncz + (ic - 1);
+        maxdpot = fmax(maxdpot, dpot[m]);
+        maxdfield = fmax(maxdfield, dfield[m]);
+        const int i = cx[ia], j = cy[ib], k = cz[ic];
+        maxpot = fmax(maxpot, fabs(pot[block][i][j][k]));
+        maxfield = fmax(maxfield, sqrt(fx[block][i][j][k] * fx[block][i][j][k] +
+                                       fy[block][i][j][k] * fy[block][i][j][k] +
+                                       fz[block][i][j][k] * fz[block][i][j][k]));
+      }
+      // The changes of successive updates can add up.
+      cells->accPot[n] += maxdpot;
+      cells->accField[n] += maxdfield;
+      const int lag = NbFastVolUpdates - cells->lastUpdate[n];
+      cells->lag[n] = 0;
+      if (cells->accPot[n] <= tol * maxpot &&
+          cells->accField[n] <= tol * maxfield && lag < FASTVOL_MAX_LAG) {
+        continue;
+      }
+      cells->lag[n] = lag;
+    }
+    free_dvector(dpot, 0, ncoarse - 1);
+    free_dvector(dfield, 0, ncoarse - 1);
+  }  // loop over blocks
+}  // UpdateFastVolCoarse ends
+
+// Recompute the nodes inside the flagged cells which lag behind by the given
+// number of updates, using the current element charges (the sum of the
+// changes of these updates).
+static void UpdateFastVolCells(FastVolCells *tab, double ****pot,
+                               double ****fx, double ****fy, double ****fz,
+                               double startX, double startY, int lag) {
+  const int stride = FastVolStride;
+  for (int block = 1; block <= FastVol.NbBlocks; ++block) {
+    FastVolCells *cells = &tab[block];
+    const int ncx = cells->ncx, ncy = cells->ncy, ncz = cells->ncz;
+    const int *cx = cells->cx, *cy = cells->cy, *cz = cells->cz;
+    const int nx = cx[ncx], ny = cy[ncy], nz = cz[ncz];
+    const double startZ = BlkCrnrZ[block];
+    const double delX = FastVol.LX / BlkNbXCells[block];
+    const double delY = FastVol.LY / BlkNbYCells[block];
+    const double delZ = BlkLZ[block] / BlkNbZCells[block];
+    int n;
+#ifdef _OPENMP
+#pragma omp parallel for private(n) schedule(dynamic)
+#endif
+    for (n = 0; n < cells->ncells; ++n) {
+      if (cells->lag[n] != lag) continue;
+      const int a = n / ((ncy - 1) * (ncz - 1)) + 1;
+      const int b = (n / (ncz - 1)) % (ncy - 1) + 1;
+      const int c = n % (ncz - 1) + 1;
+      // Update the nodes inside the cell and on its lower faces, which are
+      // not shared with any other cell.
+      for (int i = cx[a]; i < cx[a + 1] + (a + 1 == ncx ? 1 : 0); ++i) {
+        for (int j = cy[b]; j < cy[b + 1] + (b + 1 == ncy ? 1 : 0); ++j) {
+          for (int k = cz[c]; k < cz[c + 1] + (c + 1 == ncz ? 1 : 0); ++k) {
+            if ((i - 1) % stride == 0 && (j - 1) % stride == 0 &&
+                (k - 1) % stride == 0) {
+              continue;
+            }
+            if ((i == nx || j == ny || k == nz) &&
+                (i == nx || (i - 1) % stride == 0) &&
+                (j == ny || (j - 1) % stride == 0) &&
+                (k == nz || (k - 1) % stride == 0)) {
+              continue;
+            }
+            double dp, df;
+            AddFastVolNode(pot, fx, fy, fz, block, i, j, k,
+                           startX + (i - 1) * delX, startY + (j - 1) * delY,
+                           startZ + (k - 1) * delZ, &dp, &df);
+          }
+        }
+      }
+      cells->lag[n] = 0;
+      cells->lastUpdate[n] = NbFastVolUpdates;
+      cells->accPot[n] = cells->accField[n] = 0.0;
+    }  // loop over coarse cells
+  }    // loop over blocks
+}  // UpdateFastVolCells ends
+
+// Update of the fast volume after a change of the element charge densities
+// (dAssigned) and of the solution (dSolution), e.g. due to charging up.
+// Since potential and field are linear in the charges, the changes are
+// computed from the charge differences alone and added to the tables.
+// The nodes inside a coarse cell are only recomputed once the accumulated
+// relative change at its corners exceeds tol (see FastVolCells).
+int UpdateFastVolPF(double dAssigned[], double dSolution[], double tol) {
+  if (!OptFastVol) return 0;
+
+  const int nSets = OptStaggerFastVol ? 2 : 1;
+  if (!FastVolCellTab[0] || FastVolCellBlocks != FastVol.NbBlocks ||
+      FastVolNbUnknowns != NbUnknowns || FastVolNbElements != NbElements) {
+    // First update since the fast volume was computed.
+    ResetFastVolUpdates();
+    for (int set = 0; set < 2; ++set) {
+      FastVolCellTab[set] = CreateFastVolCells();
+    }
+    FastVolCellBlocks = FastVol.NbBlocks;
+    FastVolNbUnknowns = NbUnknowns;
+    FastVolNbElements = NbElements;
+    for (int slot = 0; slot < FASTVOL_MAX_LAG; ++slot) {
+      FastVolDSolution[slot] = dvector(1, NbUnknowns);
+      FastVolDAssigned[slot] = dvector(1, NbElements);
+    }
+  }
+  ++NbFastVolUpdates;
+  const int slot = NbFastVolUpdates % FASTVOL_MAX_LAG;
+  for (int i = 1; i <= NbUnknowns; ++i) {
+    FastVolDSolution[slot][i] = dSolution[i];
+  }
+  for (int i = 1; i <= NbElements; ++i) {
+    FastVolDAssigned[slot][i] = dAssigned[i];
+  }
+
+  // Save the charge densities.
+  double *solution = dvector(1, NbUnknowns);
+  double *assigned = dvector(1, NbElements);
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    solution[ele] = (EleArr + ele - 1)->Solution;
+    assigned[ele] = (EleArr + ele - 1)->Assigned;
+  }
+  for (int i = NbElements + 1; i <= NbUnknowns; ++i) solution[i] = 0.;
+  double *avChDen = dvector(1, NbPrimitives);
+  double *avAsgndChDen = dvector(1, NbPrimitives);
+  for (int prim = 1; prim <= NbPrimitives; ++prim) {
+    avChDen[prim] = AvChDen[prim];
+    avAsgndChDen[prim] = AvAsgndChDen[prim];
+  }
+  const double vSystemChargeZero = VSystemChargeZero;
+
+  double ****pot[2] = {FastPot, StgFastPot};
+  double ****fx[2] = {FastFX, StgFastFX};
+  double ****fy[2] = {FastFY, StgFastFY};
+  double ****fz[2] = {FastFZ, StgFastFZ};
+  const double startX[2] = {FastVol.CrnrX, FastVol.CrnrX + FastVol.LX};
+  const double startY[2] = {FastVol.CrnrY, FastVol.CrnrY + FastVol.YStagger};
+
+  // Changes at the coarse nodes due to this update.
+  SetElementCharges(dSolution, dAssigned);
+  for (int set = 0; set < nSets; ++set) {
+    UpdateFastVolCoarse(FastVolCellTab[set], pot[set], fx[set], fy[set],
+                        fz[set], startX[set], startY[set], tol);
+  }
+  // Bring the flagged cells up to date, grouped by the number of updates
+  // they missed.
+  double *sumSolution = dvector(1, NbUnknowns);
+  double *sumAssigned = dvector(1, NbElements);
+  for (int i = 1; i <= NbUnknowns; ++i) sumSolution[i] = 0.;
+  for (int i = 1; i <= NbElements; ++i) sumAssigned[i] = 0.;
+  const int maxLag = NbFastVolUpdates < FASTVOL_MAX_LAG ? NbFastVolUpdates
+                                                         : FASTVOL_MAX_LAG;
+  for (int lag = 1; lag <= maxLag; ++lag) {
+    const int k = (NbFastVolUpdates - lag + 1) % FASTVOL_MAX_LAG;
+    for (int i = 1; i <= NbUnknowns; ++i) {
+      sumSolution[i] += FastVolDSolution[k][i];
+    }
+    for (int i = 1; i <= NbElements; ++i) {
+      sumAssigned[i] += FastVolDAssigned[k][i];
+    }
+    int flagged = 0;
+    for (int set = 0; set < nSets && !flagged; ++set) {
+      for (int block = 1; block <= FastVol.NbBlocks && !flagged; ++block) {
+        const FastVolCells *cells = &FastVolCellTab[set][block];
+        for (int n = 0; n < cells->ncells; ++n) {
+          if (cells->lag[n] == lag) {
+            flagged = 1;
+            break;
+          }
+        }
+      }
+    }
+    if (!flagged) continue;
+    SetElementCharges(sumSolution, sumAssigned);
+    for (int set = 0; set < nSets; ++set) {
+      UpdateFastVolCells(FastVolCellTab[set], pot[set], fx[set], fy[set],
+                         fz[set], startX[set], startY[set], lag);
+    }
+  }
+  free_dvector(sumSolution, 1, NbUnknowns);
+  free_dvector(sumAssigned, 1, NbElements);
+
+  // Restore the charge densities.
+  VSystemChargeZero = vSystemChargeZero;
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    (EleArr + ele - 1)->Solution = solution[ele];
+    (EleArr + ele - 1)->Assigned = assigned[ele];
+  }
+  for (int prim = 1; prim <= NbPrimitives; ++prim) {
+    AvChDen[prim] = avChDen[prim];
+    AvAsgndChDen[prim] = avAsgndChDen[prim];
+  }
+  free_dvector(solution, 1, NbUnknowns);
+  free_dvector(assigned, 1, NbElements);
+  free_dvector(avChDen, 1, NbPrimitives);
+  free_dvector(avAsgndChDen, 1, NbPrimitives);
+  return 0;
+}  // UpdateFastVolPF ends
+
 // Gives three components of the total Potential and flux in the global
 // coordinate system due to all the elements using the results stored in
 // the FAST volume mesh.
@@ -3478,6 +3895,22 @@ int WtFldPFAtPoint(Point3D *globalP, double *Potential, Vector3D *globalF,
       plFx[primsrc] = tmpF.X;  // local fluxes lFx, lFy, lFz in GCS
       plFy[primsrc] = tmpF.Y;
       plFz[primsrc] = tmpF.Z;
+
+      // Periodic copies that are not summed explicitly (GCS)
+      if (OptEwald && EwaldPeriodicity(primsrc) > 0) {
+        const int eleMin = ElementBgn[primsrc];
+        const int eleMax = ElementEnd[primsrc];
+        for (int ele = eleMin; ele <= eleMax; ++ele) {
+          double ewPot;
+          Vector3D ewF;
+          EwaldElePF(ele, globalP, &ewPot, &ewF);
+          const double qel = WtFieldChDen[IdWtField][ele];
+          pPot[primsrc] += qel * ewPot;
+          plFx[primsrc] += qel * ewF.X;
+          plFy[primsrc] += qel * ewF.Y;
+          plFz[primsrc] += qel * ewF.Z;
+        }
+      }
     }  // for all primitives: basic device, mirror reflections and repetitions
   }    // pragma omp parallel
 
@@ -0,0 +1,334 @@
+/*
+Ewald summation of periodic copies for neBEM.
+*/
+#define DEFINE_EWALDGLOBAL
+
+#include "Ewald.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <gsl/gsl_sf.h>
+
+#include "Isles.h"
+#include "neBEM.h"
+
+// Terms which are smaller than exp(-EWALDCUT) are neglected.
+#define EWALDCUT 36.0
+#define EULERGAMMA 0.57721566490153286061
+
+#ifdef __cplusplus
+namespace neBEM {
+#endif
+
+// 16-point Gauss-Legendre nodes and weights on [-1, 1] (positive half).
+static const double GLNode[8] = {0.0950125098376374, 0.2816035507792589,
+                                 0.4580167776572274, 0.6178762444026438,
+                                 0.7554044083550030, 0.8656312023878318,
+                                 0.9445750230732326, 0.9894009349916499};
+static const double GLWeight[8] = {0.1894506104550685, 0.1826034150449236,
+                                   0.1691565193950025, 0.1495959888165767,
+                                   0.1246289712555339, 0.0951585116824928,
+                                   0.0622535239386479, 0.0271524594117541};
+
+static const double TwoBySqrtPi = 1.12837916709551257390;
+
+// Real-space term of a lattice point at separation d. For the copies which
+// are summed explicitly (nearby), their 1 / r is subtracted, leaving
+// -erf(alpha r) / r; for the others, erfc(alpha r) / r.
+// The potential is added to pot and the flux (-grad) to f.
+static void RealSpaceTerm(const double d[3], const double alpha,
+                          const int nearby, double *pot, double f[3]) {
+  const double r2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+  const double r = sqrt(r2);
+  const double x = alpha * r;
+  // -(dPot/dr) / r
+  double g = 0.;
+  if (nearby) {
+    if (x < 1.e-3) {
+      const double x2 = x * x;
+      *pot -= TwoBySqrtPi * alpha * (1. - x2 / 3. + x2 * x2 / 10.);
+      g = -TwoBySqrtPi * alpha * alpha * alpha * (2. / 3. - 0.4 * x2);
+    } else {
+      const double e = erf(x);
+      *pot -= e / r;
+      g = (TwoBySqrtPi * alpha * exp(-x * x) - e / r) / r2;
+    }
+  } else {
+    const double e = erfc(x);
+    *pot += e / r;
+    g = (TwoBySqrtPi * alpha * exp(-x * x) + e / r) / r2;
+  }
+  f[0] += g * d[0];
+  f[1] += g * d[1];
+  f[2] += g * d[2];
+}
+
+// Integrals int_1^inf exp(-beta u - gamma / u) du / u^n for n = 1, 2,
+// (the latter up to a factor) written as integrals over t = ln u.
+static void IncompleteBesselK0(const double beta, const double gamma,
+                               double *i1, double *i2) {
+  *i1 = *i2 = 0.;
+  // Upper limit of the integral and number of intervals.
+  double tmax = log((EWALDCUT + 2. * sqrt(beta * gamma)) / beta);
+  if (tmax <= 0.) return;
+  const int nIntervals = tmax < 3. ? 2 : 4;
+  const double h = 0.5 * tmax / nIntervals;
+  for (int k = 0; k < nIntervals; ++k) {
+    const double tc = (2 * k + 1) * h;
+    for (int j = 0; j < 8; ++j) {
+      for (int s = -1; s <= 1; s += 2) {
+        const double t = tc + s * h * GLNode[j];
+        const double et = exp(t);
+        const double w = h * GLWeight[j] * exp(-beta * et - gamma / et);
+        *i1 += w;
+        *i2 += w / et;
+      }
+    }
+  }
+}
+
+// Lattice of unit charges at n a along the u-axis; (u, v, w) is the
+// separation from the charge at n = 0. The charges with |n| <= ncopies
+// are excluded.
+static void EwaldLine(const double u, const double v, const double w,
+                      const double a, const int ncopies, double *pot,
+                      double f[3]) {
+  *pot = f[0] = f[1] = f[2] = 0.;
+  const double rho2 = v * v + w * w;
+  const double rho = sqrt(rho2);
+  const double alpha = 2. / a;
+  const double k1 = 2. * ST_PI / a;
+  if (rho >= 0.5 * a) {
+    // Far from the axis, the spectral (Bessel function) series converges
+    // quickly. The constant is chosen consistent with the Ewald sum below.
+    double fr = 2. / (a * rho);
+    *pot = -(2. * log(alpha * rho) + EULERGAMMA) / a;
+    for (int m = 1; m * k1 * rho < EWALDCUT; ++m) {
+      const double k = m * k1;
+      const double x = k * rho;
+      const double e = exp(-x);
+      const double bk0 = e * gsl_sf_bessel_K0_scaled(x);
+      const double bk1 = e * gsl_sf_bessel_K1_scaled(x);
+      const double c = cos(k * u);
+      const double s = sin(k * u);
+      *pot += 4. * bk0 * c / a;
+      f[0] += 4. * k * bk0 * s / a;
+      fr += 4. * k * bk1 * c / a;
+    }
+    f[1] = fr * v / rho;
+    f[2] = fr * w / rho;
+    // Subtract the copies summed explicitly.
+    for (int n = -ncopies; n <= ncopies; ++n) {
+      const double du = u - n * a;
+      const double r2 = du * du + rho2;
+      const double r = sqrt(r2);
+      *pot -= 1. / r;
+      f[0] -= du / (r * r2);
+      f[1] -= v / (r * r2);
+      f[2] -= w / (r * r2);
+    }
+    return;
+  }
+
+  // Real-space sum.
+  const double rcut = sqrt(EWALDCUT) / alpha;
+  int n0 = (int)floor((u - rcut) / a);
+  int n1 = (int)ceil((u + rcut) / a);
+  if (n0 > -ncopies) n0 = -ncopies;
+  if (n1 < ncopies) n1 = ncopies;
+  for (int n = n0; n <= n1; ++n) {
+    const double d[3] = {u - n * a, v, w};
+    const int nearby = abs(n) <= ncopies;
+    if (!nearby && d[0] * d[0] + rho2 > rcut * rcut) continue;
+    RealSpaceTerm(d, alpha, nearby, pot, f);
+  }
+
+  // Reciprocal-space sum, k = 0 term: -Ein(alpha^2 rho^2) / a.
+  const double y = alpha * alpha * rho2;
+  double ein = 0., term = 1.;
+  for (int k = 1; k <= 30; ++k) {
+    term *= -y / k;
+    ein -= term / k;
+    if (fabs(term) < 1.e-17) break;
+  }
+  *pot -= ein / a;
+  // Radial flux 2 (1 - exp(-y)) / (a rho)
+  const double fr =
+      rho2 > 0. ? -2. * expm1(-y) / (a * rho2) : 2. * alpha * alpha / a;
+  f[1] += fr * v;
+  f[2] += fr * w;
+  // Terms with k != 0.
+  for (int m = 1;; ++m) {
+    const double k = m * k1;
+    const double beta = 0.25 * k * k / (alpha * alpha);
+    if (beta > EWALDCUT) break;
+    double i1 = 0., i2 = 0.;
+    IncompleteBesselK0(beta, y, &i1, &i2);
+    const double c = cos(k * u);
+    const double s = sin(k * u);
+    *pot += 2. * c * i1 / a;
+    f[0] += 2. * k * s * i1 / a;
+    const double g = 4. * alpha * alpha * c * i2 / a;
+    f[1] += g * v;
+    f[2] += g * w;
+  }
+}
+
+// Lattice of unit charges at (i a, j b) in the (u, v) plane; (u, v, w) is
+// the separation from the charge at i = j = 0. The charges with |i| <= nu
+// and |j| <= nv are excluded.
+static void EwaldPlane(const double u, const double v, const double w,
+                       const double a, const double b, const int nu,
+                       const int nv, double *pot, double f[3]) {
+  *pot = f[0] = f[1] = f[2] = 0.;
+  const double area = a * b;
+  const double alpha = sqrt(ST_PI / area);
+
+  // Real-space sum.
+  const double rcut = sqrt(EWALDCUT) / alpha;
+  int i0 = (int)floor((u - rcut) / a);
+  int i1 = (int)ceil((u + rcut) / a);
+  int j0 = (int)floor((v - rcut) / b);
+  int j1 = (int)ceil((v + rcut) / b);
+  if (i0 > -nu) i0 = -nu;
+  if (i1 < nu) i1 = nu;
+  if (j0 > -nv) j0 = -nv;
+  if (j1 < nv) j1 = nv;
+  for (int i = i0; i <= i1; ++i) {
+    for (int j = j0; j <= j1; ++j) {
+      const double d[3] = {u - i * a, v - j * b, w};
+      const int nearby = abs(i) <= nu && abs(j) <= nv;
+      if (!nearby && d[0] * d[0] + d[1] * d[1] + w * w > rcut * rcut) {
+        continue;
+      }
+      RealSpaceTerm(d, alpha, nearby, pot, f);
+    }
+  }
+
+  // Reciprocal-space sum; k and -k are combined.
+  const double ku = 2. * ST_PI / a;
+  const double kv = 2. * ST_PI / b;
+  const double kmax = 2. * alpha * sqrt(EWALDCUT);
+  const int mumax = (int)(kmax / ku);
+  const int mvmax = (int)(kmax / kv);
+  // The phases exp(i (mu ku u + mv kv v)) are obtained by recurrence.
+  const double cu = cos(ku * u), su = sin(ku * u);
+  const double cv = cos(kv * v), sv = sin(kv * v);
+  const double cv0 = cos(mvmax * kv * v), sv0 = -sin(mvmax * kv * v);
+  double cmu = 1., smu = 0.;
+  for (int mu = 0; mu <= mumax; ++mu) {
+    double c = cmu * cv0 - smu * sv0;
+    double s = smu * cv0 + cmu * sv0;
+    for (int mv = -mvmax; mv <= mvmax; ++mv) {
+      const double kx = mu * ku;
+      const double ky = mv * kv;
+      const double k = sqrt(kx * kx + ky * ky);
+      if ((mu > 0 || mv > 0) && k <= kmax) {
+        const double h = 0.5 * k / alpha;
+        const double e1 = exp(k * w + gsl_sf_log_erfc(h + alpha * w));
+        const double e2 = exp(-k * w + gsl_sf_log_erfc(h - alpha * w));
+        const double pre = 2. * ST_PI / (area * k);
+        *pot += pre * c * (e1 + e2);
+        f[0] += pre * kx * s * (e1 + e2);
+        f[1] += pre * ky * s * (e1 + e2);
+        f[2] -= pre * k * c * (e1 - e2);
+      }
+      const double cn = c * cv - s * sv;
+      s = s * cv + c * sv;
+      c = cn;
+    }
+    const double cn = cmu * cu - smu * su;
+    smu = smu * cu + cmu * su;
+    cmu = cn;
+  }
+  // k = 0 term.
+  const double aw = alpha * w;
+  *pot -= 2. * ST_PI / area *
+          (w * erf(aw) + exp(-aw * aw) / (alpha * sqrt(ST_PI)));
+  f[2] += 2. * ST_PI / area * erf(aw);
+}
+
+// Periodic and non-periodic axes of a primitive.
+static int EwaldAxes(int prim, int axes[3], double period[2], int ncopies[2]) {
+  if (MirrorTypeX[prim] || MirrorTypeY[prim] || MirrorTypeZ[prim]) return 0;
+  const int type[3] = {PeriodicTypeX[prim], PeriodicTypeY[prim],
+                       PeriodicTypeZ[prim]};
+  const double length[3] = {XPeriod[prim], YPeriod[prim], ZPeriod[prim]};
+  const int copies[3] = {PeriodicInX[prim], PeriodicInY[prim],
+                         PeriodicInZ[prim]};
+  int nper = 0, nfree = 0;
+  int others[3];
+  for (int i = 0; i < 3; ++i) {
+    if (type[i] == 0) {
+      others[nfree++] = i;
+    } else if (type[i] == 1 && length[i] > 0. && nper < 2) {
+      axes[nper] = i;
+      period[nper] = length[i];
+      ncopies[nper] = copies[i];
+      ++nper;
+    } else {
+      // Other types of periodicity or periodicity in three directions.
+      return 0;
+    }
+  }
+  for (int i = 0; i < nfree; ++i) axes[nper + i] = others[i];
+  return nper;
+}
+
+int EwaldPeriodicity(int prim) {
+  int axes[3];
+  double period[2];
+  int ncopies[2];
+  return EwaldAxes(prim, axes, period, ncopies);
+}
+
+int EwaldElePF(int ele, Point3D *globalP, double *Potential,
+               Vector3D *globalF) {
+  *Potential = globalF->X = globalF->Y = globalF->Z = 0.;
+
+  const int prim = (EleArr + ele - 1)->PrimitiveNb;
+  int axes[3];
+  double period[2];
+  int ncopies[2];
+  const int nper = EwaldAxes(prim, axes, period, ncopies);
+  if (nper == 0) return 1;
+
+  // Centroid of the element (the origin of a triangular element is at its
+  // right-angled corner).
+  Point3D centre = (EleArr + ele - 1)->G.Origin;
+  if ((EleArr + ele - 1)->G.Type == 3) {
+    const DirnCosn3D *dc = &(EleArr + ele - 1)->G.DC;
+    const double lx = (EleArr + ele - 1)->G.LX / 3.;
+    const double lz = (EleArr + ele - 1)->G.LZ / 3.;
+    centre.X += lx * dc->XUnit.X + lz * dc->ZUnit.X;
+    centre.Y += lx * dc->XUnit.Y + lz * dc->ZUnit.Y;
+    centre.Z += lx * dc->XUnit.Z + lz * dc->ZUnit.Z;
+  }
+  const double d[3] = {globalP->X - centre.X, globalP->Y - centre.Y,
+                       globalP->Z - centre.Z};
+
+  double pot = 0.;
+  double f[3] = {0., 0., 0.};
+  if (nper == 1) {
+    EwaldLine(d[axes[0]], d[axes[1]], d[axes[2]], period[0], ncopies[0], &pot,
+              f);
+  } else {
+    EwaldPlane(d[axes[0]], d[axes[1]], d[axes[2]], period[0], period[1],
+               ncopies[0], ncopies[1], &pot, f);
+  }
+  double fg[3] = {0., 0., 0.};
+  for (int i = 0; i < 3; ++i) fg[axes[i]] = f[i];
+
+  const double dA = (EleArr + ele - 1)->G.dA;
+  *Potential = dA * pot;
+  globalF->X = dA * fg[0];
+  globalF->Y = dA * fg[1];
+  globalF->Z = dA * fg[2];
+  return 0;
+}  // EwaldElePF ends
+
+#ifdef __cplusplus
+}  // namespace neBEM
+#endif
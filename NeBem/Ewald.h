@@ -0,0 +1,43 @@
+/*
+Ewald summation of periodic copies for neBEM.
+*/
+#ifndef _Ewald_H_
+#define _Ewald_H_
+
+#ifdef DEFINE_EWALDGLOBAL
+#define EWALDGLOBAL
+#else
+#define EWALDGLOBAL extern
+#endif
+
+#include "Vector.h"
+
+#ifdef __cplusplus
+namespace neBEM {
+#endif
+
+// Copies of a primitive beyond the PeriodicInX, PeriodicInY, PeriodicInZ
+// copies that are summed explicitly can be accounted for by an Ewald sum,
+// provided the primitive has simple periodicity in one or two directions
+// and no mirror. The Ewald sum is of a point charge located at the
+// centroid of the element, which is sufficient for the copies that are
+// not summed explicitly. The (divergent) constant of the lattice sum is
+// dropped, i.e. the potential due to a cell with a net charge is defined
+// up to a constant.
+
+// Number of periodic directions (1 or 2) of a primitive for which the Ewald
+// sum can be used; 0 if it can not be used.
+EWALDGLOBAL int EwaldPeriodicity(int prim);
+
+// Potential and flux (in the GCS) at globalP per unit charge density on
+// the element ele due to its periodic copies that are not summed
+// explicitly. As for ExactRecSurf etc, the factor 1 / (4 pi eps0) is not
+// included. Returns a non-zero value if the Ewald sum does not apply.
+EWALDGLOBAL int EwaldElePF(int ele, Point3D *globalP, double *Potential,
+                           Vector3D *globalF);
+
+#ifdef __cplusplus
+}  // namespace
+#endif
+
+#endif
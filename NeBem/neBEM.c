@@ -16,6 +16,7 @@
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_matrix.h>
 
+#include "Ewald.h"
 #include "Isles.h"
 #include "NR.h"
 #include "Vector.h"
@@ -696,6 +697,27 @@ int LHMatrix(void) {
           }          // PeriodicType == 1
         }            // end of influence due to virtual elements
 
+        // Influence of the periodic copies that are not summed explicitly
+        if (OptEwald) {
+          Point3D fldpt;
+          fldpt.X = xfld;
+          fldpt.Y = yfld;
+          fldpt.Z = zfld;
+          double pot = 0.;
+          Vector3D flux;
+          if (EwaldElePF(elesrc, &fldpt, &pot, &flux) == 0) {
+            const int etfld = (EleArr + elefld - 1)->E.Type;
+            if (etfld == 1 || etfld == 3) {
+              Inf[elefld][elesrc] += pot / MyFACTOR;
+            } else if (etfld == 4 || etfld == 5) {
+              // Normal component in the ECS of the field element
+              Vector3D localF = RotateVector3D(
+                  &flux, &(EleArr + elefld - 1)->G.DC, global2local);
+              Inf[elefld][elesrc] -= localF.Y / MyFACTOR;
+            }
+          }
+        }
+
       }  // loop for elesrc, source element (influencing)
 
       // printf("\b\b\b\b\b\b");
@@ -2467,14 +2489,8 @@ double ContinuityKnCh(int elefld) {
 }  // end of ContinuityKnCh
 
 // Effect of charging up on the Dirichlet boundary conditions
-double ValueChUp(int elefld) {
-  int dbgFn = 0;
-
-  if (dbgFn) printf("\nelefld: %d\n", elefld);
-  if (dbgFn) {
-    printf("In ValueChUp ...\n");
-  }
-
+// Dirichlet contribution due to the charges assigned to the elements only.
+double EleValueChUp(int elefld) {
   double value = 0.0;
   double assigned = 0.0;
   double xfld = (EleArr + elefld - 1)->BC.CollPt.X;
@@ -2553,6 +2569,23 @@ double ValueChUp(int elefld) {
     }           // switch over gtsrc ends
   }             // for all source elements - elesrc
 
+  return (value);
+}  // EleValueChUp ends
+
+double ValueChUp(int elefld) {
+  int dbgFn = 0;
+
+  if (dbgFn) printf("\nelefld: %d\n", elefld);
+  if (dbgFn) {
+    printf("In ValueChUp ...\n");
+  }
+
+  double xfld = (EleArr + elefld - 1)->BC.CollPt.X;
+  double yfld = (EleArr + elefld - 1)->BC.CollPt.Y;
+  double zfld = (EleArr + elefld - 1)->BC.CollPt.Z;
+
+  // Effect of the charges assigned to the interface elements
+  double value = EleValueChUp(elefld);
   value *= MyFACTOR;
   if (dbgFn) {
     printf("value after known charges on elements (*MyFACTOR): %g\n", value);
@@ -2613,14 +2646,8 @@ double ValueChUp(int elefld) {
 }  // ValueChUp ends
 
 // Effect of charging up on the Neumann boundary condition
-double ContinuityChUp(int elefld) {
-  int dbgFn = 0;
-
-  if (dbgFn) printf("\nelefld: %d\n", elefld);
-  if (dbgFn) {
-    printf("In ContinuityChUp ...\n");
-  }
-
+// Neumann contribution due to the charges assigned to the elements only.
+double EleContinuityChUp(int elefld) {
   double value = 0.0;
   double assigned = 0.0;
   double xfld = (EleArr + elefld - 1)->BC.CollPt.X;
@@ -2725,6 +2752,25 @@ double ContinuityChUp(int elefld) {
     }                                // else self-influence
   }
 
+  return (value);
+}  // EleContinuityChUp ends
+
+double ContinuityChUp(int elefld) {
+  int dbgFn = 0;
+
+  if (dbgFn) printf("\nelefld: %d\n", elefld);
+  if (dbgFn) {
+    printf("In ContinuityChUp ...\n");
+  }
+
+  double xfld = (EleArr + elefld - 1)->BC.CollPt.X;
+  double yfld = (EleArr + elefld - 1)->BC.CollPt.Y;
+  double zfld = (EleArr + elefld - 1)->BC.CollPt.Z;
+
+  Vector3D localF, globalF;
+
+  // Effect of the charges assigned to the interface elements
+  double value = EleContinuityChUp(elefld);
   value *= MyFACTOR;
   if (dbgFn) {
     printf("value (* MyFACTOR): %g\n", value);
@@ -4033,36 +4079,63 @@ int ReadSolution(void) {
 // TryWtField is a script that elucidates the idea.
 int WeightingFieldSolution(int NbPrimsWtField, int PrimListWtField[],
                            double solnarray[]) {
+  return WeightingFieldSolutions(1, &NbPrimsWtField, &PrimListWtField,
+                                 &solnarray);
+}  // WtFieldSolution ends
+
+// Weighting field charge densities for several sets of primitives.
+// The right-hand side of each set is unity on the elements of its primitives
+// and zero elsewhere, so that the solution is the sum of the corresponding
+// columns of the inverted matrix. All sets are computed in a single pass
+// over the rows of the inverted matrix.
+int WeightingFieldSolutions(int NbWtFields, int NbPrimsWtField[],
+                            int *PrimListWtField[], double *solnarrays[]) {
   // Check for the inverted matrix
   if (!InvMat) {
     printf(
-        "WeightingFieldSolution: Capacitance matrix not in memory, can not "
+        "WeightingFieldSolutions: Capacitance matrix not in memory, can not "
         "calculate weighting charges.\n");
     return (-1);
   }
-
-  for (int i = 1; i <= NbUnknowns; i++) solnarray[i] = 0.0;
-
-  for (int ele = 1, InList; ele <= NbElements; ++ele) {
-    int prim = (EleArr + ele - 1)->PrimitiveNb;
-
-    InList = 0;  // assume that this prim is not in the list
-    for (int primwtfl = 0; primwtfl < NbPrimsWtField; ++primwtfl) {
-      if (prim == PrimListWtField[primwtfl]) {
-        InList = 1;
-        break;  // get out of the for loop
+  if (NbWtFields < 1) return (0);
+
+  // List the elements belonging to each set.
+  int *NbEleWtField = ivector(1, NbWtFields);
+  int **EleListWtField = imatrix(1, NbWtFields, 1, NbElements);
+  int *InList = ivector(1, NbPrimitives);
+  for (int set = 1; set <= NbWtFields; ++set) {
+    for (int prim = 1; prim <= NbPrimitives; ++prim) InList[prim] = 0;
+    for (int primwtfl = 0; primwtfl < NbPrimsWtField[set - 1]; ++primwtfl) {
+      const int prim = PrimListWtField[set - 1][primwtfl];
+      if (prim >= 1 && prim <= NbPrimitives) InList[prim] = 1;
+    }
+    NbEleWtField[set] = 0;
+    for (int ele = 1; ele <= NbElements; ++ele) {
+      if (InList[(EleArr + ele - 1)->PrimitiveNb]) {
+        EleListWtField[set][++NbEleWtField[set]] = ele;
       }
-    }  // for primwtfl
+    }
+  }  // for set
+  free_ivector(InList, 1, NbPrimitives);
 
-    if (InList) {
-      for (int i = 1; i <= NbUnknowns; ++i) {
-        solnarray[i] += InvMat[i][ele];
-      }
+  int i;
+#ifdef _OPENMP
+#pragma omp parallel for private(i)
+#endif
+  for (i = 1; i <= NbUnknowns; ++i) {
+    const double *row = InvMat[i];
+    for (int set = 1; set <= NbWtFields; ++set) {
+      const int *elelist = EleListWtField[set];
+      double sum = 0.0;
+      for (int k = 1; k <= NbEleWtField[set]; ++k) sum += row[elelist[k]];
+      solnarrays[set - 1][i] = sum;
     }
-  }  // for ele
+  }  // for i
 
+  free_imatrix(EleListWtField, 1, NbWtFields, 1, NbElements);
+  free_ivector(NbEleWtField, 1, NbWtFields);
   return (0);
-}  // WtFieldSolution ends
+}  // WeightingFieldSolutions ends
 
 // Create a function for Reflect to get the effect of given mirrors - this
 // function should provide the localP. Rest can be done within the calling
@@ -4266,6 +4339,95 @@ int UpdateKnownCharges(void) { return 0; }  // UpdateKnownCharges ends
 
 int UpdateChargingUp(void) { return 0; }  // UpdateChargingUp ends
 
+// Incremental charging-up: the charge densities dAssigned[1 ... NbElements]
+// are added to those already assigned to the elements and the solution is
+// updated using the inverted matrix in memory, i.e. without recomputing or
+// inverting the influence matrix again. Since the right-hand side is linear
+// in the assigned charges, only the contributions of the additional charges
+// need to be evaluated, and elements without additional charge are skipped.
+// The change of the solution is returned in dSolution[1 ... NbUnknowns].
+int AddChargingUp(double dAssigned[], double dSolution[]) {
+  if (!InvMat || !Solution) {
+    printf(
+        "AddChargingUp: Inverted matrix or solution not in memory, can not "
+        "update the solution.\n");
+    return (-1);
+  }
+
+  // Assign the additional charges to the elements for the time being.
+  double *assigned = dvector(1, NbElements);
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    assigned[ele] = (EleArr + ele - 1)->Assigned;
+    (EleArr + ele - 1)->Assigned = dAssigned[ele];
+  }
+
+  // Change of the right-hand side (see RHVector).
+  double *dRHS = dvector(1, NbEqns);
+  int elefld;
+#ifdef _OPENMP
+#pragma omp parallel for private(elefld)
+#endif
+  for (elefld = 1; elefld <= NbElements; ++elefld) {
+    switch ((EleArr + elefld - 1)->E.Type) {
+      case 1:  // Conducting surfaces
+      case 3:  // Floating conducting surfaces
+        dRHS[elefld] = -EleValueChUp(elefld);
+        break;
+      case 4:  // Dielectric interfaces
+      case 5:  // Dielectric interfaces with known charge
+        dRHS[elefld] = -EleContinuityChUp(elefld) + dAssigned[elefld];
+        break;
+      default:  // not supported by RHVector either
+        dRHS[elefld] = 0.0;
+    }
+  }  // for elefld
+  for (int eqn = NbElements + 1; eqn <= NbEqns; ++eqn) dRHS[eqn] = 0.0;
+
+  // Restore and accumulate the assigned charges.
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    (EleArr + ele - 1)->Assigned = assigned[ele] + dAssigned[ele];
+  }
+  free_dvector(assigned, 1, NbElements);
+
+  // Back substitution is a product with the inverted matrix.
+  int i;
+#ifdef _OPENMP
+#pragma omp parallel for private(i)
+#endif
+  for (i = 1; i <= NbUnknowns; ++i) {
+    double sum = 0.0;
+    for (int j = 1; j <= NbUnknowns; ++j) sum += InvMat[i][j] * dRHS[j];
+    dSolution[i] = sum;
+  }
+  free_dvector(dRHS, 1, NbEqns);
+
+  for (int i = 1; i <= NbUnknowns; ++i) Solution[i] += dSolution[i];
+  for (int ele = 1; ele <= NbElements; ++ele) {
+    (EleArr + ele - 1)->Solution = Solution[ele];
+  }
+  if (NbConstraints) {
+    if (OptSystemChargeZero) VSystemChargeZero = Solution[NbSystemChargeZero];
+    if (NbFloatingConductors) VFloatCon = Solution[NbFloatCon];
+  }
+
+  // Update the primitive related charge densities.
+  for (int prim = 1; prim <= NbPrimitives; ++prim) {
+    double area = 0.0;
+    AvChDen[prim] = 0.0;
+    AvAsgndChDen[prim] = 0.0;
+    for (int ele = ElementBgn[prim]; ele <= ElementEnd[prim]; ++ele) {
+      const double dA = (EleArr + ele - 1)->G.dA;
+      area += dA;
+      AvChDen[prim] += (EleArr + ele - 1)->Solution * dA;
+      AvAsgndChDen[prim] += (EleArr + ele - 1)->Assigned * dA;
+    }
+    AvChDen[prim] /= area;
+    AvAsgndChDen[prim] /= area;
+  }
+
+  return (0);
+}  // AddChargingUp ends
+
 #ifdef __cplusplus
 }  // namespace
 #endif
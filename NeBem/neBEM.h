@@ -58,6 +58,7 @@ neBEMGLOBAL int OptUnformattedFile;
 neBEMGLOBAL int OptRepeatLHMatrix;
 neBEMGLOBAL int OptKnCh;
 neBEMGLOBAL int OptChargingUp;
+neBEMGLOBAL int OptEwald;  // Ewald sum for the remote periodic copies
 
 // Geometry variables
 neBEMGLOBAL int NbVolumes;
@@ -319,6 +320,7 @@ neBEMGLOBAL int ComputeSolution(void);
 neBEMGLOBAL int ReadSolution(void);
 neBEMGLOBAL int UpdateKnownCharges(void);
 neBEMGLOBAL int UpdateChargingUp(void);
+neBEMGLOBAL int AddChargingUp(double dAssigned[], double dSolution[]);
 
 // Apparently, localPt need not be passed to ComputeInfluence. This is true if
 // there are no repetitions / reflections. With these and similar possibilities,
@@ -335,6 +337,8 @@ neBEMGLOBAL double SatisfyContinuity(int fld, int src, Point3D *localPt,
 neBEMGLOBAL double EffectChUp(int fld);
 neBEMGLOBAL double ValueChUp(int fld);
 neBEMGLOBAL double ContinuityChUp(int fld);
+neBEMGLOBAL double EleValueChUp(int fld);
+neBEMGLOBAL double EleContinuityChUp(int fld);
 // neBEMGLOBAL double EffectKnCh(int caseid, int fld);
 neBEMGLOBAL double EffectKnCh(int fld);
 neBEMGLOBAL double ValueKnCh(int fld);
@@ -347,6 +351,9 @@ neBEMGLOBAL double **WtFieldChDen, **AvWtChDen;
 neBEMGLOBAL int WeightingFieldSolution(int NbPrimsWtField,
                                        int PrimListWtField[],
                                        double WtFieldChDen[]);
+neBEMGLOBAL int WeightingFieldSolutions(int NbWtFields, int NbPrimsWtField[],
+                                        int *PrimListWtField[],
+                                        double *WtFieldChDen[]);
 neBEMGLOBAL Point3D ReflectPrimitiveOnMirror(char Axis, int prim, Point3D srcpt,
                                              Point3D fieldpt, double distance,
                                              DirnCosn3D *DirCos);
@@ -469,6 +476,9 @@ neBEMGLOBAL double ****StgFastFXKnCh, ****StgFastFYKnCh, ****StgFastFZKnCh;
 // Create Fast volumes with potential and flux components
 neBEMGLOBAL int CreateFastVolPF(void);
 neBEMGLOBAL int CreateFastVolElePF(void);
+neBEMGLOBAL int UpdateFastVolPF(double dAssigned[], double dSolution[],
+                                double tol);
+neBEMGLOBAL void ResetFastVolUpdates(void);
 neBEMGLOBAL int CreateFastVolKnChPF(void);
 
 // Evaluate potential and flux components at globalPt using FAST algorithm
@@ -1924,6 +1924,8 @@ int neBEMSolve(void) {
   // and another with OptKnCh = 1. Subtraction of these two fast volumes will
   // provide us with the effect of KnCh.
   if (OptFastVol) {
+    // The tables are computed anew, discard pending charging-up updates.
+    ResetFastVolUpdates();
     int MaxXCells = BlkNbXCells[1];
     int MaxYCells = BlkNbYCells[1];
     int MaxZCells = BlkNbZCells[1];
@@ -2125,62 +2127,10 @@ int neBEMPF(Point3D *point, double *potential, Vector3D *field) {
   return (0);
 }  // neBEMPF ends
 
-// Actual preparation of the weighting field, including those related to
-// corresponding weighting field fast volumes.
-// The return value identifies the weighting field. Error: id < 0.
-// The list contains all primitives that are part of this particular
-// read-out group. These can come from several volumes, but it is
-// not anticipated that only some of the primitives of one volume
-// are listed.
-// Weighitng field boundary conditions are useful only when the inverted
-// matrix is available.
-// This state is assigned either after element discretization has been
-// completed or in a condition when we are looking for modifying only the
-// boundary condition for a device having same geometry (hence, the same
-// inverted influence coefficient matrix)
-int neBEMPrepareWeightingField(int nprim, int primlist[]) {
-  static int IdWtField = 0;
-
+// Primitive-averaged charge densities, fixed weighting field and fast
+// volume set-up for a weighting field whose solution is available.
+static int SetUpWeightingField(int IdWtField) {
   int dbgFn = 0;
-  int fstatus = 0;
-
-  if (neBEMState < 7) {
-    printf(
-        "neBEMPrepareWeightingField: Weighting computations only meaningful "
-        "beyond neBEMState 7 ...\n");
-    return -1;
-  }
-
-  // Find first free slot
-  const int MaxWtField =
-      MAXWtFld;  // used also while deallocating these memories
-  if (WtFieldChDen == NULL)
-    WtFieldChDen = (double **)malloc(MaxWtField * sizeof(double *));
-  if (AvWtChDen == NULL)
-    AvWtChDen = (double **)malloc(MaxWtField * sizeof(double *));
-
-  ++IdWtField;
-  if (IdWtField >= MaxWtField) {
-    printf(
-        "neBEMPrepareWeightingField: reached MaxWtField (%d) weighting "
-        "fields.\n",
-        MAXWtFld);
-    return -1;
-  } else {
-    printf("\nPreparing weighting field for %d-th set.\n", IdWtField);
-  }  // else within MaxWtField
-
-  // Allocate a new column to store this solution set
-  WtFieldChDen[IdWtField] = (double *)malloc((NbElements + 2) * sizeof(double));
-  AvWtChDen[IdWtField] = (double *)malloc((NbPrimitives + 2) * sizeof(double));
-
-  fstatus = WeightingFieldSolution(nprim, primlist, WtFieldChDen[IdWtField]);
-  if (fstatus) {
-    neBEMMessage("neBEMPrepareWeightingField - WeightingFieldSolution");
-    return -1;
-  } else {
-    printf("Computed weighting field solution\n");
-  }
 
   // estimate primitive related avrg wt field charge densities
   // OMPCheck - may be parallelized
@@ -2484,7 +2434,7 @@ int neBEMPrepareWeightingField(int nprim, int primlist[]) {
     }  // if OptStaggerWtFldFastVol
 
     if (OptCreateWtFldFastPF[IdWtField]) {
-      fstatus = CreateWtFldFastVolPF(IdWtField);
+      CreateWtFldFastVolPF(IdWtField);
 
       clock_t stopFastClock = clock();
       neBEMTimeElapsed(startFastClock, stopFastClock);
@@ -2580,9 +2530,101 @@ int neBEMPrepareWeightingField(int nprim, int primlist[]) {
     }  // if OptReadWtFldFastPF
   }    // if OptWtFldFastVol
 
+  return 0;
+}  // SetUpWeightingField ends
+
+// Actual preparation of the weighting field, including those related to
+// corresponding weighting field fast volumes.
+// The return value identifies the weighting field. Error: id < 0.
+// The list contains all primitives that are part of this particular
+// read-out group. These can come from several volumes, but it is
+// not anticipated that only some of the primitives of one volume
+// are listed.
+// Weighitng field boundary conditions are useful only when the inverted
+// matrix is available.
+// This state is assigned either after element discretization has been
+// completed or in a condition when we are looking for modifying only the
+// boundary condition for a device having same geometry (hence, the same
+// inverted influence coefficient matrix)
+int neBEMPrepareWeightingField(int nprim, int primlist[]) {
+  int IdWtField = -1;
+  if (neBEMPrepareWeightingFields(1, &nprim, &primlist, &IdWtField) != 0) {
+    return -1;
+  }
   return IdWtField;
 }  // neBEMPrepareWeightingField ends
 
+// Preparation of several weighting fields at once. The right-hand sides of
+// all read-out groups are solved against the inverted matrix in a single
+// pass. The identifiers are returned in IdWtFields (-1 for failures).
+int neBEMPrepareWeightingFields(int nfield, int nprim[], int *primlist[],
+                                int IdWtFields[]) {
+  static int IdWtField = 0;
+
+  for (int field = 0; field < nfield; ++field) IdWtFields[field] = -1;
+  if (neBEMState < 7) {
+    printf(
+        "neBEMPrepareWeightingFields: Weighting computations only meaningful "
+        "beyond neBEMState 7 ...\n");
+    return -1;
+  }
+  if (nfield < 1) return 0;
+
+  // Find first free slot
+  const int MaxWtField =
+      MAXWtFld;  // used also while deallocating these memories
+  if (WtFieldChDen == NULL)
+    WtFieldChDen = (double **)malloc(MaxWtField * sizeof(double *));
+  if (AvWtChDen == NULL)
+    AvWtChDen = (double **)malloc(MaxWtField * sizeof(double *));
+
+  // Assign an identifier to each set and allocate a column to store its
+  // solution.
+  int nset = 0;
+  for (int field = 0; field < nfield; ++field) {
+    if (IdWtField + 1 >= MaxWtField) {
+      printf(
+          "neBEMPrepareWeightingFields: reached MaxWtField (%d) weighting "
+          "fields.\n",
+          MAXWtFld);
+      break;
+    }
+    ++IdWtField;
+    printf("\nPreparing weighting field for %d-th set.\n", IdWtField);
+    IdWtFields[field] = IdWtField;
+    WtFieldChDen[IdWtField] =
+        (double *)malloc((NbElements + 2) * sizeof(double));
+    AvWtChDen[IdWtField] =
+        (double *)malloc((NbPrimitives + 2) * sizeof(double));
+    ++nset;
+  }
+  if (nset == 0) return -1;
+
+  // Solve for all sets in one go.
+  double **solutions = (double **)malloc(nset * sizeof(double *));
+  for (int set = 0; set < nset; ++set) {
+    solutions[set] = WtFieldChDen[IdWtFields[set]];
+  }
+  int fstatus = WeightingFieldSolutions(nset, nprim, primlist, solutions);
+  free(solutions);
+  if (fstatus) {
+    neBEMMessage("neBEMPrepareWeightingFields - WeightingFieldSolutions");
+    for (int set = 0; set < nset; ++set) IdWtFields[set] = -1;
+    return -1;
+  } else {
+    printf("Computed weighting field solutions for %d sets\n", nset);
+  }
+
+  int status = nset < nfield ? -1 : 0;
+  for (int set = 0; set < nset; ++set) {
+    if (SetUpWeightingField(IdWtFields[set]) != 0) {
+      IdWtFields[set] = -1;
+      status = -1;
+    }
+  }
+  return status;
+}  // neBEMPrepareWeightingFields ends
+
 // Deallocates memory reserved for a weighting field
 void neBEMDeleteWeightingField(int IdWtField) {
   free(WtFieldChDen[IdWtField]);
@@ -2681,6 +2723,33 @@ double neBEMVolumeCharge(int volume) {
   return sumcharge;
 }  // end of neBEMVolumeCharge
 
+// Adds surface charge densities (dAssigned, indexed by element) to the
+// solved system, e.g. charges accumulated on dielectric surfaces during a
+// charging-up simulation. The inverted matrix is reused, so only the
+// influence of the new charges and a matrix-vector product are computed.
+// The fast volume is updated where the relative change exceeds tolerance.
+int neBEMChargingUp(double dAssigned[], double tolerance) {
+  if (neBEMState < 9) {
+    printf("neBEMChargingUp: no solution available (neBEMState %d).\n",
+           neBEMState);
+    return -1;
+  }
+
+  double *dSolution = dvector(1, NbUnknowns);
+  if (AddChargingUp(dAssigned, dSolution) != 0) {
+    neBEMMessage("neBEMChargingUp - AddChargingUp");
+    free_dvector(dSolution, 1, NbUnknowns);
+    return -1;
+  }
+  int fstatus = 0;
+  if (OptFastVol) {
+    fstatus = UpdateFastVolPF(dAssigned, dSolution, tolerance);
+    if (fstatus) neBEMMessage("neBEMChargingUp - UpdateFastVolPF");
+  }
+  free_dvector(dSolution, 1, NbUnknowns);
+  return fstatus == 0 ? 0 : -1;
+}  // neBEMChargingUp ends
+
 int neBEMEnd(void) {
   fprintf(fIsles,
           "IslesCntr: %d, ExactCntr: %d, FailureCntr: %d, ApproxCntr: %d\n",
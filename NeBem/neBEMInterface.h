@@ -113,6 +113,11 @@ INTFACEGLOBAL int neBEMPF(Point3D *, double *, Vector3D *);
 // the volume identifier is the argument
 INTFACEGLOBAL double neBEMVolumeCharge(int volume);
 
+// Adds the surface charge densities in dAssigned (indexed by element) to the
+// solution without solving the system again; the fast volume is refreshed
+// where the relative change exceeds the tolerance; returns 0 on success
+INTFACEGLOBAL int neBEMChargingUp(double dAssigned[], double tolerance);
+
 // Weighting field calculation preparation
 // arguments: number of primitives considered for this weighting field
 // computation and the related list; returns the identification tag for the
@@ -120,6 +125,14 @@ INTFACEGLOBAL double neBEMVolumeCharge(int volume);
 INTFACEGLOBAL int neBEMPrepareWeightingField(int NbPrimsWtField,
                                              int PrimListWtField[]);
 
+// Weighting field calculation preparation for several sets of primitives,
+// solved together; the identification tags are returned in IdWtFields
+// (-1 for sets that could not be prepared); returns 0 on success
+INTFACEGLOBAL int neBEMPrepareWeightingFields(int NbWtFields,
+                                              int NbPrimsWtField[],
+                                              int *PrimListWtField[],
+                                              int IdWtFields[]);
+
 // Deallocates memory reserved for a weighting field
 INTFACEGLOBAL void neBEMDeleteWeightingField(int IdWtField);
 
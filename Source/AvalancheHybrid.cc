@@ -0,0 +1,246 @@
+#include <cmath>
+#include <iostream>
+
+#include "Garfield/AvalancheHybrid.hh"
+#include "Garfield/Medium.hh"
+
+namespace Garfield {
+
+AvalancheHybrid::AvalancheHybrid(Sensor* sensor, AvalancheMicroscopic* mic,
+                                 AvalancheMC* mc)
+    : m_sensor(sensor), m_mic(mic), m_mc(mc) {}
+
+void AvalancheHybrid::SetSensor(Sensor* sensor) {
+  if (!sensor) {
+    std::cerr << m_className << "::SetSensor: Null pointer.\n";
+    return;
+  }
+  m_sensor = sensor;
+}
+
+void AvalancheHybrid::SetMicroscopic(AvalancheMicroscopic* mic) {
+  if (!mic) {
+    std::cerr << m_className << "::SetMicroscopic: Null pointer.\n";
+    return;
+  }
+  m_mic = mic;
+}
+
+void AvalancheHybrid::SetMC(AvalancheMC* mc) {
+  if (!mc) {
+    std::cerr << m_className << "::SetMC: Null pointer.\n";
+    return;
+  }
+  m_mc = mc;
+}
+
+void AvalancheHybrid::SetReducedFieldThreshold(const double eOverN) {
+  if (eOverN < 0.) {
+    std::cerr << m_className << "::SetReducedFieldThreshold:\n"
+              << "    Threshold must be non-negative.\n";
+    return;
+  }
+  m_eOverN = eOverN;
+}
+
+void AvalancheHybrid::SetHysteresis(const double h) {
+  if (h < 0. || h >= 1.) {
+    std::cerr << m_className << "::SetHysteresis:\n"
+              << "    Width must be in the range [0, 1).\n";
+    return;
+  }
+  m_hysteresis = h;
+}
+
+void AvalancheHybrid::AddMicroscopicRegion(
+    const double xmin, const double ymin, const double zmin,
+    const double xmax, const double ymax, const double zmax) {
+  if (xmin >= xmax || ymin >= ymax || zmin >= zmax) {
+    std::cerr << m_className << "::AddMicroscopicRegion:\n"
+              << "    Invalid box.\n";
+    return;
+  }
+  m_regions.push_back({xmin, ymin, zmin, xmax, ymax, zmax});
+}
+
+void AvalancheHybrid::SetHandoverEnergy(const double e) {
+  if (e <= 0.) {
+    std::cerr << m_className << "::SetHandoverEnergy:\n"
+              << "    Energy must be greater than zero.\n";
+    return;
+  }
+  m_energy = e;
+}
+
+void AvalancheHybrid::GetElectronEndpoint(const size_t i, double& x0,
+                                          double& y0, double& z0, double& t0,
+                                          double& x1, double& y1, double& z1,
+                                          double& t1, int& status) const {
+  if (i >= m_endPoints.size()) {
+    std::cerr << m_className << "::GetElectronEndpoint: Index out of range.\n";
+    return;
+  }
+  const auto& p = m_endPoints[i];
+  x0 = p.p0[0];
+  y0 = p.p0[1];
+  z0 = p.p0[2];
+  t0 = p.p0[3];
+  x1 = p.p1[0];
+  y1 = p.p1[1];
+  z1 = p.p1[2];
+  t1 = p.p1[3];
+  status = p.status;
+}
+
+bool AvalancheHybrid::AvalancheElectron(const double x, const double y,
+                                        const double z, const double t,
+                                        const double e, const double dx,
+                                        const double dy, const double dz) {
+  m_endPoints.clear();
+  m_nElectrons = 0;
+  m_nIons = 0;
+  m_nHandovers = 0;
+  if (!m_sensor || !m_mic || !m_mc) {
+    std::cerr << m_className << "::AvalancheElectron:\n"
+              << "    Sensor or transport classes not defined.\n";
+    return false;
+  }
+  // Make sure both transport classes add their signals to the same sensor.
+  m_mic->SetSensor(m_sensor);
+  m_mc->SetSensor(m_sensor);
+
+  // Decide which method to start with.
+  double ex = 0., ey = 0., ez = 0.;
+  Medium* medium = nullptr;
+  int status = 0;
+  m_sensor->ElectricField(x, y, z, ex, ey, ez, medium, status);
+  if (status != 0 || !medium) {
+    std::cerr << m_className << "::AvalancheElectron:\n"
+              << "    Starting point is not in a drift medium.\n";
+    return false;
+  }
+  const double emag = std::sqrt(ex * ex + ey * ey + ez * ez);
+
+  // Electrons waiting to be transported.
+  struct Seed {
+    std::array<double, 4> p0;  // Creation point.
+    std::array<double, 4> p;   // Starting point.
+    double e, dx, dy, dz;
+    bool microscopic;
+    // Number of handovers so far.
+    unsigned int n;
+  };
+  std::vector<Seed> stack;
+  stack.push_back({{x, y, z, t}, {x, y, z, t}, e, dx, dy, dz,
+                   IsMicroscopic(x, y, z, emag, medium), 0});
+
+  // Electron drift lines are stopped when crossing into the other regime,
+  // i. e. when leaving the hysteresis band around the threshold.
+  const double fLow = 1. - m_hysteresis;
+  const double fHigh = 1. + m_hysteresis;
+  m_mic->SetExitCondition([this, fLow](const double x1, const double y1,
+                                       const double z1, const double e1,
+                                       Medium* m1) {
+    return !IsMicroscopic(x1, y1, z1, e1, m1, fLow);
+  });
+  m_mc->SetExitCondition([this, fHigh](const double x1, const double y1,
+                                       const double z1, const double e1,
+                                       Medium* m1) {
+    return IsMicroscopic(x1, y1, z1, e1, m1, fHigh);
+  });
+
+  // Sort an electron coming out of one of the transport classes.
+  unsigned int nStopped = 0;
+  auto add = [&](const Seed& seed, const std::array<double, 4>& p0,
+                 const std::array<double, 4>& p1, int st) {
+    // Electrons started by this call keep their original creation point.
+    const bool primary = p0 == seed.p;
+    if (st == StatusHandedOver) {
+      const unsigned int n = primary ? seed.n + 1 : 1;
+      if (n <= m_maxHandovers) {
+        ++m_nHandovers;
+        stack.push_back({primary ? seed.p0 : p0, p1, m_energy, 0., 0., 0.,
+                         !seed.microscopic, n});
+        return;
+      }
+      // Stop electrons going back and forth between the two methods.
+      st = StatusCalculationAbandoned;
+      ++nStopped;
+    }
+    m_endPoints.push_back({primary ? seed.p0 : p0, p1, st});
+    if (st != StatusAttached) ++m_nElectrons;
+  };
+
+  bool ok = true;
+  while (!stack.empty()) {
+    const Seed seed = stack.back();
+    stack.pop_back();
+    if (seed.microscopic) {
+      if (m_debug) std::cout << m_className << ": Microscopic tracking.\n";
+      if (!m_mic->AvalancheElectron(seed.p[0], seed.p[1], seed.p[2],
+                                    seed.p[3], seed.e, seed.dx, seed.dy,
+                                    seed.dz)) {
+        ok = false;
+        break;
+      }
+      int ne = 0, ni = 0;
+      m_mic->GetAvalancheSize(ne, ni);
+      m_nIons += ni;
+      for (const auto& electron : m_mic->GetElectrons()) {
+        if (electron.path.empty()) continue;
+        const auto& q0 = electron.path.front();
+        const auto& q1 = electron.path.back();
+        add(seed, {q0.x, q0.y, q0.z, q0.t}, {q1.x, q1.y, q1.z, q1.t},
+            electron.status);
+      }
+    } else {
+      if (m_debug) std::cout << m_className << ": Monte Carlo drift.\n";
+      if (!m_mc->AvalancheElectron(seed.p[0], seed.p[1], seed.p[2],
+                                   seed.p[3], false)) {
+        ok = false;
+        break;
+      }
+      unsigned int ne = 0, ni = 0;
+      m_mc->GetAvalancheSize(ne, ni);
+      m_nIons += ni;
+      for (const auto& electron : m_mc->GetElectrons()) {
+        if (electron.path.empty()) continue;
+        const auto& q0 = electron.path.front();
+        const auto& q1 = electron.path.back();
+        add(seed, {q0.x, q0.y, q0.z, q0.t}, {q1.x, q1.y, q1.z, q1.t},
+            electron.status);
+      }
+    }
+  }
+  m_mic->UnsetExitCondition();
+  m_mc->UnsetExitCondition();
+  if (nStopped > 0) {
+    std::cerr << m_className << "::AvalancheElectron:\n"
+              << "    " << nStopped << " electron(s) stopped after "
+              << m_maxHandovers << " handovers.\n";
+  }
+  if (m_debug) {
+    std::cout << m_className << "::AvalancheElectron:\n"
+              << "    " << m_nElectrons << " electrons, " << m_nIons
+              << " ions, " << m_nHandovers << " handovers.\n";
+  }
+  return ok;
+}
+
+bool AvalancheHybrid::IsMicroscopic(const double x, const double y,
+                                    const double z, const double emag,
+                                    Medium* medium, const double scale) const {
+  for (const auto& r : m_regions) {
+    if (x >= r[0] && y >= r[1] && z >= r[2] &&
+        x <= r[3] && y <= r[4] && z <= r[5]) {
+      return true;
+    }
+  }
+  if (!medium) return false;
+  const double n = medium->GetNumberDensity();
+  if (n <= 0.) return false;
+  // 1 Td = 10^-17 V cm2.
+  return emag > scale * m_eOverN * 1.e-17 * n;
+}
+
+}  // namespace Garfield
@@ -1,12 +1,14 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <numeric>
 #include <string>
 
 #include "Garfield/AvalancheMC.hh"
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Numerics.hh"
 #include "Garfield/Random.hh"
 
@@ -74,6 +76,16 @@ void AvalancheMC::SetSensor(Sensor* sensor) {
   m_sensor = sensor;
 }
 
+void AvalancheMC::EnableSpaceCharge(ComponentSpaceCharge* sc,
+                                    const double dt) {
+  if (!sc) {
+    std::cerr << m_className << "::EnableSpaceCharge: Null pointer.\n";
+    return;
+  }
+  m_spaceCharge = sc;
+  m_spaceChargeInterval = std::max(dt, 0.);
+}
+
 void AvalancheMC::EnablePlotting(ViewDrift* view) {
   if (!view) {
     std::cerr << m_className << "::EnablePlotting: Null pointer.\n";
@@ -247,6 +259,7 @@ int AvalancheMC::DriftLine(const Point& p0, const Particle particle,
     std::vector<std::pair<Point, Particle> > & secondaries,
     const bool aval, const bool signal) {
 
+  GARFIELD_TIME(DriftLineMC);
   std::array<double, 3> x0 = {p0.x, p0.y, p0.z};
   double t0 = p0.t;
   // Make sure the starting point is inside an active region.
@@ -274,6 +287,8 @@ int AvalancheMC::DriftLine(const Point& p0, const Particle particle,
   const bool semiconductor = medium->IsSemiconductor();
 
   while (0 == status) {
+    // Stop at the end of the time slice (update of the space charge).
+    if (particle == Particle::Electron && t0 >= m_tStop) break;
     constexpr double tol = 1.e-10;
     // Make sure the electric field has a non-vanishing component.
     const double emag = Mag(e0);
@@ -460,6 +475,10 @@ int AvalancheMC::DriftLine(const Point& p0, const Particle particle,
     // Make sure the time is still within the specified interval.
     if (m_hasTimeWindow && (t1 < m_tMin || t1 > m_tMax)) {
       status = StatusOutsideTimeWindow;
+    } else if (particle == Particle::Electron && m_exitCondition &&
+               m_exitCondition(x1[0], x1[1], x1[2], Mag(e0), medium)) {
+      if (m_debug) std::cout << "    Handed over.\n";
+      status = StatusHandedOver;
     }
     // Add the point to the drift line.
     path.emplace_back(MakePoint(x1, t1));
@@ -648,37 +667,118 @@ bool AvalancheMC::TransportParticles(
 
   const bool signal = m_doSignal && (m_sensor->GetNumberOfElectrodes() > 0);
   std::vector<std::pair<Point, Particle> > secondaries; 
+  // Index of the drift line (in m_electrons) continued by an electron,
+  // -1 for particles which have not been transported yet.
+  std::vector<int> lines(particles.size(), -1);
+  std::vector<int> newLines;
+  // Positive and negative ions/holes produced so far (for the space charge).
+  std::vector<std::array<double, 4> > ions;
+  double tSpaceCharge = -std::numeric_limits<double>::max();
+  if (m_spaceCharge) m_spaceCharge->ClearCharges();
+  // With space charge, transport the electrons in time slices.
+  const bool slices = aval && m_spaceCharge && m_spaceChargeInterval > 0.;
+  m_tStop = std::numeric_limits<double>::max();
   while (!particles.empty()) {
-    for (const auto& particle : particles) {
+    // Have the charges been updated using the particles in the stack?
+    bool updated = false;
+    if (m_spaceCharge) {
+      // Earliest time of the electrons to be transported.
+      double t0 = std::numeric_limits<double>::max();
+      for (const auto& particle : particles) {
+        if (particle.second != Particle::Electron) continue;
+        t0 = std::min(t0, particle.first.t);
+      }
+      if (t0 < std::numeric_limits<double>::max() &&
+          t0 >= tSpaceCharge + m_spaceChargeInterval) {
+        tSpaceCharge = t0;
+        m_spaceCharge->ClearCharges();
+        for (const auto& ion : ions) {
+          m_spaceCharge->AddCharge(ion[0], ion[1], ion[2], ion[3]);
+        }
+        for (const auto& particle : particles) {
+          const auto& p = particle.first;
+          m_spaceCharge->AddCharge(p.x, p.y, p.z, Charge(particle.second));
+        }
+        updated = m_spaceCharge->Update();
+      }
+      if (slices) m_tStop = tSpaceCharge + m_spaceChargeInterval;
+      // Ions/holes are assumed not to move on the time scale of the
+      // electron avalanche.
+      for (const auto& particle : particles) {
+        if (particle.second == Particle::Electron) continue;
+        const auto& p = particle.first;
+        ions.push_back({p.x, p.y, p.z, Charge(particle.second)});
+      }
+    }
+    newLines.clear();
+    const size_t nParticles = particles.size();
+    for (size_t i = 0; i < nParticles; ++i) {
+      const auto& particle = particles[i];
       if (!withE && particle.second == Particle::Electron) continue;
       if (!withH && particle.second != Particle::Electron) continue;
+      if (particle.second == Particle::Electron && 
+          particle.first.t >= m_tStop) {
+        // Wait until the other electrons have reached the end of the slice.
+        newLines.resize(secondaries.size(), -1);
+        secondaries.push_back(particle);
+        newLines.push_back(lines[i]);
+        continue;
+      }
+      if (updated) {
+        // Leave out the particle's own charge.
+        const auto& p = particle.first;
+        m_spaceCharge->ExcludeCharge(p.x, p.y, p.z, Charge(particle.second));
+      }
       std::vector<Point> path; 
       const int status = DriftLine(particle.first, particle.second, 
                                    path, secondaries, aval, signal);
+      if (updated) m_spaceCharge->IncludeAllCharges();
       if (path.empty()) continue;
-      EndPoint p;
-      p.status = status;
-      if (m_storeDriftLines) {
-        p.path = std::move(path);
+      if (lines[i] >= 0) {
+        // Append to the drift line of the previous time slice.
+        EndPoint& p = m_electrons[lines[i]];
+        p.status = status;
+        if (m_storeDriftLines) {
+          p.path.insert(p.path.end(), path.begin() + 1, path.end());
+        } else {
+          p.path.back() = path.back();
+        }
       } else {
-        p.path = {path.front(), path.back()};
+        EndPoint p;
+        p.status = status;
+        if (m_storeDriftLines) {
+          p.path = std::move(path);
+        } else {
+          p.path = {path.front(), path.back()};
+        }
+        if (particle.second == Particle::Electron) {
+          m_electrons.push_back(std::move(p));
+        } else if (particle.second == Particle::Hole) {
+          m_holes.push_back(std::move(p));
+        } else if (particle.second == Particle::Ion) {
+          m_ions.push_back(std::move(p));
+        } else if (particle.second == Particle::NegativeIon) {
+          m_negativeIons.push_back(std::move(p));
+        } else {
+          std::cerr << m_className 
+                    << "::TransportParticles: Unexpected particle type.\n";
+        }
       }
-      if (particle.second == Particle::Electron) {
-        m_electrons.push_back(std::move(p));
-      } else if (particle.second == Particle::Hole) {
-        m_holes.push_back(std::move(p));
-      } else if (particle.second == Particle::Ion) {
-        m_ions.push_back(std::move(p));
-      } else if (particle.second == Particle::NegativeIon) {
-        m_negativeIons.push_back(std::move(p));
-      } else {
-        std::cerr << m_className 
-                  << "::TransportParticles: Unexpected particle type.\n";
+      if (particle.second == Particle::Electron && status == StatusAlive) {
+        // Stopped at the end of the time slice.
+        const int line = lines[i] >= 0 ? lines[i] : m_electrons.size() - 1;
+        newLines.resize(secondaries.size(), -1);
+        secondaries.emplace_back(
+            std::make_pair(m_electrons[line].path.back(), particle.second));
+        newLines.push_back(line);
       }
     }
+    newLines.resize(secondaries.size(), -1);
     particles.swap(secondaries);
+    lines.swap(newLines);
     secondaries.clear();
   }
+  m_tStop = std::numeric_limits<double>::max();
   return true;
 }
 
@@ -722,18 +822,12 @@ bool AvalancheMC::GetVelocity(const Particle particle, Medium* medium,
   bool ok = false;
   if (m_useVelocityMap && 
       particle != Particle::Ion && particle != Particle::NegativeIon) {
-    // We assume there is only one component with a velocity map.
-    const auto nComponents = m_sensor->GetNumberOfComponents();
-    for (size_t i = 0; i < nComponents; ++i) {
-      auto cmp = m_sensor->GetComponent(i);
-      if (!cmp->HasVelocityMap()) continue;
-      if (particle == Particle::Electron) {
-        ok = cmp->ElectronVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
-      } else if (particle == Particle::Hole) {
-        ok = cmp->HoleVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
-      }
-      if (!ok) continue;
-      // Seems to have worked.
+    if (particle == Particle::Electron) {
+      ok = m_sensor->ElectronVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
+    } else if (particle == Particle::Hole) {
+      ok = m_sensor->HoleVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
+    }
+    if (ok) {
       if (m_debug) {
         std::cout << m_className << "::GetVelocity: Velocity at "
                   << PrintVec(x) << " = " << PrintVec(v) << "\n";
@@ -789,16 +883,10 @@ double AvalancheMC::GetAttachment(const Particle particle, Medium* medium,
                                   const std::array<double, 3>& b) const {
   double eta = 0.;
   if (m_useAttachmentMap) {
-    const auto nComponents = m_sensor->GetNumberOfComponents();
-    for (size_t i = 0; i < nComponents; ++i) {
-      auto cmp = m_sensor->GetComponent(i);
-      if (!cmp->HasAttachmentMap()) continue;
-      if (particle == Particle::Electron) {
-        if (!cmp->ElectronAttachment(x[0], x[1], x[2], eta)) continue;
-      } else {
-        if (!cmp->HoleAttachment(x[0], x[1], x[2], eta)) continue;
-      }
-      return eta;
+    if (particle == Particle::Electron) {
+      if (m_sensor->ElectronAttachment(x[0], x[1], x[2], eta)) return eta;
+    } else {
+      if (m_sensor->HoleAttachment(x[0], x[1], x[2], eta)) return eta;
     }
   }
   if (particle == Particle::Electron) {
@@ -815,16 +903,10 @@ double AvalancheMC::GetTownsend(const Particle particle, Medium* medium,
                                 const std::array<double, 3>& b) const {
   double alpha = 0.;
   if (m_useTownsendMap) {
-    const auto nComponents = m_sensor->GetNumberOfComponents();
-    for (size_t i = 0; i < nComponents; ++i) {
-      auto cmp = m_sensor->GetComponent(i);
-      if (!cmp->HasTownsendMap()) continue;
-      if (particle == Particle::Electron) {
-        if (!cmp->ElectronTownsend(x[0], x[1], x[2], alpha)) continue;
-      } else {
-        if (!cmp->HoleTownsend(x[0], x[1], x[2], alpha)) continue;
-      }
-      return alpha;
+    if (particle == Particle::Electron) {
+      if (m_sensor->ElectronTownsend(x[0], x[1], x[2], alpha)) return alpha;
+    } else {
+      if (m_sensor->HoleTownsend(x[0], x[1], x[2], alpha)) return alpha;
     }
   }
   if (particle == Particle::Electron) {
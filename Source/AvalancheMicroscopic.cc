@@ -2,10 +2,12 @@
 #include <cmath>
 #include <functional>
 #include <iostream>
+#include <limits>
 #include <string>
 
 #include "Garfield/AvalancheMicroscopic.hh"
 #include "Garfield/FundamentalConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Random.hh"
 
 namespace {
@@ -91,6 +93,99 @@ void RotationMatrix(double bx, double by, double bz, const double bmag,
   }
 }
 
+/// Time at which the energy e0 + (a1 + a2 t) t of an electron leaves the
+/// window [emin, emax] between t0 and t1, or -1 if it stays inside.
+double ExitTime(const double e0, const double a1, const double a2,
+                const double t0, const double t1,
+                const double emin, const double emax, bool& up) {
+  double tx = -1.;
+  if (emax < std::numeric_limits<double>::max()) {
+    // The energy is a convex function of time, so it crosses the upper
+    // edge (for the last time) at the larger root.
+    const double c = e0 - emax;
+    double tu = -1.;
+    if (a2 > 0.) {
+      const double d = a1 * a1 - 4. * a2 * c;
+      if (d >= 0.) tu = (-a1 + sqrt(d)) / (2. * a2);
+    } else if (a1 > 0.) {
+      tu = -c / a1;
+    }
+    if (tu >= 0. && tu <= t1) {
+      tx = std::max(tu, t0);
+      up = true;
+    }
+  }
+  if (emin > 0.) {
+    // The energy drops below the lower edge at the smaller root.
+    const double c = e0 - emin;
+    double tl = -1.;
+    if (a2 > 0.) {
+      const double d = a1 * a1 - 4. * a2 * c;
+      if (d > 0.) tl = (-a1 - sqrt(d)) / (2. * a2);
+    } else if (a1 < 0.) {
+      tl = -c / a1;
+    }
+    if (tl > t0 && tl <= t1 && (tx < 0. || tl < tx)) {
+      tx = tl;
+      up = false;
+    }
+  }
+  return tx;
+}
+
+/// Time at which the energy, given as a function of the flight time by
+/// f(t, dedt), first leaves the window [emin, emax] between t0 and t1,
+/// or -1 if it stays inside. The flight is followed from t0 in steps
+/// small enough (based on the local slope and curvature of the energy)
+/// not to step across an excursion out of the window and back.
+template <class F>
+double FirstExitTime(F f, const double t0, const double t1,
+                     const double emin, const double emax, double& eOut) {
+  // Smallest step (relative to the flight time).
+  const double hMin = 1.e-3 * (t1 - t0);
+  double t = t0;
+  double de = 0.;
+  double e = f(t, de);
+  // Estimate of the second derivative of the energy.
+  double d2 = 0.;
+  while (t < t1) {
+    // Largest step for which |de| h + d2 h^2 / 2 < gap / 2.
+    const double gap = std::min(e - emin, emax - e);
+    const double b = std::abs(de);
+    double h = t1 - t;
+    if (d2 > 0.) {
+      h = (sqrt(b * b + d2 * gap) - b) / d2;
+    } else if (b > 0.) {
+      h = 0.5 * gap / b;
+    }
+    h = std::min(std::max(h, hMin), t1 - t);
+    double deh = 0.;
+    const double eh = f(t + h, deh);
+    if (eh < emin || eh >= emax) {
+      // Locate the crossing by bisection.
+      double tIn = t;
+      double tOut = t + h;
+      eOut = eh;
+      for (unsigned int i = 0; i < 30; ++i) {
+        const double tm = 0.5 * (tIn + tOut);
+        const double em = f(tm, deh);
+        if (em < emin || em >= emax) {
+          tOut = tm;
+          eOut = em;
+        } else {
+          tIn = tm;
+        }
+      }
+      return tOut;
+    }
+    d2 = std::max(d2, std::abs(deh - de) / h);
+    t += h;
+    e = eh;
+    de = deh;
+  }
+  return -1.;
+}
+
 Garfield::AvalancheMicroscopic::Point MakePoint(
     const double x, const double y, const double z,  const double t, 
     const double energy, const double dx, const double dy, const double dz,
@@ -137,6 +232,16 @@ void AvalancheMicroscopic::SetSensor(Sensor* s) {
   m_sensor = s;
 }
 
+void AvalancheMicroscopic::EnableSpaceCharge(ComponentSpaceCharge* sc,
+                                             const double dt) {
+  if (!sc) {
+    std::cerr << m_className << "::EnableSpaceCharge: Null pointer.\n";
+    return;
+  }
+  m_spaceCharge = sc;
+  m_spaceChargeInterval = std::max(dt, 0.);
+}
+
 void AvalancheMicroscopic::EnablePlotting(ViewDrift* view,
                                           const size_t nColl) {
   if (!view) {
@@ -425,7 +530,8 @@ bool AvalancheMicroscopic::DriftElectron(
   std::vector<std::pair<Point, Particle> > particles;
   Point p = MakePoint(x, y, z, t, e, dx, dy, dz, 0);
   particles.emplace_back(std::make_pair(std::move(p), Particle::Electron));
-  return TransportElectrons(particles, false);
+  std::vector<double> weights(1, 1.);
+  return TransportElectrons(particles, weights, false);
 }
 
 bool AvalancheMicroscopic::AvalancheElectron(
@@ -435,7 +541,8 @@ bool AvalancheMicroscopic::AvalancheElectron(
   std::vector<std::pair<Point, Particle> > particles;
   Point p = MakePoint(x, y, z, t, e, dx, dy, dz, 0);
   particles.emplace_back(std::make_pair(std::move(p), Particle::Electron));
-  return TransportElectrons(particles, true);
+  std::vector<double> weights(1, 1.);
+  return TransportElectrons(particles, weights, true);
 }
 
 void AvalancheMicroscopic::AddElectron(
@@ -450,22 +557,27 @@ void AvalancheMicroscopic::AddElectron(
 
 bool AvalancheMicroscopic::ResumeAvalanche() {
   std::vector<std::pair<Point, Particle> > particles;
+  std::vector<double> weights;
   for (const auto& p : m_electrons) {
     if (p.status == StatusAlive || p.status == StatusOutsideTimeWindow) { 
       particles.emplace_back(std::make_pair(p.path.back(), Particle::Electron));
+      weights.push_back(p.weight);
     }
   }
   for (const auto& p : m_holes) {
     if (p.status == StatusAlive || p.status == StatusOutsideTimeWindow) { 
       particles.emplace_back(std::make_pair(p.path.back(), Particle::Hole));
+      weights.push_back(p.weight);
     }
   }
-  return TransportElectrons(particles, true);
+  return TransportElectrons(particles, weights, true);
 }
 
 bool AvalancheMicroscopic::TransportElectrons(
-    std::vector<std::pair<Point, Particle> >& particles, const bool aval) {
+    std::vector<std::pair<Point, Particle> >& particles,
+    std::vector<double>& weights, const bool aval) {
 
+  GARFIELD_TIME(MicroscopicTransport);
   // Clear the list of electrons, holes and photons.
   m_electrons.clear();
   m_holes.clear();
@@ -473,6 +585,7 @@ bool AvalancheMicroscopic::TransportElectrons(
 
   // Reset the particle counters.
   m_nElectrons = m_nHoles = m_nIons = 0;
+  m_wElectrons = m_wHoles = m_wIons = 0.;
 
   // Make sure that the sensor is defined.
   if (!m_sensor) {
@@ -532,71 +645,203 @@ bool AvalancheMicroscopic::TransportElectrons(
       }
     }
   }
+  weights.resize(particles.size(), 1.);
+  // Index of the drift line (in m_electrons or m_holes) continued by
+  // a particle, -1 for particles which have not been transported yet.
+  std::vector<int> lines(particles.size(), -1);
   std::vector<std::pair<Point, Particle> > newParticles;
+  std::vector<double> newWeights;
+  std::vector<int> newLines;
+  // Ions produced so far (for the space-charge field).
+  std::vector<std::array<double, 4> > ions;
+  double tSpaceCharge = -std::numeric_limits<double>::max();
+  if (m_spaceCharge) m_spaceCharge->ClearCharges();
+  // With space charge, transport the avalanche in time slices.
+  const bool slices = aval && m_spaceCharge && m_spaceChargeInterval > 0.;
+  m_tStop = std::numeric_limits<double>::max();
   while (!particles.empty()) {
+    // Have the charges been updated using the particles in the stack?
+    bool updated = false;
+    if (m_spaceCharge) {
+      updated = UpdateSpaceCharge(particles, weights, ions, tSpaceCharge);
+      if (slices) m_tStop = tSpaceCharge + m_spaceChargeInterval;
+    }
     newParticles.clear();
+    newWeights.clear();
+    newLines.clear();
     // Loop over the particles in the avalanche.
-    for (const auto& particle : particles) {
+    const size_t nParticles = particles.size();
+    for (size_t i = 0; i < nParticles; ++i) {
+      const auto& particle = particles[i];
+      const double w = weights[i];
       if (particle.second == Particle::Ion) {
         ++m_nIons;
+        m_wIons += w;
+        if (m_spaceCharge) {
+          const auto& p = particle.first;
+          ions.push_back({p.x, p.y, p.z, w});
+        }
         continue;
       }
       if (aval && m_sizeCut > 0 && m_nElectrons >= (int)m_sizeCut) { 
         newParticles.clear();
+        newWeights.clear();
+        newLines.clear();
         break;
       }
+      if (particle.first.t >= m_tStop) {
+        // Wait until the other particles have reached the end of the slice.
+        newParticles.push_back(particle);
+        newWeights.push_back(w);
+        newLines.push_back(lines[i]);
+        continue;
+      }
       const bool isHole = (particle.second == Particle::Hole);
+      if (updated) {
+        // Leave out the particle's own charge.
+        const auto& p = particle.first;
+        m_spaceCharge->ExcludeCharge(p.x, p.y, p.z, isHole ? w : -w);
+      }
       std::vector<Point> path;
       double pathLength = 0.;
       int status = 0;
       if (sc) {
-        status = TransportElectronSc(particle.first, isHole, aval, 
+        status = TransportElectronSc(particle.first, w, isHole, aval, 
                                      signal, path,
                                      newParticles, pathLength);
       } else if (useBfield) {
-        status = TransportElectronBfield(particle.first, isHole, aval, 
+        status = TransportElectronBfield(particle.first, w, isHole, aval, 
                                          signal, path,
                                          newParticles, pathLength);
       } else {
-        status = TransportElectron(particle.first, isHole, aval, signal, 
+        status = TransportElectron(particle.first, w, isHole, aval, signal, 
                                    path, newParticles, pathLength);
       }
-      if (isHole) {
-        Electron hole;
-        hole.status = status;
-        hole.path = std::move(path);
-        hole.pathLength = pathLength;
-        m_holes.push_back(std::move(hole));
-        if (status != StatusAttached) ++m_nHoles;
-      } else {
+      if (updated) m_spaceCharge->IncludeAllCharges();
+      // Secondaries inherit the weight of the primary.
+      newWeights.resize(newParticles.size(), w);
+      newLines.resize(newParticles.size(), -1);
+      auto& drift = isHole ? m_holes : m_electrons;
+      int line = lines[i];
+      if (line < 0) {
+        line = drift.size();
         Electron electron;
-        electron.status = status;
         electron.path = std::move(path);
-        electron.pathLength = pathLength;
-        m_electrons.push_back(std::move(electron));
-        if (status != StatusAttached) ++m_nElectrons;
+        electron.weight = w;
+        drift.push_back(std::move(electron));
+      } else {
+        // Append to the drift line of the previous time slice.
+        auto& previous = drift[line].path;
+        previous.insert(previous.end(), path.begin() + 1, path.end());
+      }
+      drift[line].status = status;
+      drift[line].pathLength += pathLength;
+      if (status == StatusAlive) {
+        // Stopped at the end of the time slice.
+        newParticles.emplace_back(
+            std::make_pair(drift[line].path.back(), particle.second));
+        newWeights.push_back(w);
+        newLines.push_back(line);
+      } else if (status != StatusAttached) {
+        if (isHole) {
+          ++m_nHoles;
+          m_wHoles += w;
+        } else {
+          ++m_nElectrons;
+          m_wElectrons += w;
+        }
       }
     }
     if (!aval) break;
+    if (m_superSize > 0) ThinParticles(newParticles, newWeights, newLines);
     particles.swap(newParticles);
+    weights.swap(newWeights);
+    lines.swap(newLines);
   }
+  m_tStop = std::numeric_limits<double>::max();
 
   // Calculate the induced charge.
   if (m_doInducedCharge) {
     for (const auto& p : m_electrons) {
-      m_sensor->AddInducedCharge(-1, p.path[0].x, p.path[0].y, p.path[0].z, 
+      m_sensor->AddInducedCharge(-p.weight, 
+                                 p.path[0].x, p.path[0].y, p.path[0].z, 
                                  p.path.back().x, p.path.back().y, p.path.back().z);
     }
     for (const auto& p : m_holes) {
-      m_sensor->AddInducedCharge(+1, p.path[0].x, p.path[0].y, p.path[0].z, 
+      m_sensor->AddInducedCharge(p.weight, 
+                                 p.path[0].x, p.path[0].y, p.path[0].z, 
                                  p.path.back().x, p.path.back().y, p.path.back().z);
     }
   }
   return true;
 }
 
+bool AvalancheMicroscopic::UpdateSpaceCharge(
+    const std::vector<std::pair<Point, Particle> >& particles,
+    const std::vector<double>& weights,
+    const std::vector<std::array<double, 4> >& ions, double& tLast) {
+
+  // Earliest time of the electrons/holes to be transported.
+  double t0 = std::numeric_limits<double>::max();
+  for (const auto& particle : particles) {
+    if (particle.second == Particle::Ion) continue;
+    t0 = std::min(t0, particle.first.t);
+  }
+  if (t0 == std::numeric_limits<double>::max()) return false;
+  if (t0 < tLast + m_spaceChargeInterval) return false;
+  tLast = t0;
+  m_spaceCharge->ClearCharges();
+  for (const auto& ion : ions) {
+    m_spaceCharge->AddCharge(ion[0], ion[1], ion[2], ion[3]);
+  }
+  const size_t nParticles = particles.size();
+  for (size_t i = 0; i < nParticles; ++i) {
+    const auto& p = particles[i].first;
+    const double q = particles[i].second == Particle::Electron ? -weights[i]
+                                                               : weights[i];
+    m_spaceCharge->AddCharge(p.x, p.y, p.z, q);
+  }
+  return m_spaceCharge->Update();
+}
+
+void AvalancheMicroscopic::ThinParticles(
+    std::vector<std::pair<Point, Particle> >& particles,
+    std::vector<double>& weights, std::vector<int>& lines) const {
+
+  // Count the new electrons and holes (ions are not transported,
+  // particles continuing a drift line in the next time slice are kept).
+  auto isNew = [&particles, &lines](const size_t i) {
+    return particles[i].second != Particle::Ion && lines[i] < 0;
+  };
+  size_t n = 0;
+  const size_t nParticles = particles.size();
+  for (size_t i = 0; i < nParticles; ++i) {
+    if (isNew(i)) ++n;
+  }
+  if (n <= m_superSize) return;
+  // Russian roulette with survival probability p.
+  const double p = double(m_superSize) / n;
+  const double scale = 1. / p;
+  size_t k = 0;
+  for (size_t i = 0; i < nParticles; ++i) {
+    if (isNew(i)) {
+      if (RndmUniform() >= p) continue;
+      weights[i] *= scale;
+    }
+    if (k != i) {
+      particles[k] = std::move(particles[i]);
+      weights[k] = weights[i];
+      lines[k] = lines[i];
+    }
+    ++k;
+  }
+  particles.resize(k);
+  weights.resize(k);
+  lines.resize(k);
+}
+
 int AvalancheMicroscopic::TransportElectron(const Point& p0,
-  const bool hole, const bool aval, const bool signal,
+  const double w, const bool hole, const bool aval, const bool signal,
   std::vector<Point>& path, 
   std::vector<std::pair<Point, Particle> >& newParticles,
   double& pathLength) {
@@ -650,8 +895,12 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
   }
   // Get the id number of the drift medium.
   auto mid = medium->GetId();
-  // Get the null-collision rate.
-  double fLim = medium->GetElectronNullCollisionRate(band);
+  // Get the null-collision rate and the energy window in which it is valid.
+  double eMin = 0.;
+  double eMax = std::numeric_limits<double>::max();
+  double fLim = m_useNullCollisionWindows ?
+      medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax) :
+      medium->GetElectronNullCollisionRate(band);
   if (fLim <= 0.) {
     std::cerr << m_className 
               << "::TransportElectron: Got null-collision rate <= 0.\n";
@@ -669,6 +918,12 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
   size_t nColl = 0;
   size_t nCollPlot = 0;
   while (1) {
+    // Stop at the end of the time slice (update of the space charge).
+    if (t >= m_tStop) {
+      status = StatusAlive;
+      break;
+    }
+
     // Make sure the kinetic energy exceeds the transport cut.
     if (en < m_deltaCut) {
       if (m_debug) std::cout << "    Kinetic energy below transport cut.\n";
@@ -677,7 +932,7 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
     }
 
     // Fill the energy distribution histogram.
-    if (hEnergy) hEnergy->Fill(en);
+    if (hEnergy) hEnergy->Fill(en, w);
 
     // Make sure the particle is within the specified time window.
     if (m_hasTimeWindow && (t < m_tMin || t > m_tMax)) {
@@ -696,7 +951,19 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
       }
       mid = medium->GetId();
       // Update the null-collision rate.
-      fLim = medium->GetElectronNullCollisionRate(band);
+      fLim = m_useNullCollisionWindows ?
+          medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax) :
+          medium->GetElectronNullCollisionRate(band);
+      if (fLim <= 0.) {
+        std::cerr << m_className 
+                  << "::TransportElectron: Got null-collision rate <= 0.\n";
+        status = StatusCalculationAbandoned;
+        break;
+      }
+      tLim = 1. / fLim;
+    } else if (m_useNullCollisionWindows && (en < eMin || en >= eMax)) {
+      // Energy has moved to another window.
+      fLim = medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax);
       if (fLim <= 0.) {
         std::cerr << m_className 
                   << "::TransportElectron: Got null-collision rate <= 0.\n";
@@ -723,12 +990,36 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
     // Determine the timestep.
     double dt = 0.;
     bool isNullCollision = true;
+    // Flag to stop at the window edge (no usable rate in the next window).
+    bool abandon = false;
     while (isNullCollision) {
       // Sample the flight time.
       const double r = RndmUniformPos();
-      dt += -log(r) * tLim;
+      const double dt1 = dt - log(r) * tLim;
+      if (m_useNullCollisionWindows) {
+        // If the energy leaves the current window during the flight, 
+        // stop at the window edge and continue sampling with the 
+        // null-collision rate of the adjacent window.
+        bool up = false;
+        const double tx = ExitTime(en, a1, a2, dt, dt1, eMin, eMax, up);
+        if (tx >= 0.) {
+          dt = tx;
+          const double e = up ? eMax : std::nextafter(eMin, 0.);
+          fLim = medium->GetElectronNullCollisionRateWindow(e, band, 
+                                                            eMin, eMax);
+          if (fLim <= 0.) {
+            std::cerr << m_className << "::TransportElectron:\n"
+                      << "    Got null-collision rate <= 0 at " << e
+                      << " eV (band " << band << ").\n";
+            abandon = true;
+            break;
+          }
+          tLim = 1. / fLim;
+          continue;
+        }
+      }
       // Calculate the energy after the proposed step.
-      en1 = std::max(en + (a1 + a2 * dt) * dt, Small);
+      en1 = std::max(en + (a1 + a2 * dt1) * dt1, Small);
       // Get the real collision rate at the updated energy.
       const double fReal = medium->GetElectronCollisionRate(en1, band);
       if (fReal <= 0.) {
@@ -740,7 +1031,6 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
       }
       if (fReal > fLim) {
         // Real collision rate is higher than null-collision rate.
-        dt += log(r) * tLim;
         // Increase the null collision rate and try again.
         std::cerr << m_className << "::TransportElectron: "
                   << "Increasing null-collision rate by 5%.\n";
@@ -748,10 +1038,20 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
         tLim = 1. / fLim;
         continue;
       }
+      dt = dt1;
+      GARFIELD_COUNT(FreeFlights);
+      ++m_nFlights;
       if (m_useNullCollisionSteps) break;
       // Check for real or null collision.
-      if (RndmUniform() <= fReal * tLim) isNullCollision = false;
+      if (RndmUniform() <= fReal * tLim) {
+        isNullCollision = false;
+      } else {
+        GARFIELD_COUNT(NullCollisions);
+        ++m_nNullCollisions;
+      }
     }
+    // Complete the flight up to the window edge before stopping.
+    if (abandon) en1 = std::max(en + (a1 + a2 * dt) * dt, Small);
 
     // Increase the collision counters.
     ++nColl;
@@ -808,10 +1108,16 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
       z1 = zc;
       if (m_debug) std::cout << "    Hit a plane.\n";
       status = StatusHitPlane;
+    } else if (!hole && m_exitCondition &&
+               m_exitCondition(x1, y1, z1, Mag(ex, ey, ez), medium)) {
+      if (m_debug) std::cout << "    Handed over.\n";
+      status = StatusHandedOver;
+    } else if (abandon) {
+      status = StatusCalculationAbandoned;
     }
 
     // If switched on, calculate the induced signal.
-    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole);
+    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole, w);
 
     // Update the coordinates.
     if (m_computePathLength) pathLength += Mag(x1 - x, y1 - y, z1 - z);
@@ -848,7 +1154,7 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
     // If activated, histogram the distance with respect to the
     // last collision.
     if (m_histDistance) {
-      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast);
+      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast, w);
     }
 
     if (m_userHandleCollision) {
@@ -867,7 +1173,7 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
         for (const auto& secondary : secondaries) {
           if (secondary.first == Particle::Electron) {
             const double esec = std::max(secondary.second, Small);
-            if (m_histSecondary) m_histSecondary->Fill(esec);
+            if (m_histSecondary) m_histSecondary->Fill(esec, w);
             // Add the secondary electron to the stack.
             newParticles.emplace_back(std::make_pair(
               MakePoint(x, y, z, t, esec), Particle::Electron));
@@ -1008,7 +1314,7 @@ int AvalancheMicroscopic::TransportElectron(const Point& p0,
 }
 
 int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
-  const bool hole, const bool aval, const bool signal,
+  const double w, const bool hole, const bool aval, const bool signal,
   std::vector<Point>& path, 
   std::vector<std::pair<Point, Particle> >& newParticles,
   double& pathLength) {
@@ -1101,6 +1407,12 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
   size_t nColl = 0;
   size_t nCollPlot = 0;
   while (1) {
+    // Stop at the end of the time slice (update of the space charge).
+    if (t >= m_tStop) {
+      status = StatusAlive;
+      break;
+    }
+
     // Make sure the kinetic energy exceeds the transport cut.
     if (en < m_deltaCut) {
       if (m_debug) std::cout << "    Kinetic energy below transport cut.\n";
@@ -1109,7 +1421,7 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
     }
 
     // Fill the energy distribution histogram.
-    if (hEnergy) hEnergy->Fill(en);
+    if (hEnergy) hEnergy->Fill(en, w);
 
     // Make sure the particle is within the specified time window.
     if (m_hasTimeWindow && (t < m_tMin || t > m_tMax)) {
@@ -1197,9 +1509,16 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
         tLim = 1. / fLim;
         continue;
       }
+      GARFIELD_COUNT(FreeFlights);
+      ++m_nFlights;
       if (m_useNullCollisionSteps) break;
       // Check for real or null collision.
-      if (RndmUniform() <= fReal * tLim) isNullCollision = false;
+      if (RndmUniform() <= fReal * tLim) {
+        isNullCollision = false;
+      } else {
+        GARFIELD_COUNT(NullCollisions);
+        ++m_nNullCollisions;
+      }
     }
 
     // Increase the collision counters.
@@ -1269,10 +1588,14 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
       z1 = zc;
       if (m_debug) std::cout << "    Hit a plane.\n";
       status = StatusHitPlane;
+    } else if (!hole && m_exitCondition &&
+               m_exitCondition(x1, y1, z1, Mag(ex, ey, ez), medium)) {
+      if (m_debug) std::cout << "    Handed over.\n";
+      status = StatusHandedOver;
     }
 
     // If switched on, calculate the induced signal.
-    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole);
+    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole, w);
 
     // Update the coordinates.
     if (m_computePathLength) pathLength += Mag(x1 - x, y1 - y, z1 - z);
@@ -1322,7 +1645,7 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
     // If activated, histogram the distance with respect to the
     // last collision.
     if (m_histDistance) {
-      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast);
+      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast, w);
     }
 
     if (m_userHandleCollision) {
@@ -1341,7 +1664,7 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
         for (const auto& secondary : secondaries) {
           if (secondary.first == Particle::Electron) {
             const double esec = std::max(secondary.second, Small);
-            if (m_histSecondary) m_histSecondary->Fill(esec);
+            if (m_histSecondary) m_histSecondary->Fill(esec, w);
             // Add the secondary electron to the stack.
             newParticles.emplace_back(std::make_pair(
               MakePoint(x, y, z, t, esec), Particle::Electron));
@@ -1483,7 +1806,7 @@ int AvalancheMicroscopic::TransportElectronBfield(const Point& p0,
 }
 
 int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
-  const bool hole, const bool aval, const bool signal,
+  const double w, const bool hole, const bool aval, const bool signal,
   std::vector<Point>& path, 
   std::vector<std::pair<Point, Particle> >& newParticles,
   double& pathLength) {
@@ -1533,8 +1856,13 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
   }
   // Get the id number of the drift medium.
   auto mid = medium->GetId();
-  // Get the null-collision rate.
-  double fLim = medium->GetElectronNullCollisionRate(band);
+  // Get the null-collision rate and the energy window in which it is valid.
+  double eMin = 0.;
+  double eMax = std::numeric_limits<double>::max();
+  int bandLim = band;
+  double fLim = m_useNullCollisionWindows ?
+      medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax) :
+      medium->GetElectronNullCollisionRate(band);
   if (fLim <= 0.) {
     std::cerr << m_className 
               << "::TransportElectron: Got null-collision rate <= 0.\n";
@@ -1552,6 +1880,12 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
   size_t nColl = 0;
   size_t nCollPlot = 0;
   while (1) {
+    // Stop at the end of the time slice (update of the space charge).
+    if (t >= m_tStop) {
+      status = StatusAlive;
+      break;
+    }
+
     // Make sure the kinetic energy exceeds the transport cut.
     if (en < m_deltaCut) {
       if (m_debug) std::cout << "    Kinetic energy below transport cut.\n";
@@ -1560,7 +1894,7 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
     }
 
     // Fill the energy distribution histogram.
-    if (hEnergy) hEnergy->Fill(en);
+    if (hEnergy) hEnergy->Fill(en, w);
 
     // Make sure the particle is within the specified time window.
     if (m_hasTimeWindow && (t < m_tMin || t > m_tMax)) {
@@ -1581,7 +1915,10 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
       // TODO!
       // sc = (medium->IsSemiconductor() && m_useBandStructure);
       // Update the null-collision rate.
-      fLim = medium->GetElectronNullCollisionRate(band);
+      bandLim = band;
+      fLim = m_useNullCollisionWindows ?
+          medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax) :
+          medium->GetElectronNullCollisionRate(band);
       if (fLim <= 0.) {
         std::cerr << m_className 
                   << "::TransportElectron: Got null-collision rate <= 0.\n";
@@ -1594,6 +1931,29 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
     // Initial velocity.
     double vx = 0., vy = 0., vz = 0.;
     en = medium->GetElectronEnergy(kx, ky, kz, vx, vy, vz, band);
+    if (m_useNullCollisionWindows &&
+        (band != bandLim || en < eMin || en >= eMax)) {
+      // Energy has moved to another window or band.
+      bandLim = band;
+      fLim = medium->GetElectronNullCollisionRateWindow(en, band, eMin, eMax);
+      if (fLim <= 0.) {
+        std::cerr << m_className 
+                  << "::TransportElectron: Got null-collision rate <= 0.\n";
+        status = StatusCalculationAbandoned;
+        break;
+      }
+      tLim = 1. / fLim;
+    }
+    // Energy after a free flight of duration tau, and its time derivative
+    // (the wave vector changes at the rate E SpeedOfLight).
+    auto energy = [&](const double tau, double& dedt) {
+      const double cdt = tau * SpeedOfLight;
+      double ux = 0., uy = 0., uz = 0.;
+      const double e = medium->GetElectronEnergy(
+          kx + ex * cdt, ky + ey * cdt, kz + ez * cdt, ux, uy, uz, band);
+      dedt = ux * ex + uy * ey + uz * ez;
+      return e;
+    };
 
     if (m_userHandleStep) {
       m_userHandleStep(x, y, z, t, en, kx, ky, kz, hole);
@@ -1604,10 +1964,34 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
     // Determine the timestep.
     double dt = 0.;
     bool isNullCollision = true;
+    // Flag to stop at the window edge (no usable rate in the next window).
+    bool abandon = false;
     while (isNullCollision) {
       // Sample the flight time.
       const double r = RndmUniformPos();
+      const double dt0 = dt;
       dt += -log(r) * tLim;
+      if (m_useNullCollisionWindows) {
+        // If the energy leaves the current window during the flight, 
+        // stop at the first crossing and continue sampling with the 
+        // null-collision rate of the adjacent window.
+        double eOut = 0.;
+        const double tx = FirstExitTime(energy, dt0, dt, eMin, eMax, eOut);
+        if (tx >= 0.) {
+          dt = tx;
+          fLim = medium->GetElectronNullCollisionRateWindow(
+              std::max(eOut, Small), band, eMin, eMax);
+          if (fLim <= 0.) {
+            std::cerr << m_className << "::TransportElectron:\n"
+                      << "    Got null-collision rate <= 0 at " << eOut
+                      << " eV (band " << band << ").\n";
+            abandon = true;
+            break;
+          }
+          tLim = 1. / fLim;
+          continue;
+        }
+      }
       // Calculate the energy after the proposed step.
       const double cdt = dt * SpeedOfLight;
       const double kx1 = kx + ex * cdt;
@@ -1636,9 +2020,16 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
         tLim = 1. / fLim;
         continue;
       }
+      GARFIELD_COUNT(FreeFlights);
+      ++m_nFlights;
       if (m_useNullCollisionSteps) break;
       // Check for real or null collision.
-      if (RndmUniform() <= fReal * tLim) isNullCollision = false;
+      if (RndmUniform() <= fReal * tLim) {
+        isNullCollision = false;
+      } else {
+        GARFIELD_COUNT(NullCollisions);
+        ++m_nNullCollisions;
+      }
     }
 
     // Increase the collision counters.
@@ -1699,10 +2090,16 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
       z1 = zc;
       if (m_debug) std::cout << "    Hit a plane.\n";
       status = StatusHitPlane;
+    } else if (!hole && m_exitCondition &&
+               m_exitCondition(x1, y1, z1, Mag(ex, ey, ez), medium)) {
+      if (m_debug) std::cout << "    Handed over.\n";
+      status = StatusHandedOver;
+    } else if (abandon) {
+      status = StatusCalculationAbandoned;
     }
 
     // If switched on, calculate the induced signal.
-    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole);
+    if (signal) AddSignal(x, y, z, t, x1, y1, z1, t1, hole, w);
 
     // Update the coordinates.
     if (m_computePathLength) pathLength += Mag(x1 - x, y1 - y, z1 - z);
@@ -1739,7 +2136,7 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
     // If activated, histogram the distance with respect to the
     // last collision.
     if (m_histDistance) {
-      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast);
+      FillDistanceHistogram(cstype, x, y, z, xLast, yLast, zLast, w);
     }
 
     if (m_userHandleCollision) {
@@ -1758,7 +2155,7 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
         for (const auto& secondary : secondaries) {
           if (secondary.first == Particle::Electron) {
             const double esec = std::max(secondary.second, Small);
-            if (m_histSecondary) m_histSecondary->Fill(esec);
+            if (m_histSecondary) m_histSecondary->Fill(esec, w);
             // Add the secondary electron to the stack.
             double kxs = 0., kys = 0., kzs = 0.;
             int bs = -1;
@@ -1786,8 +2183,10 @@ int AvalancheMicroscopic::TransportElectronSc(const Point& p0,
         }
         if (hole) {
           --m_nHoles;
+          m_wHoles -= w;
         } else {
           --m_nElectrons;
+          m_wElectrons -= w;
         }
         path.emplace_back(MakePoint(x, y, z, t, en, kx1, ky1, kz1, band));
         return StatusAttached;
@@ -1933,23 +2332,23 @@ void AvalancheMicroscopic::PlotCollision(const int cstype, const size_t did,
 
 void AvalancheMicroscopic::FillDistanceHistogram(const int cstype,
     const double x, const double y, const double z,
-    double& xLast, double& yLast, double& zLast) const {
+    double& xLast, double& yLast, double& zLast, const double w) const {
  
   for (const auto& htype : m_distanceHistogramType) {
     if (htype != cstype) continue;
     if (m_debug) std::cout << "    Filling distance histogram.\n";
     switch (m_distanceOption) {
       case 'x':
-        m_histDistance->Fill(xLast - x);
+        m_histDistance->Fill(xLast - x, w);
         break;
       case 'y':
-        m_histDistance->Fill(yLast - y);
+        m_histDistance->Fill(yLast - y, w);
         break;
       case 'z':
-        m_histDistance->Fill(zLast - z);
+        m_histDistance->Fill(zLast - z, w);
         break;
       case 'r':
-        m_histDistance->Fill(Mag(xLast - x, yLast - y, zLast - z));
+        m_histDistance->Fill(Mag(xLast - x, yLast - y, zLast - z), w);
         break;
     }
     xLast = x;
@@ -1962,9 +2361,9 @@ void AvalancheMicroscopic::FillDistanceHistogram(const int cstype,
 void AvalancheMicroscopic::AddSignal(
   const double x0, const double y0, const double z0, const double t0,
   const double x1, const double y1, const double z1, const double t1,
-  const bool hole) const {
+  const bool hole, const double w) const {
 
-  const int q = hole ? 1 : -1;
+  const double q = hole ? w : -w;
   m_sensor->AddSignal(q, t0, t1, x0, y0, z0, x1, y1, z1,
                       m_integrateWeightingField,
                       m_useWeightingPotential);
@@ -18,6 +18,7 @@ void Component::SetGeometry(Geometry* geo) {
     std::cerr << m_className << "::SetGeometry: Null pointer.\n";
     return;
   }
+  CheckFrozen("SetGeometry");
   m_geometry = geo;
 }
 
@@ -27,6 +28,7 @@ Medium* Component::GetMedium(const double x, const double y, const double z) {
 }
 
 void Component::Clear() {
+  CheckFrozen("Clear");
   m_geometry = nullptr;
   m_ready = false;
   // Reset periodicities.
@@ -98,6 +100,29 @@ double Component::DelayedWeightingPotential(const double /*x*/,
   return 0.;
 }
 
+void Component::DelayedWeightingFields(const double x, const double y,
+                                       const double z,
+                                       const std::vector<double>& ts,
+                                       std::vector<std::array<double, 3> >& ws,
+                                       const std::string& label) {
+  const size_t nt = ts.size();
+  ws.resize(nt);
+  for (size_t i = 0; i < nt; ++i) {
+    DelayedWeightingField(x, y, z, ts[i], ws[i][0], ws[i][1], ws[i][2], label);
+  }
+}
+
+void Component::DelayedWeightingPotentials(const double x, const double y,
+                                           const double z,
+                                           const std::vector<double>& ts,
+                                           std::vector<double>& ps,
+                                           const std::string& label) {
+  const size_t nt = ts.size();
+  ps.resize(nt);
+  for (size_t i = 0; i < nt; ++i) {
+    ps[i] = DelayedWeightingPotential(x, y, z, ts[i], label);
+  }
+}
 
 void Component::MagneticField(const double x, const double y, const double z,
                               double& bx, double& by, double& bz, int& status) {
@@ -114,9 +139,30 @@ void Component::MagneticField(const double x, const double y, const double z,
 
 void Component::SetMagneticField(const double bx, const double by,
                                  const double bz) {
+  CheckFrozen("SetMagneticField");
   m_b0 = {bx, by, bz};
 }
 
+bool Component::Freeze() {
+  if (!Prepare()) {
+    std::cerr << m_className << "::Freeze: Preparation failed.\n";
+    return false;
+  }
+  m_frozen = true;
+  return true;
+}
+
+void Component::CheckFrozen(const std::string& fcn) {
+  ++m_revision;
+  if (!m_frozen) return;
+  if (m_checkFrozen) {
+    std::cerr << m_className << "::" << fcn << ":\n"
+              << "    Component is modified after Freeze.\n"
+              << "    Concurrent queries are no longer safe.\n";
+  }
+  m_frozen = false;
+}
+
 bool Component::GetBoundingBox(double& xmin, double& ymin, double& zmin,
                                double& xmax, double& ymax, double& zmax) {
   if (!m_geometry) return false;
@@ -285,7 +285,7 @@ Medium* ComponentAnalyticField::GetMedium(const double xin, const double yin,
   if (m_geometry) return m_geometry->GetMedium(xin, yin, zin);
 
   // Make sure the cell is prepared.
-  if (!m_cellset && !Prepare()) return nullptr;
+  if (!m_cellset && !PrepareCell()) return nullptr;
 
   double xpos = xin, ypos = yin;
   if (m_polar) Cartesian2Internal(xin, yin, xpos, ypos);
@@ -335,7 +335,7 @@ Medium* ComponentAnalyticField::GetMedium(const double xin, const double yin,
 
 bool ComponentAnalyticField::GetVoltageRange(double& pmin, double& pmax) {
   // Make sure the cell is prepared.
-  if (!m_cellset && !Prepare()) {
+  if (!m_cellset && !PrepareCell()) {
     std::cerr << m_className << "::GetVoltageRange: Cell not set up.\n";
     return false;
   }
@@ -359,7 +359,7 @@ bool ComponentAnalyticField::GetBoundingBox(
 bool ComponentAnalyticField::GetElementaryCell(
     double& x0, double& y0, double& z0,
     double& x1, double& y1, double& z1) {
-  if (!m_cellset && !Prepare()) return false;
+  if (!m_cellset && !PrepareCell()) return false;
   if (m_polar) {
     double rmax, thetamax;
     Internal2Polar(m_xmax, m_ymax, rmax, thetamax);
@@ -380,7 +380,7 @@ bool ComponentAnalyticField::GetElementaryCell(
 
 double ComponentAnalyticField::StepSizeHint() {
 
-  if (!m_cellset && !Prepare()) return -1.;
+  if (!m_cellset && !PrepareCell()) return -1.;
   return m_dmin;
 }
 
@@ -390,7 +390,7 @@ void ComponentAnalyticField::PrintCell() {
   //-----------------------------------------------------------------------
 
   // Make sure the cell is prepared.
-  if (!m_cellset && !Prepare()) {
+  if (!m_cellset && !PrepareCell()) {
     std::cerr << m_className << "::PrintCell: Cell not set up.\n";
     return;
   }
@@ -975,6 +975,7 @@ void ComponentAnalyticField::AddWire(const double x, const double y,
   // Add the wire to the list.
   m_w.push_back(std::move(wire));
   ++m_nWires;
+  CheckFrozen("AddWire");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1017,6 +1018,7 @@ void ComponentAnalyticField::AddTube(const double radius, const double voltage,
   m_planes[4].type = label;
   m_planes[4].ind = -1;
 
+  CheckFrozen("AddTube");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1051,6 +1053,7 @@ void ComponentAnalyticField::AddPlaneX(const double x, const double v,
     m_planes[0].ind = -1;
   }
 
+  CheckFrozen("AddPlaneX");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1085,6 +1088,7 @@ void ComponentAnalyticField::AddPlaneY(const double y, const double v,
     m_planes[2].ind = -1;
   }
 
+  CheckFrozen("AddPlaneY");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1125,6 +1129,7 @@ void ComponentAnalyticField::AddPlaneR(const double r, const double v,
     m_planes[0].ind = -1;
   }
 
+  CheckFrozen("AddPlaneR");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1163,6 +1168,7 @@ void ComponentAnalyticField::AddPlanePhi(const double phi, const double v,
     }
   }
 
+  CheckFrozen("AddPlanePhi");
   // Add the identifier to the list of readout groups.
   if (!label.empty()) AddReadout(label, true);
   // Force recalculation of the capacitance and signal matrices.
@@ -1596,6 +1602,7 @@ void ComponentAnalyticField::AddPixelOnPlanePhi(
 
 void ComponentAnalyticField::EnableDipoleTerms(const bool on) {
 
+  CheckFrozen("EnableDipoleTerms");
   m_cellset = false;
   m_sigset = false;
   m_dipole = on;
@@ -2078,7 +2085,7 @@ bool ComponentAnalyticField::ForcesOnWire(
     const unsigned int iw, std::vector<double>& xMap, std::vector<double>& yMap,
     std::vector<std::vector<double> >& fxMap,
     std::vector<std::vector<double> >& fyMap) {
-  if (!m_cellset && !Prepare()) {
+  if (!m_cellset && !PrepareCell()) {
     std::cerr << m_className << "::ForcesOnWire: Cell not set up.\n";
     return false;
   }
@@ -2296,7 +2303,7 @@ bool ComponentAnalyticField::WireDisplacement(
     const unsigned int iw, const bool detailed, std::vector<double>& csag,
     std::vector<double>& xsag, std::vector<double>& ysag, double& stretch,
     const bool print) {
-  if (!m_cellset && !Prepare()) {
+  if (!m_cellset && !PrepareCell()) {
     std::cerr << m_className << "::WireDisplacement: Cell not set up.\n";
     return false;
   }
@@ -2464,7 +2471,7 @@ int ComponentAnalyticField::Field(const double xin, const double yin,
   ex = ey = ez = volt = 0.;
 
   // Make sure the charges have been calculated.
-  if (!m_cellset && !Prepare()) return -11;
+  if (!m_cellset && !PrepareCell()) return -11;
 
   double xpos = xin, ypos = yin;
   if (m_polar) Cartesian2Internal(xin, yin, xpos, ypos);
@@ -2751,6 +2758,13 @@ void ComponentAnalyticField::CellInit() {
 }
 
 bool ComponentAnalyticField::Prepare() {
+  if (!m_cellset && !PrepareCell()) return false;
+  if (!m_readout.empty() && !m_sigset && !PrepareSignals()) return false;
+  return true;
+}
+
+bool ComponentAnalyticField::PrepareCell() {
+  CheckFrozen("Prepare");
   std::lock_guard<std::mutex> guard(m_mutex);
   // Check that the cell makes sense.
   if (!CellCheck()) {
@@ -3831,6 +3845,7 @@ void ComponentAnalyticField::AddReadout(const std::string& label,
       std::cout << "      1 pixel\n";
     }
   }
+  CheckFrozen("AddReadout");
   m_sigset = false;
 }
 
@@ -3843,6 +3858,7 @@ void ComponentAnalyticField::SetNumberOfCellCopies(const unsigned int nf) {
     }
   }
   m_nFourier = nf;
+  CheckFrozen("SetNumberOfCellCopies");
   m_sigset = false;
 }
 
@@ -6165,11 +6181,12 @@ bool ComponentAnalyticField::PrepareSignals() {
     return false;
   }
 
-  if (!m_cellset && !Prepare()) {
+  if (!m_cellset && !PrepareCell()) {
     std::cerr << m_className << "::PrepareSignals: Cell not set up.\n";
     return false;
   }
 
+  CheckFrozen("PrepareSignals");
   std::lock_guard<std::mutex> guard(m_mutex);
 
   // If using natural periodicity, copy the cell type.
@@ -10611,7 +10628,7 @@ bool ComponentAnalyticField::MultipoleMoments(const unsigned int iw,
   //-----------------------------------------------------------------------
   //   EFMWIR - Computes the dipole moment of a given wire.
   //-----------------------------------------------------------------------
-  if (!m_cellset && !Prepare()) return false;
+  if (!m_cellset && !PrepareCell()) return false;
   // Check input parameters.
   if (iw >= m_nWires) {
     std::cerr << m_className << "::MultipoleMoments:\n"
@@ -428,7 +428,7 @@ bool ComponentAnsys121::Initialise(const std::string& elist,
   if (!LoadPotentials(prnsol, m_pot)) return false;
   // Set the ready flag.
   m_ready = true;
-  Prepare();
+  PrepareMesh();
   return true;
 }
 
@@ -449,7 +449,7 @@ bool ComponentAnsys123::Initialise(const std::string& elist,
   if (!LoadPotentials(prnsol, m_pot)) return false;
 
   m_ready = true;
-  Prepare();
+  PrepareMesh();
   return true;
 }
 
@@ -465,7 +465,7 @@ bool ComponentCST::Initialise(std::string elist, std::string nlist,
               << std::endl;
     return false;
   }
-  Prepare();
+  PrepareMesh();
   return true;
 }
 
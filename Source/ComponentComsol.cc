@@ -333,7 +333,7 @@ bool ComponentComsol::Initialise(const std::string &mesh,
   }
 
   m_ready = true;
-  Prepare();
+  PrepareMesh();
   std::cout << std::endl << m_className << "::Initialise: Done.\n";
   return true;
 }
@@ -274,7 +274,7 @@ bool ComponentElmer::Initialise(const std::string& header,
   m_ready = true;
   std::cout << hdr << " Finished.\n";
 
-  Prepare();
+  PrepareMesh();
   return true;
 }
 
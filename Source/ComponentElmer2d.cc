@@ -307,7 +307,7 @@ bool ComponentElmer2d::Initialise(const std::string& header,
   m_ready = true;
   std::cout << "    Finished.\n";
 
-  Prepare();
+  PrepareMesh();
   return true;
 }
 
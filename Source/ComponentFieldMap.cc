@@ -13,6 +13,7 @@
 #include <string>
 
 #include "Garfield/FundamentalConstants.hh"
+#include "Garfield/Instrumentation.hh"
 
 namespace Garfield {
 
@@ -872,6 +873,7 @@ int ComponentFieldMap::FindElement5(const double x, const double y,
                                     double& t1, double& t2,
                                     double& t3, double& t4, double jac[4][4],
                                     double& det) const {
+  GARFIELD_COUNT(FieldMapFindElement);
   // Backup
   double jacbak[4][4], detbak = 1.;
   double t1bak = 0., t2bak = 0., t3bak = 0., t4bak = 0.;
@@ -885,12 +887,13 @@ int ComponentFieldMap::FindElement5(const double x, const double y,
   int imap = -1;
   std::array<double, 8> xn;
   std::array<double, 8> yn;
-  const auto& elements = (m_useTetrahedralTree && m_octree) ? 
-      m_octree->GetElementsInBlock(Vec3(x, y, 0.)) :
-      m_elementIndices;
+  const auto elements = (m_useTetrahedralTree && m_octree) ?
+      m_octree->GetElementsInBlock(x, y) :
+      LinearTree::Span(m_elementIndices);
   for (const auto i : elements) {
     if (x < m_bbMin[i][0] || y < m_bbMin[i][1] ||
         x > m_bbMax[i][0] || y > m_bbMax[i][1]) continue;
+    GARFIELD_COUNT(FieldMapCandidates);
     const Element& element = m_elements[i];
     if (m_degenerate[i]) {
       // Degenerate element
@@ -941,6 +944,7 @@ int ComponentFieldMap::FindElement5(const double x, const double y,
   // In checking mode, verify the element count.
   if (m_checkMultipleElement) {
     if (nfound < 1) {
+      GARFIELD_COUNT(FieldMapNotFound);
       if (m_debug) {
         std::cout << m_className << "::FindElement5:\n"
                   << "    No element matching point (" << x << ", " << y
@@ -965,6 +969,7 @@ int ComponentFieldMap::FindElement5(const double x, const double y,
     return imap;
   }
 
+  GARFIELD_COUNT(FieldMapNotFound);
   if (m_debug) {
     std::cout << m_className << "::FindElement5:\n"
               << "    No element matching point (" << x << ", " << y
@@ -978,6 +983,7 @@ int ComponentFieldMap::FindElement13(
     double& t1, double& t2, double& t3, double& t4, 
     double jac[4][4], double& det) const {
 
+  GARFIELD_COUNT(FieldMapFindElement);
   // Backup
   double jacbak[4][4];
   double detbak = 1.;
@@ -993,13 +999,15 @@ int ComponentFieldMap::FindElement13(
   std::array<double, 10> xn;
   std::array<double, 10> yn;
   std::array<double, 10> zn;
-  const auto& elements = (m_useTetrahedralTree && m_octree) ? 
-      m_octree->GetElementsInBlock(Vec3(x, y, z)) : m_elementIndices;
+  const auto elements = (m_useTetrahedralTree && m_octree) ?
+      m_octree->GetElementsInBlock(x, y, z) :
+      LinearTree::Span(m_elementIndices);
   for (const auto i : elements) {
     if (x < m_bbMin[i][0] || y < m_bbMin[i][1] || z < m_bbMin[i][2] ||
         x > m_bbMax[i][0] || y > m_bbMax[i][1] || z > m_bbMax[i][2]) {
       continue;
     }
+    GARFIELD_COUNT(FieldMapCandidates);
     for (size_t j = 0; j < 10; ++j) {
       const auto& node = m_nodes[m_elements[i].emap[j]];
       xn[j] = node.x;
@@ -1034,6 +1042,7 @@ int ComponentFieldMap::FindElement13(
   // In checking mode, verify the tetrahedron/triangle count.
   if (m_checkMultipleElement) {
     if (nfound < 1) {
+      GARFIELD_COUNT(FieldMapNotFound);
       if (m_debug) {
         std::cout << m_className << "::FindElement13:\n"
                   << "    No element matching point (" 
@@ -1057,6 +1066,7 @@ int ComponentFieldMap::FindElement13(
     imap = imapbak;
     return imap;
   }
+  GARFIELD_COUNT(FieldMapNotFound);
   if (m_debug) {
     std::cout << m_className << "::FindElement13:\n"
               << "    No element matching point (" << x << ", " << y << ", "
@@ -1069,6 +1079,7 @@ int ComponentFieldMap::FindElementCube(const double x, const double y,
                                        const double z, double& t1, double& t2,
                                        double& t3, TMatrixD*& jac,
                                        std::vector<TMatrixD*>& dN) const {
+  GARFIELD_COUNT(FieldMapFindElement);
   int imap = -1;
   const size_t nElements = m_elements.size();
   for (size_t i = 0; i < nElements; ++i) {
@@ -1890,10 +1901,12 @@ int ComponentFieldMap::Coordinates13(
 
   // Start iteration.
   std::array<double, 4> td = {t1, t2, t3, t4};
+  GARFIELD_COUNT(NewtonSolves);
 
   // Loop
   bool converged = false;
   for (int iter = 0; iter < 10; ++iter) {
+    GARFIELD_COUNT(NewtonIterations);
     if (m_debug) {
       std::printf("    Iteration %4u: t = (%15.8f, %15.8f %15.8f %15.8f)\n",
                   iter, td[0], td[1], td[2], td[3]);
@@ -1960,6 +1973,7 @@ int ComponentFieldMap::Coordinates13(
 
   // No convergence reached.
   if (!converged) {
+    GARFIELD_COUNT(NewtonFailures);
     const double xmin = std::min({xn[0], xn[1], xn[2], xn[3]});
     const double xmax = std::max({xn[0], xn[1], xn[2], xn[3]});
     const double ymin = std::min({yn[0], yn[1], yn[2], yn[3]});
@@ -2118,7 +2132,18 @@ void ComponentFieldMap::Reset() {
   m_cacheElemBoundingBoxes = false;
 }
 
-void ComponentFieldMap::Prepare() {
+bool ComponentFieldMap::Prepare() {
+  if (!m_ready) {
+    PrintNotReady("Prepare");
+    return false;
+  }
+  // Issue the warnings now, rather than from concurrent queries.
+  if (m_warning) PrintWarning("Prepare");
+  return true;
+}
+
+void ComponentFieldMap::PrepareMesh() {
+  CheckFrozen("PrepareMesh");
   // Establish the ranges.
   SetRange();
   UpdatePeriodicity();
@@ -2128,7 +2153,9 @@ void ComponentFieldMap::Prepare() {
   std::cout << " done.\n";
   // Initialize the tetrahedral tree.
   if (InitializeTetrahedralTree()) {
-    std::cout << "    Initialized tetrahedral tree.\n";
+    std::cout << "    Initialized search tree ("
+              << m_octree->GetNumberOfLeaves() << " cells, "
+              << m_octree->GetMemoryUsage() / 1024 << " kB).\n";
   }
   m_elementIndices.resize(m_elements.size());
   std::iota(m_elementIndices.begin(), m_elementIndices.end(), 0);
@@ -2745,33 +2772,66 @@ bool ComponentFieldMap::InitializeTetrahedralTree() {
               << std::scientific << "\tz: " << zmin << " -> " << zmax << "\n";
   }
 
-  const double hx = 0.5 * (xmax - xmin);
-  const double hy = 0.5 * (ymax - ymin);
-  const double hz = 0.5 * (zmax - zmin);
-  m_octree.reset(new TetrahedralTree(Vec3(xmin + hx, ymin + hy, zmin + hz),
-                                     Vec3(hx, hy, hz)));
-
-  if (m_debug) std::cout << "    Tree instantiated.\n";
-
-  // Insert all mesh nodes in the tree
-  for (unsigned int i = 0; i < m_nodes.size(); i++) {
-    const Node& n = m_nodes[i];
-    m_octree->InsertMeshNode(Vec3(n.x, n.y, n.z), i);
+  std::vector<std::array<double, 3> > points;
+  points.reserve(m_nodes.size());
+  for (const auto& node : m_nodes) points.push_back({node.x, node.y, node.z});
+  m_octree.reset(new LinearTree(m_is3d ? 3 : 2));
+  m_octree->SetLeafSize(m_treeLeafSize);
+  if (!m_octree->Build({xmin, ymin, zmin}, {xmax, ymax, zmax}, points,
+                       m_bbMin, m_bbMax)) {
+    m_octree.reset(nullptr);
+    return false;
+  }
+  if (m_debug) {
+    std::cout << "    Tree with " << m_octree->GetNumberOfCells()
+              << " cells (" << m_octree->GetNumberOfLeaves() << " leaves), "
+              << m_octree->GetMemoryUsage() << " bytes.\n";
   }
+  return true;
+}
 
-  if (m_debug) std::cout << "    Tree nodes initialized successfully.\n";
+void ComponentFieldMap::GetElementsInPlane(
+    const double fx, const double fy, const double fz, const double d,
+    std::vector<size_t>& elems) const {
 
-  // Insert all mesh elements (tetrahedrons) in the tree
-  for (unsigned int i = 0; i < m_elements.size(); i++) {
-    const double bb[6] = {m_bbMin[i][0], m_bbMin[i][1], m_bbMin[i][2],
-                          m_bbMax[i][0], m_bbMax[i][1], m_bbMax[i][2]};
-    m_octree->InsertMeshElement(bb, i);
+  elems.clear();
+  const size_t nElements = m_elements.size();
+  if (m_bbMin.size() != nElements || m_bbMax.size() != nElements) {
+    // Bounding boxes are not available; return all elements.
+    elems.resize(nElements);
+    std::iota(elems.begin(), elems.end(), 0);
+    return;
+  }
+  auto crossed = [&](const size_t i) {
+    const auto& bbmin = m_bbMin[i];
+    const auto& bbmax = m_bbMax[i];
+    const double c = 0.5 * (fx * (bbmin[0] + bbmax[0]) + 
+                            fy * (bbmin[1] + bbmax[1]) +
+                            fz * (bbmin[2] + bbmax[2])) - d;
+    const double r = 0.5 * (std::abs(fx) * (bbmax[0] - bbmin[0]) + 
+                            std::abs(fy) * (bbmax[1] - bbmin[1]) +
+                            std::abs(fz) * (bbmax[2] - bbmin[2]));
+    return std::abs(c) <= r;
+  };
+  if (m_useTetrahedralTree && m_octree) {
+    // Collect the candidates from the blocks crossed by the plane.
+    std::vector<int> candidates;
+    m_octree->GetElementsInPlane(fx, fy, fz, d, candidates);
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    for (const auto i : candidates) {
+      if (crossed(i)) elems.push_back(i);
+    }
+    return;
+  }
+  for (size_t i = 0; i < nElements; ++i) {
+    if (crossed(i)) elems.push_back(i);
   }
-  return true;
 }
 
 void ComponentFieldMap::PrintWarning(const std::string& header) {
-  if (!m_warning || m_nWarnings > 10) return;
+  if (!m_warning || m_nWarnings > 10 || m_frozen) return;
   std::cerr << m_className << "::" << header << ":\n"
             << "    Warnings have been issued for this field map.\n";
   ++m_nWarnings;
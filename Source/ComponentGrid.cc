@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <array>
 #include <bitset>
 #include <cmath>
 #include <cstdio>
@@ -10,11 +11,11 @@
 
 #include "Garfield/ComponentGrid.hh"
 #include "Garfield/GarfieldConstants.hh"
-#include "Garfield/Utilities.hh"
+#include "Garfield/GridFile.hh"
 
 namespace {
 
-void PrintError(const std::string& fcn, const unsigned int line,
+void PrintError(const std::string& fcn, const size_t line,
                 const std::string& par) {
   std::cerr << fcn << ": Error reading line " << line << ".\n"
             << "    Could not read " << par << ".\n";
@@ -40,11 +41,12 @@ void PrintProgress(const double f) {
   std::cout << bar << "\r" << std::flush;
 }
 
-bool IsComment(const std::string& line) {
-  if (line.empty()) return false;
-  if (line[0] == '#') return true;
-  if (line.size() > 1 && (line[0] == '/' && line[1] == '/')) return true;
-  return false;
+// Convert a value read from an index column.
+unsigned int ToIndex(const double u) {
+  constexpr double nMax = std::numeric_limits<unsigned int>::max();
+  // Negative indices wrap around (as when reading an unsigned integer).
+  return u < 0. || u > nMax ? std::numeric_limits<unsigned int>::max()
+                            : static_cast<unsigned int>(u);
 }
 
 }  // namespace
@@ -189,6 +191,7 @@ double ComponentGrid::DelayedWeightingPotential(
 
 void ComponentGrid::SetWeightingFieldOffset(const double x, const double y,
                                             const double z) {
+  CheckFrozen("SetWeightingFieldOffset");
   m_wFieldOffset = {x, y, z};
 }
 
@@ -259,6 +262,7 @@ bool ComponentGrid::SetMesh(const unsigned int nx, const unsigned int ny,
                             const double xmax, const double ymin,
                             const double ymax, const double zmin,
                             const double zmax) {
+  CheckFrozen("SetMesh");
   Reset();
   if (nx == 0 || ny == 0 || nz == 0) {
     std::cerr << m_className << "::SetMesh:\n"
@@ -330,6 +334,7 @@ bool ComponentGrid::GetMesh(unsigned int& nx, unsigned int& ny,
 }
 
 void ComponentGrid::SetCylindricalCoordinates() {
+  CheckFrozen("SetCylindricalCoordinates");
 
   if (m_xMin[0] < 0. || m_xMax[0] < 0.) {
     std::cerr << m_className << "::SetCylindricalCoordinates:\n"
@@ -354,6 +359,7 @@ bool ComponentGrid::LoadElectricField(const std::string& fname,
                                       const bool withFlag, const double scaleX,
                                       const double scaleE,
                                       const double scaleP) {
+  CheckFrozen("LoadElectricField");
   m_efields.clear();
   m_hasPotential = false;
   m_active.assign(m_nX[0], std::vector<std::vector<bool> >(
@@ -374,6 +380,7 @@ bool ComponentGrid::LoadWeightingField(const std::string& fname,
                                        const std::string& fmt, const bool withP,
                                        const double scaleX, const double scaleE,
                                        const double scaleP) {
+  CheckFrozen("LoadWeightingField");
   // Read the file.
   if (!LoadData(fname, fmt, withP, false, scaleX, scaleE, scaleP, m_wfields)) {
     m_wfields.clear();
@@ -387,6 +394,7 @@ bool ComponentGrid::LoadWeightingField(const std::string& fname,
                                        const bool withP, const double scaleX,
                                        const double scaleE,
                                        const double scaleP) {
+  CheckFrozen("LoadWeightingField");
   std::vector<std::vector<std::vector<Node> > > wfield;
   // Read the file.
   if (!LoadData(fname, fmt, withP, false, scaleX, scaleE, scaleP, wfield)) {
@@ -408,6 +416,7 @@ bool ComponentGrid::LoadMagneticField(const std::string& fname,
                                       const std::string& fmt,
                                       const double scaleX,
                                       const double scaleB) {
+  CheckFrozen("LoadMagneticField");
   // Read the file.
   if (!LoadData(fname, fmt, false, false, scaleX, scaleB, 1., m_bfields)) {
     m_bfields.clear();
@@ -419,6 +428,7 @@ bool ComponentGrid::LoadMagneticField(const std::string& fname,
 bool ComponentGrid::SaveElectricField(Component* cmp,
                                       const std::string& filename,
                                       const std::string& format) {
+  CheckFrozen("SaveElectricField");
   if (!cmp) {
     std::cerr << m_className << "::SaveElectricField: Null pointer.\n";
     return false;
@@ -433,82 +443,29 @@ bool ComponentGrid::SaveElectricField(Component* cmp,
               << "    Unknown format (" << format << ").\n";
     return false;
   }
-  std::ofstream outfile;
-  outfile.open(filename, std::ios::out);
-  if (!outfile) {
-    std::cerr << m_className << "::SaveElectricField:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-  std::cout << m_className << "::SaveElectricField:\n"
-            << "    Exporting field/potential to " << filename << ".\n"
-            << "    Be patient...\n";
-  PrintProgress(0.);
-  outfile << "# XMIN = " << m_xMin[0] << ", XMAX = " << m_xMax[0] 
-          << ", NX = " << m_nX[0] << "\n";
-  outfile << "# YMIN = " << m_xMin[1] << ", YMAX = " << m_xMax[1] 
-          << ", NY = " << m_nX[1] << "\n";
-  outfile << "# ZMIN = " << m_xMin[2] << ", ZMAX = " << m_xMax[2] 
-          << ", NZ = " << m_nX[2] << "\n";
-
-  const unsigned int nValues = m_nX[0] * m_nX[1] * m_nX[2];
-  const unsigned int nPrint =
-      std::pow(10, static_cast<unsigned int>(
-                       std::max(std::floor(std::log10(nValues)) - 1, 1.)));
-  unsigned int nLines = 0;
   Medium* medium = nullptr;
   int status = 0;
-  const double dx = (m_xMax[0] - m_xMin[0]) / std::max(m_nX[0] - 1., 1.);
-  const double dy = (m_xMax[1] - m_xMin[1]) / std::max(m_nX[1] - 1., 1.);
-  const double dz = (m_xMax[2] - m_xMin[2]) / std::max(m_nX[2] - 1., 1.);
-  for (unsigned int i = 0; i < m_nX[0]; ++i) {
-    const double x = m_xMin[0] + i * dx;
-    for (unsigned int j = 0; j < m_nX[1]; ++j) {
-      const double y = m_xMin[1] + j * dy;
-      for (unsigned int k = 0; k < m_nX[2]; ++k) {
-        const double z = m_xMin[2] + k * dz;
-        if (fmt == Format::XY) {
-          outfile << x << "  " << y << "  ";
-        } else if (fmt == Format::XZ) {
-          outfile << x << "  " << z << "  ";
-        } else if (fmt == Format::XYZ) {
-          outfile << x << "  " << y << "  " << z << "  ";
-        } else if (fmt == Format::IJ) {
-          outfile << i << "  " << j << "  ";
-        } else if (fmt == Format::IK) {
-          outfile << i << "  " << k << "  ";
-        } else if (fmt == Format::IJK) {
-          outfile << i << "  " << j << "  " << k << "  ";
-        } else if (fmt == Format::YXZ) {
-          outfile << y << "  " << x << "  " << z << "  ";
-        }
-        if (m_coordinates == Coordinates::Cylindrical) {
-          const double ct = cos(y);
-          const double st = sin(y);
-          double ex = 0., ey = 0., ez = 0., v = 0.;
-          cmp->ElectricField(x * ct, x * st, z, ex, ey, ez, v, medium, status);
-          const double er = +ex * ct + ey * st;
-          const double et = -ex * st + ey * ct;
-          outfile << er << "  " << et << "  " << ez << "  " << v << "\n";
-        } else { 
-          double ex = 0., ey = 0., ez = 0., v = 0.;
-          cmp->ElectricField(x, y, z, ex, ey, ez, v, medium, status);
-          outfile << ex << "  " << ey << "  " << ez << "  " << v << "\n";
-        }
-        ++nLines;
-        if (nLines % nPrint == 0) PrintProgress(double(nLines) / nValues);
-      }
+  auto field = [&](const double x, const double y, const double z,
+                   double& fx, double& fy, double& fz, double& v) {
+    if (m_coordinates == Coordinates::Cylindrical) {
+      const double ct = cos(y);
+      const double st = sin(y);
+      double ex = 0., ey = 0.;
+      cmp->ElectricField(x * ct, x * st, z, ex, ey, fz, v, medium, status);
+      fx = +ex * ct + ey * st;
+      fy = -ex * st + ey * ct;
+    } else {
+      cmp->ElectricField(x, y, z, fx, fy, fz, v, medium, status);
     }
-  }
-  outfile.close();
-  std::cout << std::endl << m_className << "::SaveElectricField: Done.\n";
-  return true;
+  };
+  return Save(filename, fmt, field, m_className + "::SaveElectricField");
 }
 
 bool ComponentGrid::SaveWeightingField(Component* cmp,
                                        const std::string& id,
                                        const std::string& filename,
                                        const std::string& format) {
+  CheckFrozen("SaveWeightingField");
   if (!cmp) {
     std::cerr << m_className << "::SaveWeightingField: Null pointer.\n";
     return false;
@@ -523,23 +480,62 @@ bool ComponentGrid::SaveWeightingField(Component* cmp,
               << "    Unknown format (" << format << ").\n";
     return false;
   }
+  auto field = [&](const double x, const double y, const double z,
+                   double& fx, double& fy, double& fz, double& v) {
+    if (m_coordinates == Coordinates::Cylindrical) {
+      const double ct = cos(y);
+      const double st = sin(y);
+      double wx = 0., wy = 0.;
+      cmp->WeightingField(x * ct, x * st, z, wx, wy, fz, id);
+      v = cmp->WeightingPotential(x * ct, x * st, z, id);
+      fx = +wx * ct + wy * st;
+      fy = -wx * st + wy * ct;
+    } else {
+      cmp->WeightingField(x, y, z, fx, fy, fz, id);
+      v = cmp->WeightingPotential(x, y, z, id);
+    }
+  };
+  return Save(filename, fmt, field, m_className + "::SaveWeightingField");
+}
+
+bool ComponentGrid::Save(const std::string& filename, const Format fmt,
+                         FieldFunction field, const std::string& fcn) {
+  const bool binary = fmt == Format::Binary;
   std::ofstream outfile;
-  outfile.open(filename, std::ios::out);
-  if (!outfile) {
-    std::cerr << m_className << "::SaveWeightingField:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
+  GridFile gridfile;
+  if (binary) {
+    GridFile::Header header;
+    header.n = m_nX;
+    header.xmin = m_xMin;
+    header.xmax = m_xMax;
+    header.cylindrical = m_coordinates == Coordinates::Cylindrical;
+    header.withPotential = true;
+    if (!gridfile.Create(filename, header)) {
+      std::cerr << fcn << ":\n"
+                << "    Could not open file " << filename << ".\n";
+      return false;
+    }
+  } else {
+    outfile.open(filename, std::ios::out);
+    if (!outfile) {
+      std::cerr << fcn << ":\n"
+                << "    Could not open file " << filename << ".\n";
+      return false;
+    }
   }
-  std::cout << m_className << "::SaveWeightingField:\n"
+  std::cout << fcn << ":\n"
             << "    Exporting field/potential to " << filename << ".\n"
             << "    Be patient...\n";
   PrintProgress(0.);
-  outfile << "# XMIN = " << m_xMin[0] << ", XMAX = " << m_xMax[0] 
-          << ", NX = " << m_nX[0] << "\n";
-  outfile << "# YMIN = " << m_xMin[1] << ", YMAX = " << m_xMax[1] 
-          << ", NY = " << m_nX[1] << "\n";
-  outfile << "# ZMIN = " << m_xMin[2] << ", ZMAX = " << m_xMax[2] 
-          << ", NZ = " << m_nX[2] << "\n";
+  if (!binary) {
+    outfile << "# XMIN = " << m_xMin[0] << ", XMAX = " << m_xMax[0]
+            << ", NX = " << m_nX[0] << "\n";
+    outfile << "# YMIN = " << m_xMin[1] << ", YMAX = " << m_xMax[1]
+            << ", NY = " << m_nX[1] << "\n";
+    outfile << "# ZMIN = " << m_xMin[2] << ", ZMAX = " << m_xMax[2]
+            << ", NZ = " << m_nX[2] << "\n";
+  }
+
   const unsigned int nValues = m_nX[0] * m_nX[1] * m_nX[2];
   const unsigned int nPrint =
       std::pow(10, static_cast<unsigned int>(
@@ -548,12 +544,29 @@ bool ComponentGrid::SaveWeightingField(Component* cmp,
   const double dx = (m_xMax[0] - m_xMin[0]) / std::max(m_nX[0] - 1., 1.);
   const double dy = (m_xMax[1] - m_xMin[1]) / std::max(m_nX[1] - 1., 1.);
   const double dz = (m_xMax[2] - m_xMin[2]) / std::max(m_nX[2] - 1., 1.);
+  // Values in a plane of constant x (binary format).
+  const size_t nPlane = size_t(m_nX[1]) * m_nX[2];
+  std::array<std::vector<double>, 4> plane;
+  if (binary) {
+    for (auto& values : plane) values.resize(nPlane);
+  }
+  bool ok = true;
   for (unsigned int i = 0; i < m_nX[0]; ++i) {
     const double x = m_xMin[0] + i * dx;
     for (unsigned int j = 0; j < m_nX[1]; ++j) {
       const double y = m_xMin[1] + j * dy;
       for (unsigned int k = 0; k < m_nX[2]; ++k) {
         const double z = m_xMin[2] + k * dz;
+        double fx = 0., fy = 0., fz = 0., v = 0.;
+        field(x, y, z, fx, fy, fz, v);
+        if (binary) {
+          const size_t l = size_t(j) * m_nX[2] + k;
+          plane[0][l] = fx;
+          plane[1][l] = fy;
+          plane[2][l] = fz;
+          plane[3][l] = v;
+          continue;
+        }
         if (fmt == Format::XY) {
           outfile << x << "  " << y << "  ";
         } else if (fmt == Format::XZ) {
@@ -569,33 +582,36 @@ bool ComponentGrid::SaveWeightingField(Component* cmp,
         } else if (fmt == Format::YXZ) {
           outfile << y << "  " << x << "  " << z << "  ";
         }
-        if (m_coordinates == Coordinates::Cylindrical) {
-          const double ct = cos(y);
-          const double st = sin(y);
-          double wx = 0., wy = 0., wz = 0.;
-          cmp->WeightingField(x * ct, x * st, z, wx, wy, wz, id);
-          const double v = cmp->WeightingPotential(x * ct, x * st, z, id);
-          const double wr = +wx * ct + wy * st;
-          const double wt = -wx * st + wy * ct;
-          outfile << wr << "  " << wt << "  " << wz << "  " << v << "\n";
-        } else { 
-          double wx = 0., wy = 0., wz = 0.;
-          cmp->WeightingField(x, y, z, wx, wy, wz, id);
-          const double v = cmp->WeightingPotential(x, y, z, id);
-          outfile << wx << "  " << wy << "  " << wz << "  " << v << "\n";
-        }
+        outfile << fx << "  " << fy << "  " << fz << "  " << v << "\n";
         ++nLines;
         if (nLines % nPrint == 0) PrintProgress(double(nLines) / nValues);
       }
     }
+    if (binary) {
+      for (unsigned int q = 0; q < 4; ++q) {
+        if (!gridfile.Write(q, i * nPlane, plane[q])) ok = false;
+      }
+      if (!ok) break;
+      PrintProgress(double(i + 1) / m_nX[0]);
+    }
+  }
+  if (binary) {
+    if (!gridfile.Close()) ok = false;
+  } else {
+    outfile.close();
   }
-  outfile.close();
-  std::cout << std::endl << m_className << "::SaveWeightingField: Done.\n";
+  if (!ok) {
+    std::cerr << std::endl << fcn << ":\n"
+              << "    Error writing file " << filename << ".\n";
+    return false;
+  }
+  std::cout << std::endl << fcn << ": Done.\n";
   return true;
 }
 
 bool ComponentGrid::LoadMesh(const std::string& filename, std::string format,
                              const double scaleX) {
+  CheckFrozen("LoadMesh");
   const auto fmt = GetFormat(format);
   if (fmt == Format::Unknown) {
     std::cerr << m_className << "::LoadMesh:\n"
@@ -611,23 +627,7 @@ bool ComponentGrid::LoadMesh(const std::string& filename, std::string format,
   unsigned int nx = 0, ny = 0, nz = 0;
   bool cylindrical = (m_coordinates == Coordinates::Cylindrical);
   // Parse the comment lines in the file.
-  std::ifstream infile(filename);
-  if (!infile) {
-    std::cerr << m_className << "::LoadMesh:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-  std::string line;
-  unsigned int nLines = 0;
-  // Read the file line by line.
-  while (std::getline(infile, line)) {
-    ++nLines;
-    // Strip white space from the beginning of the line.
-    ltrim(line);
-    // Skip empty lines.
-    if (line.empty()) continue;
-    // Skip lines that are not comments.
-    if (!IsComment(line)) continue;
+  auto comment = [&](const size_t /*line*/, const std::string& line) {
     std::size_t pos0 = 0;
     std::size_t pos1 = line.find("=", pos0);
     while (pos1 != std::string::npos) {
@@ -669,8 +669,15 @@ bool ComponentGrid::LoadMesh(const std::string& filename, std::string format,
       pos0 = pos2 + 1;
       pos1 = line.find("=", pos0);
     }
+  };
+  auto skip = [](const size_t, const double*, const unsigned int) {
+    return true;
+  };
+  if (!GridFile::ReadTable(filename, 0, 0, skip, comment)) {
+    std::cerr << m_className << "::LoadMesh:\n"
+              << "    Could not open file " << filename << ".\n";
+    return false;
   }
-  infile.close();
 
   if (fmt == Format::XY || fmt == Format::IJ) {
     // Try to complement missing information on the z-range.
@@ -751,14 +758,6 @@ bool ComponentGrid::LoadMesh(const std::string& filename, std::string format,
     return false;
   }
 
-  unsigned int nValues = 0;
-  infile.open(filename, std::ios::in);
-  if (!infile) {
-    std::cerr << m_className << "::LoadMesh:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-
   if (!found[0]) xmin = std::numeric_limits<double>::max();
   if (!found[1]) ymin = std::numeric_limits<double>::max();
   if (!found[2]) zmin = std::numeric_limits<double>::max();
@@ -772,129 +771,54 @@ bool ComponentGrid::LoadMesh(const std::string& filename, std::string format,
   std::set<double, decltype(cmp)> xLines(cmp);
   std::set<double, decltype(cmp)> yLines(cmp);
   std::set<double, decltype(cmp)> zLines(cmp);
-  nLines = 0;
+  const std::array<double*, 3> lo = {{&xmin, &ymin, &zmin}};
+  const std::array<double*, 3> hi = {{&xmax, &ymax, &zmax}};
+  const std::array<unsigned int*, 3> nn = {{&nx, &ny, &nz}};
+  const std::array<decltype(xLines)*, 3> gridLines = {
+      {&xLines, &yLines, &zLines}};
+  // Last value inserted in each set.
+  std::array<double, 3> last;
+  last.fill(std::numeric_limits<double>::quiet_NaN());
+
+  unsigned int nCoordinates = 0;
+  bool indices = false;
+  std::array<unsigned int, 3> axes;
+  GetColumns(fmt, nCoordinates, indices, axes);
+  unsigned int nValues = 0;
   bool bad = false;
-  // Read the file line by line.
-  while (std::getline(infile, line)) {
-    ++nLines;
-    // Strip white space from the beginning of the line.
-    ltrim(line);
-    // Skip empty lines.
-    if (line.empty()) continue;
-    // Skip comments.
-    if (IsComment(line)) continue;
-    std::istringstream data(line);
-    if (fmt == Format::XY) {
-      double x, y;
-      data >> x >> y;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      if (!found[0]) xmin = std::min(x, xmin);
-      if (!found[1]) ymin = std::min(y, ymin);
-      if (!found[3]) xmax = std::max(x, xmax);
-      if (!found[4]) ymax = std::max(y, ymax);
-      xLines.insert(x);
-      yLines.insert(y);
-    } else if (fmt == Format::XZ) {
-      double x, z;
-      data >> x >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      z *= scaleX;
-      if (!found[0]) xmin = std::min(x, xmin);
-      if (!found[2]) zmin = std::min(z, zmin);
-      if (!found[3]) xmax = std::max(x, xmax);
-      if (!found[5]) zmax = std::max(z, zmax);
-      xLines.insert(x);
-      zLines.insert(z);
-    } else if (fmt == Format::XYZ) {
-      double x, y, z;
-      data >> x >> y >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (!found[0]) xmin = std::min(x, xmin);
-      if (!found[1]) ymin = std::min(y, ymin);
-      if (!found[2]) zmin = std::min(z, zmin);
-      if (!found[3]) xmax = std::max(x, xmax);
-      if (!found[4]) ymax = std::max(y, ymax);
-      if (!found[5]) zmax = std::max(z, zmax);
-      xLines.insert(x);
-      yLines.insert(y);
-      zLines.insert(z);
-    } else if (fmt == Format::IJ) {
-      unsigned int i = 0, j = 0;
-      data >> i >> j;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "indices");
-        bad = true;
-        break;
-      }
-      if (!found[6]) nx = std::max(nx, i);
-      if (!found[7]) ny = std::max(ny, j);
-    } else if (fmt == Format::IK) {
-      unsigned int i = 0, k = 0;
-      data >> i >> k;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "indices");
-        bad = true;
-        break;
-      }
-      if (!found[6]) nx = std::max(nx, i);
-      if (!found[8]) nz = std::max(nz, k);
-    } else if (fmt == Format::IJK) {
-      unsigned int i = 0, j = 0, k = 0;
-      data >> i >> j >> k;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "indices");
-        bad = true;
-        break;
-      }
-      if (!found[6]) nx = std::max(nx, i);
-      if (!found[7]) ny = std::max(ny, j);
-      if (!found[8]) nz = std::max(nz, k);
-    } else if (fmt == Format::YXZ) {
-      double x, y, z;
-      data >> y >> x >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadMesh", nLines, "coordinates");
-        bad = true;
-        break;
+  auto row = [&](const size_t line, const double* val, const unsigned int n) {
+    if (n < nCoordinates) {
+      PrintError(m_className + "::LoadMesh", line,
+                 indices ? "indices" : "coordinates");
+      bad = true;
+      return false;
+    }
+    for (unsigned int l = 0; l < nCoordinates; ++l) {
+      const unsigned int a = axes[l];
+      if (indices) {
+        if (!found[6 + a]) *nn[a] = std::max(*nn[a], ToIndex(val[l]));
+        continue;
       }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (!found[0]) xmin = std::min(x, xmin);
-      if (!found[1]) ymin = std::min(y, ymin);
-      if (!found[2]) zmin = std::min(z, zmin);
-      if (!found[3]) xmax = std::max(x, xmax);
-      if (!found[4]) ymax = std::max(y, ymax);
-      if (!found[5]) zmax = std::max(z, zmax);
-      xLines.insert(x);
-      yLines.insert(y);
-      zLines.insert(z);
+      const double x = val[l] * scaleX;
+      if (!found[a]) *lo[a] = std::min(x, *lo[a]);
+      if (!found[3 + a]) *hi[a] = std::max(x, *hi[a]);
+      // Consecutive lines often share a coordinate.
+      if (x != last[a]) gridLines[a]->insert(x);
+      last[a] = x;
     }
     ++nValues;
+    return true;
+  };
+  if (!GridFile::ReadTable(filename, nCoordinates, indices ? nCoordinates : 0,
+                           row)) {
+    if (!bad) {
+      std::cerr << m_className << "::LoadMesh:\n"
+                << "    Could not open file " << filename << ".\n";
+    }
+    return false;
   }
-  infile.close();
-  if (bad) return false;
 
-  if (fmt == Format::XY || fmt == Format::XYZ || 
-      fmt == Format::XZ || fmt == Format::YXZ) {
+  if (!indices) {
     if (!found[6]) nx = xLines.size();
     if (!found[7]) ny = yLines.size();
     if (!found[8]) nz = zLines.size();
@@ -941,6 +865,11 @@ bool ComponentGrid::LoadData(
     const bool withFlag, const double scaleX, const double scaleF,
     const double scaleP,
     std::vector<std::vector<std::vector<Node> > >& fields) {
+  const auto fmt = GetFormat(format);
+  if (fmt == Format::Binary) {
+    return LoadBinary(filename, withPotential, withFlag, scaleX, scaleF,
+                      scaleP, fields);
+  }
   if (!m_hasMesh) {
     if (!LoadMesh(filename, format, scaleX)) {
       std::cerr << m_className << "::LoadData: Mesh not set.\n";
@@ -948,7 +877,6 @@ bool ComponentGrid::LoadData(
     }
   }
 
-  const auto fmt = GetFormat(format);
   if (fmt == Format::Unknown) {
     std::cerr << m_className << "::LoadData:\n"
               << "    Unknown format (" << format << ").\n";
@@ -957,6 +885,10 @@ bool ComponentGrid::LoadData(
 
   // Set up the grid.
   Initialise(fields);
+  if (withFlag) {
+    m_active.assign(m_nX[0], std::vector<std::vector<bool> >(
+                                 m_nX[1], std::vector<bool>(m_nX[2], true)));
+  }
 
   unsigned int nValues = 0;
   // Keep track of which elements have been read.
@@ -964,185 +896,60 @@ bool ComponentGrid::LoadData(
       m_nX[0],
       std::vector<std::vector<bool> >(m_nX[1], std::vector<bool>(m_nX[2], false)));
 
-  std::ifstream infile(filename);
-  if (!infile) {
-    std::cerr << m_className << "::LoadData:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-
-  std::string line;
-  unsigned int nLines = 0;
+  unsigned int nCoordinates = 0;
+  bool indices = false;
+  std::array<unsigned int, 3> axes;
+  GetColumns(fmt, nCoordinates, indices, axes);
+  // Columns with the potential and the flag.
+  const unsigned int colP = 2 * nCoordinates;
+  const unsigned int colF = withPotential ? colP + 1 : colP;
+  const unsigned int nColumns = withFlag ? colF + 1 : colF;
   bool bad = false;
-  // Read the file line by line.
-  while (std::getline(infile, line)) {
-    ++nLines;
-    // Strip white space from beginning of line.
-    ltrim(line);
-    // Skip empty lines.
-    if (line.empty()) continue;
-    // Skip comments.
-    if (IsComment(line)) continue;
-    unsigned int i = 0;
-    unsigned int j = 0;
-    unsigned int k = 0;
-    double fx = 0.;
-    double fy = 0.;
-    double fz = 0.;
-    double p = 0.;
-    std::istringstream data(line);
-    if (fmt == Format::XY) {
-      double x, y;
-      data >> x >> y;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-    } else if (fmt == Format::XZ) {
-      double x, z;
-      data >> x >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      z *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[2] > 1) {
-        const double v = std::round((z - m_xMin[2]) * m_sX[2]);
-        k = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-    } else if (fmt == Format::XYZ) {
-      double x, y, z;
-      data >> x >> y >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-      if (m_nX[2] > 1) {
-        const double w = std::round((z - m_xMin[2]) * m_sX[2]);
-        k = w < 0. ? 0 : static_cast<unsigned int>(w);
-        if (k >= m_nX[2]) k = m_nX[2] - 1;
-      }
-    } else if (fmt == Format::IJ) {
-      data >> i >> j;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "indices");
-        bad = true;
-        break;
-      }
-    } else if (fmt == Format::IJK) {
-      data >> i >> j >> k;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "indices");
-        bad = true;
-        break;
-      }
-    } else if (fmt == Format::YXZ) {
-      double x, y, z;
-      data >> y >> x >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-      if (m_nX[2] > 1) {
-        const double w = std::round((z - m_xMin[2]) * m_sX[2]);
-        k = w < 0. ? 0 : static_cast<unsigned int>(w);
-        if (k >= m_nX[2]) k = m_nX[2] - 1;
-      }
+  auto row = [&](const size_t line, const double* val, const unsigned int n) {
+    if (n < nCoordinates) {
+      PrintError(m_className + "::LoadData", line,
+                 indices ? "indices" : "coordinates");
+      bad = true;
+      return false;
     }
+    std::array<unsigned int, 3> index;
+    GetIndices(fmt, val, scaleX, index);
+    const unsigned int i = index[0];
+    const unsigned int j = index[1];
+    const unsigned int k = index[2];
     // Check the indices.
     if (i >= m_nX[0] || j >= m_nX[1] || k >= m_nX[2]) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Index (" << i << ", " << j << ", " << k
                 << ") out of range.\n";
-      continue;
+      return true;
     }
     if (isSet[i][j][k]) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Node (" << i << ", " << j << ", " << k
                 << ") has already been set.\n";
-      continue;
+      return true;
     }
     // Get the field values.
-    if (fmt == Format::XY || fmt == Format::IJ) {
-      // Two-dimensional map.
-      fz = 0.;
-      data >> fx >> fy;
-    } else if (fmt == Format::XZ || fmt == Format::IK) {
-      // Two-dimensional map.
-      fy = 0.;
-      data >> fx >> fz;
-    } else if (fmt == Format::YXZ) {
-      data >> fy >> fx >> fz;
-    } else {
-      data >> fx >> fy >> fz;
-    }
-    if (data.fail()) {
-      PrintError(m_className + "::LoadData", nLines, "field components");
+    if (n < colP) {
+      PrintError(m_className + "::LoadData", line, "field components");
       bad = true;
-      break;
+      return false;
     }
-    fx *= scaleF;
-    fy *= scaleF;
-    fz *= scaleF;
+    std::array<double, 3> f = {{0., 0., 0.}};
+    for (unsigned int l = 0; l < nCoordinates; ++l) {
+      f[axes[l]] = val[nCoordinates + l] * scaleF;
+    }
+    double p = 0.;
     if (withPotential) {
-      data >> p;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "potential");
+      if (n <= colP) {
+        PrintError(m_className + "::LoadData", line, "potential");
         bad = true;
-        break;
+        return false;
       }
-      p *= scaleP;
+      p = val[colP] * scaleP;
       if (m_pMin > m_pMax) {
         // First value.
         m_pMin = p;
@@ -1154,45 +961,43 @@ bool ComponentGrid::LoadData(
     }
     int flag = 0;
     if (withFlag) {
-      data >> flag;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "region");
+      if (n <= colF) {
+        PrintError(m_className + "::LoadData", line, "region");
         bad = true;
-        break;
+        return false;
       }
+      flag = static_cast<int>(val[colF]);
     }
     const bool isActive = flag == 0 ? false : true;
+    auto set = [&](const unsigned int ii, const unsigned int jj,
+                   const unsigned int kk) {
+      fields[ii][jj][kk].fx = f[0];
+      fields[ii][jj][kk].fy = f[1];
+      fields[ii][jj][kk].fz = f[2];
+      fields[ii][jj][kk].v = p;
+      if (withFlag) m_active[ii][jj][kk] = isActive;
+      isSet[ii][jj][kk] = true;
+    };
     if (fmt == Format::XY || fmt == Format::IJ) {
       // Two-dimensional map.
-      for (unsigned int kk = 0; kk < m_nX[2]; ++kk) {
-        fields[i][j][kk].fx = fx;
-        fields[i][j][kk].fy = fy;
-        fields[i][j][kk].fz = fz;
-        fields[i][j][kk].v = p;
-        if (withFlag) m_active[i][j][kk] = isActive;
-        isSet[i][j][kk] = true;
-      }
+      for (unsigned int kk = 0; kk < m_nX[2]; ++kk) set(i, j, kk);
     } else if (fmt == Format::XZ || fmt == Format::IK) {
       // Two-dimensional map.
-      for (unsigned int jj = 0; jj < m_nX[1]; ++jj) {
-        fields[i][jj][k].fx = fx;
-        fields[i][jj][k].fy = fy;
-        fields[i][jj][k].fz = fz;
-        fields[i][jj][k].v = p;
-        if (withFlag) m_active[i][jj][k] = isActive;
-        isSet[i][jj][k] = true;
-      }
+      for (unsigned int jj = 0; jj < m_nX[1]; ++jj) set(i, jj, k);
     } else {
-      fields[i][j][k].fx = fx;
-      fields[i][j][k].fy = fy;
-      fields[i][j][k].fz = fz;
-      fields[i][j][k].v = p;
-      isSet[i][j][k] = true;
+      set(i, j, k);
     }
     ++nValues;
+    return true;
+  };
+  if (!GridFile::ReadTable(filename, nColumns, indices ? nCoordinates : 0,
+                           row)) {
+    if (!bad) {
+      std::cerr << m_className << "::LoadData:\n"
+                << "    Could not open file " << filename << ".\n";
+    }
+    return false;
   }
-  infile.close();
-  if (bad) return false;
   std::cout << m_className << "::LoadData:\n"
             << "    Read " << nValues << " values from " << filename << ".\n";
   unsigned int nExpected = m_nX[0];
@@ -1210,6 +1015,122 @@ bool ComponentGrid::LoadData(
   return true;
 }
 
+bool ComponentGrid::LoadBinary(
+    const std::string& filename, const bool withPotential,
+    const bool withFlag, const double scaleX, const double scaleF,
+    const double scaleP,
+    std::vector<std::vector<std::vector<Node> > >& fields) {
+  GridFile infile;
+  if (!infile.Open(filename)) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    Could not import " << filename << ".\n";
+    return false;
+  }
+  const auto& header = infile.GetHeader();
+  if (withPotential && !header.withPotential) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    " << filename << " does not contain potentials.\n";
+    return false;
+  }
+  if (withFlag && !header.withFlag) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    " << filename << " does not contain region flags.\n";
+    return false;
+  }
+  // Mesh limits in the file (the azimuth is not scaled).
+  const double sx = scaleX * header.scaleX;
+  const std::array<double, 3> sc = {sx, header.cylindrical ? 1. : sx, sx};
+  std::array<double, 3> xmin, xmax;
+  for (size_t i = 0; i < 3; ++i) {
+    xmin[i] = header.xmin[i] * sc[i];
+    xmax[i] = header.xmax[i] * sc[i];
+  }
+  const auto coordinates = header.cylindrical ? Coordinates::Cylindrical
+                                              : Coordinates::Cartesian;
+  if (!m_hasMesh) {
+    // Take the mesh from the file.
+    m_coordinates = coordinates;
+    if (!SetMesh(header.n[0], header.n[1], header.n[2], xmin[0], xmax[0],
+                 xmin[1], xmax[1], xmin[2], xmax[2])) {
+      std::cerr << m_className << "::LoadBinary: Mesh not set.\n";
+      return false;
+    }
+  } else {
+    bool match = header.n == m_nX && coordinates == m_coordinates;
+    for (size_t i = 0; i < 3; ++i) {
+      const double tol = 1.e-6 * std::max(m_xMax[i] - m_xMin[i], 1.e-10);
+      if (std::abs(xmin[i] - m_xMin[i]) > tol ||
+          std::abs(xmax[i] - m_xMax[i]) > tol) {
+        match = false;
+      }
+    }
+    if (!match) {
+      std::cerr << m_className << "::LoadBinary:\n"
+                << "    Mesh in " << filename << " (" << header.n[0] << " x "
+                << header.n[1] << " x " << header.n[2] << " nodes, "
+                << (header.cylindrical ? "cylindrical" : "Cartesian")
+                << " coordinates, [" << xmin[0] << ", " << xmax[0] << "] x ["
+                << xmin[1] << ", " << xmax[1] << "] x [" << xmin[2] << ", "
+                << xmax[2] << "]) does not match.\n";
+      return false;
+    }
+  }
+
+  // Set up the grid.
+  Initialise(fields);
+  if (withFlag) {
+    m_active.assign(m_nX[0], std::vector<std::vector<bool> >(
+                                 m_nX[1], std::vector<bool>(m_nX[2], true)));
+  }
+  const double* fx = infile.GetValues(0);
+  const double* fy = infile.GetValues(1);
+  const double* fz = infile.GetValues(2);
+  const double* v = withPotential ? infile.GetValues(3) : nullptr;
+  const int32_t* flags = withFlag ? infile.GetFlags() : nullptr;
+  const double sf = scaleF * header.scaleF;
+  const double sp = scaleP * header.scaleP;
+  const int nx = m_nX[0];
+  const size_t ny = m_nX[1];
+  const size_t nz = m_nX[2];
+  double pmin = std::numeric_limits<double>::max();
+  double pmax = std::numeric_limits<double>::lowest();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(min : pmin) \
+    reduction(max : pmax)
+#endif
+  for (int i = 0; i < nx; ++i) {
+    for (size_t j = 0; j < ny; ++j) {
+      auto& column = fields[i][j];
+      for (size_t k = 0; k < nz; ++k) {
+        const size_t l = (i * ny + j) * nz + k;
+        column[k].fx = fx[l] * sf;
+        column[k].fy = fy[l] * sf;
+        column[k].fz = fz[l] * sf;
+        if (v) {
+          const double p = v[l] * sp;
+          column[k].v = p;
+          pmin = std::min(pmin, p);
+          pmax = std::max(pmax, p);
+        }
+        if (flags) m_active[i][j][k] = flags[l] != 0;
+      }
+    }
+  }
+  if (withPotential) {
+    if (m_pMin > m_pMax) {
+      m_pMin = pmin;
+      m_pMax = pmax;
+    } else {
+      m_pMin = std::min(m_pMin, pmin);
+      m_pMax = std::max(m_pMax, pmax);
+    }
+  }
+  std::cout << m_className << "::LoadBinary:\n"
+            << "    Read " << infile.GetNumberOfNodes() << " values from "
+            << filename << ".\n";
+  return true;
+}
+
 bool ComponentGrid::GetBoundingBox(double& xmin, double& ymin, double& zmin,
                                    double& xmax, double& ymax, double& zmax) {
   if (m_efields.empty() && m_wfields.empty() && m_bfields.empty()) {
@@ -1310,6 +1231,7 @@ bool ComponentGrid::GetElectricFieldRange(double& exmin, double& exmax,
 }
 
 void ComponentGrid::SetMedium(Medium* m) {
+  CheckFrozen("SetMedium");
   if (!m) {
     std::cerr << m_className << "::SetMedium: Null pointer.\n";
   }
@@ -1580,6 +1502,7 @@ bool ComponentGrid::LoadElectronVelocity(const std::string& fname,
                                          const std::string& fmt,
                                          const double scaleX,
                                          const double scaleV) {
+  CheckFrozen("LoadElectronVelocity");
   // Read the file.
   if (!LoadData(fname, fmt, false, false, scaleX, scaleV, 1., m_eVelocity)) {
     return false;
@@ -1591,6 +1514,7 @@ bool ComponentGrid::LoadHoleVelocity(const std::string& fname,
                                      const std::string& fmt,
                                      const double scaleX,
                                      const double scaleV) {
+  CheckFrozen("LoadHoleVelocity");
   // Read the file.
   if (!LoadData(fname, fmt, false, false, scaleX, scaleV, 1., m_hVelocity)) {
     return false;
@@ -1626,6 +1550,7 @@ bool ComponentGrid::LoadElectronAttachment(const std::string& fname,
                                            const std::string& fmt, 
                                            const unsigned int col,
                                            const double scaleX) {
+  CheckFrozen("LoadElectronAttachment");
   // Read the file.
   return LoadData(fname, fmt, scaleX, m_eAttachment, col);
 }
@@ -1634,6 +1559,7 @@ bool ComponentGrid::LoadHoleAttachment(const std::string& fname,
                                        const std::string& fmt, 
                                        const unsigned int col,
                                        const double scaleX) {
+  CheckFrozen("LoadHoleAttachment");
   // Read the file.
   return LoadData(fname, fmt, scaleX, m_hAttachment, col);
 }
@@ -1642,6 +1568,12 @@ bool ComponentGrid::LoadData(
     const std::string& filename, std::string format, const double scaleX,
     std::vector<std::vector<std::vector<double> > >& tab, 
     const unsigned int col) {
+  const auto fmt = GetFormat(format);
+  if (fmt == Format::Binary) {
+    std::cerr << m_className << "::LoadData:\n"
+              << "    Binary files contain only field maps.\n";
+    return false;
+  }
   if (!m_hasMesh) {
     if (!LoadMesh(filename, format, scaleX)) {
       std::cerr << m_className << "::LoadData: Mesh not set.\n";
@@ -1649,29 +1581,21 @@ bool ComponentGrid::LoadData(
     }
   }
 
-  const auto fmt = GetFormat(format);
   if (fmt == Format::Unknown) {
     std::cerr << m_className << "::LoadData:\n"
               << "    Unknown format (" << format << ").\n";
     return false;
   }
+  unsigned int nCoordinates = 0;
+  bool indices = false;
+  std::array<unsigned int, 3> axes;
+  GetColumns(fmt, nCoordinates, indices, axes);
   // Check the column index.
-  unsigned int offset = 0;
-  if (fmt == Format::XY || fmt == Format::IJ) {
-    if (col < 2) {
-      std::cerr << m_className << "::LoadData:\n"
-                << "    Unexpected column index (" << col << ").\n";
-      return false; 
-    }
-    offset = 2;
-  } else {
-    if (col < 3) {
-      std::cerr << m_className << "::LoadData:\n"
-                << "    Unexpected column index (" << col << ").\n";
-      return false; 
-    }
-    offset = 3;
-  } 
+  if (col < nCoordinates) {
+    std::cerr << m_className << "::LoadData:\n"
+              << "    Unexpected column index (" << col << ").\n";
+    return false; 
+  }
 
   // Set up the grid.
   tab.assign(
@@ -1684,175 +1608,78 @@ bool ComponentGrid::LoadData(
       m_nX[0],
       std::vector<std::vector<bool> >(m_nX[1], std::vector<bool>(m_nX[2], false)));
 
-  std::ifstream infile(filename);
-  if (!infile) {
-    std::cerr << m_className << "::LoadData:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-
-  std::string line;
-  unsigned int nLines = 0;
   bool bad = false;
-  // Read the file line by line.
-  while (std::getline(infile, line)) {
-    ++nLines;
-    // Strip white space from beginning of line.
-    ltrim(line);
-    // Skip empty lines.
-    if (line.empty()) continue;
-    // Skip comments.
-    if (IsComment(line)) continue;
-    unsigned int i = 0;
-    unsigned int j = 0;
-    unsigned int k = 0;
-    double val = 0;
-    std::istringstream data(line);
-    if (fmt == Format::XY) {
-      double x, y;
-      data >> x >> y;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-         i = u < 0. ? 0 : static_cast<unsigned int>(u);
-         if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-    } else if (fmt == Format::XYZ) {
-      double x, y, z;
-      data >> x >> y >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v); 
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-      if (m_nX[2] > 1) {
-        const double w = std::round((z - m_xMin[2]) * m_sX[2]);
-        k = w < 0. ? 0 : static_cast<unsigned int>(w);
-        if (k >= m_nX[2]) k = m_nX[2] - 1;
-      }
-    } else if (fmt == Format::IJ) {
-      data >> i >> j;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "indices");
-        bad = true;
-        break;
-      }
-    } else if (fmt == Format::IJK) {
-      data >> i >> j >> k;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "indices");
-        bad = true;
-        break;
-      }
-    } else if (fmt == Format::YXZ) {
-      double x, y, z;
-      data >> y >> x >> z;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, "coordinates");
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      if (m_nX[0] > 1) {
-        const double u = std::round((x - m_xMin[0]) * m_sX[0]);
-        i = u < 0. ? 0 : static_cast<unsigned int>(u);
-        if (i >= m_nX[0]) i = m_nX[0] - 1;
-      }
-      if (m_nX[1] > 1) {
-        const double v = std::round((y - m_xMin[1]) * m_sX[1]);
-        j = v < 0. ? 0 : static_cast<unsigned int>(v);
-        if (j >= m_nX[1]) j = m_nX[1] - 1;
-      }
-      if (m_nX[2] > 1) {
-        const double w = std::round((z - m_xMin[2]) * m_sX[2]);
-        k = w < 0. ? 0 : static_cast<unsigned int>(w);
-        if (k >= m_nX[2]) k = m_nX[2] - 1;
-      }
+  auto row = [&](const size_t line, const double* val, const unsigned int n) {
+    if (n < nCoordinates) {
+      PrintError(m_className + "::LoadData", line,
+                 indices ? "indices" : "coordinates");
+      bad = true;
+      return false;
     }
+    std::array<unsigned int, 3> index;
+    GetIndices(fmt, val, scaleX, index);
+    const unsigned int i = index[0];
+    const unsigned int j = index[1];
+    const unsigned int k = index[2];
     // Check the indices.
     if (i >= m_nX[0] || j >= m_nX[1] || k >= m_nX[2]) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Index (" << i << ", " << j << ", " << k
                 << ") out of range.\n";
-      continue;
+      return true;
     }
     if (isSet[i][j][k]) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Node (" << i << ", " << j << ", " << k
                 << ") has already been set.\n";
-      continue;
+      return true;
     }
-
-    // Skip to the requested column.
-    for (unsigned int ii = 0; ii < col - offset; ++ii) {
-      double dummy = 0.;
-      data >> dummy;
-      if (data.fail()) {
-        PrintError(m_className + "::LoadData", nLines, 
-                   "column " + std::to_string(offset + ii));
-        break;
-      }
-    }
-    if (data.fail()) {
+    // Get the value in the requested column.
+    if (n <= col) {
+      PrintError(m_className + "::LoadData", line, 
+                 "column " + std::to_string(n));
       bad = true;
-      break;
-    }
-    data >> val;
-
-    if (data.fail()) {
-      PrintError(m_className + "::LoadData", nLines, 
-                 "column " + std::to_string(col));
-      bad = true;
-      break;
+      return false;
     }
-
+    const double value = val[col];
     if (fmt == Format::XY || fmt == Format::IJ) {
       // Two-dimensional map
       for (unsigned int kk = 0; kk < m_nX[2]; ++kk) {
-        tab[i][j][kk] = val;
+        tab[i][j][kk] = value;
         isSet[i][j][kk] = true;
       }
+    } else if (fmt == Format::XZ || fmt == Format::IK) {
+      // Two-dimensional map
+      for (unsigned int jj = 0; jj < m_nX[1]; ++jj) {
+        tab[i][jj][k] = value;
+        isSet[i][jj][k] = true;
+      }
     } else {
-      tab[i][j][k] = val;
+      tab[i][j][k] = value;
       isSet[i][j][k] = true;
     }
     ++nValues;
+    return true;
+  };
+  if (!GridFile::ReadTable(filename, col + 1, indices ? nCoordinates : 0,
+                           row)) {
+    if (!bad) {
+      std::cerr << m_className << "::LoadData:\n"
+                << "    Could not open file " << filename << ".\n";
+    }
+    return false;
   }
-  infile.close();
-  if (bad) return false;
   std::cout << m_className << "::LoadData:\n"
             << "    Read " << nValues << " values from " << filename << ".\n";
-  unsigned int nExpected = m_nX[0] * m_nX[1];
-  if (fmt == Format::XYZ || fmt == Format::IJK || fmt == Format::YXZ) {
+  unsigned int nExpected = m_nX[0];
+  if (fmt == Format::XY || fmt == Format::IJ) {
+    nExpected *= m_nX[1];
+  } else if (fmt == Format::XZ || fmt == Format::IK) {
     nExpected *= m_nX[2];
+  } else {
+    nExpected *= m_nX[1] * m_nX[2];
   }
   if (nExpected != nValues) {
     std::cerr << m_className << "::LoadData:\n"
@@ -1945,6 +1772,43 @@ bool ComponentGrid::HoleAttachment(const double x, const double y,
   return GetData(x, y, z, m_hAttachment, att);
 }
 
+void ComponentGrid::GetColumns(const Format fmt, unsigned int& nCoordinates,
+                               bool& indices,
+                               std::array<unsigned int, 3>& axes) {
+  nCoordinates = 3;
+  indices = fmt == Format::IJ || fmt == Format::IK || fmt == Format::IJK;
+  axes = {{0, 1, 2}};
+  if (fmt == Format::XY || fmt == Format::IJ) {
+    nCoordinates = 2;
+  } else if (fmt == Format::XZ || fmt == Format::IK) {
+    nCoordinates = 2;
+    axes[1] = 2;
+  } else if (fmt == Format::YXZ) {
+    axes = {{1, 0, 2}};
+  }
+}
+
+void ComponentGrid::GetIndices(const Format fmt, const double* val,
+                               const double scaleX,
+                               std::array<unsigned int, 3>& index) const {
+  unsigned int nCoordinates = 0;
+  bool indices = false;
+  std::array<unsigned int, 3> axes;
+  GetColumns(fmt, nCoordinates, indices, axes);
+  index.fill(0);
+  for (unsigned int l = 0; l < nCoordinates; ++l) {
+    const unsigned int a = axes[l];
+    if (indices) {
+      index[a] = ToIndex(val[l]);
+    } else if (m_nX[a] > 1) {
+      // Take the nearest node.
+      const double u = std::round((val[l] * scaleX - m_xMin[a]) * m_sX[a]);
+      index[a] = u < 0. ? 0 : static_cast<unsigned int>(
+                                  std::min(u, m_nX[a] - 1.));
+    }
+  }
+}
+
 ComponentGrid::Format ComponentGrid::GetFormat(std::string format) {
   std::transform(format.begin(), format.end(), format.begin(), toupper);
   if (format == "XY") {
@@ -1961,6 +1825,8 @@ ComponentGrid::Format ComponentGrid::GetFormat(std::string format) {
     return Format::IJK;
   } else if (format == "YXZ") {
     return Format::YXZ;
+  } else if (format == "BIN" || format == "BINARY") {
+    return Format::Binary;
   }
   return Format::Unknown;
 }
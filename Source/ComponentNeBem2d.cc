@@ -773,6 +773,7 @@ bool ComponentNeBem2d::GetElement(const unsigned int i,
 
 bool ComponentNeBem2d::Initialise() {
 
+  CheckFrozen("Initialise");
   m_ready = false;
   m_elements.clear();
 
@@ -6,12 +6,14 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <numeric>
 #include <set>
 #include <vector>
 
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Polygon.hh"
 #include "NR.h"
 #include "neBEM.h"
@@ -823,6 +825,110 @@ void ComponentNeBem3d::SetChargingUpOptions(const unsigned int OptChargingUp) {
   m_optChargingUp = OptChargingUp;
 }
 
+void ComponentNeBem3d::AddSurfaceCharge(const double x, const double y,
+                                        const double z, const double q) {
+  CheckFrozen("AddSurfaceCharge");
+  m_surfaceCharges.push_back({x, y, z, q});
+}
+
+bool ComponentNeBem3d::UpdateChargingUp() {
+  CheckFrozen("UpdateChargingUp");
+  if (!m_ready) {
+    std::cerr << m_className << "::UpdateChargingUp:\n"
+              << "    Component not ready.\n";
+    return false;
+  }
+  if (m_surfaceCharges.empty()) return true;
+
+  const int nElements = neBEM::NbElements;
+  double* dAssigned = neBEM::dvector(1, nElements);
+  if (!SurfaceChargeDensities(dAssigned, "UpdateChargingUp")) {
+    neBEM::free_dvector(dAssigned, 1, nElements);
+    return false;
+  }
+
+  const bool ok = neBEM::neBEMChargingUp(dAssigned, m_chargingUpTolerance) == 0;
+  neBEM::free_dvector(dAssigned, 1, nElements);
+  if (!ok) {
+    std::cerr << m_className << "::UpdateChargingUp:\n"
+              << "    Updating the solution failed.\n";
+  }
+  return ok;
+}
+
+bool ComponentNeBem3d::SurfaceChargeDensities(double* assigned,
+                                              const std::string& fcn) {
+  const int nElements = neBEM::NbElements;
+  for (int ele = 1; ele <= nElements; ++ele) assigned[ele] = 0.;
+  // Elements on dielectric interfaces.
+  std::vector<int> dielectric;
+  for (int ele = 1; ele <= nElements; ++ele) {
+    const int type = (neBEM::EleArr + ele - 1)->E.Type;
+    if (type == 4 || type == 5) dielectric.push_back(ele);
+  }
+  if (dielectric.empty()) {
+    std::cerr << m_className << "::" << fcn << ":\n"
+              << "    No dielectric interfaces. Discarding the charges.\n";
+    m_surfaceCharges.clear();
+    return false;
+  }
+
+  // Assign each charge to the nearest element.
+  const int nCharges = m_surfaceCharges.size();
+  std::vector<int> nearest(nCharges, 0);
+#ifdef _OPENMP
+#pragma omp parallel for num_threads(m_nThreads) if (m_nThreads > 1)
+#endif
+  for (int i = 0; i < nCharges; ++i) {
+    // Convert from cm to m.
+    const double x = 0.01 * m_surfaceCharges[i][0];
+    const double y = 0.01 * m_surfaceCharges[i][1];
+    const double z = 0.01 * m_surfaceCharges[i][2];
+    double dmin = DBL_MAX;
+    for (const int ele : dielectric) {
+      const auto& origin = (neBEM::EleArr + ele - 1)->G.Origin;
+      const double dx = origin.X - x;
+      const double dy = origin.Y - y;
+      const double dz = origin.Z - z;
+      const double d2 = dx * dx + dy * dy + dz * dz;
+      if (d2 < dmin) {
+        dmin = d2;
+        nearest[i] = ele;
+      }
+    }
+  }
+
+  // Convert to surface charge densities [C / m2].
+  for (int i = 0; i < nCharges; ++i) {
+    const int ele = nearest[i];
+    const double q = m_surfaceCharges[i][3] * ElementaryCharge * 1.e-15;
+    assigned[ele] += q / (neBEM::EleArr + ele - 1)->G.dA;
+  }
+  m_surfaceCharges.clear();
+  return true;
+}
+
+bool ComponentNeBem3d::RebuildFastVolume() {
+  CheckFrozen("RebuildFastVolume");
+  if (!m_ready) {
+    std::cerr << m_className << "::RebuildFastVolume:\n"
+              << "    Component not ready.\n";
+    return false;
+  }
+  if (neBEM::OptFastVol == 0) {
+    std::cerr << m_className << "::RebuildFastVolume:\n"
+              << "    Fast volume is not enabled.\n";
+    return false;
+  }
+  neBEM::ResetFastVolUpdates();
+  if (neBEM::CreateFastVolPF() != 0) {
+    std::cerr << m_className << "::RebuildFastVolume:\n"
+              << "    Computing the fast volume failed.\n";
+    return false;
+  }
+  return true;
+}
+
 void ComponentNeBem3d::SetPeriodicCopies(const unsigned int nx,
                                          const unsigned int ny,
                                          const unsigned int nz) {
@@ -931,6 +1037,8 @@ bool ComponentNeBem3d::GetPeriodicityZ(double& s) const {
 }
 
 bool ComponentNeBem3d::Initialise() {
+  GARFIELD_TIME(NeBemInitialise);
+  CheckFrozen("Initialise");
   // Reset the lists.
   m_primitives.clear();
   m_elements.clear();
@@ -979,6 +1087,36 @@ bool ComponentNeBem3d::Initialise() {
       eps[id] = medium->GetDielectricConstant();
     }
   }
+  // Copy the boundary conditions to arrays indexed by solid id, for use
+  // in the parallel loop below (where an exception would terminate).
+  const unsigned int nIds = solids.empty() ? 0 : solids.rbegin()->first + 1;
+  std::vector<Solid*> solidById(nIds, nullptr);
+  std::vector<Solid::BoundaryCondition> bcById(nIds, Solid::Unknown);
+  std::vector<double> voltById(nIds, 0.);
+  std::vector<double> epsById(nIds, 1.);
+  std::vector<double> chargeById(nIds, 0.);
+  for (const auto& solid : solids) {
+    const int id = solid.first;
+    solidById[id] = solid.second;
+    bcById[id] = bc[id];
+    voltById[id] = volt[id];
+    epsById[id] = eps[id];
+    chargeById[id] = charge[id];
+  }
+  // Discard panels which do not belong to any of the solids.
+  const auto nPanels = panelsIn.size();
+  panelsIn.erase(std::remove_if(panelsIn.begin(), panelsIn.end(),
+                                [&solidById, nIds](const Panel& panel) {
+                                  return panel.volume < 0 ||
+                                         panel.volume >= (int)nIds ||
+                                         !solidById[panel.volume];
+                                }),
+                 panelsIn.end());
+  if (panelsIn.size() < nPanels) {
+    std::cerr << m_className << "::Initialise:\n"
+              << "    Skipped " << nPanels - panelsIn.size()
+              << " panels with unknown volume.\n";
+  }
   // Apply cuts.
   // CALL CELSCT('APPLY')
   // Reduce to basic periodic copy.
@@ -1001,13 +1139,42 @@ bool ComponentNeBem3d::Initialise() {
     std::cout << m_className << "::Initialise: Retrieved " << nIn
               << " panels from the solids.\n";
   }
+  // Establish norm and offset of each panel.
+  std::vector<double> offsets(nIn, 0.);
+  double dmax = 0.;
+  for (unsigned int i = 0; i < nIn; ++i) {
+    const auto& panel = panelsIn[i];
+    offsets[i] = panel.a * panel.xv[0] + panel.b * panel.yv[0] +
+                 panel.c * panel.zv[0];
+    dmax = std::max(dmax, fabs(offsets[i]));
+  }
+  // Sort the panels into buckets according to their plane equation.
+  // Two panels that pass the coplanarity test below differ by at most
+  // tolNorm in each component of the (signed) norm vector and by at
+  // most tolOffset in the offset.
+  const double tolNorm = 2. * sqrt(epsang);
+  const double tolOffset = epsxyz + epsang * dmax;
+  const double cellNorm = 0.05;
+  const double cellOffset = 100. * tolOffset;
+  const std::array<double, 4> cells = {cellNorm, cellNorm, cellNorm,
+                                       cellOffset};
+  const std::array<double, 4> tols = {tolNorm, tolNorm, tolNorm, tolOffset};
+  std::map<std::array<long, 4>, std::vector<unsigned int> > buckets;
+  for (unsigned int i = 0; i < nIn; ++i) {
+    const auto& panel = panelsIn[i];
+    const std::array<double, 4> plane = {panel.a, panel.b, panel.c,
+                                         offsets[i]};
+    std::array<long, 4> key;
+    for (unsigned int k = 0; k < 4; ++k) {
+      key[k] = std::lround(std::floor(plane[k] / cells[k]));
+    }
+    buckets[key].push_back(i);
+  }
+
   // Keep track of which panels have been processed.
   std::vector<bool> mark(nIn, false);
-  // Count the number of interface panels that have been discarded.
-  unsigned int nTrivial = 0;
-  unsigned int nConflicting = 0;
-  unsigned int nNotImplemented = 0;
   // Pick up panels which coincide potentially.
+  std::vector<std::vector<unsigned int> > groups;
   for (unsigned int i = 0; i < nIn; ++i) {
     // Skip panels already done.
     if (mark[i]) continue;
@@ -1015,16 +1182,81 @@ bool ComponentNeBem3d::Initialise() {
     const double a1 = panelsIn[i].a;
     const double b1 = panelsIn[i].b;
     const double c1 = panelsIn[i].c;
-    const auto& xp1 = panelsIn[i].xv;
-    const auto& yp1 = panelsIn[i].yv;
-    const auto& zp1 = panelsIn[i].zv;
-    const unsigned int np1 = xp1.size();
-    // Establish its norm and offset.
-    const double d1 = a1 * xp1[0] + b1 * yp1[0] + c1 * zp1[0];
+    // Norm and offset.
+    const double d1 = offsets[i];
     if (m_debug) {
       std::cout << "  Panel " << i << "\n    Norm vector: " << a1 << ", " << b1
                 << ", " << c1 << ", " << d1 << ".\n";
     }
+    // Collect the candidates from the neighbouring buckets, for both
+    // orientations of the norm vector.
+    std::vector<unsigned int> candidates;
+    for (const double s : {1., -1.}) {
+      const std::array<double, 4> plane = {s * a1, s * b1, s * c1, s * d1};
+      std::array<long, 4> lo;
+      std::array<long, 4> hi;
+      for (unsigned int k = 0; k < 4; ++k) {
+        lo[k] = std::lround(std::floor((plane[k] - tols[k]) / cells[k]));
+        hi[k] = std::lround(std::floor((plane[k] + tols[k]) / cells[k]));
+      }
+      std::array<long, 4> key;
+      for (key[0] = lo[0]; key[0] <= hi[0]; ++key[0]) {
+        for (key[1] = lo[1]; key[1] <= hi[1]; ++key[1]) {
+          for (key[2] = lo[2]; key[2] <= hi[2]; ++key[2]) {
+            for (key[3] = lo[3]; key[3] <= hi[3]; ++key[3]) {
+              auto it = buckets.find(key);
+              if (it == buckets.end()) continue;
+              for (const auto j : it->second) {
+                if (j > i && !mark[j]) candidates.push_back(j);
+              }
+            }
+          }
+        }
+      }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    std::vector<unsigned int> group = {i};
+    // Pick up all matching planes.
+    for (const auto j : candidates) {
+      const double a2 = panelsIn[j].a;
+      const double b2 = panelsIn[j].b;
+      const double c2 = panelsIn[j].c;
+      // See whether this matches the first.
+      const double d2 = offsets[j];
+      // Inner product.
+      const double dot = a1 * a2 + b1 * b2 + c1 * c2;
+      // Offset between the two planes.
+      const double offset = d1 - d2 * dot;
+      if (fabs(fabs(dot) - 1.) > epsang || fabs(offset) > epsxyz) continue;
+      // Found a match.
+      mark[j] = true;
+      if (m_debug) std::cout << "    Match with panel " << j << ".\n";
+      group.push_back(j);
+    }
+    groups.push_back(std::move(group));
+  }
+
+  // Remove the contacts within each group of coplanar panels.
+  // The groups are independent and can be processed in parallel.
+  const unsigned int nGroups = groups.size();
+  std::vector<std::vector<Primitive> > primitives(nGroups);
+  // Count the number of interface panels that have been discarded.
+  unsigned int nTrivial = 0;
+  unsigned int nConflicting = 0;
+  unsigned int nNotImplemented = 0;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(m_nThreads) \
+    if (m_nThreads > 1 && !m_debug) \
+    reduction(+ : nTrivial, nConflicting, nNotImplemented)
+#endif
+  for (unsigned int ig = 0; ig < nGroups; ++ig) {
+    const auto& group = groups[ig];
+    const unsigned int i = group[0];
+    const double a1 = panelsIn[i].a;
+    const double b1 = panelsIn[i].b;
+    const double c1 = panelsIn[i].c;
     // Rotation matrix.
     std::array<std::array<double, 3>, 3> rot;
     if (fabs(c1) <= fabs(a1) && fabs(c1) <= fabs(b1)) {
@@ -1049,63 +1281,41 @@ bool ComponentNeBem3d::Initialise() {
     rot[1][0] = rot[2][1] * rot[0][2] - rot[2][2] * rot[0][1];
     rot[1][1] = rot[2][2] * rot[0][0] - rot[2][0] * rot[0][2];
     rot[1][2] = rot[2][0] * rot[0][1] - rot[2][1] * rot[0][0];
-    // Rotate to the x, y plane.
-    std::vector<double> xp(np1, 0.);
-    std::vector<double> yp(np1, 0.);
-    std::vector<double> zp(np1, 0.);
-    for (unsigned int k = 0; k < np1; ++k) {
-      xp[k] = rot[0][0] * xp1[k] + rot[0][1] * yp1[k] + rot[0][2] * zp1[k];
-      yp[k] = rot[1][0] * xp1[k] + rot[1][1] * yp1[k] + rot[1][2] * zp1[k];
-      zp[k] = rot[2][0] * xp1[k] + rot[2][1] * yp1[k] + rot[2][2] * zp1[k];
-    }
-    // Store it.
+    // Rotate the panels to the x, y plane and store them.
     std::vector<Panel> newPanels;
     std::vector<int> vol1;
     std::vector<int> vol2;
-    Panel panel1 = panelsIn[i];
-    panel1.xv = xp;
-    panel1.yv = yp;
-    panel1.zv = zp;
-    vol1.push_back(panel1.volume);
-    vol2.push_back(-1);
-    newPanels.push_back(std::move(panel1));
-    // Pick up all matching planes.
-    for (unsigned int j = i + 1; j < nIn; ++j) {
-      if (mark[j]) continue;
-      const double a2 = panelsIn[j].a;
-      const double b2 = panelsIn[j].b;
-      const double c2 = panelsIn[j].c;
-      const auto& xp2 = panelsIn[j].xv;
-      const auto& yp2 = panelsIn[j].yv;
-      const auto& zp2 = panelsIn[j].zv;
-      const unsigned int np2 = xp2.size();
-      // See whether this matches the first.
-      const double d2 = a2 * xp2[0] + b2 * yp2[0] + c2 * zp2[0];
-      // Inner product.
-      const double dot = a1 * a2 + b1 * b2 + c1 * c2;
-      // Offset between the two planes.
-      const double offset = d1 - d2 * dot;
-      if (fabs(fabs(dot) - 1.) > epsang || fabs(offset) > epsxyz) continue;
-      // Found a match.
-      mark[j] = true;
-      if (m_debug) std::cout << "    Match with panel " << j << ".\n";
-      // Rotate this plane too.
-      xp.assign(np2, 0.);
-      yp.assign(np2, 0.);
-      zp.assign(np2, 0.);
-      for (unsigned int k = 0; k < np2; ++k) {
-        xp[k] = rot[0][0] * xp2[k] + rot[0][1] * yp2[k] + rot[0][2] * zp2[k];
-        yp[k] = rot[1][0] * xp2[k] + rot[1][1] * yp2[k] + rot[1][2] * zp2[k];
-        zp[k] = rot[2][0] * xp2[k] + rot[2][1] * yp2[k] + rot[2][2] * zp2[k];
-      }
-      // Store it.
-      Panel panel2 = panelsIn[j];
-      panel2.xv = xp;
-      panel2.yv = yp;
-      panel2.zv = zp;
-      vol1.push_back(panel2.volume);
+    // Bounding boxes (in the rotated frame) of the panels.
+    std::vector<std::array<double, 4> > boxes;
+    auto addBox = [&boxes](const Panel& panel) {
+      const auto x = std::minmax_element(panel.xv.cbegin(), panel.xv.cend());
+      const auto y = std::minmax_element(panel.yv.cbegin(), panel.yv.cend());
+      boxes.push_back({*x.first, *x.second, *y.first, *y.second});
+    };
+    std::vector<double> xp;
+    std::vector<double> yp;
+    std::vector<double> zp;
+    for (const auto j : group) {
+      const auto& xp1 = panelsIn[j].xv;
+      const auto& yp1 = panelsIn[j].yv;
+      const auto& zp1 = panelsIn[j].zv;
+      const unsigned int np1 = xp1.size();
+      xp.assign(np1, 0.);
+      yp.assign(np1, 0.);
+      zp.assign(np1, 0.);
+      for (unsigned int k = 0; k < np1; ++k) {
+        xp[k] = rot[0][0] * xp1[k] + rot[0][1] * yp1[k] + rot[0][2] * zp1[k];
+        yp[k] = rot[1][0] * xp1[k] + rot[1][1] * yp1[k] + rot[1][2] * zp1[k];
+        zp[k] = rot[2][0] * xp1[k] + rot[2][1] * yp1[k] + rot[2][2] * zp1[k];
+      }
+      Panel panel = panelsIn[j];
+      panel.xv = xp;
+      panel.yv = yp;
+      panel.zv = zp;
+      vol1.push_back(panel.volume);
       vol2.push_back(-1);
-      newPanels.push_back(std::move(panel2));
+      addBox(panel);
+      newPanels.push_back(std::move(panel));
     }
     std::vector<bool> obsolete(newPanels.size(), false);
     // Cut them as long as needed till no contacts remain.
@@ -1118,9 +1328,21 @@ bool ComponentNeBem3d::Initialise() {
         if (obsolete[j] || j < jmin) continue;
         if (vol1[j] >= 0 && vol2[j] >= 0) continue;
         const auto& panelj = newPanels[j];
+        const auto& boxj = boxes[j];
         for (unsigned int k = j + 1; k < n; ++k) {
           if (obsolete[k]) continue;
           if (vol1[k] >= 0 && vol2[k] >= 0) continue;
+          // Panels with disjoint bounding boxes cannot overlap.
+          const auto& boxk = boxes[k];
+          const double tol =
+              epsxyz + 1.e-6 * std::max({fabs(boxj[0]), fabs(boxj[1]),
+                                         fabs(boxj[2]), fabs(boxj[3]),
+                                         fabs(boxk[0]), fabs(boxk[1]),
+                                         fabs(boxk[2]), fabs(boxk[3])});
+          if (boxk[0] > boxj[1] + tol || boxj[0] > boxk[1] + tol ||
+              boxk[2] > boxj[3] + tol || boxj[2] > boxk[3] + tol) {
+            continue;
+          }
           const auto& panelk = newPanels[k];
           if (m_debug) std::cout << "    Cutting " << j << ", " << k << ".\n";
           // Separate contact and non-contact areas.
@@ -1166,6 +1388,7 @@ bool ComponentNeBem3d::Initialise() {
               vol1.push_back(std::max(vol1[j], vol2[j]));
               vol2.push_back(std::max(vol1[k], vol2[k]));
             }
+            addBox(panelsOut[l]);
             newPanels.push_back(std::move(panelsOut[l]));
             obsolete.push_back(false);
           }
@@ -1195,40 +1418,40 @@ bool ComponentNeBem3d::Initialise() {
       } else if (vol1[j] < 0 || vol2[j] < 0) {
         // Interface between a solid and vacuum/background.
         const auto vol = vol1[j] < 0 ? vol2[j] : vol1[j];
-        interfaceType = InterfaceType(bc[vol]);
-        if (bc[vol] == Solid::Dielectric ||
-            bc[vol] == Solid::DielectricCharge) {
-          if (fabs(eps[vol] - 1.) < 1.e-6) {
+        const auto bc0 = bcById[vol];
+        interfaceType = InterfaceType(bc0);
+        if (bc0 == Solid::Dielectric || bc0 == Solid::DielectricCharge) {
+          if (fabs(epsById[vol] - 1.) < 1.e-6) {
             // Same epsilon on both sides. Skip.
             interfaceType = 0;
           } else {
-            lambda = (eps[vol] - 1.) / (eps[vol] + 1.);
+            lambda = (epsById[vol] - 1.) / (epsById[vol] + 1.);
           }
-        } else if (bc[vol] == Solid::Voltage) {
-          potential = volt[vol];
+        } else if (bc0 == Solid::Voltage) {
+          potential = voltById[vol];
         }
-        if (bc[vol] == Solid::Charge || bc[vol] == Solid::DielectricCharge) {
-          chargeDensity = charge[vol];
+        if (bc0 == Solid::Charge || bc0 == Solid::DielectricCharge) {
+          chargeDensity = chargeById[vol];
         }
       } else {
-        const auto bc1 = bc[vol1[j]];
-        const auto bc2 = bc[vol2[j]];
+        const auto bc1 = bcById[vol1[j]];
+        const auto bc2 = bcById[vol2[j]];
         if (bc1 == Solid::Voltage || bc1 == Solid::Charge ||
             bc1 == Solid::Float) {
           interfaceType = InterfaceType(bc1);
           // First volume is a conductor. Other volume must be a dielectric.
           if (bc2 == Solid::Dielectric || bc2 == Solid::DielectricCharge) {
             if (bc1 == Solid::Voltage) {
-              potential = volt[vol1[j]];
+              potential = voltById[vol1[j]];
             } else if (bc1 == Solid::Charge) {
-              chargeDensity = charge[vol1[j]];
+              chargeDensity = chargeById[vol1[j]];
             }
           } else {
             interfaceType = -1;
           }
           if (bc1 == Solid::Voltage && bc2 == Solid::Voltage) {
-            const double v1 = volt[vol1[j]];
-            const double v2 = volt[vol2[j]];
+            const double v1 = voltById[vol1[j]];
+            const double v2 = voltById[vol2[j]];
             if (fabs(v1 - v2) < 1.e-6 * (1. + fabs(v1) + fabs(v2))) {
               interfaceType = 0;
             }
@@ -1237,13 +1460,13 @@ bool ComponentNeBem3d::Initialise() {
           interfaceType = InterfaceType(bc2);
           // First volume is a dielectric.
           if (bc2 == Solid::Voltage) {
-            potential = volt[vol2[j]];
+            potential = voltById[vol2[j]];
           } else if (bc2 == Solid::Charge) {
-            chargeDensity = charge[vol2[j]];
+            chargeDensity = chargeById[vol2[j]];
           } else if (bc2 == Solid::Dielectric ||
                      bc2 == Solid::DielectricCharge) {
-            const double eps1 = eps[vol1[j]];
-            const double eps2 = eps[vol2[j]];
+            const double eps1 = epsById[vol1[j]];
+            const double eps2 = epsById[vol2[j]];
             if (fabs(eps1 - eps2) < 1.e-6 * (1. + fabs(eps1) + fabs(eps2))) {
               // Same epsilon. Skip.
               interfaceType = 0;
@@ -1304,18 +1527,19 @@ bool ComponentNeBem3d::Initialise() {
         primitive.interface = interfaceType;
         // Set the requested discretization level (target element size).
         primitive.elementSize = -1.;
-        if (solids.find(vol1[j]) != solids.end()) {
-          const auto solid = solids[vol1[j]];
-          if (solid) {
-            primitive.elementSize = solid->GetDiscretisationLevel(panel);
-          }
-        }
+        Solid* solid = vol1[j] >= 0 ? solidById[vol1[j]] : nullptr;
+        if (solid) primitive.elementSize = solid->GetDiscretisationLevel(panel);
         primitive.vol1 = vol1[j];
         primitive.vol2 = vol2[j];
-        m_primitives.push_back(std::move(primitive));
+        primitives[ig].push_back(std::move(primitive));
       }
     }
   }
+  for (auto& group : primitives) {
+    m_primitives.insert(m_primitives.end(),
+                        std::make_move_iterator(group.begin()),
+                        std::make_move_iterator(group.end()));
+  }
 
   // Add the wires.
   for (unsigned int i = 0; i < nSolids; ++i) {
@@ -1408,6 +1632,17 @@ bool ComponentNeBem3d::Initialise() {
   neBEM::PrimAfter = m_primAfter;
   neBEM::WtFldPrimAfter = m_wtFldPrimAfter;
   neBEM::OptRmPrim = m_optRmPrim;
+  neBEM::OptEwald = m_ewald ? 1 : 0;
+  if (m_ewald) {
+    const unsigned int nPeriodic =
+        std::count(m_periodic.cbegin(), m_periodic.cend(), true);
+    if (nPeriodic < 1 || nPeriodic > 2 || m_mirrorPeriodic[0] ||
+        m_mirrorPeriodic[1] || m_mirrorPeriodic[2]) {
+      std::cerr << m_className << "::Initialise:\n"
+                << "    Ewald summation requires simple periodicity in one or "
+                << "two directions.\n    Using explicit copies only.\n";
+    }
+  }
 
   // Fast volume details (physical potential and field related)
   neBEM::OptFastVol = m_optFastVol;
@@ -1586,6 +1821,18 @@ bool ComponentNeBem3d::Initialise() {
               << "    Setting the boundary and initial conditions failed.\n";
     return false;
   }
+  if (!m_surfaceCharges.empty()) {
+    // Include the charges deposited so far in the solution. They enter
+    // the right-hand side through the charging-up terms (see RHVector).
+    double* assigned = neBEM::dvector(1, neBEM::NbElements);
+    if (SurfaceChargeDensities(assigned, "Initialise")) {
+      for (int ele = 1; ele <= neBEM::NbElements; ++ele) {
+        (neBEM::EleArr + ele - 1)->Assigned += assigned[ele];
+      }
+      neBEM::OptChargingUp = 1;
+    }
+    neBEM::free_dvector(assigned, 1, neBEM::NbElements);
+  }
   if (neBEM::neBEMSolve() != 0) {
     std::cerr << m_className << "::Initialise: Solution failed.\n";
     return false;
@@ -1598,24 +1845,37 @@ bool ComponentNeBem3d::Initialise() {
     const std::string label = solid->GetLabel();
     if (!label.empty()) labels.insert(label);
   }
-  for (const auto& label : labels) {
-    std::vector<int> primitives;
+  // Collect the primitives associated to each readout group.
+  std::vector<std::string> readouts(labels.begin(), labels.end());
+  std::vector<std::vector<int> > readoutPrimitives(readouts.size());
+  for (size_t k = 0; k < readouts.size(); ++k) {
     for (unsigned int i = 0; i < nSolids; ++i) {
       const auto solid = m_geometry->GetSolid(i);
       if (!solid) continue;
-      if (solid->GetLabel() != label) continue;
+      if (solid->GetLabel() != readouts[k]) continue;
       const int id = solid->GetId();
       // Add the primitives associated to this solid to the list.
       for (int j = 1; j <= neBEM::NbPrimitives; ++j) {
         if (neBEM::VolRef1[j] == id || neBEM::VolRef2[j] == id) {
-          primitives.push_back(j);
+          readoutPrimitives[k].push_back(j);
         }
       }
     }
-    // Request the weighting field for this list of primitives.
-    const int np = primitives.size();
-    const int id = neBEM::neBEMPrepareWeightingField(np, primitives.data());
-    if (id < 0) {
+  }
+  // Request the weighting fields for all readout groups in one go.
+  const int nReadouts = readouts.size();
+  std::vector<int> nPrimitives(nReadouts, 0);
+  std::vector<int*> lists(nReadouts, nullptr);
+  std::vector<int> ids(nReadouts, -1);
+  for (int k = 0; k < nReadouts; ++k) {
+    nPrimitives[k] = readoutPrimitives[k].size();
+    lists[k] = readoutPrimitives[k].data();
+  }
+  neBEM::neBEMPrepareWeightingFields(nReadouts, nPrimitives.data(),
+                                     lists.data(), ids.data());
+  for (int k = 0; k < nReadouts; ++k) {
+    const auto& label = readouts[k];
+    if (ids[k] < 0) {
       std::cerr << m_className << "::Initialise:\n"
                 << "    Weighting field calculation for readout group \""
                 << label << "\" failed.\n";
@@ -1624,7 +1884,7 @@ bool ComponentNeBem3d::Initialise() {
       std::cout << m_className << "::Initialise:\n"
                 << "    Prepared weighting field for readout group \"" << label
                 << "\".\n";
-      m_wfields[label] = id;
+      m_wfields[label] = ids[k];
     }
   }
   // TODO! Not sure if we should call this here.
@@ -2042,7 +2302,7 @@ unsigned int ComponentNeBem3d::NbOfSegments(const double length,
 bool ComponentNeBem3d::EliminateOverlaps(const Panel& panel1,
                                          const Panel& panel2,
                                          std::vector<Panel>& panelsOut,
-                                         std::vector<int>& itypo) {
+                                         std::vector<int>& itypo) const {
   // *-----------------------------------------------------------------------
   // *   PLAOVL - Isolates the parts of plane 1 that are not hidden by 2.
   // *-----------------------------------------------------------------------
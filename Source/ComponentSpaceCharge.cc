@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Garfield/ComponentSpaceCharge.hh"
+#include "Garfield/FundamentalConstants.hh"
+#include "Garfield/GarfieldConstants.hh"
+
+namespace {
+
+// Max. depth of the tree.
+constexpr unsigned int nMaxDepth = 24;
+// Depth at which the sub-trees are distributed over the threads.
+constexpr unsigned int nSplitDepth = 2;
+
+}  // namespace
+
+namespace Garfield {
+
+ComponentSpaceCharge::ComponentSpaceCharge() : Component("SpaceCharge") {
+  m_ready = true;
+}
+
+void ComponentSpaceCharge::AddCharge(const double x, const double y,
+                                     const double z, const double q) {
+  CheckFrozen("AddCharge");
+  m_charges.push_back({x, y, z, q});
+  m_changed = true;
+}
+
+void ComponentSpaceCharge::ClearCharges() {
+  CheckFrozen("ClearCharges");
+  m_charges.clear();
+  m_nodes.clear();
+  m_changed = false;
+  m_hasExcluded = false;
+}
+
+void ComponentSpaceCharge::ExcludeCharge(const double x, const double y,
+                                         const double z, const double q) {
+  CheckFrozen("ExcludeCharge");
+  m_excluded = {x, y, z, q};
+  m_hasExcluded = true;
+}
+
+void ComponentSpaceCharge::SetOpeningAngle(const double theta) {
+  if (theta < 0.) {
+    std::cerr << m_className << "::SetOpeningAngle: Value must be >= 0.\n";
+    return;
+  }
+  m_theta = theta;
+}
+
+void ComponentSpaceCharge::SetSmoothingLength(const double eps) {
+  if (eps < 0.) {
+    std::cerr << m_className << "::SetSmoothingLength: Value must be >= 0.\n";
+    return;
+  }
+  m_eps = eps;
+}
+
+void ComponentSpaceCharge::SetMaxChargesPerCell(const unsigned int n) {
+  if (n == 0) {
+    std::cerr << m_className << "::SetMaxChargesPerCell: Value must be > 0.\n";
+    return;
+  }
+  CheckFrozen("SetMaxChargesPerCell");
+  m_leafSize = n;
+  m_changed = true;
+}
+
+bool ComponentSpaceCharge::Update() {
+  m_nodes.clear();
+  m_changed = false;
+  const size_t nCharges = m_charges.size();
+  if (nCharges == 0) return true;
+
+  // Determine the bounding cube of the charges.
+  std::array<double, 3> xmin = {m_charges[0][0], m_charges[0][1],
+                                m_charges[0][2]};
+  std::array<double, 3> xmax = xmin;
+  for (const auto& charge : m_charges) {
+    for (size_t k = 0; k < 3; ++k) {
+      xmin[k] = std::min(xmin[k], charge[k]);
+      xmax[k] = std::max(xmax[k], charge[k]);
+    }
+  }
+  std::array<double, 3> centre;
+  double size = 0.;
+  for (size_t k = 0; k < 3; ++k) {
+    centre[k] = 0.5 * (xmin[k] + xmax[k]);
+    size = std::max(size, xmax[k] - xmin[k]);
+  }
+  size = std::max(1.001 * size, Small);
+
+  // Build the upper levels of the tree and collect the sub-trees below.
+  std::vector<Task> tasks;
+  BuildTree(m_nodes, 0, nCharges, centre, size, 0, &tasks);
+  const int nTasks = tasks.size();
+  std::vector<std::vector<Node> > subtrees(nTasks);
+#pragma omp parallel for schedule(dynamic) num_threads(m_nThreads) \
+    if (m_nThreads > 1)
+  for (int i = 0; i < nTasks; ++i) {
+    const auto& task = tasks[i];
+    BuildTree(subtrees[i], task.begin, task.end, task.centre, task.size,
+              nSplitDepth, nullptr);
+  }
+  // Append the sub-trees.
+  for (int i = 0; i < nTasks; ++i) {
+    const int offset = m_nodes.size();
+    for (auto& node : subtrees[i]) {
+      for (auto& child : node.children) {
+        if (child >= 0) child += offset;
+      }
+      m_nodes.push_back(std::move(node));
+    }
+    m_nodes[tasks[i].parent].children[tasks[i].octant] = offset;
+  }
+  if (m_debug) {
+    std::cout << m_className << "::Update:\n    " << nCharges
+              << " charges, " << m_nodes.size() << " cells.\n";
+  }
+  return true;
+}
+
+int ComponentSpaceCharge::BuildTree(std::vector<Node>& nodes,
+                                    const size_t begin, const size_t end,
+                                    const std::array<double, 3>& centre,
+                                    const double size,
+                                    const unsigned int depth,
+                                    std::vector<Task>* tasks) {
+  Node node;
+  node.centre = centre;
+  node.size = size;
+  node.qp = node.qn = 0.;
+  node.cp.fill(0.);
+  node.cn.fill(0.);
+  node.children.fill(-1);
+  node.begin = begin;
+  node.end = end;
+  for (size_t i = begin; i < end; ++i) {
+    const auto& charge = m_charges[i];
+    const double q = charge[3];
+    if (q > 0.) {
+      node.qp += q;
+      for (size_t k = 0; k < 3; ++k) node.cp[k] += q * charge[k];
+    } else {
+      node.qn += q;
+      for (size_t k = 0; k < 3; ++k) node.cn[k] += q * charge[k];
+    }
+  }
+  for (size_t k = 0; k < 3; ++k) {
+    if (node.qp > 0.) node.cp[k] /= node.qp;
+    if (node.qn < 0.) node.cn[k] /= node.qn;
+  }
+  node.leaf = end - begin <= m_leafSize || depth >= nMaxDepth;
+  const int index = nodes.size();
+  nodes.push_back(std::move(node));
+  if (nodes[index].leaf) return index;
+
+  // Sort the charges by octant (bit 0: x, bit 1: y, bit 2: z).
+  auto first = m_charges.begin() + begin;
+  auto last = m_charges.begin() + end;
+  typedef const std::array<double, 4>& Charge;
+  auto mz = std::partition(first, last,
+                           [&](Charge a) { return a[2] < centre[2]; });
+  auto my0 = std::partition(first, mz,
+                            [&](Charge a) { return a[1] < centre[1]; });
+  auto my1 = std::partition(mz, last,
+                            [&](Charge a) { return a[1] < centre[1]; });
+  auto inLowerX = [&](Charge a) { return a[0] < centre[0]; };
+  const std::array<decltype(first), 9> bounds = {
+      first, std::partition(first, my0, inLowerX),
+      my0,   std::partition(my0, mz, inLowerX),
+      mz,    std::partition(mz, my1, inLowerX),
+      my1,   std::partition(my1, last, inLowerX),
+      last};
+  const double h = 0.25 * size;
+  for (unsigned int k = 0; k < 8; ++k) {
+    const size_t i0 = bounds[k] - m_charges.begin();
+    const size_t i1 = bounds[k + 1] - m_charges.begin();
+    if (i0 == i1) continue;
+    const std::array<double, 3> c = {centre[0] + (k & 1 ? h : -h),
+                                     centre[1] + (k & 2 ? h : -h),
+                                     centre[2] + (k & 4 ? h : -h)};
+    if (tasks && depth + 1 == nSplitDepth) {
+      tasks->push_back({index, k, i0, i1, c, 0.5 * size});
+      continue;
+    }
+    const int child = BuildTree(nodes, i0, i1, c, 0.5 * size, depth + 1,
+                                tasks);
+    nodes[index].children[k] = child;
+  }
+  return index;
+}
+
+void ComponentSpaceCharge::Evaluate(const double x, const double y,
+                                    const double z, double& ex, double& ey,
+                                    double& ez, double& v) const {
+  ex = ey = ez = v = 0.;
+  if (m_nodes.empty()) return;
+  const double eps2 = m_eps * m_eps;
+  const double theta2 = m_theta * m_theta;
+  auto add = [&](const double xq, const double yq, const double zq,
+                 const double q) {
+    const double dx = x - xq;
+    const double dy = y - yq;
+    const double dz = z - zq;
+    const double r2 = dx * dx + dy * dy + dz * dz + eps2;
+    if (r2 <= 0.) return;
+    const double r = sqrt(r2);
+    const double f = q / (r2 * r);
+    ex += f * dx;
+    ey += f * dy;
+    ez += f * dz;
+    v += q / r;
+  };
+  // Depth-first traversal of the tree.
+  std::array<int, 8 * nMaxDepth + 8> stack;
+  size_t n = 0;
+  stack[n++] = 0;
+  while (n > 0) {
+    const auto& node = m_nodes[stack[--n]];
+    const double dx = x - node.centre[0];
+    const double dy = y - node.centre[1];
+    const double dz = z - node.centre[2];
+    const double d2 = dx * dx + dy * dy + dz * dz;
+    if (node.size * node.size < theta2 * d2) {
+      // Cell is sufficiently far away.
+      if (node.qp > 0.) add(node.cp[0], node.cp[1], node.cp[2], node.qp);
+      if (node.qn < 0.) add(node.cn[0], node.cn[1], node.cn[2], node.qn);
+    } else if (node.leaf) {
+      for (size_t i = node.begin; i < node.end; ++i) {
+        const auto& charge = m_charges[i];
+        add(charge[0], charge[1], charge[2], charge[3]);
+      }
+    } else {
+      for (const int child : node.children) {
+        if (child >= 0) stack[n++] = child;
+      }
+    }
+  }
+  // Subtract the contribution of the excluded charge (exact in the cells
+  // evaluated charge by charge).
+  if (m_hasExcluded) {
+    add(m_excluded[0], m_excluded[1], m_excluded[2], -m_excluded[3]);
+  }
+  // Convert to V / cm (vacuum permittivity).
+  constexpr double f = ElementaryCharge / FourPiEpsilon0;
+  ex *= f;
+  ey *= f;
+  ez *= f;
+  v *= f;
+}
+
+void ComponentSpaceCharge::ElectricField(const double x, const double y,
+                                         const double z, double& ex,
+                                         double& ey, double& ez, Medium*& m,
+                                         int& status) {
+  double v = 0.;
+  ElectricField(x, y, z, ex, ey, ez, v, m, status);
+}
+
+void ComponentSpaceCharge::ElectricField(const double x, const double y,
+                                         const double z, double& ex,
+                                         double& ey, double& ez, double& v,
+                                         Medium*& m, int& status) {
+  // The component only contributes a field, not a medium.
+  m = nullptr;
+  status = 0;
+  if (m_changed) Update();
+  Evaluate(x, y, z, ex, ey, ez, v);
+}
+
+bool ComponentSpaceCharge::GetVoltageRange(double& vmin, double& vmax) {
+  vmin = vmax = 0.;
+  return false;
+}
+
+void ComponentSpaceCharge::Reset() {
+  ClearCharges();
+  m_ready = true;
+}
+
+void ComponentSpaceCharge::UpdatePeriodicity() {
+  if (m_debug) {
+    std::cerr << m_className << "::UpdatePeriodicity:\n"
+              << "    Periodicities are not supported.\n";
+  }
+}
+
+}  // namespace Garfield
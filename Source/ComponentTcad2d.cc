@@ -5,6 +5,7 @@
 #include <string>
 
 #include "Garfield/ComponentTcad2d.hh"
+#include "Garfield/Instrumentation.hh"
 
 namespace Garfield {
 
@@ -151,24 +152,28 @@ Medium* ComponentTcad2d::GetMedium(const double xin, const double yin,
 void ComponentTcad2d::FillTree() {
 
   // Set up the quad tree.
-  const double hx = 0.5 * (m_bbMax[0] - m_bbMin[0]);
-  const double hy = 0.5 * (m_bbMax[1] - m_bbMin[1]);
-  m_tree.reset(new QuadTree(m_bbMin[0] + hx, m_bbMin[1] + hy, hx, hy));
-  // Insert the mesh nodes in the tree.
-  const auto nVertices = m_vertices.size();
-  for (size_t i = 0; i < nVertices; ++i) {
-    m_tree->InsertMeshNode(m_vertices[i][0], m_vertices[i][1], i);
+  std::vector<std::array<double, 3> > points;
+  points.reserve(m_vertices.size());
+  for (const auto& vtx : m_vertices) points.push_back({vtx[0], vtx[1], 0.});
+  std::vector<std::array<double, 3> > bbMin;
+  std::vector<std::array<double, 3> > bbMax;
+  bbMin.reserve(m_elements.size());
+  bbMax.reserve(m_elements.size());
+  for (const auto& element : m_elements) {
+    bbMin.push_back({element.bbMin[0], element.bbMin[1], 0.});
+    bbMax.push_back({element.bbMax[0], element.bbMax[1], 0.});
   }
-
-  const auto nElements = m_elements.size();
-  // Insert the mesh elements in the tree.
-  for (size_t i = 0; i < nElements; ++i) {
-    const Element& element = m_elements[i];
-    const double bb[4] = {element.bbMin[0], element.bbMin[1], 
-                          element.bbMax[0], element.bbMax[1]};
-    m_tree->InsertMeshElement(bb, i);
+  m_tree.reset(new LinearTree(2));
+  m_tree->SetLeafSize(m_treeLeafSize);
+  if (!m_tree->Build(m_bbMin, m_bbMax, points, bbMin, bbMax)) {
+    m_tree.reset(nullptr);
+    return;
+  }
+  if (m_debug) {
+    std::cout << m_className << "::FillTree:\n    "
+              << m_tree->GetNumberOfLeaves() << " cells, "
+              << m_tree->GetMemoryUsage() << " bytes.\n";
   }
-
 }
 
 bool ComponentTcad2d::GetBoundingBox(double& xmin, double& ymin, double& zmin,
@@ -218,6 +223,7 @@ bool ComponentTcad2d::GetElementaryCell(
 }
 
 void ComponentTcad2d::SetRangeZ(const double zmin, const double zmax) {
+  CheckFrozen("SetRangeZ");
   if (fabs(zmax - zmin) <= 0.) {
     std::cerr << m_className << "::SetRangeZ: Zero range is not permitted.\n";
     return;
@@ -298,11 +304,32 @@ bool ComponentTcad2d::GetNode(const size_t i, double& x, double& y,
 size_t ComponentTcad2d::FindElement(const double x, const double y, 
     std::array<double, nMaxVertices>& w) const {
 
+  GARFIELD_COUNT(TcadFindElement);
   w.fill(0.);
+  const std::array<double, 2> p = {x, y};
+  // Start from the element found in the previous call and walk 
+  // through the neighbouring triangles towards the point.
+  size_t& last = LastElement();
+  const size_t j = Walk(last, p, w);
+  if (j < m_elements.size()) {
+    GARFIELD_COUNT(TcadWalkHits);
+    last = j;
+    return j;
+  }
+  if (last < m_elements.size() && m_elements[last].type != SimplexType &&
+      InElement(x, y, m_elements[last], w)) {
+    return last;
+  }
   if (m_tree) {
-    const auto& elements = m_tree->GetElementsInBlock(x, y);
+    const auto elements = m_tree->GetElementsInBlock(x, y);
     for (const auto i : elements) { 
-      if (InElement(x, y, m_elements[i], w)) return i;
+      GARFIELD_COUNT(TcadCandidates);
+      const bool inside = m_elements[i].type == SimplexType ? 
+          InSimplex(i, p, w) : InElement(x, y, m_elements[i], w);
+      if (inside) {
+        last = i;
+        return i;
+      }
     }
   } else {
     const size_t nElements = m_elements.size();
@@ -318,6 +345,22 @@ size_t ComponentTcad2d::FindElement(const double x, const double y,
   return m_elements.size();
 }
 
+size_t ComponentTcad2d::Locate(const double xin, const double yin,
+                               const double z,
+                               std::array<double, nMaxVertices>& w,
+                               std::array<bool, 2>& mirr) const {
+  mirr.fill(false);
+  if (m_hasRangeZ && (z < m_bbMin[2] || z > m_bbMax[2])) {
+    return m_elements.size();
+  }
+  std::array<double, 2> x = {xin, yin};
+  // In case of periodicity, reduce to the cell volume.
+  MapCoordinates(x, mirr);
+  // Make sure the point is inside the bounding box.
+  if (!InBoundingBox(x)) return m_elements.size();
+  return FindElement(x[0], x[1], w);
+}
+
 bool ComponentTcad2d::InElement(const double x, const double y,
                                 const Element& element,
                                 std::array<double, nMaxVertices>& w) const {
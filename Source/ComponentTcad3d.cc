@@ -5,6 +5,7 @@
 #include <string>
 
 #include "Garfield/ComponentTcad3d.hh"
+#include "Garfield/Instrumentation.hh"
 
 namespace Garfield {
 
@@ -151,26 +152,24 @@ Medium* ComponentTcad3d::GetMedium(const double xin, const double yin,
 void ComponentTcad3d::FillTree() {
 
   // Set up the octree.
-  const float hx = 0.5 * (m_bbMax[0] - m_bbMin[0]);
-  const float hy = 0.5 * (m_bbMax[1] - m_bbMin[1]);
-  const float hz = 0.5 * (m_bbMax[2] - m_bbMin[2]);
-  m_tree.reset(new TetrahedralTree(Vec3(m_bbMin[0] + hx, m_bbMin[1] + hy, m_bbMin[2] + hz),
-                                   Vec3(hx, hy, hz)));
-
-  // Insert the mesh nodes in the tree.
-  const size_t nVertices = m_vertices.size();
-  for (size_t i = 0; i < nVertices; ++i) {
-    const auto& vtx = m_vertices[i];
-    m_tree->InsertMeshNode(Vec3(vtx[0], vtx[1], vtx[2]), i);
+  std::vector<std::array<double, 3> > bbMin;
+  std::vector<std::array<double, 3> > bbMax;
+  bbMin.reserve(m_elements.size());
+  bbMax.reserve(m_elements.size());
+  for (const auto& element : m_elements) {
+    bbMin.push_back({element.bbMin[0], element.bbMin[1], element.bbMin[2]});
+    bbMax.push_back({element.bbMax[0], element.bbMax[1], element.bbMax[2]});
   }
-
-  // Insert the mesh elements in the tree.
-  const size_t nElements = m_elements.size();
-  for (size_t i = 0; i < nElements; ++i) {
-    const Element& element = m_elements[i];
-    const double bb[6] = {element.bbMin[0], element.bbMin[1], element.bbMin[2],
-                          element.bbMax[0], element.bbMax[1], element.bbMax[2]};
-    m_tree->InsertMeshElement(bb, i);
+  m_tree.reset(new LinearTree(3));
+  m_tree->SetLeafSize(m_treeLeafSize);
+  if (!m_tree->Build(m_bbMin, m_bbMax, m_vertices, bbMin, bbMax)) {
+    m_tree.reset(nullptr);
+    return;
+  }
+  if (m_debug) {
+    std::cout << m_className << "::FillTree:\n    "
+              << m_tree->GetNumberOfLeaves() << " cells, "
+              << m_tree->GetMemoryUsage() << " bytes.\n";
   }
 }
 
@@ -215,14 +214,31 @@ size_t ComponentTcad3d::FindElement(
     const double x, const double y, const double z,
     std::array<double, nMaxVertices>& w) const {
 
+  GARFIELD_COUNT(TcadFindElement);
   w.fill(0.);
+  const std::array<double, 3> p = {x, y, z};
+  // Start from the element found in the previous call and walk 
+  // through the neighbouring tetrahedra towards the point.
+  size_t& last = LastElement();
+  const size_t nElements = m_elements.size();
+  const size_t j = Walk(last, p, w);
+  if (j < nElements) {
+    GARFIELD_COUNT(TcadWalkHits);
+    last = j;
+    return j;
+  }
   if (m_tree) {
-    const auto& elements = m_tree->GetElementsInBlock(Vec3(x, y, z));
+    const auto elements = m_tree->GetElementsInBlock(x, y, z);
     for (const auto i : elements) {
-      if (InElement(x, y, z, m_elements[i], w)) return i;
+      GARFIELD_COUNT(TcadCandidates);
+      const bool inside = m_elements[i].type == SimplexType ? 
+          InSimplex(i, p, w) : InElement(x, y, z, m_elements[i], w);
+      if (inside) {
+        last = i;
+        return i;
+      }
     }
   } else {
-    const size_t nElements = m_elements.size();
     for (size_t i = 0; i < nElements; ++i) {
       if (InElement(x, y, z, m_elements[i], w)) return i;
     }
@@ -235,6 +251,19 @@ size_t ComponentTcad3d::FindElement(
   return m_elements.size();
 }
 
+size_t ComponentTcad3d::Locate(const double xin, const double yin,
+                               const double zin,
+                               std::array<double, nMaxVertices>& w,
+                               std::array<bool, 3>& mirr) const {
+  std::array<double, 3> x = {xin, yin, zin};
+  mirr.fill(false);
+  // In case of periodicity, reduce to the cell volume.
+  MapCoordinates(x, mirr);
+  // Make sure the point is inside the bounding box.
+  if (!InBoundingBox(x)) return m_elements.size();
+  return FindElement(x[0], x[1], x[2], w);
+}
+
 bool ComponentTcad3d::GetElement(const size_t i, double& vol,
                                  double& dmin, double& dmax, int& type,
                                  std::vector<size_t>& nodes, int& reg) const {
@@ -1,13 +1,24 @@
+#include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
 
+#include <sys/stat.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include "Garfield/ComponentTcadBase.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Utilities.hh"
 
 namespace {
@@ -41,6 +52,239 @@ void PrintError(const std::string& fcn, const std::string& filename,
             << " (line " << line << ").\n";
 }
 
+// Convert the white-space separated numbers in [p, end).
+bool Convert(const char* p, const char* end, std::vector<double>& values) {
+  while (p < end) {
+    if (std::isspace(static_cast<unsigned char>(*p))) {
+      ++p;
+      continue;
+    }
+    char* q = nullptr;
+    const double v = std::strtod(p, &q);
+    if (q == p) return false;
+    values.push_back(v);
+    p = q;
+  }
+  return true;
+}
+
+bool Convert(const char* p, const char* end, std::vector<long>& values) {
+  while (p < end) {
+    if (std::isspace(static_cast<unsigned char>(*p))) {
+      ++p;
+      continue;
+    }
+    char* q = nullptr;
+    const long v = std::strtol(p, &q, 10);
+    if (q == p) return false;
+    values.push_back(v);
+    p = q;
+  }
+  return true;
+}
+
+// Read a block of numbers up to the closing brace. Large blocks are 
+// split (at white space) into chunks which are converted in parallel.
+template <typename T>
+bool ReadValues(std::istream& in, std::vector<T>& values) {
+  values.clear();
+  std::string buffer;
+  if (!std::getline(in, buffer, '}') || in.eof()) return false;
+  const size_t nChars = buffer.size();
+  size_t nChunks = 1;
+#ifdef _OPENMP
+  nChunks = std::min<size_t>(omp_get_max_threads(), 1 + (nChars >> 20));
+#endif
+  std::vector<size_t> bounds(nChunks + 1, nChars);
+  bounds[0] = 0;
+  for (size_t i = 1; i < nChunks; ++i) {
+    size_t b = std::max(bounds[i - 1], i * nChars / nChunks);
+    while (b < nChars && !std::isspace(static_cast<unsigned char>(buffer[b]))) {
+      ++b;
+    }
+    bounds[i] = b;
+  }
+  if (nChunks == 1) {
+    values.reserve(nChars / 8);
+    return Convert(buffer.c_str(), buffer.c_str() + nChars, values);
+  }
+  std::vector<std::vector<T> > chunks(nChunks);
+  std::vector<int> ok(nChunks, 1);
+  const char* s = buffer.c_str();
+  const int n = nChunks;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+  for (int i = 0; i < n; ++i) {
+    chunks[i].reserve((bounds[i + 1] - bounds[i]) / 8);
+    ok[i] = Convert(s + bounds[i], s + bounds[i + 1], chunks[i]) ? 1 : 0;
+  }
+  size_t nValues = 0;
+  for (size_t i = 0; i < nChunks; ++i) {
+    if (!ok[i]) return false;
+    nValues += chunks[i].size();
+  }
+  values.reserve(nValues);
+  for (const auto& chunk : chunks) {
+    values.insert(values.end(), chunk.begin(), chunk.end());
+  }
+  return true;
+}
+
+// Size and modification time of a file.
+std::array<int64_t, 2> GetFileStamp(const std::string& filename) {
+  struct stat fileStatus;
+  if (stat(filename.c_str(), &fileStatus) != 0) return {{-1, -1}};
+  return {{static_cast<int64_t>(fileStatus.st_size), 
+           static_cast<int64_t>(fileStatus.st_mtime)}};
+}
+
+template <typename T>
+void Write(std::ostream& out, const T& x) {
+  out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+template <typename T>
+bool Read(std::istream& in, T& x) {
+  return static_cast<bool>(in.read(reinterpret_cast<char*>(&x), sizeof(T)));
+}
+
+template <typename T>
+void WriteVector(std::ostream& out, const std::vector<T>& v) {
+  Write(out, static_cast<uint64_t>(v.size()));
+  out.write(reinterpret_cast<const char*>(v.data()), v.size() * sizeof(T));
+}
+
+template <typename T>
+bool ReadVector(std::istream& in, std::vector<T>& v) {
+  uint64_t n = 0;
+  if (!Read(in, n)) return false;
+  v.resize(n);
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(v.data()), n * sizeof(T)));
+}
+
+void WriteString(std::ostream& out, const std::string& s) {
+  Write(out, static_cast<uint64_t>(s.size()));
+  out.write(s.data(), s.size());
+}
+
+bool ReadString(std::istream& in, std::string& s) {
+  uint64_t n = 0;
+  if (!Read(in, n)) return false;
+  s.resize(n);
+  return static_cast<bool>(in.read(&s[0], n));
+}
+
+// Invert a 2 x 2 or 3 x 3 matrix (row-major) in place.
+bool Invert(std::array<double, 4>& m) {
+  const double det = m[0] * m[3] - m[1] * m[2];
+  if (det == 0.) return false;
+  const double s = 1. / det;
+  m = {{m[3] * s, -m[1] * s, -m[2] * s, m[0] * s}};
+  return true;
+}
+
+bool Invert(std::array<double, 9>& m) {
+  const std::array<double, 9> a = {{
+      m[4] * m[8] - m[5] * m[7], m[2] * m[7] - m[1] * m[8],
+      m[1] * m[5] - m[2] * m[4], m[5] * m[6] - m[3] * m[8],
+      m[0] * m[8] - m[2] * m[6], m[2] * m[3] - m[0] * m[5],
+      m[3] * m[7] - m[4] * m[6], m[1] * m[6] - m[0] * m[7],
+      m[0] * m[4] - m[1] * m[3]}};
+  const double det = m[0] * a[0] + m[1] * a[3] + m[2] * a[6];
+  if (det == 0.) return false;
+  const double s = 1. / det;
+  for (size_t i = 0; i < 9; ++i) m[i] = a[i] * s;
+  return true;
+}
+
+// Identifier and version of the binary snapshot format.
+constexpr char SnapshotTag[8] = {'G', 'T', 'C', 'A', 'D', 'B', 'I', 'N'};
+constexpr uint32_t SnapshotVersion = 1;
+
+// Interpolate in time between two consecutive entries of a node-major
+// table and add the result (multiplied by a shape function) to f.
+template <size_t M, typename T>
+void Gather(const T* p, const double w, const double f0, const double f1,
+            std::array<double, M>& f) {
+  if (f1 > 0.) {
+    for (size_t l = 0; l < M; ++l) f[l] += w * (f0 * p[l] + f1 * p[M + l]);
+  } else {
+    for (size_t l = 0; l < M; ++l) f[l] += w * f0 * p[l];
+  }
+}
+
+// Insert a map in a list of time slices (sorted by time).
+template <typename T, typename U>
+void InsertSlice(const double t, T&& map, U&& files, 
+                 std::vector<double>& times, std::vector<T>& maps,
+                 std::vector<U>& fileList) {
+  const auto it = std::upper_bound(times.begin(), times.end(), t);
+  const auto n = std::distance(times.begin(), it);
+  times.insert(it, t);
+  maps.insert(maps.begin() + n, std::move(map));
+  fileList.insert(fileList.begin() + n, std::move(files));
+}
+
+// Flag the time slices that are in memory and clear the failure flags.
+template <typename T>
+void ResetLoadFlags(const std::vector<T>& maps,
+                    std::vector<std::atomic<bool> >& flags,
+                    std::vector<std::atomic<bool> >& failed) {
+  std::vector<std::atomic<bool> > loaded(maps.size());
+  for (size_t i = 0; i < maps.size(); ++i) loaded[i] = !maps[i].empty();
+  flags.swap(loaded);
+  std::vector<std::atomic<bool> > none(maps.size());
+  for (auto& flag : none) flag = false;
+  failed.swap(none);
+}
+
+// Check if the time slice(s) needed for an interpolation are in memory.
+bool SlicesLoaded(const std::vector<std::atomic<bool> >& flags,
+                  const size_t i0, const double f1) {
+  if (i0 >= flags.size() || !flags[i0].load(std::memory_order_acquire)) {
+    return false;
+  }
+  if (f1 > 0.) {
+    if (i0 + 1 >= flags.size()) return false;
+    return flags[i0 + 1].load(std::memory_order_acquire);
+  }
+  return true;
+}
+
+// Check if reading one of the time slices needed for an interpolation
+// has failed before.
+bool SlicesFailed(const std::vector<std::atomic<bool> >& failed,
+                  const size_t i0, const double f1) {
+  if (i0 < failed.size() && failed[i0].load(std::memory_order_acquire)) {
+    return true;
+  }
+  return f1 > 0. && i0 + 1 < failed.size() &&
+         failed[i0 + 1].load(std::memory_order_acquire);
+}
+
+// Keep only every n-th time slice (and the last one).
+template <typename T, typename U>
+void Downsample(const unsigned int stride, std::vector<double>& times,
+                std::vector<T>& maps, std::vector<U>& fileList) {
+  if (stride < 2) return;
+  const size_t n = times.size();
+  size_t k = 0;
+  for (size_t i = 0; i < n; ++i) {
+    if (i % stride != 0 && i != n - 1) continue;
+    if (k != i) {
+      times[k] = times[i];
+      maps[k] = std::move(maps[i]);
+      fileList[k] = std::move(fileList[i]);
+    }
+    ++k;
+  }
+  times.resize(k);
+  maps.resize(k);
+  fileList.resize(k);
+}
+
 }
 
 namespace Garfield {
@@ -80,36 +324,27 @@ void ComponentTcadBase<N>::DelayedWeightingField(
     const double x, const double y, const double z, const double t, 
     double& wx, double& wy, double& wz, const std::string& label) {
   wx = wy = wz = 0.;
-  if (m_dwf.empty()) {
+  if (m_dwtf.empty()) {
     std::cerr << m_className << "::DelayedWeightingField: Not available.\n";
     return;
   }
-  if (m_dwtf.empty()) return;
   if (t < m_dwtf.front() || t > m_dwtf.back()) return;
 
   double dx = 0., dy = 0., dz = 0.;
   if (!GetOffset(label, dx, dy, dz)) return;
 
-  const auto it1 = std::upper_bound(m_dwtf.cbegin(), m_dwtf.cend(), t);
-  const auto it0 = std::prev(it1);
-  const double dt = t - *it0;
-  const auto i0 = std::distance(m_dwtf.cbegin(), it0);
-  double wx0 = 0., wy0 = 0., wz0 = 0.;
-  Interpolate(x - dx, y - dy, z - dz, m_dwf[i0], wx0, wy0, wz0);
-  if (dt < Small || it1 == m_dwtf.cend()) {
-    wx = wx0;
-    wy = wy0;
-    wz = wz0;
-    return;
-  }
-  const auto i1 = std::distance(m_dwtf.cbegin(), it1);
-  double wx1 = 0., wy1 = 0., wz1 = 0.;
-  Interpolate(x - dx, y - dy, z - dz, m_dwf[i1], wx1, wy1, wz1);
-  const double f1 = dt / (*it1 - *it0);
-  const double f0 = 1. - f1;
-  wx = f0 * wx0 + f1 * wx1;
-  wy = f0 * wy0 + f1 * wy1;
-  wz = f0 * wz0 + f1 * wz1;
+  std::array<double, nMaxVertices> w;
+  std::array<bool, N> mirr;
+  const size_t i = Locate(x - dx, y - dy, z - dz, w, mirr);
+  if (i >= m_elements.size()) return;
+  std::array<double, N> f;
+  if (!DelayedField(m_elements[i], w, t, f)) return;
+  for (size_t l = 0; l < N; ++l) {
+    if (mirr[l]) f[l] = -f[l];
+  }
+  wx = f[0];
+  wy = f[1];
+  if (N > 2) wz = f[N - 1];
 }
 
 template<size_t N>
@@ -117,31 +352,316 @@ double ComponentTcadBase<N>::DelayedWeightingPotential(
     const double x, const double y, const double z, const double t,
     const std::string& label) {
 
-  if (m_dwp.empty()) {
+  if (m_dwtp.empty()) {
     std::cerr << m_className << "::DelayedWeightingPotential: Not available.\n";
     return 0.;
   }
-  if (m_dwtp.empty()) return 0.;
   if (t < m_dwtp.front() || t > m_dwtp.back()) return 0.;
 
   double dx = 0., dy = 0., dz = 0.;
   if (!GetOffset(label, dx, dy, dz)) return 0.;
 
-  const auto it1 = std::upper_bound(m_dwtp.cbegin(), m_dwtp.cend(), t);
+  std::array<double, nMaxVertices> w;
+  std::array<bool, N> mirr;
+  const size_t i = Locate(x - dx, y - dy, z - dz, w, mirr);
+  if (i >= m_elements.size()) return 0.;
+  double v = 0.;
+  DelayedPotential(m_elements[i], w, t, v);
+  return v;
+} 
+
+template<size_t N>
+void ComponentTcadBase<N>::DelayedWeightingFields(
+    const double x, const double y, const double z,
+    const std::vector<double>& ts, std::vector<std::array<double, 3> >& ws,
+    const std::string& label) {
+  const size_t nt = ts.size();
+  ws.assign(nt, {0., 0., 0.});
+  if (m_dwtf.empty()) {
+    std::cerr << m_className << "::DelayedWeightingFields: Not available.\n";
+    return;
+  }
+
+  double dx = 0., dy = 0., dz = 0.;
+  if (!GetOffset(label, dx, dy, dz)) return;
+  // Locate the point once, and reuse the shape functions for all times.
+  std::array<double, nMaxVertices> w;
+  std::array<bool, N> mirr;
+  const size_t i = Locate(x - dx, y - dy, z - dz, w, mirr);
+  if (i >= m_elements.size()) return;
+  const Element& element = m_elements[i];
+  std::array<double, N> f;
+  for (size_t k = 0; k < nt; ++k) {
+    if (!DelayedField(element, w, ts[k], f)) continue;
+    for (size_t l = 0; l < N; ++l) {
+      ws[k][l] = mirr[l] ? -f[l] : f[l];
+    }
+  }
+}
+
+template<size_t N>
+void ComponentTcadBase<N>::DelayedWeightingPotentials(
+    const double x, const double y, const double z,
+    const std::vector<double>& ts, std::vector<double>& ps,
+    const std::string& label) {
+  const size_t nt = ts.size();
+  ps.assign(nt, 0.);
+  if (m_dwtp.empty()) {
+    std::cerr << m_className 
+              << "::DelayedWeightingPotentials: Not available.\n";
+    return;
+  }
+
+  double dx = 0., dy = 0., dz = 0.;
+  if (!GetOffset(label, dx, dy, dz)) return;
+  std::array<double, nMaxVertices> w;
+  std::array<bool, N> mirr;
+  const size_t i = Locate(x - dx, y - dy, z - dz, w, mirr);
+  if (i >= m_elements.size()) return;
+  const Element& element = m_elements[i];
+  for (size_t k = 0; k < nt; ++k) {
+    DelayedPotential(element, w, ts[k], ps[k]);
+  }
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::DelayedField(
+    const Element& element, const std::array<double, nMaxVertices>& w,
+    const double t, std::array<double, N>& f) {
+
+  f.fill(0.);
+  // If packing fails, fall back to the time-slice layout.
+  bool packed = m_dwNodeMajor && m_dwPacked.load(std::memory_order_acquire);
+  if (m_dwNodeMajor && !packed) packed = PackDelayedWeightingMaps();
+  size_t i0 = 0;
+  double f0 = 1., f1 = 0.;
+  if (!TimeInterpolation(m_dwtf, t, i0, f0, f1)) return false;
+  const size_t nVertices = ElementVertices(element);
+  if (packed) {
+    const size_t nt = m_dwtf.size();
+    for (size_t j = 0; j < nVertices; ++j) {
+      const size_t k = (element.vertex[j] * nt + i0) * N;
+      if (m_dwSinglePrecision) {
+        Gather<N>(&m_dwfNodeMajorF[k], w[j], f0, f1, f);
+      } else {
+        Gather<N>(&m_dwfNodeMajor[k], w[j], f0, f1, f);
+      }
+    }
+    return true;
+  }
+  if (m_lazyLoading && !SlicesLoaded(m_dwfLoaded, i0, f1)) {
+    if (SlicesFailed(m_dwfFailed, i0, f1)) return false;
+    std::lock_guard<std::mutex> guard(m_dwMutex);
+    if (!LoadDelayedWeightingField(i0)) return false;
+    if (f1 > 0. && !LoadDelayedWeightingField(i0 + 1)) return false;
+  }
+  for (size_t j = 0; j < nVertices; ++j) {
+    const auto index = element.vertex[j];
+    for (size_t l = 0; l < N; ++l) {
+      double fl = f0 * m_dwf[i0][index][l];
+      if (f1 > 0.) fl += f1 * m_dwf[i0 + 1][index][l];
+      f[l] += w[j] * fl;
+    }
+  }
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::DelayedPotential(
+    const Element& element, const std::array<double, nMaxVertices>& w,
+    const double t, double& p) {
+
+  p = 0.;
+  // If packing fails, fall back to the time-slice layout.
+  bool packed = m_dwNodeMajor && m_dwPacked.load(std::memory_order_acquire);
+  if (m_dwNodeMajor && !packed) packed = PackDelayedWeightingMaps();
+  size_t i0 = 0;
+  double f0 = 1., f1 = 0.;
+  if (!TimeInterpolation(m_dwtp, t, i0, f0, f1)) return false;
+  const size_t nVertices = ElementVertices(element);
+  if (packed) {
+    const size_t nt = m_dwtp.size();
+    std::array<double, 1> v = {0.};
+    for (size_t j = 0; j < nVertices; ++j) {
+      const size_t k = element.vertex[j] * nt + i0;
+      if (m_dwSinglePrecision) {
+        Gather<1>(&m_dwpNodeMajorF[k], w[j], f0, f1, v);
+      } else {
+        Gather<1>(&m_dwpNodeMajor[k], w[j], f0, f1, v);
+      }
+    }
+    p = v[0];
+    return true;
+  }
+  if (m_lazyLoading && !SlicesLoaded(m_dwpLoaded, i0, f1)) {
+    if (SlicesFailed(m_dwpFailed, i0, f1)) return false;
+    std::lock_guard<std::mutex> guard(m_dwMutex);
+    if (!LoadDelayedWeightingPotential(i0)) return false;
+    if (f1 > 0. && !LoadDelayedWeightingPotential(i0 + 1)) return false;
+  }
+  for (size_t j = 0; j < nVertices; ++j) {
+    const auto index = element.vertex[j];
+    double v = f0 * m_dwp[i0][index];
+    if (f1 > 0.) v += f1 * m_dwp[i0 + 1][index];
+    p += w[j] * v;
+  }
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::TimeInterpolation(
+    const std::vector<double>& times, const double t, 
+    size_t& i0, double& f0, double& f1) {
+  
+  if (times.empty() || t < times.front() || t > times.back()) return false;
+  const auto it1 = std::upper_bound(times.cbegin(), times.cend(), t);
   const auto it0 = std::prev(it1);
+  i0 = std::distance(times.cbegin(), it0);
   const double dt = t - *it0;
-  const auto i0 = std::distance(m_dwtp.cbegin(), it0);
-  double v0 = 0.;
-  Interpolate(x - dx, y - dy, z - dz, m_dwp[i0], v0);
-  if (dt < Small || it1 == m_dwtp.cend()) return v0;
-
-  const auto i1 = std::distance(m_dwtp.cbegin(), it1);
-  double v1 = 0.;
-  Interpolate(x - dx, y - dy, z - dz, m_dwp[i1], v1);
-  const double f1 = dt / (*it1 - *it0);
-  const double f0 = 1. - f1;
-  return f0 * v0 + f1 * v1;
-} 
+  if (dt < Small || it1 == times.cend()) {
+    f0 = 1.;
+    f1 = 0.;
+  } else {
+    f1 = dt / (*it1 - *it0);
+    f0 = 1. - f1;
+  }
+  return true;
+}
+
+template<size_t N>
+void ComponentTcadBase<N>::EnableNodeMajorDelayedWeighting(
+    const bool on, const bool compress, const unsigned int stride) {
+  CheckFrozen("EnableNodeMajorDelayedWeighting");
+  if (m_dwPacked) {
+    std::cerr << m_className << "::EnableNodeMajorDelayedWeighting:\n"
+              << "    Delayed weighting maps have already been packed.\n";
+    return;
+  }
+  m_dwNodeMajor = on;
+  m_dwSinglePrecision = compress;
+  m_dwStride = std::max(stride, 1U);
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::PackDelayedWeightingMaps() {
+
+  if (m_dwPackFailed.load(std::memory_order_acquire)) return false;
+  std::lock_guard<std::mutex> guard(m_dwMutex);
+  if (m_dwPacked.load(std::memory_order_relaxed)) return true;
+  if (m_dwPackFailed.load(std::memory_order_relaxed)) return false;
+  // Drop time slices that are not needed.
+  Downsample(m_dwStride, m_dwtf, m_dwf, m_dwfFiles);
+  Downsample(m_dwStride, m_dwtp, m_dwp, m_dwpFiles);
+  ResetLoadFlags(m_dwf, m_dwfLoaded, m_dwfFailed);
+  ResetLoadFlags(m_dwp, m_dwpLoaded, m_dwpFailed);
+  const size_t nVertices = m_vertices.size();
+  // Delayed weighting field.
+  const size_t ntf = m_dwtf.size();
+  if (m_dwSinglePrecision) {
+    m_dwfNodeMajorF.assign(nVertices * ntf * N, 0.f);
+  } else {
+    m_dwfNodeMajor.assign(nVertices * ntf * N, 0.);
+  }
+  for (size_t i = 0; i < ntf; ++i) {
+    if (!LoadDelayedWeightingField(i)) {
+      std::cerr << m_className << "::PackDelayedWeightingMaps:\n"
+                << "    Could not load the weighting field map for t = "
+                << m_dwtf[i] << " ns.\n"
+                << "    Delayed weighting maps are not packed.\n";
+      m_dwfNodeMajor.clear();
+      m_dwfNodeMajorF.clear();
+      m_dwPackFailed.store(true, std::memory_order_release);
+      return false;
+    }
+    for (size_t j = 0; j < nVertices; ++j) {
+      const size_t k = (j * ntf + i) * N;
+      for (size_t l = 0; l < N; ++l) {
+        if (m_dwSinglePrecision) {
+          m_dwfNodeMajorF[k + l] = m_dwf[i][j][l];
+        } else {
+          m_dwfNodeMajor[k + l] = m_dwf[i][j][l];
+        }
+      }
+    }
+    // Release the slice.
+    std::vector<std::array<double, N> >().swap(m_dwf[i]);
+    m_dwfLoaded[i] = false;
+  }
+  // Delayed weighting potential.
+  const size_t ntp = m_dwtp.size();
+  if (m_dwSinglePrecision) {
+    m_dwpNodeMajorF.assign(nVertices * ntp, 0.f);
+  } else {
+    m_dwpNodeMajor.assign(nVertices * ntp, 0.);
+  }
+  for (size_t i = 0; i < ntp; ++i) {
+    if (!LoadDelayedWeightingPotential(i)) {
+      std::cerr << m_className << "::PackDelayedWeightingMaps:\n"
+                << "    Could not load the weighting potential map for t = "
+                << m_dwtp[i] << " ns.\n"
+                << "    Delayed weighting maps are not packed.\n";
+      m_dwfNodeMajor.clear();
+      m_dwfNodeMajorF.clear();
+      m_dwpNodeMajor.clear();
+      m_dwpNodeMajorF.clear();
+      m_dwPackFailed.store(true, std::memory_order_release);
+      return false;
+    }
+    for (size_t j = 0; j < nVertices; ++j) {
+      if (m_dwSinglePrecision) {
+        m_dwpNodeMajorF[j * ntp + i] = m_dwp[i][j];
+      } else {
+        m_dwpNodeMajor[j * ntp + i] = m_dwp[i][j];
+      }
+    }
+    std::vector<double>().swap(m_dwp[i]);
+    m_dwpLoaded[i] = false;
+  }
+  m_dwPacked.store(true, std::memory_order_release);
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::LoadDelayedWeightingField(const size_t i) {
+  if (i >= m_dwf.size() || i >= m_dwfLoaded.size()) return false;
+  if (m_dwfLoaded[i].load(std::memory_order_relaxed)) return true;
+  if (m_dwfFailed[i].load(std::memory_order_relaxed)) return false;
+  const auto& files = m_dwfFiles[i];
+  if (m_debug) {
+    std::cout << m_className << "::LoadDelayedWeightingField:\n"
+              << "    Reading map for t = " << m_dwtf[i] << " ns.\n";
+  }
+  if (!ReadDelayedWeightingField(files.file1, files.file2, files.dv, m_dwf[i])) {
+    std::cerr << m_className << "::LoadDelayedWeightingField:\n"
+              << "    Map for t = " << m_dwtf[i] << " ns is not available.\n";
+    // Do not try to read the files again at every query.
+    m_dwfFailed[i].store(true, std::memory_order_release);
+    return false;
+  }
+  m_dwfLoaded[i].store(true, std::memory_order_release);
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::LoadDelayedWeightingPotential(const size_t i) {
+  if (i >= m_dwp.size() || i >= m_dwpLoaded.size()) return false;
+  if (m_dwpLoaded[i].load(std::memory_order_relaxed)) return true;
+  if (m_dwpFailed[i].load(std::memory_order_relaxed)) return false;
+  const auto& files = m_dwpFiles[i];
+  if (m_debug) {
+    std::cout << m_className << "::LoadDelayedWeightingPotential:\n"
+              << "    Reading map for t = " << m_dwtp[i] << " ns.\n";
+  }
+  if (!ReadDelayedWeightingPotential(files.file1, files.file2, files.dv, m_dwp[i])) {
+    std::cerr << m_className << "::LoadDelayedWeightingPotential:\n"
+              << "    Map for t = " << m_dwtp[i] << " ns is not available.\n";
+    // Do not try to read the files again at every query.
+    m_dwpFailed[i].store(true, std::memory_order_release);
+    return false;
+  }
+  m_dwpLoaded[i].store(true, std::memory_order_release);
+  return true;
+}
 
 template<size_t N>
 bool ComponentTcadBase<N>::GetOffset(
@@ -159,23 +679,406 @@ bool ComponentTcadBase<N>::GetOffset(
 template<size_t N>
 bool ComponentTcadBase<N>::Initialise(const std::string& gridfilename,
                                       const std::string& datafilename) {
+  CheckFrozen("Initialise");
 
+  GARFIELD_TIME(TcadInitialise);
   m_ready = false;
   Cleanup();
-  // Import mesh data from .grd file.
-  if (!LoadGrid(gridfilename)) {
+  // Size and modification time of the input files.
+  const auto grdStamp = GetFileStamp(gridfilename);
+  const auto datStamp = GetFileStamp(datafilename);
+  const std::array<int64_t, 4> stamps = {
+      {grdStamp[0], grdStamp[1], datStamp[0], datStamp[1]}};
+  const std::string cachefilename = datafilename + ".cache";
+  bool cached = false;
+  if (m_useBinaryCache && ReadSnapshot(cachefilename, &stamps)) {
+    std::cout << m_className << "::Initialise:\n"
+              << "    Reading mesh and field map from " << cachefilename 
+              << ".\n";
+    cached = true;
+  } else {
+    Cleanup();
+    // Import mesh data from .grd file.
+    if (!LoadGrid(gridfilename)) {
+      std::cerr << m_className << "::Initialise:\n"
+                << "    Importing mesh data failed.\n";
+      Cleanup();
+      return false;
+    }
+    // Import electric field, potential and other data from .dat file.
+    if (!LoadData(datafilename)) {
+      std::cerr << m_className << "::Initialise:\n"
+                << "    Importing electric field and potential failed.\n";
+      Cleanup();
+      return false;
+    }
+  }
+  if (!Finalise()) return false;
+  if (m_useBinaryCache && !cached) {
+    if (!WriteSnapshot(cachefilename, stamps)) {
+      std::cerr << m_className << "::Initialise:\n"
+                << "    Could not write " << cachefilename << ".\n";
+    }
+  }
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::SaveSnapshot(const std::string& filename) const {
+  if (!m_ready) {
+    std::cerr << m_className << "::SaveSnapshot:\n"
+              << "    Field map is not available.\n";
+    return false;
+  }
+  if (!WriteSnapshot(filename, {{-1, -1, -1, -1}})) {
+    std::cerr << m_className << "::SaveSnapshot:\n"
+              << "    Could not write " << filename << ".\n";
+    return false;
+  }
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::LoadSnapshot(const std::string& filename) {
+  CheckFrozen("LoadSnapshot");
+  m_ready = false;
+  Cleanup();
+  if (!ReadSnapshot(filename, nullptr)) {
+    std::cerr << m_className << "::LoadSnapshot:\n"
+              << "    Could not import " << filename << ".\n";
+    Cleanup();
+    return false;
+  }
+  return Finalise();
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::WriteSnapshot(
+    const std::string& filename, const std::array<int64_t, 4>& stamps) const {
+
+  std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+  if (!out) return false;
+  out.write(SnapshotTag, sizeof(SnapshotTag));
+  Write(out, SnapshotVersion);
+  Write(out, static_cast<uint32_t>(N));
+  for (const auto stamp : stamps) Write(out, stamp);
+  // Regions.
+  Write(out, static_cast<uint64_t>(m_regions.size()));
+  for (const auto& region : m_regions) {
+    WriteString(out, region.name);
+    WriteString(out, region.material);
+    Write(out, static_cast<uint8_t>(region.drift ? 1 : 0));
+  }
+  // Mesh.
+  WriteVector(out, m_vertices);
+  WriteVector(out, m_elements);
+  // Nodal data.
+  WriteVector(out, m_epot);
+  WriteVector(out, m_efield);
+  WriteVector(out, m_eVelocity);
+  WriteVector(out, m_hVelocity);
+  WriteVector(out, m_eMobility);
+  WriteVector(out, m_hMobility);
+  WriteVector(out, m_eAlpha);
+  WriteVector(out, m_hAlpha);
+  WriteVector(out, m_eLifetime);
+  WriteVector(out, m_hLifetime);
+  WriteVector(out, m_donors);
+  WriteVector(out, m_acceptors);
+  Write(out, static_cast<uint64_t>(m_donorOcc.size()));
+  for (const auto& occ : m_donorOcc) WriteVector(out, occ);
+  Write(out, static_cast<uint64_t>(m_acceptorOcc.size()));
+  for (const auto& occ : m_acceptorOcc) WriteVector(out, occ);
+  // Prompt weighting fields and potentials.
+  WriteVector(out, m_wfield);
+  WriteVector(out, m_wpot);
+  Write(out, static_cast<uint64_t>(m_wlabel.size()));
+  for (const auto& label : m_wlabel) WriteString(out, label);
+  WriteVector(out, m_wshift);
+  return static_cast<bool>(out);
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::ReadSnapshot(
+    const std::string& filename, const std::array<int64_t, 4>* stamps) {
+
+  std::ifstream in(filename, std::ios::binary);
+  if (!in) return false;
+  char tag[sizeof(SnapshotTag)];
+  uint32_t version = 0, dimension = 0;
+  if (!in.read(tag, sizeof(tag)) ||
+      !std::equal(tag, tag + sizeof(tag), SnapshotTag) ||
+      !Read(in, version) || version != SnapshotVersion ||
+      !Read(in, dimension) || dimension != N) {
+    std::cerr << m_className << "::ReadSnapshot:\n"
+              << "    " << filename << " is not a valid " << N 
+              << "D snapshot.\n";
+    return false;
+  }
+  std::array<int64_t, 4> header;
+  for (auto& stamp : header) Read(in, stamp);
+  if (stamps && header != *stamps) {
+    if (m_debug) {
+      std::cout << m_className << "::ReadSnapshot:\n"
+                << "    " << filename << " is out of date.\n";
+    }
+    return false;
+  }
+  // Regions.
+  uint64_t nRegions = 0;
+  Read(in, nRegions);
+  if (!in) return false;
+  m_regions.resize(nRegions);
+  for (auto& region : m_regions) {
+    uint8_t drift = 0;
+    ReadString(in, region.name);
+    ReadString(in, region.material);
+    Read(in, drift);
+    region.drift = drift != 0;
+    region.medium = nullptr;
+  }
+  // Mesh.
+  ReadVector(in, m_vertices);
+  ReadVector(in, m_elements);
+  // Nodal data.
+  ReadVector(in, m_epot);
+  ReadVector(in, m_efield);
+  ReadVector(in, m_eVelocity);
+  ReadVector(in, m_hVelocity);
+  ReadVector(in, m_eMobility);
+  ReadVector(in, m_hMobility);
+  ReadVector(in, m_eAlpha);
+  ReadVector(in, m_hAlpha);
+  ReadVector(in, m_eLifetime);
+  ReadVector(in, m_hLifetime);
+  ReadVector(in, m_donors);
+  ReadVector(in, m_acceptors);
+  uint64_t nOcc = 0;
+  if (!Read(in, nOcc)) return false;
+  m_donorOcc.resize(nOcc);
+  for (auto& occ : m_donorOcc) ReadVector(in, occ);
+  if (!Read(in, nOcc)) return false;
+  m_acceptorOcc.resize(nOcc);
+  for (auto& occ : m_acceptorOcc) ReadVector(in, occ);
+  // Prompt weighting fields and potentials.
+  ReadVector(in, m_wfield);
+  ReadVector(in, m_wpot);
+  uint64_t nLabels = 0;
+  if (!Read(in, nLabels)) return false;
+  m_wlabel.resize(nLabels);
+  for (auto& label : m_wlabel) ReadString(in, label);
+  ReadVector(in, m_wshift);
+  if (!in || m_wshift.size() != m_wlabel.size()) {
+    std::cerr << m_className << "::ReadSnapshot:\n"
+              << "    Error reading file " << filename << ".\n";
+    return false;
+  }
+  return true;
+}
+
+template<size_t N>
+void ComponentTcadBase<N>::FillNeighbours() {
+
+  const size_t nElements = m_elements.size();
+  std::array<int, N + 1> none;
+  none.fill(-1);
+  m_neighbours.assign(nElements, none);
+  std::array<double, N * N> undefined;
+  undefined.fill(std::numeric_limits<double>::quiet_NaN());
+  m_barycentric.assign(nElements, undefined);
+  // Facet of a simplex (opposite to vertex k).
+  struct Facet {
+    std::array<unsigned int, N> vertices;
+    unsigned int element;
+    unsigned int k;
+  };
+  std::vector<Facet> facets;
+  for (size_t i = 0; i < nElements; ++i) {
+    const auto& element = m_elements[i];
+    if (element.type != SimplexType) continue;
+    // Compute the inverse of the edge matrix.
+    const auto& v0 = m_vertices[element.vertex[0]];
+    std::array<double, N * N> m;
+    for (size_t r = 0; r < N; ++r) {
+      for (size_t c = 0; c < N; ++c) {
+        m[r * N + c] = m_vertices[element.vertex[c + 1]][r] - v0[r];
+      }
+    }
+    if (Invert(m)) m_barycentric[i] = m;
+    // Add the facets to the list.
+    for (unsigned int k = 0; k <= N; ++k) {
+      Facet facet;
+      facet.element = i;
+      facet.k = k;
+      for (unsigned int j = 0, l = 0; j <= N; ++j) {
+        if (j != k) facet.vertices[l++] = element.vertex[j];
+      }
+      std::sort(facet.vertices.begin(), facet.vertices.end());
+      facets.push_back(std::move(facet));
+    }
+  }
+  // Simplices sharing a facet are neighbours.
+  std::sort(facets.begin(), facets.end(), 
+            [](const Facet& a, const Facet& b) { 
+              return a.vertices < b.vertices; });
+  const size_t nFacets = facets.size();
+  for (size_t i = 0; i + 1 < nFacets; ++i) {
+    const auto& a = facets[i];
+    const auto& b = facets[i + 1];
+    if (a.vertices != b.vertices) continue;
+    m_neighbours[a.element][a.k] = b.element;
+    m_neighbours[b.element][b.k] = a.element;
+    ++i;
+  }
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::InSimplex(
+    const size_t i, const std::array<double, N>& x,
+    std::array<double, nMaxVertices>& w) const {
+
+  const auto& element = m_elements[i];
+  for (size_t k = 0; k < N; ++k) {
+    if (x[k] < element.bbMin[k] || x[k] > element.bbMax[k]) return false;
+  }
+  const auto& v0 = m_vertices[element.vertex[0]];
+  const auto& m = m_barycentric[i];
+  std::array<double, N> d;
+  for (size_t k = 0; k < N; ++k) d[k] = x[k] - v0[k];
+  double w0 = 1.;
+  for (size_t r = 0; r < N; ++r) {
+    double b = 0.;
+    for (size_t c = 0; c < N; ++c) b += m[r * N + c] * d[c];
+    if (!(b >= 0.)) return false;
+    w[r + 1] = b;
+    w0 -= b;
+  }
+  if (w0 < 0.) return false;
+  w[0] = w0;
+  return true;
+}
+
+template<size_t N>
+size_t ComponentTcadBase<N>::Walk(
+    size_t i, const std::array<double, N>& x,
+    std::array<double, nMaxVertices>& w) const {
+
+  const size_t nElements = m_elements.size();
+  if (m_neighbours.size() != nElements || i >= nElements) return nElements;
+  // Only walk if the point is close to the starting element.
+  const auto& element = m_elements[i];
+  for (size_t k = 0; k < N; ++k) {
+    const double d = element.bbMax[k] - element.bbMin[k];
+    if (x[k] < element.bbMin[k] - d || x[k] > element.bbMax[k] + d) {
+      return nElements;
+    }
+  }
+  constexpr unsigned int nMaxSteps = 8;
+  for (unsigned int step = 0; step < nMaxSteps; ++step) {
+    if (i >= nElements || m_elements[i].type != SimplexType) break;
+    // Compute the barycentric coordinates.
+    const auto& v0 = m_vertices[m_elements[i].vertex[0]];
+    const auto& m = m_barycentric[i];
+    std::array<double, N> d;
+    for (size_t k = 0; k < N; ++k) d[k] = x[k] - v0[k];
+    std::array<double, N + 1> b;
+    b[0] = 1.;
+    for (size_t r = 0; r < N; ++r) {
+      b[r + 1] = 0.;
+      for (size_t c = 0; c < N; ++c) b[r + 1] += m[r * N + c] * d[c];
+      b[0] -= b[r + 1];
+    }
+    size_t kmin = 0;
+    for (size_t k = 1; k <= N; ++k) {
+      if (b[k] < b[kmin]) kmin = k;
+    }
+    if (b[kmin] >= 0.) {
+      w.fill(0.);
+      std::copy(b.cbegin(), b.cend(), w.begin());
+      return i;
+    }
+    // Move to the neighbour across the facet opposite to the vertex 
+    // with the most negative coordinate.
+    const int next = m_neighbours[i][kmin];
+    if (next < 0) break;
+    i = next;
+  }
+  return nElements;
+}
+
+template<size_t N>
+size_t& ComponentTcadBase<N>::LastElement() const {
+  // Keep the last element for a few components per thread.
+  constexpr size_t nSlots = 4;
+  thread_local std::array<const void*, nSlots> owners = {};
+  thread_local std::array<size_t, nSlots> elements = {};
+  thread_local size_t next = 0;
+  for (size_t i = 0; i < nSlots; ++i) {
+    if (owners[i] == this) return elements[i];
+  }
+  const size_t i = next;
+  next = (next + 1) % nSlots;
+  owners[i] = this;
+  elements[i] = 0;
+  return elements[i];
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::Finalise() {
+
+  // Check the consistency of the mesh and the nodal data.
+  const size_t nVertices = m_vertices.size();
+  if (m_elements.empty() || nVertices == 0) {
     std::cerr << m_className << "::Initialise:\n"
-              << "    Importing mesh data failed.\n";
+              << "    Mesh is empty.\n";
     Cleanup();
     return false;
   }
-  // Import electric field, potential and other data from .dat file.
-  if (!LoadData(datafilename)) {
+  std::vector<bool> isUsed(nVertices, false);
+  for (const auto& element : m_elements) {
+    const auto nV = ElementVertices(element);
+    for (unsigned int j = 0; j < nV; ++j) {
+      if (element.vertex[j] >= nVertices) {
+        std::cerr << m_className << "::Initialise:\n"
+                  << "    Vertex index out of range.\n";
+        Cleanup();
+        return false;
+      }
+      isUsed[element.vertex[j]] = true;
+    }
+  }
+  const size_t nUnused = std::count(isUsed.begin(), isUsed.end(), false);
+  if (nUnused > 0) {
+    std::cerr << m_className << "::Initialise:\n"
+              << "    Warning: " << nUnused 
+              << " vertices do not belong to any element.\n";
+  }
+  const std::array<size_t, 12> sizes = {
+      {m_epot.size(), m_efield.size(), m_eVelocity.size(), 
+       m_hVelocity.size(), m_eMobility.size(), m_hMobility.size(),
+       m_eAlpha.size(), m_hAlpha.size(), m_eLifetime.size(), 
+       m_hLifetime.size(), m_wfield.size(), m_wpot.size()}};
+  for (const auto n : sizes) {
+    if (n == 0 || n == nVertices) continue;
     std::cerr << m_className << "::Initialise:\n"
-              << "    Importing electric field and potential failed.\n";
+              << "    Number of values does not match number of vertices.\n";
     Cleanup();
     return false;
   }
+  size_t nNonFinite = 0;
+  for (const auto& p : m_epot) {
+    if (!std::isfinite(p)) ++nNonFinite;
+  }
+  for (const auto& f : m_efield) {
+    for (size_t k = 0; k < N; ++k) {
+      if (!std::isfinite(f[k])) ++nNonFinite;
+    }
+  }
+  if (nNonFinite > 0) {
+    std::cerr << m_className << "::Initialise:\n"
+              << "    Warning: potential/field map contains " << nNonFinite
+              << " non-finite values.\n";
+  }
 
   // Find min./max. coordinates and potentials.
   for (size_t i = 0; i < N; ++i) {
@@ -203,8 +1106,10 @@ bool ComponentTcadBase<N>::Initialise(const std::string& gridfilename,
       m_bbMax[k] = std::max(m_bbMax[k], xmax[k]);
     }
   }
-  m_pMin = *std::min_element(m_epot.begin(), m_epot.end());
-  m_pMax = *std::max_element(m_epot.begin(), m_epot.end());
+  if (!m_epot.empty()) {
+    m_pMin = *std::min_element(m_epot.begin(), m_epot.end());
+    m_pMax = *std::max_element(m_epot.begin(), m_epot.end());
+  }
 
   std::cout << m_className << "::Initialise:\n"
             << "    Available data:\n";
@@ -331,6 +1236,7 @@ bool ComponentTcadBase<N>::Initialise(const std::string& gridfilename,
   }
 
   FillTree();
+  FillNeighbours();
 
   m_ready = true;
   UpdatePeriodicity();
@@ -351,6 +1257,7 @@ bool ComponentTcadBase<N>::SetWeightingField(const std::string& datfile1,
                                              const std::string& datfile2,
                                              const double dv,
                                              const std::string& label) {
+  CheckFrozen("SetWeightingField");
 
   if (!m_ready) {
     std::cerr << m_className << "::SetWeightingField:\n"
@@ -371,7 +1278,7 @@ bool ComponentTcadBase<N>::SetWeightingField(const std::string& datfile1,
   // Load first the field/potential at nominal bias.
   std::vector<std::array<double, N> > wf1;
   std::vector<double> wp1;
-  if (!LoadWeightingField(datfile1, wf1, wp1)) {
+  if (!LoadWeightingField(datfile1, wf1, wp1, true)) {
     std::cerr << m_className << "::SetWeightingField:\n"
               << "    Could not import data from " << datfile1 << ".\n";
     return false;
@@ -423,6 +1330,7 @@ template<size_t N>
 bool ComponentTcadBase<N>::SetWeightingPotential(
     const std::string& datfile1, const std::string& datfile2,
     const double dv, const double t, const std::string& label) {
+  CheckFrozen("SetWeightingPotential");
 
   if (!m_ready) {
     std::cerr << m_className << "::SetWeightingPotential:\n"
@@ -434,7 +1342,6 @@ bool ComponentTcadBase<N>::SetWeightingPotential(
                << "    Voltage difference must be > 0.\n";
      return false;
   }
-  const double s = 1. / dv;
  
   if (m_wlabel.empty()) {
     std::cerr << m_className << "::SetWeightingPotential:\n"
@@ -447,49 +1354,27 @@ bool ComponentTcadBase<N>::SetWeightingPotential(
               << "    Label does not match the existing prompt component.\n";
     return false;
   }
-
-  // Load the first map.
-  std::vector<std::array<double, N> > wf1;
-  std::vector<double> wp1;
-  if (!LoadWeightingField(datfile1, wf1, wp1)) {
+  if (m_dwPacked) {
     std::cerr << m_className << "::SetWeightingPotential:\n"
-              << "    Could not import data from " << datfile1 << ".\n";
+              << "    Delayed weighting maps have already been packed.\n";
     return false;
   }
-  // Load the second map.
-  std::vector<std::array<double, N> > wf2;
-  std::vector<double> wp2;
-  if (!LoadWeightingField(datfile2, wf2, wp2)) {
-    std::cerr << m_className << "::SetWeightingPotential:\n"
-              << "    Could not import data from " << datfile2 << ".\n";
+
+  std::vector<double> wp;
+  if (m_lazyLoading) {
+    // Only check that the files exist, the maps are read when needed.
+    if (!std::ifstream(datfile1) || !std::ifstream(datfile2)) {
+      std::cerr << m_className << "::SetWeightingPotential:\n"
+                << "    Could not open " << datfile1 << " or " << datfile2 
+                << ".\n";
+      return false;
+    }
+  } else if (!ReadDelayedWeightingPotential(datfile1, datfile2, dv, wp)) {
     return false;
   }
-  const size_t nVertices = m_vertices.size();
-  if (wp1.size() != nVertices || wp2.size() != nVertices) {
-    std::cerr << m_className << "::SetWeightingPotential:\n"
-              << "    Could not load electrostatic potentials.\n";
-    return false;
-  } 
-  if (m_wpot.size() != nVertices) {
-    std::cerr << m_className << "::SetWeightingPotential:\n"
-              << "    Prompt weighting potential not present.\n";
-    return false; 
-  }
-  std::vector<double> wp(nVertices, 0.);
-  for (size_t i = 0; i < nVertices; ++i) {
-    wp[i] = (wp2[i] - wp1[i]) * s;
-    // Subtract the prompt component.
-    wp[i] -= m_wpot[i]; 
-  }
-  if (m_dwtp.empty() || t > m_dwtp.back()) {
-    m_dwtp.push_back(t);
-    m_dwp.push_back(std::move(wp));
-  } else {
-    const auto it = std::upper_bound(m_dwtp.begin(), m_dwtp.end(), t);
-    const auto n = std::distance(m_dwtp.begin(), it);
-    m_dwtp.insert(it, t);
-    m_dwp.insert(m_dwp.begin() + n, std::move(wp));
-  }
+  DelayedMapFiles files = {datfile1, datfile2, dv};
+  InsertSlice(t, std::move(wp), std::move(files), m_dwtp, m_dwp, m_dwpFiles);
+  ResetLoadFlags(m_dwp, m_dwpLoaded, m_dwpFailed);
   return true;
 }
 
@@ -497,6 +1382,7 @@ template<size_t N>
 bool ComponentTcadBase<N>::SetWeightingField(
     const std::string& datfile1, const std::string& datfile2,
     const double dv, const double t, const std::string& label) {
+  CheckFrozen("SetWeightingField");
 
   if (!m_ready) {
     std::cerr << m_className << "::SetWeightingField:\n"
@@ -508,7 +1394,6 @@ bool ComponentTcadBase<N>::SetWeightingField(
                << "    Voltage difference must be > 0.\n";
      return false;
   }
-  const double s = 1. / dv;
  
   if (m_wlabel.empty()) {
     std::cerr << m_className << "::SetWeightingField:\n"
@@ -521,12 +1406,41 @@ bool ComponentTcadBase<N>::SetWeightingField(
               << "    Label does not match the existing prompt component.\n";
     return false;
   }
+  if (m_dwPacked) {
+    std::cerr << m_className << "::SetWeightingField:\n"
+              << "    Delayed weighting maps have already been packed.\n";
+    return false;
+  }
+
+  std::vector<std::array<double, N> > wf;
+  if (m_lazyLoading) {
+    // Only check that the files exist, the maps are read when needed.
+    if (!std::ifstream(datfile1) || !std::ifstream(datfile2)) {
+      std::cerr << m_className << "::SetWeightingField:\n"
+                << "    Could not open " << datfile1 << " or " << datfile2 
+                << ".\n";
+      return false;
+    }
+  } else if (!ReadDelayedWeightingField(datfile1, datfile2, dv, wf)) {
+    return false;
+  }
+  DelayedMapFiles files = {datfile1, datfile2, dv};
+  InsertSlice(t, std::move(wf), std::move(files), m_dwtf, m_dwf, m_dwfFiles);
+  ResetLoadFlags(m_dwf, m_dwfLoaded, m_dwfFailed);
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::ReadDelayedWeightingPotential(
+    const std::string& datfile1, const std::string& datfile2,
+    const double dv, std::vector<double>& wp) {
 
+  const double s = 1. / dv;
   // Load the first map.
   std::vector<std::array<double, N> > wf1;
   std::vector<double> wp1;
-  if (!LoadWeightingField(datfile1, wf1, wp1)) {
-    std::cerr << m_className << "::SetWeightingField:\n"
+  if (!LoadWeightingField(datfile1, wf1, wp1, true)) {
+    std::cerr << m_className << "::ReadDelayedWeightingPotential:\n"
               << "    Could not import data from " << datfile1 << ".\n";
     return false;
   }
@@ -534,43 +1448,76 @@ bool ComponentTcadBase<N>::SetWeightingField(
   std::vector<std::array<double, N> > wf2;
   std::vector<double> wp2;
   if (!LoadWeightingField(datfile2, wf2, wp2)) {
-    std::cerr << m_className << "::SetWeightingField:\n"
+    std::cerr << m_className << "::ReadDelayedWeightingPotential:\n"
+              << "    Could not import data from " << datfile2 << ".\n";
+    return false;
+  }
+  const size_t nVertices = m_vertices.size();
+  if (wp1.size() != nVertices || wp2.size() != nVertices) {
+    std::cerr << m_className << "::ReadDelayedWeightingPotential:\n"
+              << "    Could not load electrostatic potentials.\n";
+    return false;
+  } 
+  if (m_wpot.size() != nVertices) {
+    std::cerr << m_className << "::ReadDelayedWeightingPotential:\n"
+              << "    Prompt weighting potential not present.\n";
+    return false; 
+  }
+  wp.assign(nVertices, 0.);
+  for (size_t i = 0; i < nVertices; ++i) {
+    wp[i] = (wp2[i] - wp1[i]) * s;
+    // Subtract the prompt component.
+    wp[i] -= m_wpot[i]; 
+  }
+  return true;
+}
+
+template<size_t N>
+bool ComponentTcadBase<N>::ReadDelayedWeightingField(
+    const std::string& datfile1, const std::string& datfile2,
+    const double dv, std::vector<std::array<double, N> >& wf) {
+
+  const double s = 1. / dv;
+  // Load the first map.
+  std::vector<std::array<double, N> > wf1;
+  std::vector<double> wp1;
+  if (!LoadWeightingField(datfile1, wf1, wp1, true)) {
+    std::cerr << m_className << "::ReadDelayedWeightingField:\n"
+              << "    Could not import data from " << datfile1 << ".\n";
+    return false;
+  }
+  // Load the second map.
+  std::vector<std::array<double, N> > wf2;
+  std::vector<double> wp2;
+  if (!LoadWeightingField(datfile2, wf2, wp2)) {
+    std::cerr << m_className << "::ReadDelayedWeightingField:\n"
               << "    Could not import data from " << datfile2 << ".\n";
     return false;
   }
   const size_t nVertices = m_vertices.size();
   if (wf1.size() != nVertices || wf2.size() != nVertices) {
-    std::cerr << m_className << "::SetWeightingField:\n"
+    std::cerr << m_className << "::ReadDelayedWeightingField:\n"
               << "    Could not load electric field values.\n";
     return false;
   }
   if (m_wfield.size() != nVertices) {
-    std::cerr << m_className << "::SetWeightingField:\n"
+    std::cerr << m_className << "::ReadDelayedWeightingField:\n"
               << "    Prompt weighting field not present.\n";
     return false; 
   }
-  std::vector<std::array<double, N> > wf; 
   wf.resize(nVertices);
   for (size_t i = 0; i < nVertices; ++i) {
     for (size_t j = 0; j < N; ++j) {
       wf[i][j] = (wf2[i][j] - wf1[i][j]) * s;
     } 
   }
-  if (m_dwtf.empty() || t > m_dwtf.back()) {
-    m_dwtf.push_back(t);
-    m_dwf.push_back(std::move(wf));
-  } else {
-    const auto it = std::upper_bound(m_dwtf.begin(), m_dwtf.end(), t);
-    const auto n = std::distance(m_dwtf.begin(), it);
-    m_dwtf.insert(it, t);
-    m_dwf.insert(m_dwf.begin() + n, std::move(wf));
-  }
   return true;
 }
 
 template<size_t N>
 bool ComponentTcadBase<N>::SetWeightingFieldShift(
   const std::string& label, const double x, const double y, const double z) {
+  CheckFrozen("SetWeightingFieldShift");
   if (m_wlabel.empty()) {
     std::cerr << m_className << "::SetWeightingFieldShift:\n"
               << "    No map of weighting potentials/fields loaded.\n";
@@ -596,6 +1543,7 @@ bool ComponentTcadBase<N>::SetWeightingFieldShift(
 
 template<size_t N>
 void ComponentTcadBase<N>::EnableVelocityMap(const bool on) {
+  CheckFrozen("EnableVelocityMap");
   m_useVelocityMap = on;
   if (m_ready && (m_eVelocity.empty() && m_hVelocity.empty())) {
     std::cout << m_className << "::EnableVelocityMap:\n"
@@ -742,16 +1690,21 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
     }
     std::istringstream data(line);
     data >> nVertices;
-    m_vertices.resize(nVertices);
     // Get the coordinates of every vertex.
+    std::vector<double> values;
+    if (!ReadValues(gridfile, values) || values.size() != N * nVertices) {
+      PrintError(m_className + "::LoadGrid", filename, iLine);
+      std::cerr << "    Could not read vertex coordinates.\n";
+      return false;
+    }
+    m_vertices.resize(nVertices);
     for (size_t j = 0; j < nVertices; ++j) {
       for (size_t k = 0; k < N; ++k) {
-        gridfile >> m_vertices[j][k];
         // Change units from micron to cm.
-        m_vertices[j][k] *= 1.e-4;
+        m_vertices[j][k] = values[j * N + k] * 1.e-4;
       }
-      ++iLine;
     }
+    iLine += nVertices;
     break;
   }
   if (gridfile.eof()) {
@@ -783,13 +1736,20 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
     }
     std::istringstream data(line);
     data >> nEdges;
+    // Get the indices of the two endpoints.
+    std::vector<long> values;
+    if (!ReadValues(gridfile, values) || values.size() != 2 * nEdges) {
+      PrintError(m_className + "::LoadGrid", filename, iLine);
+      std::cerr << "    Could not read edges.\n";
+      return false;
+    }
     edgeP1.resize(nEdges);
     edgeP2.resize(nEdges);
-    // Get the indices of the two endpoints.
     for (size_t j = 0; j < nEdges; ++j) {
-      gridfile >> edgeP1[j] >> edgeP2[j];
-      ++iLine;
+      edgeP1[j] = values[2 * j];
+      edgeP2[j] = values[2 * j + 1];
     }
+    iLine += nEdges;
     break;
   }
   if (gridfile.eof()) {
@@ -840,18 +1800,30 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
       }
       std::istringstream data(line);
       data >> nFaces;
+      std::vector<long> values;
+      if (!ReadValues(gridfile, values)) {
+        PrintError(m_className + "::LoadGrid", filename, iLine);
+        std::cerr << "    Could not read faces.\n";
+        return false;
+      }
       faces.resize(nFaces);
       // Get the indices of the edges constituting this face.
+      size_t pos = 0;
       for (size_t j = 0; j < nFaces; ++j) {
-        gridfile >> faces[j].type;
+        faces[j].type = pos < values.size() ? values[pos++] : 0;
         if (faces[j].type != 3 && faces[j].type != 4) {
           std::cerr << m_className << "::LoadGrid:\n"
                     << "    Face with index " << j
                     << " has invalid number of edges, " << faces[j].type << ".\n";
           return false;
         }
+        if (pos + faces[j].type > values.size()) {
+          PrintError(m_className + "::LoadGrid", filename, iLine);
+          std::cerr << "    Unexpected end of face list.\n";
+          return false;
+        }
         for (int k = 0; k < faces[j].type; ++k) {
-          gridfile >> faces[j].edge[k];
+          faces[j].edge[k] = values[pos++];
         }
       }
       iLine += nFaces - 1;
@@ -885,18 +1857,35 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
     std::istringstream data(line);
     data >> nElements;
     data.clear();
+    std::vector<long> values;
+    if (!ReadValues(gridfile, values)) {
+      PrintError(m_className + "::LoadGrid", filename, iLine);
+      std::cerr << "    Could not read elements.\n";
+      return false;
+    }
+    size_t pos = 0;
+    bool truncated = false;
+    auto next = [&values, &pos, &truncated]() {
+      if (pos < values.size()) return values[pos++];
+      truncated = true;
+      return 0L;
+    };
     // Resize the list of elements.
     m_elements.resize(nElements);
     // Get type and constituting edges of each element.
     for (size_t j = 0; j < nElements; ++j) {
       ++iLine;
-      unsigned int type = 0;
-      gridfile >> type;
+      const long ltype = next();
+      if (truncated || ltype < 0) {
+        PrintError(m_className + "::LoadGrid", filename, iLine);
+        std::cerr << "    Unexpected end of element list.\n";
+        return false;
+      }
+      const unsigned int type = ltype;
       if (N == 2) {
         if (type == 0) {
           // Point
-          unsigned int p = 0; 
-          gridfile >> p;
+          const unsigned int p = next();
           // Make sure the index is not out of range.
           if (p >= nVertices) {
             PrintError(m_className + "::LoadGrid", filename, iLine);
@@ -907,8 +1896,7 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
         } else if (type == 1) {
           // Line
           for (size_t k = 0; k < 2; ++k) {
-            int p = 0;
-            gridfile >> p;
+            int p = next();
             if (p < 0) p = -p - 1;
             // Make sure the index is not out of range.
             if (p >= (int)nVertices) {
@@ -921,7 +1909,9 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
         } else if (type == 2) {
           // Triangle
           int p0 = 0, p1 = 0, p2 = 0;
-          gridfile >> p0 >> p1 >> p2;
+          p0 = next();
+          p1 = next();
+          p2 = next();
           // Negative edge index means that the sequence of the two points
           // is supposed to be inverted.
           // The actual index is then given by "-index - 1".
@@ -955,8 +1945,7 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
         } else if (type == 3) {
           // Rectangle
           for (size_t k = 0; k < 4; ++k) {
-            int p = 0;
-            gridfile >> p;
+            int p = next();
             // Make sure the index is not out of range.
             if (p >= (int)nEdges || -p - 1 >= (int)nEdges) {
               PrintError(m_className + "::LoadGrid", filename, iLine);
@@ -992,8 +1981,9 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
       } else if (N == 3) {
         if (type == 2) {
           // Triangle
-          int edge0, edge1, edge2;
-          gridfile >> edge0 >> edge1 >> edge2;
+          int edge0 = next();
+          int edge1 = next();
+          int edge2 = next();
           // Get the vertices.
           // Negative edge index means that the sequence of the two points
           // is supposed to be inverted.
@@ -1023,8 +2013,10 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
           // Negative face index means that the sequence of the edges
           // is supposed to be inverted.
           // For our purposes, the orientation does not matter.
-          int face0, face1, face2, face3;
-          gridfile >> face0 >> face1 >> face2 >> face3;
+          int face0 = next();
+          int face1 = next();
+          int face2 = next();
+          int face3 = next();
           if (face0 < 0) face0 = -face0 - 1;
           if (face1 < 0) face1 = -face1 - 1;
           if (face2 < 0) face2 = -face2 - 1;
@@ -1101,6 +2093,11 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
           return false;
         }
       }
+      if (truncated) {
+        PrintError(m_className + "::LoadGrid", filename, iLine);
+        std::cerr << "    Unexpected end of element list.\n";
+        return false;
+      }
       m_elements[j].type = type;
       m_elements[j].region = m_regions.size();
     }
@@ -1147,14 +2144,19 @@ bool ComponentTcadBase<N>::LoadGrid(const std::string& filename) {
                 << name << ".\n";
       return false;
     }
-    int nElementsRegion;
+    size_t nElementsRegion;
     data.str(line);
     data >> nElementsRegion;
     data.clear();
-    for (int j = 0; j < nElementsRegion; ++j) {
-      size_t iElement = 0;
-      gridfile >> iElement;
-      if (iElement >= m_elements.size()) {
+    std::vector<long> values;
+    if (!ReadValues(gridfile, values) || values.size() != nElementsRegion) {
+      std::cerr << m_className << "::LoadGrid:\n"
+                << "    Error reading element indices for region " 
+                << name << ".\n";
+      return false;
+    }
+    for (const long iElement : values) {
+      if (iElement < 0 || iElement >= (long)m_elements.size()) {
         std::cerr << m_className << "::LoadGrid:\n"
                   << "    Error reading element indices for region " 
                   << name << ".\n";
@@ -1414,14 +2416,27 @@ bool ComponentTcadBase<N>::ReadDataset(std::ifstream& datafile,
     std::cout << "    Region has " << nElementsInRegion << " elements and "
               << nVerticesInRegion << " vertices.\n";
   }
+  // Read the values.
+  const size_t nComponents = isVector ? N : 1;
+  std::vector<double> values;
+  if (!ReadValues(datafile, values) || 
+      values.size() != nValues * nComponents) {
+    std::cerr << m_className << "::ReadDataset:\n"
+              << "    Error reading values of dataset " << dataset 
+              << " for region " << name << ".\n";
+    return false;
+  }
+  if (ds == DonorTrapOccupation && m_donorOcc.empty()) {
+    m_donorOcc.resize(nVertices);
+  } else if (ds == AcceptorTrapOccupation && m_acceptorOcc.empty()) {
+    m_acceptorOcc.resize(nVertices);
+  }
   unsigned int ivertex = 0;
   for (int j = 0; j < nValues; ++j) {
-    // Read the next value.
-    std::array<long double, N> val;
-    if (isVector) {
-      for (size_t k = 0; k < N; ++k) datafile >> val[k];
-    } else {
-      datafile >> val[0];
+    // Get the next value.
+    std::array<double, N> val;
+    for (size_t k = 0; k < nComponents; ++k) {
+      val[k] = values[j * nComponents + k];
     }
     // Find the next vertex belonging to the region.
     while (ivertex < nVertices) {
@@ -1497,8 +2512,14 @@ bool ComponentTcadBase<N>::ReadDataset(std::ifstream& datafile,
 template<size_t N>
 bool ComponentTcadBase<N>::LoadWeightingField(
     const std::string& filename,
-    std::vector<std::array<double, N> >& wf, std::vector<double>& wp) {
+    std::vector<std::array<double, N> >& wf, std::vector<double>& wp,
+    const bool cache) {
 
+  if (cache && filename == m_wfCacheFile) {
+    wf = m_wfCacheField;
+    wp = m_wfCachePot;
+    return true;
+  }
   std::ifstream datafile(filename, std::ios::in);
   if (!datafile) {
     std::cerr << m_className << "::LoadWeightingField:\n"
@@ -1589,14 +2610,23 @@ bool ComponentTcadBase<N>::LoadWeightingField(
         isInRegion[m_elements[j].vertex[k]] = true;
       }
     }
+    // Read the values.
+    const size_t nComponents = field ? N : 1;
+    std::vector<double> values;
+    if (!ReadValues(datafile, values) || 
+        values.size() != nValues * nComponents) {
+      std::cerr << m_className << "::LoadWeightingField:\n"
+                << "    Error reading values of dataset " << dataset 
+                << " for region " << name << ".\n";
+      ok = false;
+      break;
+    }
     unsigned int ivertex = 0;
     for (int j = 0; j < nValues; ++j) {
-      // Read the next value.
+      // Get the next value.
       std::array<double, N> val;
-      if (field) {
-        for (size_t k = 0; k < N; ++k) datafile >> val[k];
-      } else {
-        datafile >> val[0];
+      for (size_t k = 0; k < nComponents; ++k) {
+        val[k] = values[j * nComponents + k];
       }
       // Find the next vertex belonging to the region.
       while (ivertex < nVertices) {
@@ -1626,6 +2656,11 @@ bool ComponentTcadBase<N>::LoadWeightingField(
               << "    Error reading file " << filename << "\n";
     return false;
   }
+  if (cache) {
+    m_wfCacheFile = filename;
+    m_wfCacheField = wf;
+    m_wfCachePot = wp;
+  }
   return true;
 }
 
@@ -1672,6 +2707,7 @@ void ComponentTcadBase<N>::GetRegion(const size_t i, std::string& name,
 
 template<size_t N>
 void ComponentTcadBase<N>::SetDriftRegion(const size_t i) {
+  CheckFrozen("SetDriftRegion");
   if (i >= m_regions.size()) {
     std::cerr << m_className << "::SetDriftRegion: Index out of range.\n";
     return;
@@ -1681,6 +2717,7 @@ void ComponentTcadBase<N>::SetDriftRegion(const size_t i) {
 
 template<size_t N>
 void ComponentTcadBase<N>::UnsetDriftRegion(const size_t i) {
+  CheckFrozen("UnsetDriftRegion");
   if (i >= m_regions.size()) {
     std::cerr << m_className << "::UnsetDriftRegion: Index out of range.\n";
     return;
@@ -1690,6 +2727,7 @@ void ComponentTcadBase<N>::UnsetDriftRegion(const size_t i) {
 
 template<size_t N>
 void ComponentTcadBase<N>::SetMedium(const size_t i, Medium* medium) {
+  CheckFrozen("SetMedium");
   if (i >= m_regions.size()) {
     std::cerr << m_className << "::SetMedium: Index out of range.\n";
     return;
@@ -1704,6 +2742,7 @@ void ComponentTcadBase<N>::SetMedium(const size_t i, Medium* medium) {
 template<size_t N>
 void ComponentTcadBase<N>::SetMedium(const std::string& material, 
                                      Medium* medium) {
+  CheckFrozen("SetMedium");
   if (!medium) {
     std::cerr << m_className << "::SetMedium: Null pointer.\n";
     return;
@@ -1728,6 +2767,7 @@ template<size_t N>
 bool ComponentTcadBase<N>::SetDonor(const size_t donorNumber,
                                const double eXsec, const double hXsec,
                                const double conc) {
+  CheckFrozen("SetDonor");
   if (donorNumber >= m_donors.size()) {
     std::cerr << m_className << "::SetDonor: Index out of range.\n";
     return false;
@@ -1744,6 +2784,7 @@ template<size_t N>
 bool ComponentTcadBase<N>::SetAcceptor(const size_t acceptorNumber,
                                   const double eXsec, const double hXsec,
                                   const double conc) {
+  CheckFrozen("SetAcceptor");
   if (acceptorNumber >= m_acceptors.size()) {
     std::cerr << m_className << "::SetAcceptor: Index out of range.\n";
     return false;
@@ -1868,8 +2909,25 @@ void ComponentTcadBase<N>::Cleanup() {
   m_wshift.clear();
   m_dwf.clear();
   m_dwp.clear();
+  m_dwfLoaded.clear();
+  m_dwpLoaded.clear();
+  m_dwfFailed.clear();
+  m_dwpFailed.clear();
   m_dwtp.clear();
   m_dwtf.clear();
+  m_dwfFiles.clear();
+  m_dwpFiles.clear();
+  m_dwfNodeMajor.clear();
+  m_dwpNodeMajor.clear();
+  m_dwfNodeMajorF.clear();
+  m_dwpNodeMajorF.clear();
+  m_dwPacked = false;
+  m_dwPackFailed = false;
+  m_wfCacheFile.clear();
+  m_wfCacheField.clear();
+  m_wfCachePot.clear();
+  m_neighbours.clear();
+  m_barycentric.clear();
 
   // Other data.
   m_eVelocity.clear();
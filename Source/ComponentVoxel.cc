@@ -1,13 +1,24 @@
 #include <algorithm>
 #include <cmath>
-#include <fstream>
 #include <iostream>
-#include <sstream>
+#include <limits>
 #include <string>
 
 #include "Garfield/ComponentVoxel.hh"
-#include "Garfield/Utilities.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/GridFile.hh"
+
+namespace {
+
+// Convert a value read from an index column.
+unsigned int ToIndex(const double u) {
+  constexpr double nMax = std::numeric_limits<unsigned int>::max();
+  // Negative indices wrap around (as when reading an unsigned integer).
+  return u < 0. || u > nMax ? std::numeric_limits<unsigned int>::max()
+                            : static_cast<unsigned int>(u);
+}
+
+}  // namespace
 
 namespace Garfield {
 
@@ -157,6 +168,7 @@ double ComponentVoxel::DelayedWeightingPotential(
 
 void ComponentVoxel::SetWeightingFieldOffset(const double x, const double y,
                                              const double z) {
+  CheckFrozen("SetWeightingFieldOffset");
   m_wField_xOffset = x;
   m_wField_yOffset = y;
   m_wField_zOffset = z;
@@ -205,6 +217,7 @@ void ComponentVoxel::SetMesh(const unsigned int nx, const unsigned int ny,
                              const double xmax, const double ymin,
                              const double ymax, const double zmin,
                              const double zmax) {
+  CheckFrozen("SetMesh");
   Reset();
   if (nx == 0 || ny == 0 || nz == 0) {
     std::cerr << m_className << "::SetMesh:\n"
@@ -241,6 +254,7 @@ bool ComponentVoxel::LoadElectricField(const std::string& fname,
                                        const bool withP, const bool withR,
                                        const double scaleX, const double scaleE,
                                        const double scaleP) {
+  CheckFrozen("LoadElectricField");
   m_ready = false;
   m_efields.clear();
   m_hasPotential = m_hasEfield = false;
@@ -274,6 +288,7 @@ bool ComponentVoxel::LoadWeightingField(const std::string& fname,
                                         const double scaleX, 
                                         const double scaleE,
                                         const double scaleP) {
+  CheckFrozen("LoadWeightingField");
   m_hasWfield = false;
   if (!m_hasMesh) {
     std::cerr << m_className << "::LoadWeightingField:\n"
@@ -297,6 +312,7 @@ bool ComponentVoxel::LoadWeightingField(const std::string& fname,
                                         const double t, const bool withP, 
                                         const double scaleX, const double scaleE,
                                         const double scaleP) {
+  CheckFrozen("LoadWeightingField");
 
   if (!m_hasMesh) {
     std::cerr << m_className << "::LoadWeightingField:\n"
@@ -328,6 +344,7 @@ bool ComponentVoxel::LoadMagneticField(const std::string& fname,
                                        const std::string& fmt,
                                        const double scaleX,
                                        const double scaleB) {
+  CheckFrozen("LoadMagneticField");
   m_hasBfield = false;
   if (!m_hasMesh) {
     std::cerr << m_className << "::LoadMagneticField:\n"
@@ -357,19 +374,6 @@ bool ComponentVoxel::LoadData(const std::string& filename, std::string format,
     return false;
   }
 
-  unsigned int nValues = 0;
-  // Keep track of which elements have been read.
-  std::vector<std::vector<std::vector<bool> > > isSet(
-      m_nX,
-      std::vector<std::vector<bool> >(m_nY, std::vector<bool>(m_nZ, false)));
-
-  std::ifstream infile(filename);
-  if (!infile) {
-    std::cerr << m_className << "::LoadData:\n"
-              << "    Could not open file " << filename << ".\n";
-    return false;
-  }
-
   std::transform(format.begin(), format.end(), format.begin(), toupper);
   unsigned int fmt = 0;
   if (format == "XY") {
@@ -382,169 +386,97 @@ bool ComponentVoxel::LoadData(const std::string& filename, std::string format,
     fmt = 4;
   } else if (format == "YXZ") {
     fmt = 5;
+  } else if (format == "BIN" || format == "BINARY") {
+    return LoadBinary(filename, withPotential, withRegion, scaleF, scaleP,
+                      fields);
   } else {
     std::cerr << m_className << "::LoadData:\n"
               << "    Unknown format (" << format << ").\n";
     return false;
   }
-  std::string line;
-  unsigned int nLines = 0;
+
+  unsigned int nValues = 0;
+  // Keep track of which elements have been read.
+  std::vector<std::vector<std::vector<bool> > > isSet(
+      m_nX,
+      std::vector<std::vector<bool> >(m_nY, std::vector<bool>(m_nZ, false)));
+
+  // Number of columns with coordinates or indices.
+  const unsigned int nCoordinates = fmt == 1 || fmt == 3 ? 2 : 3;
+  const unsigned int nIndices = fmt == 3 || fmt == 4 ? nCoordinates : 0;
+  // Columns with the potential and the region.
+  const unsigned int colP = 2 * nCoordinates;
+  const unsigned int colR = withPotential ? colP + 1 : colP;
+  const unsigned int nColumns = withRegion ? colR + 1 : colR;
   bool bad = false;
-  // Read the file line by line.
-  while (std::getline(infile, line)) {
-    ++nLines;
-    // Strip white space from beginning of line.
-    ltrim(line);
-    // Skip empty lines.
-    if (line.empty()) continue;
-    // Skip comments.
-    if (line[0] == '#') continue;
-    if (line[0] == '/' && line[1] == '/') continue;
+  auto row = [&](const size_t line, const double* val, const unsigned int n) {
     unsigned int i = 0;
     unsigned int j = 0;
     unsigned int k = 0;
-    double fx = 0.;
-    double fy = 0.;
-    double fz = 0.;
-    double v = 0.;
-    int region = 0;
-    std::istringstream data(line);
-    if (fmt == 1) {
-      // "XY"
-      double x, y;
-      data >> x >> y;
-      if (data.fail()) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Cannot retrieve element coordinates.\n";
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      const double z = 0.5 * (m_zMin + m_zMax);
-      bool xMirrored, yMirrored, zMirrored;
-      if (!GetElement(x, y, z, i, j, k, xMirrored, yMirrored, zMirrored)) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Point is outside mesh.\n";
-        bad = true;
-        break;
-      }
-    } else if (fmt == 2) {
-      // "XYZ"
-      double x, y, z;
-      data >> x >> y >> z;
-      if (data.fail()) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Cannot retrieve element coordinates.\n";
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
-      bool xMirrored, yMirrored, zMirrored;
-      if (!GetElement(x, y, z, i, j, k, xMirrored, yMirrored, zMirrored)) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Point is outside mesh.\n";
-        bad = true;
-        break;
-      }
-    } else if (fmt == 3) {
-      // "IJ"
-      k = 0;
-      data >> i >> j;
-      if (data.fail()) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Cannot retrieve element index.\n";
-        bad = true;
-        break;
-      }
-    } else if (fmt == 4) {
-      // "IJK"
-      data >> i >> j >> k;
-      if (data.fail()) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Cannot retrieve element index.\n";
-        bad = true;
-        break;
-      }
-    } else if (fmt == 5) {
-      // "YXZ"
-      double x, y, z, temp;
-      data >> y >> x >> temp;
-      z = temp;
-      if (data.fail()) {
-        std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
-                  << "    Cannot retrieve element coordinates.\n";
-        bad = true;
-        break;
-      }
-      x *= scaleX;
-      y *= scaleX;
-      z *= scaleX;
+    if (n < nCoordinates) {
+      std::cerr << m_className << "::LoadData:\n"
+                << "    Error reading line " << line << ".\n"
+                << (nIndices > 0 ? "    Cannot retrieve element index.\n"
+                    : "    Cannot retrieve element coordinates.\n");
+      bad = true;
+      return false;
+    }
+    if (nIndices > 0) {
+      i = ToIndex(val[0]);
+      j = ToIndex(val[1]);
+      if (fmt == 4) k = ToIndex(val[2]);
+    } else {
+      // "XY", "XYZ" or "YXZ"
+      double x = val[0] * scaleX;
+      double y = val[1] * scaleX;
+      if (fmt == 5) std::swap(x, y);
+      const double z = fmt == 1 ? 0.5 * (m_zMin + m_zMax) : val[2] * scaleX;
       bool xMirrored, yMirrored, zMirrored;
       if (!GetElement(x, y, z, i, j, k, xMirrored, yMirrored, zMirrored)) {
         std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
+                  << "    Error reading line " << line << ".\n"
                   << "    Point is outside mesh.\n";
         bad = true;
-        break;
+        return false;
       }
     }
     // Check the indices.
     if (i >= m_nX || j >= m_nY || k >= m_nZ) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Index (" << i << ", " << j << ", " << k
                 << ") out of range.\n";
-      continue;
+      return true;
     }
     if (isSet[i][j][k]) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Mesh element (" << i << ", " << j << ", " << k
                 << ") has already been set.\n";
-      continue;
+      return true;
     }
     // Get the field values.
-    if (fmt == 1 || fmt == 3) {
-      // Two-dimensional field-map
-      fz = 0.;
-      data >> fx >> fy;
-    } else if (fmt == 5) {
-      double temp;
-      data >> fy >> fx >> temp;
-      fz = temp;
-    } else {
-      data >> fx >> fy >> fz;
-    }
-    if (data.fail()) {
+    if (n < colP) {
       std::cerr << m_className << "::LoadData:\n"
-                << "    Error reading line " << nLines << ".\n"
+                << "    Error reading line " << line << ".\n"
                 << "    Cannot read field values.\n";
       bad = true;
-      break;
+      return false;
     }
-    fx *= scaleF;
-    fy *= scaleF;
-    fz *= scaleF;
+    double fx = val[nCoordinates] * scaleF;
+    double fy = val[nCoordinates + 1] * scaleF;
+    const double fz = nCoordinates > 2 ? val[nCoordinates + 2] * scaleF : 0.;
+    if (fmt == 5) std::swap(fx, fy);
+    double v = 0.;
     if (withPotential) {
-      data >> v;
-      if (data.fail()) {
+      if (n <= colP) {
         std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
+                  << "    Error reading line " << line << ".\n"
                   << "    Cannot read potential.\n";
         bad = true;
-        break;
+        return false;
       }
-      v *= scaleP;
+      v = val[colP] * scaleP;
       if (m_pMin > m_pMax) {
         // First value.
         m_pMin = v;
@@ -554,15 +486,16 @@ bool ComponentVoxel::LoadData(const std::string& filename, std::string format,
         if (v > m_pMax) m_pMax = v;
       }
     }
+    int region = 0;
     if (withRegion) {
-      data >> region;
-      if (data.fail()) {
+      if (n <= colR) {
         std::cerr << m_className << "::LoadData:\n"
-                  << "    Error reading line " << nLines << ".\n"
+                  << "    Error reading line " << line << ".\n"
                   << "    Cannot read region.\n";
         bad = true;
-        break;
+        return false;
       }
+      region = static_cast<int>(val[colR]);
     }
     if (fmt == 1 || fmt == 3) {
       // Two-dimensional field-map
@@ -583,8 +516,15 @@ bool ComponentVoxel::LoadData(const std::string& filename, std::string format,
       isSet[i][j][k] = true;
     }
     ++nValues;
+    return true;
+  };
+  if (!GridFile::ReadTable(filename, nColumns, nIndices, row)) {
+    if (!bad) {
+      std::cerr << m_className << "::LoadData:\n"
+                << "    Could not open file " << filename << ".\n";
+    }
+    return false;
   }
-  if (bad) return false;
   std::cout << m_className << "::LoadData:\n"
             << "    Read " << nValues << " values from " << filename << ".\n";
   unsigned int nExpected = m_nX * m_nY;
@@ -596,6 +536,95 @@ bool ComponentVoxel::LoadData(const std::string& filename, std::string format,
   return true;
 }
 
+bool ComponentVoxel::LoadBinary(const std::string& filename,
+    const bool withPotential, const bool withRegion,
+    const double scaleF, const double scaleP,
+    std::vector<std::vector<std::vector<Element> > >& fields) {
+
+  GridFile infile;
+  if (!infile.Open(filename)) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    Could not import " << filename << ".\n";
+    return false;
+  }
+  const auto& header = infile.GetHeader();
+  bool match = !header.cylindrical && header.n[0] == m_nX &&
+               header.n[1] == m_nY && header.n[2] == m_nZ;
+  const std::array<double, 3> xmin = {m_xMin, m_yMin, m_zMin};
+  const std::array<double, 3> xmax = {m_xMax, m_yMax, m_zMax};
+  for (size_t i = 0; i < 3; ++i) {
+    const double tol = 1.e-6 * std::max(xmax[i] - xmin[i], 1.e-10);
+    if (std::abs(header.xmin[i] * header.scaleX - xmin[i]) > tol ||
+        std::abs(header.xmax[i] * header.scaleX - xmax[i]) > tol) {
+      match = false;
+    }
+  }
+  if (!match) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    Mesh in " << filename << " (" << header.n[0] << " x "
+              << header.n[1] << " x " << header.n[2] << " elements, "
+              << (header.cylindrical ? "cylindrical" : "Cartesian")
+              << " coordinates) does not match.\n";
+    return false;
+  }
+  if (withPotential && !header.withPotential) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    " << filename << " does not contain potentials.\n";
+    return false;
+  }
+  if (withRegion && !header.withFlag) {
+    std::cerr << m_className << "::LoadBinary:\n"
+              << "    " << filename << " does not contain regions.\n";
+    return false;
+  }
+  const double* fx = infile.GetValues(0);
+  const double* fy = infile.GetValues(1);
+  const double* fz = infile.GetValues(2);
+  const double* v = withPotential ? infile.GetValues(3) : nullptr;
+  const int32_t* regions = withRegion ? infile.GetFlags() : nullptr;
+  const double sf = scaleF * header.scaleF;
+  const double sp = scaleP * header.scaleP;
+  const int nx = m_nX;
+  const size_t ny = m_nY;
+  const size_t nz = m_nZ;
+  double pmin = std::numeric_limits<double>::max();
+  double pmax = std::numeric_limits<double>::lowest();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) reduction(min : pmin) \
+    reduction(max : pmax)
+#endif
+  for (int i = 0; i < nx; ++i) {
+    for (size_t j = 0; j < ny; ++j) {
+      for (size_t k = 0; k < nz; ++k) {
+        const size_t l = (i * ny + j) * nz + k;
+        auto& element = fields[i][j][k];
+        element.fx = fx[l] * sf;
+        element.fy = fy[l] * sf;
+        element.fz = fz[l] * sf;
+        if (v) {
+          element.v = v[l] * sp;
+          pmin = std::min(pmin, element.v);
+          pmax = std::max(pmax, element.v);
+        }
+        if (regions) m_regions[i][j][k] = regions[l];
+      }
+    }
+  }
+  if (withPotential) {
+    if (m_pMin > m_pMax) {
+      m_pMin = pmin;
+      m_pMax = pmax;
+    } else {
+      m_pMin = std::min(m_pMin, pmin);
+      m_pMax = std::max(m_pMax, pmax);
+    }
+  }
+  std::cout << m_className << "::LoadBinary:\n"
+            << "    Read " << infile.GetNumberOfNodes() << " values from "
+            << filename << ".\n";
+  return true;
+}
+
 bool ComponentVoxel::GetBoundingBox(double& xmin, double& ymin, double& zmin,
                                     double& xmax, double& ymax, double& zmax) {
   if (!m_ready) return false;
@@ -696,6 +725,7 @@ void ComponentVoxel::PrintRegions() const {
 }
 
 void ComponentVoxel::SetMedium(const unsigned int i, Medium* m) {
+  CheckFrozen("SetMedium");
   if (!m) {
     std::cerr << m_className << "::SetMedium: Null pointer.\n";
     if (m_media.empty()) return;
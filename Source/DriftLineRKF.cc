@@ -6,6 +6,7 @@
 #include "Garfield/DriftLineRKF.hh"
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Numerics.hh"
 #include "Garfield/Random.hh"
 
@@ -301,6 +302,7 @@ bool DriftLineRKF::DriftLine(const Vec& xi, const double ti,
                              std::vector<double>& ts,
                              std::vector<Vec>& xs, int& flag) const {
 
+  GARFIELD_TIME(DriftLineRKF);
   // -----------------------------------------------------------------------
   //    DLCALC - Subroutine doing the actual drift line calculations. 
   //             The calculations are based on a Runge-Kutta-Fehlberg method
@@ -901,19 +903,13 @@ Vec DriftLineRKF::GetVelocity(const std::array<double, 3>& x,
   } 
   if (m_useVelocityMap && 
       particle != Particle::Ion && particle != Particle::NegativeIon) {
-    // We assume there is only one component with a velocity map.
-    const auto nComponents = m_sensor->GetNumberOfComponents();
-    for (size_t i = 0; i < nComponents; ++i) {
-      auto cmp = m_sensor->GetComponent(i);
-      if (!cmp->HasVelocityMap()) continue;
-      bool ok = false;
-      if (particle == Particle::Electron || particle == Particle::Positron) {
-        ok = cmp->ElectronVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
-      } else if (particle == Particle::Hole) {
-        ok = cmp->HoleVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
-      }
-      if (!ok) continue;
-      // Seems to have worked.
+    bool ok = false;
+    if (particle == Particle::Electron || particle == Particle::Positron) {
+      ok = m_sensor->ElectronVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
+    } else if (particle == Particle::Hole) {
+      ok = m_sensor->HoleVelocity(x[0], x[1], x[2], v[0], v[1], v[2]);
+    }
+    if (ok) {
       if (particle == Particle::Positron) {
         for (unsigned int k = 0; k < 3; ++k) v[k] *= -1;
       }
@@ -991,16 +987,10 @@ double DriftLineRKF::GetAlpha(const std::array<double, 3>& x,
   double alpha = 0.;
   if (m_useTownsendMap && (particle == Particle::Electron || 
       particle == Particle::Hole || particle == Particle::Positron)) {
-    const auto nComponents = m_sensor->GetNumberOfComponents();
-    for (size_t i = 0; i < nComponents; ++i) {
-      auto cmp = m_sensor->GetComponent(i);
-      if (!cmp->HasTownsendMap()) continue;
-      if (particle == Particle::Electron || particle == Particle::Positron) {
-        if (!cmp->ElectronTownsend(x[0], x[1], x[2], alpha)) continue;
-      } else {
-        if (!cmp->HoleTownsend(x[0], x[1], x[2], alpha)) continue;
-      }
-      return alpha;
+    if (particle == Particle::Electron || particle == Particle::Positron) {
+      if (m_sensor->ElectronTownsend(x[0], x[1], x[2], alpha)) return alpha;
+    } else {
+      if (m_sensor->HoleTownsend(x[0], x[1], x[2], alpha)) return alpha;
     }
   }
   double ex = 0., ey = 0., ez = 0.;
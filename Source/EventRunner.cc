@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <iostream>
+#include <map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <TROOT.h>
+
+#include "Garfield/EventRunner.hh"
+#include "Garfield/Medium.hh"
+#include "Garfield/Random.hh"
+
+namespace {
+
+// Derive the seed of an event from the global seed (SplitMix64).
+unsigned int EventSeed(const unsigned long long seed, const size_t event) {
+  unsigned long long z = seed + (event + 1) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z ^= z >> 31;
+  const unsigned int s = static_cast<unsigned int>(z ^ (z >> 32));
+  // TRandom3 uses a time-dependent seed for zero.
+  return s == 0 ? 1 : s;
+}
+
+}  // namespace
+
+namespace Garfield {
+
+EventRunner::EventRunner(Sensor* sensor) : m_sensor(sensor) {
+#ifdef _OPENMP
+  m_nThreads = std::max(omp_get_max_threads(), 1);
+#endif
+}
+
+void EventRunner::SetNumberOfThreads(const unsigned int n) {
+  m_nThreads = n > 0 ? n : 1;
+#ifndef _OPENMP
+  if (m_nThreads > 1) {
+    std::cerr << m_className << "::SetNumberOfThreads:\n"
+              << "    Compiled without OpenMP. Events are run sequentially.\n";
+  }
+#endif
+}
+
+void EventRunner::AddMedium(Medium* medium) {
+  if (!medium) {
+    std::cerr << m_className << "::AddMedium: Null pointer.\n";
+    return;
+  }
+  if (std::find(m_media.begin(), m_media.end(), medium) != m_media.end()) {
+    return;
+  }
+  m_media.push_back(medium);
+}
+
+void EventRunner::AddHistogram(TH1* histogram) {
+  if (!histogram) {
+    std::cerr << m_className << "::AddHistogram: Null pointer.\n";
+    return;
+  }
+  m_histograms.push_back(histogram);
+}
+
+bool EventRunner::Run(const size_t nEvents, EventFunction fcn) {
+  if (!m_sensor) {
+    std::cerr << m_className << "::Run: Sensor is not defined.\n";
+    return false;
+  }
+  if (!fcn) {
+    std::cerr << m_className << "::Run: Event function is not defined.\n";
+    return false;
+  }
+  // Freeze the components and media (unless they are frozen already).
+  std::vector<Component*> components;
+  std::vector<Medium*> media;
+  if (!Freeze(components, media)) {
+    for (auto cmp : components) cmp->Unfreeze();
+    for (auto medium : media) medium->Unfreeze();
+    return false;
+  }
+  if (m_nThreads > 1) ROOT::EnableThreadSafety();
+  CreateWorkers();
+  m_endpoints = Endpoints();
+
+  const size_t nWorkers = m_workers.size();
+  const size_t nPerBatch = nWorkers * m_eventsPerBatch;
+  for (size_t first = 0; first < nEvents; first += nPerBatch) {
+    const size_t last = std::min(nEvents, first + nPerBatch);
+    // Event i is always processed by worker (i - first) % nWorkers.
+    const long long n = nWorkers;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nWorkers) \
+    if (nWorkers > 1)
+#endif
+    for (long long t = 0; t < n; ++t) {
+      Worker& worker = *m_workers[t];
+      for (size_t i = first + t; i < last; i += nWorkers) {
+        worker.rng.SetSeed(EventSeed(m_seed, i));
+        SetThreadRandomEngine(&worker.rng);
+        worker.sensor.NewSignal();
+        fcn(i, worker);
+        if (m_collectEndpoints) CollectEndpoints(worker);
+      }
+      SetThreadRandomEngine(nullptr);
+    }
+    Reduce(last - first);
+    if (m_debug) {
+      std::cout << m_className << "::Run: Processed " << last << " of "
+                << nEvents << " events.\n";
+    }
+  }
+  m_workers.clear();
+  for (auto cmp : components) cmp->Unfreeze();
+  for (auto medium : media) medium->Unfreeze();
+  return true;
+}
+
+bool EventRunner::Freeze(std::vector<Component*>& components,
+                         std::vector<Medium*>& media) {
+  const size_t nComponents = m_sensor->GetNumberOfComponents();
+  for (size_t i = 0; i < nComponents; ++i) {
+    Component* cmp = m_sensor->GetComponent(i);
+    if (!cmp || cmp->IsFrozen()) continue;
+    if (!cmp->Freeze()) {
+      std::cerr << m_className << "::Run: Component " << i
+                << " could not be prepared.\n";
+      return false;
+    }
+    components.push_back(cmp);
+  }
+  for (auto medium : m_media) {
+    if (medium->IsFrozen()) continue;
+    if (!medium->Freeze()) {
+      std::cerr << m_className << "::Run: Medium " << medium->GetName()
+                << " could not be prepared.\n";
+      return false;
+    }
+    media.push_back(medium);
+  }
+  return true;
+}
+
+void EventRunner::CreateWorkers() {
+  m_workers.clear();
+  m_engineHistograms.clear();
+  char distanceOption = 'r';
+  if (m_microscopic) {
+    for (TH1* hist : {m_microscopic->GetElectronEnergyHistogram(),
+                      m_microscopic->GetHoleEnergyHistogram(),
+                      m_microscopic->GetDistanceHistogram(distanceOption),
+                      m_microscopic->GetSecondaryEnergyHistogram()}) {
+      if (!hist || std::find(m_engineHistograms.begin(),
+                             m_engineHistograms.end(),
+                             hist) != m_engineHistograms.end()) {
+        continue;
+      }
+      m_engineHistograms.push_back(hist);
+    }
+  }
+  auto clone = [](TH1* hist, const unsigned int i) {
+    const std::string name =
+        std::string(hist->GetName()) + "_" + std::to_string(i);
+    TH1* copy = static_cast<TH1*>(hist->Clone(name.c_str()));
+    copy->SetDirectory(nullptr);
+    copy->Reset();
+    return copy;
+  };
+  for (unsigned int i = 0; i < m_nThreads; ++i) {
+    std::unique_ptr<Worker> worker(new Worker());
+    worker->index = i;
+    worker->sensor.CopySettings(*m_sensor);
+    // The space charge is modified during an event, so each worker needs
+    // its own copy (shared by its transport engines).
+    std::map<ComponentSpaceCharge*, ComponentSpaceCharge*> copies;
+    auto copySpaceCharge = [&worker, &copies](ComponentSpaceCharge* sc) {
+      auto it = copies.find(sc);
+      if (it != copies.end()) return it->second;
+      ComponentSpaceCharge* copy = new ComponentSpaceCharge(*sc);
+      worker->spaceCharge.emplace_back(copy);
+      copy->Unfreeze();
+      copy->ClearCharges();
+      Sensor& sensor = worker->sensor;
+      const size_t nComponents = sensor.GetNumberOfComponents();
+      for (size_t j = 0; j < nComponents; ++j) {
+        if (sensor.GetComponent(j) != sc) continue;
+        sensor.EnableComponent(j, false);
+        sensor.AddComponent(copy);
+        break;
+      }
+      copies[sc] = copy;
+      return copy;
+    };
+    if (m_mc) {
+      worker->mc.reset(new AvalancheMC(*m_mc));
+      auto mc = worker->mc.get();
+      mc->SetSensor(&worker->sensor);
+      mc->DisablePlotting();
+      if (mc->GetSpaceCharge()) {
+        mc->EnableSpaceCharge(copySpaceCharge(mc->GetSpaceCharge()),
+                              mc->GetSpaceChargeInterval());
+      }
+    }
+    if (m_microscopic) {
+      worker->microscopic.reset(new AvalancheMicroscopic(*m_microscopic));
+      auto aval = worker->microscopic.get();
+      aval->SetSensor(&worker->sensor);
+      if (aval->GetSpaceCharge()) {
+        aval->EnableSpaceCharge(copySpaceCharge(aval->GetSpaceCharge()),
+                                aval->GetSpaceChargeInterval());
+      }
+      aval->DisablePlotting();
+      // Fill per-thread copies of the histograms.
+      for (TH1* hist : m_engineHistograms) {
+        worker->engineHistograms.emplace_back(clone(hist, i));
+      }
+      auto local = [this, &worker](TH1* hist) {
+        const auto it = std::find(m_engineHistograms.begin(),
+                                  m_engineHistograms.end(), hist);
+        return worker->engineHistograms[it - m_engineHistograms.begin()].get();
+      };
+      TH1* hist = m_microscopic->GetElectronEnergyHistogram();
+      if (hist) aval->EnableElectronEnergyHistogramming(local(hist));
+      hist = m_microscopic->GetHoleEnergyHistogram();
+      if (hist) aval->EnableHoleEnergyHistogramming(local(hist));
+      hist = m_microscopic->GetDistanceHistogram(distanceOption);
+      if (hist) aval->SetDistanceHistogram(local(hist), distanceOption);
+      hist = m_microscopic->GetSecondaryEnergyHistogram();
+      if (hist) aval->EnableSecondaryEnergyHistogramming(local(hist));
+    }
+    if (m_driftLineRKF) {
+      worker->driftLineRKF.reset(new DriftLineRKF(*m_driftLineRKF));
+      worker->driftLineRKF->SetSensor(&worker->sensor);
+      worker->driftLineRKF->DisablePlotting();
+    }
+    if (m_trackFactory) {
+      worker->track.reset(m_trackFactory());
+      if (worker->track) worker->track->SetSensor(&worker->sensor);
+    }
+    for (auto hist : m_histograms) {
+      worker->histograms.emplace_back(clone(hist, i));
+    }
+    if (m_workerSetup) m_workerSetup(*worker);
+    m_workers.push_back(std::move(worker));
+  }
+}
+
+void EventRunner::CollectEndpoints(Worker& worker) const {
+  Endpoints endpoints;
+  if (worker.microscopic) {
+    endpoints.electrons = worker.microscopic->GetElectrons();
+    endpoints.holes = worker.microscopic->GetHoles();
+  }
+  if (worker.mc) {
+    endpoints.mcElectrons = worker.mc->GetElectrons();
+    endpoints.mcHoles = worker.mc->GetHoles();
+    endpoints.mcIons = worker.mc->GetIons();
+  }
+  worker.endpoints.push_back(std::move(endpoints));
+}
+
+void EventRunner::Reduce(const size_t nEvents) {
+  // Always add up the contributions in the same order.
+  for (auto& worker : m_workers) {
+    if (m_batchFunction) m_batchFunction(*worker);
+    m_sensor->AddSignals(worker->sensor);
+    worker->sensor.ClearSignal();
+    const size_t nHistograms = m_histograms.size();
+    for (size_t j = 0; j < nHistograms; ++j) {
+      m_histograms[j]->Add(worker->histograms[j].get());
+      worker->histograms[j]->Reset();
+    }
+    const size_t nEngineHistograms = worker->engineHistograms.size();
+    for (size_t j = 0; j < nEngineHistograms; ++j) {
+      m_engineHistograms[j]->Add(worker->engineHistograms[j].get());
+      worker->engineHistograms[j]->Reset();
+    }
+  }
+  if (!m_collectEndpoints) return;
+  // Event k of the batch was processed by worker k % nWorkers.
+  const size_t nWorkers = m_workers.size();
+  auto append = [](auto& to, const auto& from) {
+    to.insert(to.end(), from.begin(), from.end());
+  };
+  for (size_t k = 0; k < nEvents; ++k) {
+    const auto& endpoints = m_workers[k % nWorkers]->endpoints[k / nWorkers];
+    append(m_endpoints.electrons, endpoints.electrons);
+    append(m_endpoints.holes, endpoints.holes);
+    append(m_endpoints.mcElectrons, endpoints.mcElectrons);
+    append(m_endpoints.mcHoles, endpoints.mcHoles);
+    append(m_endpoints.mcIons, endpoints.mcIons);
+  }
+  for (auto& worker : m_workers) worker->endpoints.clear();
+}
+
+}  // namespace Garfield
@@ -0,0 +1,333 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Garfield/GridFile.hh"
+
+namespace {
+
+// Identifier and version of the binary format.
+constexpr char GridTag[8] = {'G', 'G', 'R', 'I', 'D', 'B', 'I', 'N'};
+constexpr uint32_t GridVersion = 1;
+// Size of the header.
+constexpr size_t HeaderSize = 112;
+// Index of the region flags.
+constexpr unsigned int FlagIndex = 4;
+
+template <typename T>
+void Put(std::ostream& out, const T& x) {
+  out.write(reinterpret_cast<const char*>(&x), sizeof(T));
+}
+
+template <typename T>
+T Get(const char* p) {
+  T x;
+  std::memcpy(&x, p, sizeof(T));
+  return x;
+}
+
+// Values converted from a chunk of a text file.
+struct Chunk {
+  size_t begin, end;
+  // Number of lines in the chunk.
+  size_t nLines = 0;
+  // Line number (in the chunk) and number of values of each record.
+  std::vector<size_t> lines;
+  std::vector<unsigned int> counts;
+  std::vector<double> values;
+  std::vector<std::string> comments;
+};
+
+constexpr unsigned int IsComment = std::numeric_limits<unsigned int>::max();
+
+void Convert(const char* s, const unsigned int nColumns,
+             const unsigned int nIndices, const bool withComments,
+             Chunk& chunk) {
+  const char* p = s + chunk.begin;
+  const char* end = s + chunk.end;
+  size_t line = 0;
+  while (p < end) {
+    const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    if (!eol) eol = end;
+    ++line;
+    // Strip white space from the beginning of the line.
+    while (p < eol && std::isspace(static_cast<unsigned char>(*p))) ++p;
+    if (p == eol) {
+      // Empty line.
+      p = eol + 1;
+      continue;
+    }
+    if (*p == '#' || (eol - p > 1 && p[0] == '/' && p[1] == '/')) {
+      if (withComments) {
+        chunk.lines.push_back(line);
+        chunk.counts.push_back(IsComment);
+        chunk.comments.emplace_back(p, eol);
+      }
+      p = eol + 1;
+      continue;
+    }
+    // The numbers cannot extend beyond the end of the line, since a
+    // newline is not part of a number and white space is skipped here.
+    unsigned int n = 0;
+    while (n < nColumns) {
+      while (p < eol && std::isspace(static_cast<unsigned char>(*p))) ++p;
+      if (p == eol) break;
+      char* q = nullptr;
+      const double v = n < nIndices ? double(std::strtol(p, &q, 10))
+                                    : std::strtod(p, &q);
+      if (q == p) break;
+      chunk.values.push_back(v);
+      p = q;
+      ++n;
+    }
+    chunk.values.resize(chunk.values.size() + nColumns - n, 0.);
+    chunk.lines.push_back(line);
+    chunk.counts.push_back(n);
+    p = eol + 1;
+  }
+  chunk.nLines = line;
+}
+
+}  // namespace
+
+namespace Garfield {
+
+bool GridFile::Open(const std::string& filename) {
+  Close();
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::cerr << "GridFile::Open: Could not open file " << filename << ".\n";
+    return false;
+  }
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || fileStatus.st_size < 0) {
+    close(fd);
+    std::cerr << "GridFile::Open: Could not determine size of "
+              << filename << ".\n";
+    return false;
+  }
+  m_size = fileStatus.st_size;
+  void* p = m_size > 0 ? mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0)
+                       : MAP_FAILED;
+  close(fd);
+  if (p != MAP_FAILED) {
+    m_data = static_cast<const char*>(p);
+    m_mapped = true;
+  } else {
+    // Read the file into memory instead.
+    std::ifstream infile(filename, std::ios::binary);
+    m_buffer.resize(m_size);
+    if (!infile.read(m_buffer.data(), m_size)) {
+      std::cerr << "GridFile::Open: Could not read file " << filename
+                << ".\n";
+      Close();
+      return false;
+    }
+    m_data = m_buffer.data();
+  }
+
+  // Check the header.
+  if (m_size < HeaderSize ||
+      !std::equal(GridTag, GridTag + sizeof(GridTag), m_data) ||
+      Get<uint32_t>(m_data + 8) != GridVersion) {
+    std::cerr << "GridFile::Open: " << filename
+              << " is not a valid grid file.\n";
+    Close();
+    return false;
+  }
+  m_header.cylindrical = Get<uint32_t>(m_data + 12) == 1;
+  for (size_t k = 0; k < 3; ++k) {
+    m_header.n[k] = Get<uint32_t>(m_data + 16 + 4 * k);
+    m_header.xmin[k] = Get<double>(m_data + 32 + 16 * k);
+    m_header.xmax[k] = Get<double>(m_data + 40 + 16 * k);
+  }
+  const uint32_t content = Get<uint32_t>(m_data + 28);
+  m_header.withPotential = (content & 1) != 0;
+  m_header.withFlag = (content & 2) != 0;
+  m_header.scaleX = Get<double>(m_data + 80);
+  m_header.scaleF = Get<double>(m_data + 88);
+  m_header.scaleP = Get<double>(m_data + 96);
+  const uint64_t nNodes = Get<uint64_t>(m_data + 104);
+  if (nNodes != GetNumberOfNodes() ||
+      m_size < GetOffset(FlagIndex) +
+                   (m_header.withFlag ? nNodes * sizeof(int32_t) : 0)) {
+    std::cerr << "GridFile::Open: " << filename << " is truncated.\n";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+size_t GridFile::GetOffset(const unsigned int q) const {
+  const size_t n = GetNumberOfNodes();
+  if (q < FlagIndex) return HeaderSize + q * n * sizeof(double);
+  return HeaderSize + (m_header.withPotential ? 4 : 3) * n * sizeof(double);
+}
+
+const double* GridFile::GetValues(const unsigned int q) const {
+  if (!m_data || q >= FlagIndex) return nullptr;
+  if (q == 3 && !m_header.withPotential) return nullptr;
+  // The header size is a multiple of 8, so the arrays are aligned.
+  return reinterpret_cast<const double*>(m_data + GetOffset(q));
+}
+
+const int32_t* GridFile::GetFlags() const {
+  if (!m_data || !m_header.withFlag) return nullptr;
+  return reinterpret_cast<const int32_t*>(m_data + GetOffset(FlagIndex));
+}
+
+bool GridFile::Create(const std::string& filename, const Header& header) {
+  Close();
+  m_header = header;
+  m_out.open(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!m_out) {
+    std::cerr << "GridFile::Create: Could not open file " << filename
+              << ".\n";
+    return false;
+  }
+  m_out.write(GridTag, sizeof(GridTag));
+  Put(m_out, GridVersion);
+  Put(m_out, uint32_t(header.cylindrical ? 1 : 0));
+  for (const auto n : header.n) Put(m_out, n);
+  const uint32_t content = (header.withPotential ? 1 : 0) |
+                           (header.withFlag ? 2 : 0);
+  Put(m_out, content);
+  for (size_t k = 0; k < 3; ++k) {
+    Put(m_out, header.xmin[k]);
+    Put(m_out, header.xmax[k]);
+  }
+  Put(m_out, header.scaleX);
+  Put(m_out, header.scaleF);
+  Put(m_out, header.scaleP);
+  Put(m_out, uint64_t(GetNumberOfNodes()));
+  return static_cast<bool>(m_out);
+}
+
+bool GridFile::Write(const unsigned int q, const size_t first,
+                     const std::vector<double>& values) {
+  if (!m_out.is_open() || q >= FlagIndex ||
+      (q == 3 && !m_header.withPotential) ||
+      first + values.size() > GetNumberOfNodes()) {
+    return false;
+  }
+  m_out.seekp(GetOffset(q) + first * sizeof(double));
+  m_out.write(reinterpret_cast<const char*>(values.data()),
+              values.size() * sizeof(double));
+  return static_cast<bool>(m_out);
+}
+
+bool GridFile::Write(const size_t first, const std::vector<int32_t>& flags) {
+  if (!m_out.is_open() || !m_header.withFlag ||
+      first + flags.size() > GetNumberOfNodes()) {
+    return false;
+  }
+  m_out.seekp(GetOffset(FlagIndex) + first * sizeof(int32_t));
+  m_out.write(reinterpret_cast<const char*>(flags.data()),
+              flags.size() * sizeof(int32_t));
+  return static_cast<bool>(m_out);
+}
+
+bool GridFile::Close() {
+  bool ok = true;
+  if (m_out.is_open()) {
+    m_out.close();
+    ok = !m_out.fail();
+  }
+  if (m_mapped) munmap(const_cast<char*>(m_data), m_size);
+  m_mapped = false;
+  m_data = nullptr;
+  m_size = 0;
+  m_buffer.clear();
+  m_buffer.shrink_to_fit();
+  return ok;
+}
+
+bool GridFile::ReadTable(const std::string& filename,
+                         const unsigned int nColumns,
+                         const unsigned int nIndices, RowFunction row,
+                         CommentFunction comment) {
+  std::ifstream infile(filename, std::ios::binary);
+  if (!infile) return false;
+  constexpr size_t blockSize = 1 << 26;
+  int nThreads = 1;
+#ifdef _OPENMP
+  nThreads = omp_get_max_threads();
+#endif
+  // Number of lines in the blocks processed so far.
+  size_t nLines = 0;
+  std::string buffer;
+  std::vector<Chunk> chunks;
+  bool last = false;
+  while (!last) {
+    const size_t n0 = buffer.size();
+    buffer.resize(n0 + blockSize);
+    infile.read(&buffer[n0], blockSize);
+    buffer.resize(n0 + infile.gcount());
+    last = infile.gcount() < std::streamsize(blockSize);
+    // Process the complete lines in the buffer.
+    size_t nChars = buffer.size();
+    if (!last) {
+      const auto pos = buffer.rfind('\n');
+      if (pos == std::string::npos) continue;
+      nChars = pos + 1;
+    }
+    // Split the block (at line breaks) into chunks.
+    const size_t nChunks =
+        std::min<size_t>(nThreads, 1 + (nChars >> 20));
+    chunks.assign(nChunks, Chunk());
+    size_t b = 0;
+    for (size_t i = 0; i < nChunks; ++i) {
+      chunks[i].begin = b;
+      if (i + 1 < nChunks) {
+        b = std::max(b, (i + 1) * nChars / nChunks);
+        const auto pos = buffer.find('\n', b);
+        b = pos == std::string::npos || pos >= nChars ? nChars : pos + 1;
+      } else {
+        b = nChars;
+      }
+      chunks[i].end = b;
+    }
+    const char* s = buffer.c_str();
+    const bool withComments = static_cast<bool>(comment);
+    const int n = nChunks;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+    for (int i = 0; i < n; ++i) {
+      Convert(s, nColumns, nIndices, withComments, chunks[i]);
+    }
+    // Hand over the lines in their original order.
+    for (const auto& chunk : chunks) {
+      const size_t nRecords = chunk.lines.size();
+      size_t nRows = 0;
+      size_t nComments = 0;
+      for (size_t j = 0; j < nRecords; ++j) {
+        const size_t line = nLines + chunk.lines[j];
+        if (chunk.counts[j] == IsComment) {
+          comment(line, chunk.comments[nComments++]);
+          continue;
+        }
+        const double* values = chunk.values.data() + nRows * nColumns;
+        ++nRows;
+        if (!row(line, values, chunk.counts[j])) return false;
+      }
+      nLines += chunk.nLines;
+    }
+    buffer.erase(0, nChars);
+  }
+  return true;
+}
+
+}  // namespace Garfield
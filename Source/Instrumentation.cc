@@ -0,0 +1,146 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <utility>
+
+#include "Garfield/Instrumentation.hh"
+
+namespace {
+
+constexpr std::array<const char*, Garfield::Instrumentation::nCounters>
+    counterNames = {"sensor_electric_field",
+                    "sensor_magnetic_field",
+                    "sensor_weighting_field",
+                    "sensor_weighting_potential",
+                    "sensor_add_signal",
+                    "fieldmap_find_element",
+                    "fieldmap_candidates",
+                    "fieldmap_not_found",
+                    "newton_solves",
+                    "newton_iterations",
+                    "newton_failures",
+                    "tcad_find_element",
+                    "tcad_walk_hits",
+                    "tcad_candidates",
+                    "electron_velocity",
+                    "electron_collision",
+                    "free_flights",
+                    "null_collisions"};
+
+constexpr std::array<const char*, Garfield::Instrumentation::nTimers>
+    timerNames = {"cross_section_tables",
+                  "tcad_initialise",
+                  "nebem_initialise",
+                  "track_heed",
+                  "drift_line_mc",
+                  "drift_line_rkf",
+                  "microscopic_transport",
+                  "signal_convolution"};
+
+double Ratio(const unsigned long long a, const unsigned long long b) {
+  return b > 0 ? double(a) / double(b) : 0.;
+}
+
+}  // namespace
+
+namespace Garfield {
+namespace Instrumentation {
+
+std::array<std::atomic<unsigned long long>, nCounters> counters{};
+std::array<std::atomic<unsigned long long>, nTimers> timerCalls{};
+std::array<std::atomic<unsigned long long>, nTimers> timerNanoseconds{};
+
+bool Enabled() {
+#ifdef GARFIELD_INSTRUMENTATION
+  return true;
+#else
+  return false;
+#endif
+}
+
+void Reset() {
+  for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+  for (auto& c : timerCalls) c.store(0, std::memory_order_relaxed);
+  for (auto& c : timerNanoseconds) c.store(0, std::memory_order_relaxed);
+}
+
+unsigned long long Get(const Counter c) {
+  return counters[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+}
+
+double GetTime(const Timer t) {
+  const size_t i = static_cast<size_t>(t);
+  return 1.e-9 * timerNanoseconds[i].load(std::memory_order_relaxed);
+}
+
+std::string Json() {
+  char buffer[256];
+  std::string s = "{\n  \"enabled\": ";
+  s += Enabled() ? "true" : "false";
+  s += ",\n  \"counters\": {";
+  for (size_t i = 0; i < nCounters; ++i) {
+    std::snprintf(buffer, sizeof(buffer), "%s\n    \"%s\": %llu",
+                  i > 0 ? "," : "", counterNames[i],
+                  counters[i].load(std::memory_order_relaxed));
+    s += buffer;
+  }
+  s += "\n  },\n  \"ratios\": {";
+  const std::array<std::pair<const char*, double>, 4> ratios = {{
+      {"fieldmap_candidates_per_search",
+       Ratio(Get(Counter::FieldMapCandidates),
+             Get(Counter::FieldMapFindElement))},
+      {"newton_iterations_per_solve",
+       Ratio(Get(Counter::NewtonIterations), Get(Counter::NewtonSolves))},
+      {"tcad_walk_hit_rate",
+       Ratio(Get(Counter::TcadWalkHits), Get(Counter::TcadFindElement))},
+      {"null_collision_fraction",
+       Ratio(Get(Counter::NullCollisions), Get(Counter::FreeFlights))}}};
+  for (size_t i = 0; i < ratios.size(); ++i) {
+    std::snprintf(buffer, sizeof(buffer), "%s\n    \"%s\": %.6g",
+                  i > 0 ? "," : "", ratios[i].first, ratios[i].second);
+    s += buffer;
+  }
+  s += "\n  },\n  \"timers\": {";
+  for (size_t i = 0; i < nTimers; ++i) {
+    std::snprintf(buffer, sizeof(buffer),
+                  "%s\n    \"%s\": {\"calls\": %llu, \"seconds\": %.9f}",
+                  i > 0 ? "," : "", timerNames[i],
+                  timerCalls[i].load(std::memory_order_relaxed),
+                  GetTime(static_cast<Timer>(i)));
+    s += buffer;
+  }
+  s += "\n  }\n}\n";
+  return s;
+}
+
+bool WriteJson(const std::string& filename) {
+  std::ofstream outfile(filename, std::ios::out);
+  if (!outfile) {
+    std::cerr << "Instrumentation::WriteJson:\n"
+              << "    Could not open file " << filename << ".\n";
+    return false;
+  }
+  outfile << Json();
+  return true;
+}
+
+void Print() {
+  if (!Enabled()) {
+    std::cout << "Instrumentation::Print:\n"
+              << "    Library was built without instrumentation.\n";
+    return;
+  }
+  std::cout << "Instrumentation::Print:\n";
+  for (size_t i = 0; i < nCounters; ++i) {
+    std::printf("    %-28s %15llu\n", counterNames[i],
+                counters[i].load(std::memory_order_relaxed));
+  }
+  for (size_t i = 0; i < nTimers; ++i) {
+    std::printf("    %-28s %15llu calls %12.6f s\n", timerNames[i],
+                timerCalls[i].load(std::memory_order_relaxed),
+                GetTime(static_cast<Timer>(i)));
+  }
+}
+
+}  // namespace Instrumentation
+}  // namespace Garfield
@@ -0,0 +1,270 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+
+#include "Garfield/LinearTree.hh"
+
+namespace Garfield {
+
+LinearTree::LinearTree(const unsigned int dim) : m_dim(dim == 2 ? 2 : 3) {
+  if (dim != 2 && dim != 3) {
+    std::cerr << "LinearTree: Dimension must be 2 or 3. Using 3.\n";
+  }
+  m_nChildren = 1u << m_dim;
+  // Keep the Morton codes within 64 bits.
+  m_maxDepth = m_dim == 2 ? 31 : 21;
+}
+
+std::array<uint32_t, 3> LinearTree::Quantise(
+    const std::array<double, 3>& x) const {
+  const double nMax = std::ldexp(1., m_maxDepth) - 1.;
+  std::array<uint32_t, 3> ix = {{0, 0, 0}};
+  for (unsigned int k = 0; k < m_dim; ++k) {
+    const double u = (x[k] - m_xmin[k]) * m_scale[k];
+    ix[k] = u <= 0. ? 0 : u >= nMax ? uint32_t(nMax) : uint32_t(u);
+  }
+  return ix;
+}
+
+uint64_t LinearTree::Encode(const std::array<uint32_t, 3>& ix) const {
+  // Interleave the bits of the grid coordinates.
+  uint64_t code = 0;
+  for (unsigned int b = 0; b < m_maxDepth; ++b) {
+    for (unsigned int k = 0; k < m_dim; ++k) {
+      code |= uint64_t((ix[k] >> b) & 1) << (b * m_dim + k);
+    }
+  }
+  return code;
+}
+
+template <typename F>
+void LinearTree::VisitLeaves(const std::array<uint32_t, 3>& lo,
+                             const std::array<uint32_t, 3>& hi, F f) const {
+  struct Item {
+    int cell;
+    unsigned int level;
+    std::array<uint32_t, 3> ix;
+  };
+  // Each level adds at most (number of children - 1) cells to the stack.
+  std::array<Item, 160> stack;
+  size_t n = 0;
+  stack[n++] = {0, 0, {{0, 0, 0}}};
+  while (n > 0) {
+    const Item item = stack[--n];
+    const int first = m_cells[item.cell];
+    if (first < 0) {
+      f(size_t(-first - 1));
+      continue;
+    }
+    const uint32_t w = uint32_t(1) << (m_maxDepth - item.level - 1);
+    for (unsigned int c = 0; c < m_nChildren; ++c) {
+      std::array<uint32_t, 3> ix = item.ix;
+      bool overlap = true;
+      for (unsigned int k = 0; k < m_dim; ++k) {
+        if ((c >> k) & 1) ix[k] += w;
+        if (ix[k] > hi[k] || ix[k] + (w - 1) < lo[k]) {
+          overlap = false;
+          break;
+        }
+      }
+      if (overlap) stack[n++] = {first + int(c), item.level + 1, ix};
+    }
+  }
+}
+
+bool LinearTree::Build(const std::array<double, 3>& xmin,
+                       const std::array<double, 3>& xmax,
+                       const std::vector<std::array<double, 3> >& points,
+                       const std::vector<std::array<double, 3> >& bbMin,
+                       const std::vector<std::array<double, 3> >& bbMax) {
+  m_cells.clear();
+  m_offsets.clear();
+  m_elements.clear();
+  if (bbMin.size() != bbMax.size()) {
+    std::cerr << "LinearTree::Build: Inconsistent bounding boxes.\n";
+    return false;
+  }
+  const double nCells = std::ldexp(1., m_maxDepth);
+  for (unsigned int k = 0; k < 3; ++k) {
+    m_xmin[k] = xmin[k];
+    m_size[k] = k < m_dim ? std::max(xmax[k] - xmin[k], 0.) : 0.;
+    m_scale[k] = m_size[k] > 0. ? nCells / m_size[k] : 0.;
+  }
+
+  // Sort the mesh nodes along the Morton curve.
+  const int nPoints = points.size();
+  std::vector<uint64_t> codes(nPoints);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < nPoints; ++i) codes[i] = Encode(Quantise(points[i]));
+  std::sort(codes.begin(), codes.end());
+
+  // Subdivide the cells level by level. Since the codes are sorted, the
+  // mesh nodes in a cell (and in each of its children) are contiguous.
+  struct Item {
+    int cell;
+    unsigned int level;
+    size_t begin, end;
+  };
+  std::vector<Item> current = {{0, 0, 0, codes.size()}};
+  std::vector<Item> next;
+  m_cells.assign(1, 0);
+  int nLeaves = 0;
+  const uint64_t mask = m_nChildren - 1;
+  while (!current.empty()) {
+    next.clear();
+    for (const auto& item : current) {
+      if (item.end - item.begin <= m_leafSize || item.level >= m_maxDepth) {
+        m_cells[item.cell] = -(++nLeaves);
+        continue;
+      }
+      const int first = m_cells.size();
+      m_cells[item.cell] = first;
+      m_cells.resize(first + m_nChildren, 0);
+      const unsigned int shift = m_dim * (m_maxDepth - item.level - 1);
+      size_t b = item.begin;
+      for (unsigned int c = 0; c < m_nChildren; ++c) {
+        const auto it = std::partition_point(
+            codes.begin() + b, codes.begin() + item.end,
+            [&](const uint64_t code) { return ((code >> shift) & mask) <= c; });
+        const size_t e = it - codes.begin();
+        next.push_back({first + int(c), item.level + 1, b, e});
+        b = e;
+      }
+    }
+    current.swap(next);
+  }
+  codes.clear();
+  codes.shrink_to_fit();
+
+  // Count the elements overlapping with each leaf.
+  const int nElements = bbMin.size();
+  auto outside = [&](const int i) {
+    for (unsigned int k = 0; k < m_dim; ++k) {
+      if (bbMax[i][k] < m_xmin[k] || bbMin[i][k] > m_xmin[k] + m_size[k]) {
+        return true;
+      }
+    }
+    return false;
+  };
+  m_offsets.assign(nLeaves + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+  for (int i = 0; i < nElements; ++i) {
+    if (outside(i)) continue;
+    VisitLeaves(Quantise(bbMin[i]), Quantise(bbMax[i]), [&](const size_t j) {
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+      ++m_offsets[j + 1];
+    });
+  }
+  std::partial_sum(m_offsets.begin(), m_offsets.end(), m_offsets.begin());
+
+  // Fill the element lists.
+  m_elements.resize(m_offsets.back());
+  std::vector<size_t> pos(m_offsets.begin(), m_offsets.end() - 1);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024)
+#endif
+  for (int i = 0; i < nElements; ++i) {
+    if (outside(i)) continue;
+    VisitLeaves(Quantise(bbMin[i]), Quantise(bbMax[i]), [&](const size_t j) {
+      size_t k = 0;
+#ifdef _OPENMP
+#pragma omp atomic capture
+#endif
+      k = pos[j]++;
+      m_elements[k] = i;
+    });
+  }
+  // Restore the element order (independent of the thread scheduling).
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (int j = 0; j < nLeaves; ++j) {
+    std::sort(m_elements.begin() + m_offsets[j],
+              m_elements.begin() + m_offsets[j + 1]);
+  }
+  return true;
+}
+
+LinearTree::Span LinearTree::GetElementsInBlock(const double x,
+                                                const double y,
+                                                const double z) const {
+  if (m_cells.empty()) return Span();
+  const std::array<double, 3> p = {x, y, z};
+  for (unsigned int k = 0; k < m_dim; ++k) {
+    if (p[k] < m_xmin[k] || p[k] > m_xmin[k] + m_size[k]) return Span();
+  }
+  const auto ix = Quantise(p);
+  int cell = 0;
+  unsigned int level = 0;
+  while (m_cells[cell] >= 0) {
+    const unsigned int shift = m_maxDepth - level - 1;
+    unsigned int c = 0;
+    for (unsigned int k = 0; k < m_dim; ++k) {
+      c |= ((ix[k] >> shift) & 1) << k;
+    }
+    cell = m_cells[cell] + c;
+    ++level;
+  }
+  const size_t j = -m_cells[cell] - 1;
+  const int* elements = m_elements.data();
+  return Span(elements + m_offsets[j], elements + m_offsets[j + 1]);
+}
+
+void LinearTree::GetElementsInPlane(const double fx, const double fy,
+                                    const double fz, const double d,
+                                    std::vector<int>& elems) const {
+  if (m_cells.empty()) return;
+  const std::array<double, 3> f = {fx, fy, fz};
+  const double nCells = std::ldexp(1., m_maxDepth);
+  struct Item {
+    int cell;
+    unsigned int level;
+    std::array<uint32_t, 3> ix;
+  };
+  std::vector<Item> stack = {{0, 0, {{0, 0, 0}}}};
+  while (!stack.empty()) {
+    const Item item = stack.back();
+    stack.pop_back();
+    // Distance of the centre of the cell from the plane
+    // and projected half-width of the cell.
+    const double w = std::ldexp(1., m_maxDepth - item.level);
+    double c = -d;
+    double r = 0.;
+    for (unsigned int k = 0; k < 3; ++k) {
+      const double h = 0.5 * w * m_size[k] / nCells;
+      c += f[k] * (m_xmin[k] + item.ix[k] * m_size[k] / nCells + h);
+      r += std::abs(f[k]) * h;
+    }
+    if (std::abs(c) > 1.0001 * r + 1.e-10 * std::abs(d)) continue;
+    const int first = m_cells[item.cell];
+    if (first < 0) {
+      const size_t j = -first - 1;
+      elems.insert(elems.end(), m_elements.begin() + m_offsets[j],
+                   m_elements.begin() + m_offsets[j + 1]);
+      continue;
+    }
+    const uint32_t h = uint32_t(1) << (m_maxDepth - item.level - 1);
+    for (unsigned int i = 0; i < m_nChildren; ++i) {
+      std::array<uint32_t, 3> ix = item.ix;
+      for (unsigned int k = 0; k < m_dim; ++k) {
+        if ((i >> k) & 1) ix[k] += h;
+      }
+      stack.push_back({first + int(i), item.level + 1, ix});
+    }
+  }
+}
+
+size_t LinearTree::GetMemoryUsage() const {
+  return m_cells.capacity() * sizeof(int) +
+         m_offsets.capacity() * sizeof(size_t) +
+         m_elements.capacity() * sizeof(int);
+}
+
+}  // namespace Garfield
@@ -2,10 +2,12 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <utility>
 
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Medium.hh"
 #include "Garfield/Numerics.hh"
 #include "Garfield/Random.hh"
@@ -76,6 +78,19 @@ void Medium::SetTemperature(const double t) {
     return;
   }
   m_temperature = t;
+  CheckFrozen("SetTemperature");
+  m_isChanged = true;
+}
+
+void Medium::EnableFieldTables(const bool on, const double tol) {
+  if (tol <= 0.) {
+    std::cerr << m_className << "::EnableFieldTables:\n"
+              << "    Tolerance must be greater than zero.\n";
+    return;
+  }
+  m_useFieldTables = on;
+  m_fieldTableTol = tol;
+  CheckFrozen("EnableFieldTables");
   m_isChanged = true;
 }
 
@@ -86,6 +101,7 @@ void Medium::SetPressure(const double p) {
     return;
   }
   m_pressure = p;
+  CheckFrozen("SetPressure");
   m_isChanged = true;
 }
 
@@ -96,6 +112,7 @@ void Medium::SetDielectricConstant(const double eps) {
     return;
   }
   m_epsilon = eps;
+  CheckFrozen("SetDielectricConstant");
   m_isChanged = true;
 }
 
@@ -119,6 +136,7 @@ void Medium::SetAtomicNumber(const double z) {
     return;
   }
   m_z = z;
+  CheckFrozen("SetAtomicNumber");
   m_isChanged = true;
 }
 
@@ -129,6 +147,7 @@ void Medium::SetAtomicWeight(const double a) {
     return;
   }
   m_a = a;
+  CheckFrozen("SetAtomicWeight");
   m_isChanged = true;
 }
 
@@ -139,6 +158,7 @@ void Medium::SetNumberDensity(const double n) {
     return;
   }
   m_density = n;
+  CheckFrozen("SetNumberDensity");
   m_isChanged = true;
 }
 
@@ -155,9 +175,39 @@ void Medium::SetMassDensity(const double rho) {
     return;
   }
   m_density = rho / (AtomicMassUnit * m_a);
+  CheckFrozen("SetMassDensity");
   m_isChanged = true;
 }
 
+bool Medium::Freeze() {
+  if (!Prepare()) {
+    std::cerr << m_className << "::Freeze: Preparation failed.\n";
+    return false;
+  }
+  m_frozen = true;
+  return true;
+}
+
+void Medium::CheckFrozen(const std::string& fcn) {
+  if (!m_frozen) return;
+  if (m_checkFrozen) {
+    std::cerr << m_className << "::" << fcn << ":\n"
+              << "    Medium is modified after Freeze.\n"
+              << "    Concurrent queries are no longer safe.\n";
+  }
+  m_frozen = false;
+}
+
+bool Medium::UpdateAllowed(const std::string& fcn) const {
+  if (!m_frozen) return true;
+  if (m_isChanged && m_checkFrozen) {
+    std::cerr << m_className << "::" << fcn << ":\n"
+              << "    Medium has pending changes but is frozen.\n"
+              << "    Using the transport parameters computed before.\n";
+  }
+  return false;
+}
+
 void Medium::PlotVelocity(const std::string& opt, TPad* pad) {
   ViewMedium view;
   view.SetMedium(this);
@@ -445,6 +495,7 @@ bool Medium::ElectronVelocity(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& vx, double& vy, double& vz) {
 
+  GARFIELD_COUNT(ElectronVelocity);
   return Velocity(ex, ey, ez, bx, by, bz, m_eVelE, m_eVelB, m_eVelX, -1., 
                   vx, vy, vz);
 }
@@ -547,6 +598,16 @@ double Medium::GetElectronNullCollisionRate(const int /*band*/) {
   return 0.;
 }
 
+double Medium::GetElectronNullCollisionRateWindow(const double /*e*/, 
+                                                  const int band,
+                                                  double& emin, 
+                                                  double& emax) {
+  // By default, use a single window covering the full energy range.
+  emin = 0.;
+  emax = std::numeric_limits<double>::max();
+  return GetElectronNullCollisionRate(band);
+}
+
 double Medium::GetElectronCollisionRate(const double /*e*/,
                                         const int /*band*/) {
   if (m_debug) PrintNotImplemented(m_className, "GetElectronCollisionRate");
@@ -886,6 +947,7 @@ void Medium::SetFieldGrid(const std::vector<double>& efields,
   if (!CheckFields(efields, hdr, "E-fields")) return;
   if (!CheckFields(bfields, hdr, "B-fields")) return;
   if (!CheckFields(angles, hdr, "angles")) return;
+  CheckFrozen("SetFieldGrid");
 
   if (m_debug) {
     std::cout << m_className << "::SetFieldGrid:\n    E-fields:\n";
@@ -968,6 +1030,7 @@ bool Medium::SetEntry(const size_t i, const size_t j, const size_t k,
                       std::vector<std::vector<std::vector<double> > >& tab,
                       const double val) {
 
+  CheckFrozen("Set" + fcn);
   if (i >= m_eFields.size() || j >= m_bFields.size() || k >= m_bAngles.size()) {
     PrintOutOfRange(m_className, "Set" + fcn, i, j, k);
     return false;
@@ -997,6 +1060,7 @@ bool Medium::GetEntry(const size_t i, const size_t j, const size_t k,
 }
 
 void Medium::ResetTables() {
+  CheckFrozen("ResetTables");
   ResetElectronVelocity();
   ResetElectronDiffusion();
   ResetElectronTownsend();
@@ -1108,6 +1172,7 @@ void Medium::Clone(
 
 bool Medium::SetIonMobility(const size_t ie, const size_t ib,
                             const size_t ia, const double mu) {
+  CheckFrozen("SetIonMobility");
   // Check the index.
   if (ie >= m_eFields.size() || ib >= m_bFields.size() ||
       ia >= m_bAngles.size()) {
@@ -1139,6 +1204,7 @@ bool Medium::SetIonMobility(const size_t ie, const size_t ib,
 bool Medium::SetIonMobility(const std::vector<double>& efields,
                             const std::vector<double>& mobs,
                             const bool negativeIons) {
+  CheckFrozen("SetIonMobility");
   if (efields.size() != mobs.size()) {
     std::cerr << m_className << "::SetIonMobility:\n"
               << "    E-field and mobility arrays have different sizes.\n";
@@ -1331,6 +1397,57 @@ bool Medium::Interpolate(
   return true;
 }
 
+void Medium::FillFieldTable(const std::function<double(double)>& f,
+                            FieldTable& tab,
+                            const std::vector<double>& breaks) const {
+  // Range [V / cm] covered by the table.
+  constexpr double eMin = 1.;
+  constexpr double eMax = 1.e7;
+  constexpr size_t nMin = 128;
+  constexpr size_t nMax = 65536;
+  tab.eMin = eMin;
+  tab.eMax = eMax;
+  tab.lnMin = std::log(eMin);
+  const double range = std::log(eMax) - tab.lnMin;
+  for (size_t n = nMin; n <= nMax; n *= 2) {
+    const double h = range / n;
+    tab.scale = n / range;
+    tab.values.resize(n + 1);
+    for (size_t i = 0; i <= n; ++i) {
+      tab.values[i] = f(std::exp(tab.lnMin + i * h));
+    }
+    // Intervals containing a discontinuity are not interpolated.
+    tab.gaps.clear();
+    for (const double b : breaks) {
+      if (b <= eMin || b >= eMax) continue;
+      const double u = (std::log(b) - tab.lnMin) * tab.scale;
+      const size_t i = static_cast<size_t>(u);
+      tab.gaps.push_back(std::min(i, n - 1));
+    }
+    double fmax = 0.;
+    for (const double v : tab.values) fmax = std::max(fmax, std::abs(v));
+    // Check the interpolation error at the centre of each interval.
+    bool ok = true;
+    for (size_t i = 0; i < n; ++i) {
+      const auto end = tab.gaps.cend();
+      if (std::find(tab.gaps.cbegin(), end, i) != end) continue;
+      const double fm = f(std::exp(tab.lnMin + (i + 0.5) * h));
+      const double fi = 0.5 * (tab.values[i] + tab.values[i + 1]);
+      const double fs = std::max(std::abs(fm), 1.e-6 * fmax);
+      if (std::abs(fi - fm) > m_fieldTableTol * fs) {
+        ok = false;
+        break;
+      }
+    }
+    if (ok) return;
+  }
+  if (m_debug) {
+    std::cerr << m_className << "::FillFieldTable:\n"
+              << "    Requested accuracy not reached with " << nMax
+              << " intervals.\n";
+  }
+}
+
 double Medium::Interpolate1D(
     const double e, const std::vector<double>& table,
     const std::vector<double>& fields, const unsigned int intpMeth,
@@ -42,7 +42,7 @@ bool MediumCdTe::ElectronVelocity(const double ex, const double ey,
                                   const double by, const double bz, double& vx,
                                   double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -91,7 +91,7 @@ bool MediumCdTe::HoleVelocity(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -143,15 +143,26 @@ void MediumCdTe::SetLowFieldMobility(const double mue, const double muh) {
   m_eMobility = mue;
   m_hMobility = muh;
   m_userMobility = true;
+  CheckFrozen("SetLowFieldMobility");
   m_isChanged = true;
 }
 
 void MediumCdTe::UnsetLowFieldMobility() {
   m_userMobility = false;
+  CheckFrozen("UnsetLowFieldMobility");
   m_isChanged = true;
 }
 
+bool MediumCdTe::Prepare() {
+  if (m_isChanged) {
+    UpdateTransportParameters();
+    m_isChanged = false;
+  }
+  return true;
+}
+
 void MediumCdTe::UpdateTransportParameters() {
+  CheckFrozen("UpdateTransportParameters");
 
   if (!m_userMobility) {
     const double t = m_temperature / 300.;
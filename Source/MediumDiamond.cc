@@ -40,7 +40,7 @@ bool MediumDiamond::ElectronVelocity(
     const double bx, const double by, const double bz, 
     double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -89,7 +89,7 @@ bool MediumDiamond::HoleVelocity(
     const double bx, const double by, const double bz,
     double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -142,11 +142,13 @@ void MediumDiamond::SetLowFieldMobility(const double mue, const double muh) {
   m_eMobility = mue;
   m_hMobility = muh;
   m_userMobility = true;
+  CheckFrozen("SetLowFieldMobility");
   m_isChanged = true;
 }
 
 void MediumDiamond::UnsetLowFieldMobility() {
   m_userMobility = false;
+  CheckFrozen("UnsetLowFieldMobility");
   m_isChanged = true;
 }
 
@@ -168,7 +170,16 @@ void MediumDiamond::UnsetSaturationVelocity() {
   m_hSatVel = 1.6e-2;
 }
  
+bool MediumDiamond::Prepare() {
+  if (m_isChanged) {
+    UpdateTransportParameters();
+    m_isChanged = false;
+  }
+  return true;
+}
+
 void MediumDiamond::UpdateTransportParameters() {
+  CheckFrozen("UpdateTransportParameters");
   std::lock_guard<std::mutex> guard(m_mutex);
 
   // M. Pomorski, Electronic Properties of Single Crystal CVD Diamond and  
@@ -45,7 +45,7 @@ bool MediumGaAs::ElectronVelocity(const double ex, const double ey,
                                   const double by, const double bz, double& vx,
                                   double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -54,14 +54,12 @@ bool MediumGaAs::ElectronVelocity(const double ex, const double ey,
     return Medium::ElectronVelocity(ex, ey, ez, bx, by, bz, vx, vy, vz);
   }
   // Calculate the mobility.
-  // - J. J. Barnes, R. J. Lomax, G. I. Haddad, 
-  //   IEEE Trans. Electron Devices ED-23 (1976), 1042.
-  const double e2 = ex * ex + ey * ey + ez * ez;
-  // Inverse of the critical field.
-  constexpr double r = 1. / 4000.;
-  constexpr double r4 = r * r * r * r;
-  const double er4 = e2 * e2 * r4;
-  const double mu = -(m_eMobility + er4 * m_eSatVel / sqrt(e2)) / (1. + er4);
+  const double emag = sqrt(ex * ex + ey * ey + ez * ez);
+  double mu = 0.;
+  if (!LookupFieldTable(m_eMobilityTable, emag, mu)) {
+    mu = ElectronMobility(emag);
+  }
+  mu = -mu;
   const double b2 = bx * bx + by * by + bz * bz;
   if (b2 < Small) {
     vx = mu * ex;
@@ -78,7 +76,7 @@ bool MediumGaAs::ElectronTownsend(const double ex, const double ey,
                                   const double by, const double bz,
                                   double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronTownsend")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -87,9 +85,9 @@ bool MediumGaAs::ElectronTownsend(const double ex, const double ey,
     return Medium::ElectronTownsend(ex, ey, ez, bx, by, bz, alpha);
   }
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  if (emag > Small) {
-    alpha = m_eImpactA * exp(-pow(m_eImpactB / emag, 1.82));
-  } 
+  if (!LookupFieldTable(m_eAlphaTable, emag, alpha)) {
+    alpha = ElectronAlpha(emag);
+  }
   return true;
 }
 
@@ -109,7 +107,7 @@ bool MediumGaAs::HoleVelocity(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -118,12 +116,11 @@ bool MediumGaAs::HoleVelocity(const double ex, const double ey, const double ez,
     return Medium::HoleVelocity(ex, ey, ez, bx, by, bz, vx, vy, vz);
   }
   // Calculate the mobility.
-  // - J. J. Barnes, R. J. Lomax, G. I. Haddad, 
-  //   IEEE Trans. Electron Devices ED-23 (1976), 1042–1048.
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  // Inverse of the critical field.
-  constexpr double r = 1. / 4000.;
-  const double mu = (m_hMobility + m_hSatVel * r) / (1. + emag * r);
+  double mu = 0.;
+  if (!LookupFieldTable(m_hMobilityTable, emag, mu)) {
+    mu = HoleMobility(emag);
+  }
   const double b2 = bx * bx + by * by + bz * bz;
   if (b2 < Small) {
     vx = mu * ex;
@@ -139,7 +136,7 @@ bool MediumGaAs::HoleTownsend(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleTownsend")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -148,10 +145,9 @@ bool MediumGaAs::HoleTownsend(const double ex, const double ey, const double ez,
     return Medium::HoleTownsend(ex, ey, ez, bx, by, bz, alpha);
   }
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  if (emag > Small) {
-    // alpha = m_hImpactA * exp(-m_hImpactB / emag);
-    alpha = m_hImpactA * exp(-pow(m_hImpactB / emag, 1.75));
-  } 
+  if (!LookupFieldTable(m_hAlphaTable, emag, alpha)) {
+    alpha = HoleAlpha(emag);
+  }
   return true;
 }
 
@@ -176,15 +172,26 @@ void MediumGaAs::SetLowFieldMobility(const double mue, const double muh) {
   m_eMobility = mue;
   m_hMobility = muh;
   m_userMobility = true;
+  CheckFrozen("SetLowFieldMobility");
   m_isChanged = true;
 }
 
 void MediumGaAs::UnsetLowFieldMobility() {
   m_userMobility = false;
+  CheckFrozen("UnsetLowFieldMobility");
   m_isChanged = true;
 }
 
+bool MediumGaAs::Prepare() {
+  if (m_isChanged) {
+    UpdateTransportParameters();
+    m_isChanged = false;
+  }
+  return true;
+}
+
 void MediumGaAs::UpdateTransportParameters() {
+  CheckFrozen("UpdateTransportParameters");
 
   const double t = m_temperature / 300.;
   // Update the low field lattice mobility.
@@ -210,5 +217,52 @@ void MediumGaAs::UpdateTransportParameters() {
   m_hImpactA = 2.215e5 * (1. + 0.588 * (t  - 1));
   m_eImpactB = 5.75e5 * (1. + 0.248 * (t  - 1));
   m_hImpactB = 6.57e5 * (1. + 0.248 * (t  - 1));
+
+  // Tabulate the field dependence (if requested).
+  if (m_useFieldTables) {
+    FillFieldTable([this](const double e) { return ElectronMobility(e); },
+                   m_eMobilityTable);
+    FillFieldTable([this](const double e) { return HoleMobility(e); },
+                   m_hMobilityTable);
+    FillFieldTable([this](const double e) { return ElectronAlpha(e); },
+                   m_eAlphaTable);
+    FillFieldTable([this](const double e) { return HoleAlpha(e); },
+                   m_hAlphaTable);
+  } else {
+    m_eMobilityTable.values.clear();
+    m_hMobilityTable.values.clear();
+    m_eAlphaTable.values.clear();
+    m_hAlphaTable.values.clear();
+  }
+}
+
+double MediumGaAs::ElectronMobility(const double emag) const {
+  if (emag < Small) return m_eMobility;
+  // - J. J. Barnes, R. J. Lomax, G. I. Haddad, 
+  //   IEEE Trans. Electron Devices ED-23 (1976), 1042.
+  // Inverse of the critical field.
+  constexpr double r = 1. / 4000.;
+  const double er = emag * r;
+  const double er4 = er * er * er * er;
+  return (m_eMobility + er4 * m_eSatVel / emag) / (1. + er4);
+}
+
+double MediumGaAs::ElectronAlpha(const double emag) const {
+  if (emag < Small) return 0.;
+  return m_eImpactA * exp(-pow(m_eImpactB / emag, 1.82));
+}
+
+double MediumGaAs::HoleMobility(const double emag) const {
+  // - J. J. Barnes, R. J. Lomax, G. I. Haddad, 
+  //   IEEE Trans. Electron Devices ED-23 (1976), 1042–1048.
+  // Inverse of the critical field.
+  constexpr double r = 1. / 4000.;
+  return (m_hMobility + m_hSatVel * r) / (1. + emag * r);
+}
+
+double MediumGaAs::HoleAlpha(const double emag) const {
+  if (emag < Small) return 0.;
+  // alpha = m_hImpactA * exp(-m_hImpactB / emag);
+  return m_hImpactA * exp(-pow(m_hImpactB / emag, 1.75));
 }
 }
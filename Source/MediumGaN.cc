@@ -50,7 +50,7 @@ bool MediumGaN::ElectronVelocity(const double ex, const double ey,
                                   const double by, const double bz, double& vx,
                                   double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -60,12 +60,11 @@ bool MediumGaN::ElectronVelocity(const double ex, const double ey,
   }
   // Calculate the mobility.
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  constexpr double vsat = 1.27e-2;
-  constexpr double ec = 172.e3;
-  const double e0 = emag / ec;
-  const double e1 = pow(e0, 4.19);
-  const double den = 1. + e1 + 3.24 * pow(e0, 0.885);
-  const double mu = -(m_eMobility + vsat * e1 / emag) / den; 
+  double mu = 0.;
+  if (!LookupFieldTable(m_eMobilityTable, emag, mu)) {
+    mu = ElectronMobility(emag);
+  }
+  mu = -mu;
   const double b2 = bx * bx + by * by + bz * bz;
   if (b2 < Small) {
     vx = mu * ex;
@@ -82,7 +81,7 @@ bool MediumGaN::ElectronTownsend(const double ex, const double ey,
                                   const double by, const double bz,
                                   double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronTownsend")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -91,9 +90,9 @@ bool MediumGaN::ElectronTownsend(const double ex, const double ey,
     return Medium::ElectronTownsend(ex, ey, ez, bx, by, bz, alpha);
   }
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  if (emag > Small) {
-    alpha = m_eImpactA * exp(-m_eImpactB / emag);
-  } 
+  if (!LookupFieldTable(m_eAlphaTable, emag, alpha)) {
+    alpha = ElectronAlpha(emag);
+  }
   return true;
 }
 
@@ -113,7 +112,7 @@ bool MediumGaN::HoleVelocity(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleVelocity")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -123,12 +122,10 @@ bool MediumGaN::HoleVelocity(const double ex, const double ey, const double ez,
   }
   // Calculate the mobility.
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  // Values for saturation velocity and exponent from Sentaurus Synopsys. 
-  constexpr double vsat = 7.e-3;
-  constexpr double beta = 0.725;
-  constexpr double invbeta = 1. / beta;
-  const double r = m_hMobility * emag / vsat;
-  const double mu = m_hMobility / pow(1. + pow(r, beta), invbeta);
+  double mu = 0.;
+  if (!LookupFieldTable(m_hMobilityTable, emag, mu)) {
+    mu = HoleMobility(emag);
+  }
   const double b2 = bx * bx + by * by + bz * bz;
   if (b2 < Small) {
     vx = mu * ex;
@@ -144,7 +141,7 @@ bool MediumGaN::HoleTownsend(const double ex, const double ey, const double ez,
                               const double bx, const double by, const double bz,
                               double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleTownsend")) {
     UpdateTransportParameters();
     m_isChanged = false;
   }
@@ -153,9 +150,9 @@ bool MediumGaN::HoleTownsend(const double ex, const double ey, const double ez,
     return Medium::HoleTownsend(ex, ey, ez, bx, by, bz, alpha);
   }
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  if (emag > Small) {
-    alpha = m_hImpactA * exp(-m_hImpactB / emag);
-  } 
+  if (!LookupFieldTable(m_hAlphaTable, emag, alpha)) {
+    alpha = HoleAlpha(emag);
+  }
   return true;
 }
 
@@ -190,32 +187,79 @@ void MediumGaN::SetLowFieldMobility(const double mue, const double muh) {
   m_eMobility = mue;
   m_hMobility = muh;
   m_userMobility = true;
+  CheckFrozen("SetLowFieldMobility");
   m_isChanged = true;
 }
 
 void MediumGaN::UnsetLowFieldMobility() {
   m_userMobility = false;
+  CheckFrozen("UnsetLowFieldMobility");
   m_isChanged = true;
 }
 
+bool MediumGaN::Prepare() {
+  if (m_isChanged) {
+    UpdateTransportParameters();
+    m_isChanged = false;
+  }
+  return true;
+}
+
 void MediumGaN::UpdateTransportParameters() {
+  CheckFrozen("UpdateTransportParameters");
 
-  if (m_userMobility) return;
-  const double t = m_temperature / 300.;
-
-  // Electron low field mobility.
-  // - F. Schwierz, Solid-State Electronics 49 (2005), 889
-  //   https://doi.org/10.1016/j.sse.2005.03.006
-  const double eMuMin = 0.080e-6 * pow(t, -0.2);
-  const double eMuMax = 1.405e-6 * pow(t, -2.85);
-  const double cRef = 7.78e16 * pow(t, 1.3);
-  const double alpha = 0.71 * pow(t, 0.31);
-  const double den = 1. + pow(m_eDensity / cRef, alpha);
-  m_eMobility = eMuMin + (eMuMax - eMuMin) / den; 
-  // Low-field mobility for holes (using only the lattice mobility).
-  // - T. TMnatsakanov et al., Solid-State Electronics 47 (2003), 111
-  //   https://doi.org/10.1016/S0038-1101(02)00256-3 
-  m_hMobility = 0.170e-6 * pow(t, -5.);
+  if (!m_userMobility) {
+    const double t = m_temperature / 300.;
 
+    // Electron low field mobility.
+    // - F. Schwierz, Solid-State Electronics 49 (2005), 889
+    //   https://doi.org/10.1016/j.sse.2005.03.006
+    const double eMuMin = 0.080e-6 * pow(t, -0.2);
+    const double eMuMax = 1.405e-6 * pow(t, -2.85);
+    const double cRef = 7.78e16 * pow(t, 1.3);
+    const double alpha = 0.71 * pow(t, 0.31);
+    const double den = 1. + pow(m_eDensity / cRef, alpha);
+    m_eMobility = eMuMin + (eMuMax - eMuMin) / den; 
+    // Low-field mobility for holes (using only the lattice mobility).
+    // - T. TMnatsakanov et al., Solid-State Electronics 47 (2003), 111
+    //   https://doi.org/10.1016/S0038-1101(02)00256-3 
+    m_hMobility = 0.170e-6 * pow(t, -5.);
+  }
+
+  // Tabulate the field dependence (if requested).
+  if (m_useFieldTables) {
+    FillFieldTable([this](const double e) { return ElectronMobility(e); },
+                   m_eMobilityTable);
+    FillFieldTable([this](const double e) { return HoleMobility(e); },
+                   m_hMobilityTable);
+    FillFieldTable([this](const double e) { return ElectronAlpha(e); },
+                   m_eAlphaTable);
+    FillFieldTable([this](const double e) { return HoleAlpha(e); },
+                   m_hAlphaTable);
+  } else {
+    m_eMobilityTable.values.clear();
+    m_hMobilityTable.values.clear();
+    m_eAlphaTable.values.clear();
+    m_hAlphaTable.values.clear();
+  }
+}
+
+double MediumGaN::ElectronMobility(const double emag) const {
+  if (emag < Small) return m_eMobility;
+  constexpr double vsat = 1.27e-2;
+  constexpr double ec = 172.e3;
+  const double e0 = emag / ec;
+  const double e1 = pow(e0, 4.19);
+  const double den = 1. + e1 + 3.24 * pow(e0, 0.885);
+  return (m_eMobility + vsat * e1 / emag) / den; 
+}
+
+double MediumGaN::HoleMobility(const double emag) const {
+  // Values for saturation velocity and exponent from Sentaurus Synopsys. 
+  constexpr double vsat = 7.e-3;
+  constexpr double beta = 0.725;
+  constexpr double invbeta = 1. / beta;
+  const double r = m_hMobility * emag / vsat;
+  return m_hMobility / pow(1. + pow(r, beta), invbeta);
 }
 }
@@ -141,6 +141,7 @@ bool MediumGas::SetComposition(const std::string& gas1, const double f1,
                                const std::string& gas4, const double f4,
                                const std::string& gas5, const double f5,
                                const std::string& gas6, const double f6) {
+  CheckFrozen("SetComposition");
   std::array<std::string, 6> gases = {gas1, gas2, gas3, gas4, gas5, gas6};
   std::array<double, 6> fractions = {f1, f2, f3, f4, f5, f6};
 
@@ -322,6 +323,7 @@ double MediumGas::GetAtomicNumber() const {
 
 bool MediumGas::LoadGasFile(const std::string& filename, 
                             const bool quiet) {
+  CheckFrozen("LoadGasFile");
 
   // -----------------------------------------------------------------------
   //    GASGET
@@ -954,6 +956,7 @@ bool MediumGas::GetMixture(const std::vector<double>& mixture,
 
 bool MediumGas::MergeGasFile(const std::string& filename,
                              const bool replaceOld) {
+  CheckFrozen("MergeGasFile");
 
   // -----------------------------------------------------------------------
   //    GASMRG - Merges gas data from a file with existing gas tables.
@@ -2243,6 +2246,7 @@ bool MediumGas::LoadNegativeIonMobility(const std::string& filename,
 
 bool MediumGas::LoadMobility(const std::string& filename, 
                              const bool quiet, const bool negative) {
+  CheckFrozen("LoadMobility");
   // Open the file.
   std::ifstream infile(filename);
   // Make sure the file could actually be opened.
@@ -2326,6 +2330,7 @@ void MediumGas::ResetTables() {
 }
 
 bool MediumGas::EnablePenningTransfer() {
+  CheckFrozen("EnablePenningTransfer");
   DisablePenningTransfer();
  
   if (m_nComponents != 2) { 
@@ -2515,6 +2520,7 @@ bool MediumGas::EnablePenningTransfer() {
 
 bool MediumGas::EnablePenningTransfer(const double r,
                                       const double lambda) {
+  CheckFrozen("EnablePenningTransfer");
 
   if (r < 0. ) {
     std::cerr << m_className << "::EnablePenningTransfer:\n"
@@ -2569,6 +2575,7 @@ bool MediumGas::EnablePenningTransfer(const double r,
 
 bool MediumGas::EnablePenningTransfer(const double r, const double lambda,
                                       std::string gasname) {
+  CheckFrozen("EnablePenningTransfer");
 
   if (r < 0.) {
     std::cerr << m_className << "::EnablePenningTransfer:\n"
@@ -2640,6 +2647,7 @@ bool MediumGas::EnablePenningTransfer(const double r, const double lambda,
 }
 
 void MediumGas::DisablePenningTransfer() {
+  CheckFrozen("DisablePenningTransfer");
 
   m_rPenningGlobal = 0.;
   m_lambdaPenningGlobal = 0.;
@@ -2720,6 +2728,7 @@ bool MediumGas::GetElectronExcitationRate(const size_t level,
 }
 
 bool MediumGas::DisablePenningTransfer(std::string gasname) {
+  CheckFrozen("DisablePenningTransfer");
 
   // Get the "standard" name of this gas.
   gasname = GetGasName(gasname);
@@ -2760,6 +2769,7 @@ bool MediumGas::DisablePenningTransfer(std::string gasname) {
 
 
 bool MediumGas::AdjustTownsendCoefficient() {
+  CheckFrozen("AdjustTownsendCoefficient");
 
   // -----------------------------------------------------------------------
   //    GASSPT
@@ -6,6 +6,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <numeric>
 
@@ -16,6 +17,7 @@
 
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/MagboltzInterface.hh"
 #include "Garfield/MediumMagboltz.hh"
 #include "Garfield/OpticalData.hh"
@@ -25,6 +27,9 @@
 
 namespace {
 
+// Index of the last bin of the linear part of the collision rates table.
+constexpr int LastLinearBin = Garfield::Magboltz::nEnergySteps - 1;
+
 bool IsComment(const std::string& line) {
   if (line.empty()) return false;
   if (line[0] == '#') return true;
@@ -68,6 +73,46 @@ void SetScatteringParameters(const int model, const double parIn, double& cut,
   cut = thetac * 2. / Garfield::Pi;
 }
 
+// Set up the alias table for sampling from a discrete distribution
+// with probabilities p (normalised).
+void SetupAliasTable(const std::vector<double>& p, double* prob,
+                     unsigned int* alias) {
+  const unsigned int n = p.size();
+  std::vector<double> q(n);
+  std::vector<unsigned int> small;
+  std::vector<unsigned int> large;
+  for (unsigned int j = 0; j < n; ++j) {
+    prob[j] = 1.;
+    alias[j] = j;
+    q[j] = n * p[j];
+    if (q[j] < 1.) {
+      small.push_back(j);
+    } else {
+      large.push_back(j);
+    }
+  }
+  while (!small.empty() && !large.empty()) {
+    const unsigned int j = small.back();
+    small.pop_back();
+    const unsigned int k = large.back();
+    prob[j] = q[j];
+    alias[j] = k;
+    q[k] += q[j] - 1.;
+    if (q[k] < 1.) {
+      large.pop_back();
+      small.push_back(k);
+    }
+  }
+}
+
+unsigned int SampleAlias(const double* prob, const unsigned int* alias,
+                         const unsigned int n, const double r) {
+  const double u = r * n;
+  unsigned int j = static_cast<unsigned int>(u);
+  if (j >= n) j = n - 1;
+  return u - j < prob[j] ? j : alias[j];
+}
+
 }
 
 namespace Garfield {
@@ -145,6 +190,7 @@ bool MediumMagboltz::SetMaxElectronEnergy(const double e) {
     std::cerr << m_className << "::SetMaxElectronEnergy: Invalid energy.\n";
     return false;
   }
+  CheckFrozen("SetMaxElectronEnergy");
   m_eMax = e;
 
   std::lock_guard<std::mutex> guard(m_mutex);
@@ -163,6 +209,7 @@ bool MediumMagboltz::SetMaxPhotonEnergy(const double e) {
     std::cerr << m_className << "::SetMaxPhotonEnergy: Invalid energy.\n";
     return false;
   }
+  CheckFrozen("SetMaxPhotonEnergy");
   m_eFinalGamma = e;
 
   // Determine the energy interval size.
@@ -175,11 +222,13 @@ bool MediumMagboltz::SetMaxPhotonEnergy(const double e) {
 }
 
 void MediumMagboltz::SetSplittingFunctionOpalBeaty() {
+  CheckFrozen("SetSplittingFunctionOpalBeaty");
   m_useOpalBeaty = true;
   m_useGreenSawada = false;
 }
 
 void MediumMagboltz::SetSplittingFunctionGreenSawada() {
+  CheckFrozen("SetSplittingFunctionGreenSawada");
   m_useOpalBeaty = false;
   m_useGreenSawada = true;
   if (m_isChanged) return;
@@ -198,11 +247,13 @@ void MediumMagboltz::SetSplittingFunctionGreenSawada() {
 }
 
 void MediumMagboltz::SetSplittingFunctionFlat() {
+  CheckFrozen("SetSplittingFunctionFlat");
   m_useOpalBeaty = false;
   m_useGreenSawada = false;
 }
 
 void MediumMagboltz::EnableDeexcitation() {
+  CheckFrozen("EnableDeexcitation");
   if (m_usePenning) {
     std::cout << m_className << "::EnableDeexcitation:\n"
               << "    Penning transfer will be switched off.\n";
@@ -219,6 +270,7 @@ void MediumMagboltz::EnableDeexcitation() {
 }
 
 void MediumMagboltz::EnableRadiationTrapping() {
+  CheckFrozen("EnableRadiationTrapping");
   m_useRadTrap = true;
   if (!m_useDeexcitation) {
     std::cout << m_className << "::EnableRadiationTrapping:\n    "
@@ -229,6 +281,7 @@ void MediumMagboltz::EnableRadiationTrapping() {
 }
 
 bool MediumMagboltz::EnablePenningTransfer() {
+  CheckFrozen("EnablePenningTransfer");
   m_rPenning.fill(0.);
   m_lambdaPenning.fill(0.);
   if (!MediumGas::EnablePenningTransfer()) return false;
@@ -239,6 +292,7 @@ bool MediumMagboltz::EnablePenningTransfer() {
 
 bool MediumMagboltz::EnablePenningTransfer(const double r,
                                            const double lambda) {
+  CheckFrozen("EnablePenningTransfer");
    
   if (!MediumGas::EnablePenningTransfer(r, lambda)) return false;
  
@@ -283,6 +337,7 @@ bool MediumMagboltz::EnablePenningTransfer(const double r,
 
 bool MediumMagboltz::EnablePenningTransfer(const double r, const double lambda,
                                            std::string gasname) {
+  CheckFrozen("EnablePenningTransfer");
 
   if (!MediumGas::EnablePenningTransfer(r, lambda, gasname)) return false;
 
@@ -333,6 +388,7 @@ bool MediumMagboltz::EnablePenningTransfer(const double r, const double lambda,
 }
 
 void MediumMagboltz::DisablePenningTransfer() {
+  CheckFrozen("DisablePenningTransfer");
 
   MediumGas::DisablePenningTransfer();
   m_rPenning.fill(0.);
@@ -342,6 +398,7 @@ void MediumMagboltz::DisablePenningTransfer() {
 }
 
 bool MediumMagboltz::DisablePenningTransfer(std::string gasname) {
+  CheckFrozen("DisablePenningTransfer");
 
   if (!MediumGas::DisablePenningTransfer(gasname)) return false;
   // Get the "standard" name of this gas.
@@ -382,6 +439,7 @@ bool MediumMagboltz::DisablePenningTransfer(std::string gasname) {
 }
 
 void MediumMagboltz::SetExcitationScaling(const double r, std::string gasname) {
+  CheckFrozen("SetExcitationScaling");
   if (r <= 0.) {
     std::cerr << m_className << "::SetExcitationScaling: Incorrect value.\n";
     return;
@@ -428,7 +486,7 @@ bool MediumMagboltz::Initialise(const bool verbose) {
 void MediumMagboltz::PrintGas() {
   MediumGas::PrintGas();
 
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("PrintGas")) {
     if (!Initialise()) return;
   }
 
@@ -510,10 +568,29 @@ void MediumMagboltz::PrintGas() {
 
 double MediumMagboltz::GetElectronNullCollisionRate(const int /*band*/) {
   // If necessary, update the collision rates table.
-  if (!Update()) return 0.;
+  if (m_isChanged && UpdateAllowed("GetElectronNullCollisionRate") &&
+      !Update()) {
+    return 0.;
+  }
   return m_cfNull;
 }
 
+double MediumMagboltz::GetElectronNullCollisionRateWindow(const double e,
+    const int /*band*/, double& emin, double& emax) {
+  // If necessary, update the collision rates table.
+  if (m_isChanged && UpdateAllowed("GetElectronNullCollisionRateWindow") &&
+      !Update()) {
+    return 0.;
+  }
+  const auto it = std::upper_bound(m_eNullWindow.cbegin(), 
+                                   m_eNullWindow.cend(), e);
+  const size_t k = std::min(size_t(it - m_eNullWindow.cbegin()), 
+                            m_eNullWindow.size() - 1);
+  emin = k == 0 ? 0. : m_eNullWindow[k - 1];
+  emax = m_eNullWindow[k];
+  return m_cfNullWindow[k];
+}
+
 double MediumMagboltz::GetElectronCollisionRate(const double e,
                                                 const int /*band*/) {
   // Check if the electron energy is within the currently set range.
@@ -522,24 +599,33 @@ double MediumMagboltz::GetElectronCollisionRate(const double e,
     return m_cfTot[0];
   }
   if (e > m_eMax) {
-    std::cerr << m_className << "::GetElectronCollisionRate:\n    Rate at " << e
-              << " eV is not included in the current table.\n    "
-              << "Increasing energy range to " << 1.05 * e << " eV.\n";
-    SetMaxElectronEnergy(1.05 * e);
+    if (!m_frozen) {
+      std::cerr << m_className << "::GetElectronCollisionRate:\n    Rate at "
+                << e << " eV is not included in the current table.\n    "
+                << "Increasing energy range to " << 1.05 * e << " eV.\n";
+      SetMaxElectronEnergy(1.05 * e);
+    } else if (m_checkFrozen) {
+      std::cerr << m_className << "::GetElectronCollisionRate:\n    Rate at "
+                << e << " eV is not included in the frozen table.\n";
+    }
   }
 
   // If necessary, update the collision rates table.
-  if (!Update()) return 0.;
+  if (m_isChanged && UpdateAllowed("GetElectronCollisionRate") &&
+      !Update()) {
+    return 0.;
+  }
 
   // Get the energy interval.
   if (e < m_eHigh) {
     // Linear binning
-    return m_cfTot[int(e * m_eStepInv)];
+    return m_cfTot[std::min(int(e * m_eStepInv), LastLinearBin)];
   }
 
   // Logarithmic binning
   const double eLog = log(e);
-  int iE = int((eLog - m_eHighLog) / m_lnStep);
+  const int iE = std::min(int((eLog - m_eHighLog) / m_lnStep),
+                          nEnergyStepsLog - 1);
   // Calculate the collision rate by log-log interpolation.
   const double fmax = m_cfTotLog[iE];
   const double fmin = iE == 0 ? log(m_cfTot.back()) : m_cfTotLog[iE - 1];
@@ -568,7 +654,7 @@ double MediumMagboltz::GetElectronCollisionRate(const double e,
   // Get the energy interval.
   if (e < m_eHigh) {
     // Linear binning
-    const int iE = int(e * m_eStepInv);
+    const int iE = std::min(int(e * m_eStepInv), LastLinearBin);
     if (level == 0) {
       rate *= m_cf[iE][0];
     } else {
@@ -576,7 +662,8 @@ double MediumMagboltz::GetElectronCollisionRate(const double e,
     }
   } else {
     // Logarithmic binning
-    const int iE = int((log(e) - m_eHighLog) / m_lnStep);
+    const int iE = std::min(int((log(e) - m_eHighLog) / m_lnStep),
+                            nEnergyStepsLog - 1);
     if (level == 0) {
       rate *= m_cfLog[iE][0];
     } else {
@@ -590,6 +677,7 @@ bool MediumMagboltz::ElectronCollision(const double e, int& type,
     int& level, double& e1, double& dx, double& dy, double& dz, 
     std::vector<std::pair<Particle, double> >& secondaries, int& ndxc,
     int& band) {
+  GARFIELD_COUNT(ElectronCollision);
   band = 0;
   ndxc = 0;
   if (e <= 0.) {
@@ -597,15 +685,26 @@ bool MediumMagboltz::ElectronCollision(const double e, int& type,
     return false;
   }
   // Check if the electron energy is within the currently set range.
+  // In read-only mode, the table is not extended.
   if (e > m_eMax) {
-    std::cerr << m_className << "::ElectronCollision:\n    Requested energy ("
-              << e << " eV) exceeds current energy range.\n"
-              << "    Increasing energy range to " << 1.05 * e << " eV.\n";
-    SetMaxElectronEnergy(1.05 * e);
+    if (!m_frozen) {
+      std::cerr << m_className << "::ElectronCollision:\n"
+                << "    Requested energy (" << e
+                << " eV) exceeds current energy range.\n"
+                << "    Increasing energy range to " << 1.05 * e << " eV.\n";
+      SetMaxElectronEnergy(1.05 * e);
+    } else if (m_checkFrozen) {
+      std::cerr << m_className << "::ElectronCollision:\n"
+                << "    Requested energy (" << e
+                << " eV) exceeds the range of the frozen table.\n";
+    }
   }
 
   // If necessary, update the collision rates table.
-  if (!Update()) return false;
+  if (m_isChanged && UpdateAllowed("ElectronCollision") &&
+      !Update()) {
+    return false;
+  }
 
   double angCut = 1.;
   double angPar = 0.5;
@@ -613,7 +712,7 @@ bool MediumMagboltz::ElectronCollision(const double e, int& type,
   if (e < m_eHigh) {
     // Linear binning
     // Get the energy interval.
-    const int iE = int(e * m_eStepInv);
+    const int iE = std::min(int(e * m_eStepInv), LastLinearBin);
 
     // Sample the scattering process.
     const double r = RndmUniform();
@@ -850,14 +949,17 @@ double MediumMagboltz::GetPhotonCollisionRate(const double e) {
     std::cerr << m_className << "::GetPhotonCollisionRate: Invalid energy.\n";
     return m_cfTotGamma[0];
   }
-  if (e > m_eFinalGamma) {
+  if (e > m_eFinalGamma && !m_frozen) {
     std::cerr << m_className << "::GetPhotonCollisionRate:\n    Rate at " << e
               << " eV is not included in the current table.\n"
               << "    Increasing energy range to " << 1.05 * e << " eV.\n";
     SetMaxPhotonEnergy(1.05 * e);
   }
 
-  if (!Update()) return 0.;
+  if (m_isChanged && UpdateAllowed("GetPhotonCollisionRate") &&
+      !Update()) {
+    return 0.;
+  }
 
   const int iE =
       std::min(std::max(int(e / m_eStepGamma), 0), nEnergyStepsGamma - 1);
@@ -883,14 +985,17 @@ bool MediumMagboltz::GetPhotonCollision(const double e, int& type, int& level,
     std::cerr << m_className << "::GetPhotonCollision: Invalid energy.\n";
     return false;
   }
-  if (e > m_eFinalGamma) {
+  if (e > m_eFinalGamma && !m_frozen) {
     std::cerr << m_className << "::GetPhotonCollision:\n    Provided energy ("
               << e << " eV) exceeds current energy range.\n"
               << "    Increasing energy range to " << 1.05 * e << " eV.\n";
     SetMaxPhotonEnergy(1.05 * e);
   }
 
-  if (!Update()) return false;
+  if (m_isChanged && UpdateAllowed("GetPhotonCollision") &&
+      !Update()) {
+    return false;
+  }
 
   // Energy interval
   const int iE =
@@ -989,13 +1094,13 @@ unsigned int MediumMagboltz::GetNumberOfElectronCollisions(
 }
 
 unsigned int MediumMagboltz::GetNumberOfLevels() {
-  if (!Update()) return 0;
+  if (m_isChanged && UpdateAllowed("GetNumberOfLevels") && !Update()) return 0;
   return m_nTerms;
 }
 
 bool MediumMagboltz::GetLevel(const unsigned int i, int& ngas, int& type,
                               std::string& descr, double& e) {
-  if (!Update()) return false;
+  if (m_isChanged && UpdateAllowed("GetLevel") && !Update()) return false;
 
   if (i >= m_nTerms) {
     std::cerr << m_className << "::GetLevel: Index out of range.\n";
@@ -1065,7 +1170,10 @@ bool MediumMagboltz::GetPenningTransfer(const unsigned int i,
                                         double& r, double& lambda) {
   r = 0.;
   lambda = 0.;
-  if (!Update()) return false;
+  if (m_isChanged && UpdateAllowed("GetPenningTransfer") &&
+      !Update()) {
+    return false;
+  }
   if (i >= m_nTerms) return false;
   r = m_rPenning[i];
   lambda = m_lambdaPenning[i];
@@ -1259,6 +1367,7 @@ int MediumMagboltz::GetGasNumberMagboltz(const std::string& input) {
 bool MediumMagboltz::Update(const bool verbose) {
 
   if (!m_isChanged) return true;
+  CheckFrozen("Update");
   std::lock_guard<std::mutex> guard(m_mutex);
   if (!Mixer(verbose)) {
     std::cerr << m_className 
@@ -1272,6 +1381,7 @@ bool MediumMagboltz::Update(const bool verbose) {
 
 bool MediumMagboltz::Mixer(const bool verbose) {
 
+  GARFIELD_TIME(CrossSectionTables);
   // Set constants and parameters in Magboltz common blocks.
   Magboltz::cnsts_.echarg = ElementaryCharge * 1.e-15;
   Magboltz::cnsts_.emass = ElectronMassGramme;
@@ -1803,6 +1913,43 @@ bool MediumMagboltz::Mixer(const bool verbose) {
     }
   }
 
+  // Determine the null collision frequency in each energy window.
+  // The windows get wider with increasing energy and overlap by one 
+  // table entry on either side.
+  m_eNullWindow.clear();
+  m_cfNullWindow.clear();
+  constexpr unsigned int nSteps = Magboltz::nEnergySteps;
+  unsigned int j0 = 0;
+  for (unsigned int k = 1; k <= nNullWindows; ++k) {
+    const double f = double(k) / nNullWindows;
+    const unsigned int j1 = std::max(j0 + 1, 
+        std::min(nSteps, static_cast<unsigned int>(nSteps * f * f + 0.5)));
+    double cf = 0.;
+    for (unsigned int j = j0 > 0 ? j0 - 1 : 0; j <= j1 && j < nSteps; ++j) {
+      cf = std::max(cf, m_cfTot[j]);
+    }
+    if (j1 >= nSteps && m_eMax > m_eHigh) cf = std::max(cf, exp(m_cfTotLog[0]));
+    m_eNullWindow.push_back(j1 * m_eStep);
+    m_cfNullWindow.push_back(cf);
+    j0 = j1;
+    if (j1 >= nSteps) break;
+  }
+  if (m_eMax > m_eHigh) {
+    constexpr int nStepsLog = nEnergyStepsLog / nNullWindowsLog;
+    for (int i0 = 0; i0 < nEnergyStepsLog; i0 += nStepsLog) {
+      const int i1 = std::min(i0 + nStepsLog, nEnergyStepsLog - 1);
+      double cf = i0 == 0 ? m_cfTot.back() : 0.;
+      for (int j = std::max(i0 - 1, 0); j <= i1; ++j) {
+        cf = std::max(cf, exp(m_cfTotLog[j]));
+      }
+      m_eNullWindow.push_back(exp(m_eHighLog + (i0 + nStepsLog) * m_lnStep));
+      m_cfNullWindow.push_back(cf);
+    }
+  }
+  // Above the table, use the overall null-collision frequency.
+  m_eNullWindow.back() = std::numeric_limits<double>::max();
+  m_cfNullWindow.back() = std::max(m_cfNullWindow.back(), m_cfNull);
+
   // Reset the collision counters.
   m_nCollisionsDetailed.assign(m_nTerms, 0);
   m_nCollisions.fill(0);
@@ -1841,6 +1988,9 @@ bool MediumMagboltz::Mixer(const bool verbose) {
       m_useDeexcitation = false;
     }
   }
+  // Set up the tables for sampling the de-excitation channels
+  // (needs the line widths computed in ComputePhotonCollisionTable).
+  if (m_useDeexcitation) ComputeDeexcitationSamplingTables();
 
   // Reset the Penning transfer parameters.
   if (m_debug) {
@@ -1870,7 +2020,10 @@ bool MediumMagboltz::Mixer(const bool verbose) {
 
 void MediumMagboltz::PlotElectronCrossSections() {
 
-  if (!Update()) return;
+  if (m_isChanged && UpdateAllowed("PlotElectronCrossSections") &&
+      !Update()) {
+    return;
+  }
 
   std::array<float, Magboltz::nEnergySteps> en;
   for (unsigned int k = 0; k < Magboltz::nEnergySteps; ++k) {
@@ -2407,7 +2560,7 @@ void MediumMagboltz::ComputeDeexcitation(int iLevel, int& fLevel) {
   }
 
   // Make sure that the tables are updated.
-  if (!Update()) return;
+  if (m_isChanged && UpdateAllowed("ComputeDeexcitation") && !Update()) return;
 
   if (iLevel < 0 || iLevel >= (int)m_nTerms) {
     std::cerr << m_className << "::ComputeDeexcitation: Index out of range.\n";
@@ -2429,7 +2582,9 @@ void MediumMagboltz::ComputeDeexcitation(int iLevel, int& fLevel) {
 
 void MediumMagboltz::ComputeDeexcitationInternal(int iLevel, int& fLevel) {
   m_dxcProducts.clear();
+  if (m_useDxcCascades && SampleDeexcitationCascade(iLevel, fLevel)) return;
 
+  const bool tabulated = m_dxcOffset.size() == m_deexcitations.size() + 1;
   double t = 0.;
   fLevel = iLevel;
   while (iLevel >= 0 && iLevel < (int)m_deexcitations.size()) {
@@ -2446,11 +2601,19 @@ void MediumMagboltz::ComputeDeexcitationInternal(int iLevel, int& fLevel) {
     fLevel = -1;
     int type = DxcTypeRad;
     const double r = RndmUniform();
-    for (int j = 0; j < nChannels; ++j) {
-      if (r <= dxc.p[j]) {
-        fLevel = dxc.final[j];
-        type = dxc.type[j];
-        break;
+    if (tabulated) {
+      const unsigned int k = m_dxcOffset[iLevel];
+      const unsigned int j = SampleAlias(&m_dxcProb[k], &m_dxcAlias[k],
+                                         nChannels, r);
+      fLevel = dxc.final[j];
+      type = dxc.type[j];
+    } else {
+      for (int j = 0; j < nChannels; ++j) {
+        if (r <= dxc.p[j]) {
+          fLevel = dxc.final[j];
+          type = dxc.type[j];
+          break;
+        }
       }
     }
     if (type == DxcTypeRad) {
@@ -2469,9 +2632,14 @@ void MediumMagboltz::ComputeDeexcitationInternal(int iLevel, int& fLevel) {
         iLevel = fLevel;
       } else {
         // Decay to ground state.
-        double delta = RndmVoigt(0., dxc.sDoppler, dxc.gPressure);
-        while (photon.energy + delta < Small || fabs(delta) >= dxc.width) {
+        double delta = 0.;
+        if (tabulated) {
+          delta = SampleDeexcitationLineShape(iLevel);
+        } else {
           delta = RndmVoigt(0., dxc.sDoppler, dxc.gPressure);
+          while (photon.energy + delta < Small || fabs(delta) >= dxc.width) {
+            delta = RndmVoigt(0., dxc.sDoppler, dxc.gPressure);
+          }
         }
         photon.energy += delta;
         m_dxcProducts.push_back(std::move(photon));
@@ -2517,6 +2685,212 @@ void MediumMagboltz::ComputeDeexcitationInternal(int iLevel, int& fLevel) {
   }
 }
 
+void MediumMagboltz::ComputeDeexcitationSamplingTables() {
+  m_dxcOffset.clear();
+  m_dxcProb.clear();
+  m_dxcAlias.clear();
+  m_dxcLineShape.clear();
+  m_dxcCascades.clear();
+  m_dxcCascadeOffset.clear();
+  m_dxcCascadeProb.clear();
+  m_dxcCascadeAlias.clear();
+  const unsigned int nLevels = m_deexcitations.size();
+  if (nLevels == 0) return;
+
+  // Alias tables for the channels of each level.
+  std::vector<double> p;
+  for (const auto& dxc : m_deexcitations) {
+    m_dxcOffset.push_back(m_dxcProb.size());
+    // Undo the cumulative normalisation of the branching ratios.
+    const unsigned int nChannels = dxc.p.size();
+    p.assign(nChannels, 0.);
+    for (unsigned int j = 0; j < nChannels; ++j) {
+      p[j] = j > 0 ? dxc.p[j] - dxc.p[j - 1] : dxc.p[j];
+    }
+    m_dxcProb.resize(m_dxcProb.size() + nChannels);
+    m_dxcAlias.resize(m_dxcAlias.size() + nChannels);
+    if (nChannels == 0 || dxc.rate <= 0.) continue;
+    const unsigned int k = m_dxcOffset.back();
+    SetupAliasTable(p, &m_dxcProb[k], &m_dxcAlias[k]);
+  }
+  m_dxcOffset.push_back(m_dxcProb.size());
+
+  // Line shapes (inverse cumulative distribution of the truncated
+  // Voigt profile) for radiative decays to the ground state.
+  constexpr unsigned int nNodes = 2048;
+  m_dxcLineShape.assign(nLevels * (nDxcLineShape + 1), 0.);
+  std::vector<double> x(nNodes + 1, 0.);
+  std::vector<double> cdf(nNodes + 1, 0.);
+  for (unsigned int i = 0; i < nLevels; ++i) {
+    const auto& dxc = m_deexcitations[i];
+    if (dxc.width <= 0.) continue;
+    const double h = std::max(dxc.sDoppler, dxc.gPressure);
+    if (h <= 0.) continue;
+    const double lo = std::max(-dxc.width, Small - dxc.energy);
+    const double hi = dxc.width;
+    if (lo >= hi) continue;
+    // Use nodes which are dense in the core and sparse in the tails.
+    const double v0 = atan(lo / h);
+    const double dv = (atan(hi / h) - v0) / nNodes;
+    double fLast = 0.;
+    for (unsigned int k = 0; k <= nNodes; ++k) {
+      x[k] = h * tan(v0 + k * dv);
+      const double f = TMath::Voigt(x[k], dxc.sDoppler, 2 * dxc.gPressure);
+      cdf[k] = k > 0 ? cdf[k - 1] + 0.5 * (f + fLast) * (x[k] - x[k - 1])
+                     : 0.;
+      fLast = f;
+    }
+    if (cdf[nNodes] <= 0.) continue;
+    double* table = &m_dxcLineShape[i * (nDxcLineShape + 1)];
+    unsigned int k = 0;
+    for (unsigned int m = 0; m <= nDxcLineShape; ++m) {
+      const double u = cdf[nNodes] * m / nDxcLineShape;
+      while (k < nNodes - 1 && cdf[k + 1] < u) ++k;
+      const double dc = cdf[k + 1] - cdf[k];
+      const double w = dc > 0. ? std::min(std::max((u - cdf[k]) / dc, 0.), 1.)
+                               : 0.;
+      table[m] = x[k] + w * (x[k + 1] - x[k]);
+    }
+  }
+
+  // Complete cascades of each level (only if requested).
+  if (!m_useDxcCascades) return;
+  constexpr unsigned int nMaxCascades = 1024;
+  std::vector<DxcCascade> cascades;
+  std::vector<double> weights;
+  for (unsigned int i = 0; i < nLevels; ++i) {
+    m_dxcCascadeOffset.push_back(m_dxcCascades.size());
+    cascades.clear();
+    weights.clear();
+    DxcCascade cascade;
+    cascade.line = cascade.final = -1;
+    if (!ListDeexcitationCascades(i, 1., cascade, cascades, weights) ||
+        cascades.size() > nMaxCascades) {
+      // Too many possibilities, sample this level step by step.
+      if (m_debug) {
+        std::cout << m_className << "::ComputeDeexcitationSamplingTables:\n"
+                  << "    Cascades of level " << m_deexcitations[i].label
+                  << " are not tabulated.\n";
+      }
+      continue;
+    }
+    const double sum = std::accumulate(weights.begin(), weights.end(), 0.);
+    if (sum <= 0.) continue;
+    for (auto& w : weights) w /= sum;
+    const unsigned int k = m_dxcCascades.size();
+    m_dxcCascadeProb.resize(k + cascades.size());
+    m_dxcCascadeAlias.resize(k + cascades.size());
+    SetupAliasTable(weights, &m_dxcCascadeProb[k], &m_dxcCascadeAlias[k]);
+    m_dxcCascades.insert(m_dxcCascades.end(), cascades.begin(),
+                         cascades.end());
+  }
+  m_dxcCascadeOffset.push_back(m_dxcCascades.size());
+}
+
+bool MediumMagboltz::ListDeexcitationCascades(
+    const int iLevel, const double p, DxcCascade& cascade,
+    std::vector<DxcCascade>& cascades, std::vector<double>& weights) const {
+  // Guard against loops and combinatorial explosion.
+  constexpr size_t nMaxCascades = 4096;
+  if (cascade.levels.size() >= nMaxDxcSteps ||
+      cascades.size() > nMaxCascades) {
+    return false;
+  }
+  if (iLevel < 0) {
+    // Collisional loss.
+    cascade.final = -1;
+    cascades.push_back(cascade);
+    weights.push_back(p);
+    return true;
+  }
+  const auto& dxc = m_deexcitations[iLevel];
+  const unsigned int nChannels = dxc.p.size();
+  if (dxc.rate <= 0. || nChannels == 0) {
+    // Dead end.
+    cascade.final = iLevel;
+    cascades.push_back(cascade);
+    weights.push_back(p);
+    return true;
+  }
+  for (unsigned int j = 0; j < nChannels; ++j) {
+    const double pj = j > 0 ? dxc.p[j] - dxc.p[j - 1] : dxc.p[j];
+    if (pj <= 0.) continue;
+    const int f = dxc.final[j];
+    const int type = dxc.type[j];
+    DxcCascade next = cascade;
+    next.levels.push_back(iLevel);
+    dxcProd prod;
+    prod.s = 0.;
+    prod.t = next.levels.size() - 1;
+    prod.energy = dxc.energy;
+    if (type == DxcTypeRad || type == DxcTypeCollIon) {
+      prod.type = type == DxcTypeRad ? DxcProdTypePhoton : DxcProdTypeElectron;
+      if (f >= 0) {
+        prod.energy -= m_deexcitations[f].energy;
+      } else if (type == DxcTypeRad) {
+        // Decay to the ground state, with line broadening.
+        next.line = m_dxcLineShape.empty() ? -1 : iLevel;
+      } else {
+        // Penning ionisation
+        prod.energy -= m_minIonPot;
+      }
+      if (prod.energy < Small) prod.energy = Small;
+      next.products.push_back(std::move(prod));
+      if (f < 0) {
+        next.final = iLevel;
+        cascades.push_back(std::move(next));
+        weights.push_back(p * pj);
+        continue;
+      }
+    } else if (type != DxcTypeCollNonIon) {
+      return false;
+    }
+    if (!ListDeexcitationCascades(f, p * pj, next, cascades, weights)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool MediumMagboltz::SampleDeexcitationCascade(const int iLevel,
+                                               int& fLevel) {
+  if (iLevel < 0 || iLevel + 1 >= (int)m_dxcCascadeOffset.size()) {
+    return false;
+  }
+  const unsigned int k0 = m_dxcCascadeOffset[iLevel];
+  const unsigned int n = m_dxcCascadeOffset[iLevel + 1] - k0;
+  if (n == 0) return false;
+  const unsigned int j = SampleAlias(&m_dxcCascadeProb[k0],
+                                     &m_dxcCascadeAlias[k0], n, RndmUniform());
+  const auto& cascade = m_dxcCascades[k0 + j];
+  // Sample the decay times of the levels along the cascade.
+  const size_t nSteps = cascade.levels.size();
+  std::array<double, nMaxDxcSteps> times;
+  double t = 0.;
+  for (size_t i = 0; i < nSteps; ++i) {
+    t += -log(RndmUniformPos()) / m_deexcitations[cascade.levels[i]].rate;
+    times[i] = t;
+  }
+  for (const auto& prod : cascade.products) {
+    m_dxcProducts.push_back(prod);
+    m_dxcProducts.back().t = times[size_t(prod.t)];
+    if (prod.type == DxcProdTypeElectron) ++m_nPenning;
+  }
+  if (cascade.line >= 0 && !m_dxcProducts.empty()) {
+    m_dxcProducts.back().energy += SampleDeexcitationLineShape(cascade.line);
+  }
+  fLevel = cascade.final;
+  return true;
+}
+
+double MediumMagboltz::SampleDeexcitationLineShape(const int iLevel) const {
+  const double* table = &m_dxcLineShape[iLevel * (nDxcLineShape + 1)];
+  const double u = RndmUniform() * nDxcLineShape;
+  unsigned int m = static_cast<unsigned int>(u);
+  if (m >= nDxcLineShape) m = nDxcLineShape - 1;
+  return table[m] + (u - m) * (table[m + 1] - table[m]);
+}
+
 bool MediumMagboltz::ComputePhotonCollisionTable(const bool verbose) {
 
   // Atomic density
@@ -2,6 +2,7 @@
 #include <cmath>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <sstream>
 
 #include "Garfield/FundamentalConstants.hh"
@@ -73,6 +74,7 @@ void MediumSilicon::SetDoping(const char type, const double c) {
     return;
   }
 
+  CheckFrozen("SetDoping");
   m_isChanged = true;
 }
 
@@ -97,6 +99,7 @@ void MediumSilicon::SetTrapCrossSection(const double ecs, const double hcs) {
   }
 
   m_trappingModel = 0;
+  CheckFrozen("SetTrapCrossSection");
   m_isChanged = true;
 }
 
@@ -110,6 +113,7 @@ void MediumSilicon::SetTrapDensity(const double n) {
   }
 
   m_trappingModel = 0;
+  CheckFrozen("SetTrapDensity");
   m_isChanged = true;
 }
 
@@ -129,6 +133,7 @@ void MediumSilicon::SetTrappingTime(const double etau, const double htau) {
   }
 
   m_trappingModel = 1;
+  CheckFrozen("SetTrappingTime");
   m_isChanged = true;
 }
 
@@ -137,7 +142,7 @@ bool MediumSilicon::ElectronVelocity(const double ex, const double ey,
                                      const double by, const double bz,
                                      double& vx, double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronVelocity")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::ElectronVelocity:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -153,7 +158,11 @@ bool MediumSilicon::ElectronVelocity(const double ex, const double ey,
 
   // Calculate the mobility.
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  const double mu = -ElectronMobility(emag);
+  double mu = 0.;
+  if (!LookupFieldTable(m_eMobilityTable, emag, mu)) {
+    mu = ElectronMobility(emag);
+  }
+  mu = -mu;
 
   if (fabs(bx) < Small && fabs(by) < Small && fabs(bz) < Small) {
     vx = mu * ex;
@@ -170,7 +179,7 @@ bool MediumSilicon::ElectronTownsend(const double ex, const double ey,
                                      const double by, const double bz,
                                      double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronTownsend")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::ElectronTownsend:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -185,7 +194,9 @@ bool MediumSilicon::ElectronTownsend(const double ex, const double ey,
   }
 
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  alpha = ElectronAlpha(emag);
+  if (!LookupFieldTable(m_eAlphaTable, emag, alpha)) {
+    alpha = ElectronAlpha(emag);
+  }
   return true;
 }
 
@@ -194,7 +205,7 @@ bool MediumSilicon::ElectronAttachment(const double ex, const double ey,
                                        const double by, const double bz,
                                        double& eta) {
   eta = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronAttachment")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::ElectronAttachment:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -231,7 +242,7 @@ bool MediumSilicon::HoleVelocity(const double ex, const double ey,
                                  const double by, const double bz, double& vx,
                                  double& vy, double& vz) {
   vx = vy = vz = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleVelocity")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::HoleVelocity:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -247,7 +258,10 @@ bool MediumSilicon::HoleVelocity(const double ex, const double ey,
 
   // Calculate the mobility.
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  const double mu = HoleMobility(emag);
+  double mu = 0.;
+  if (!LookupFieldTable(m_hMobilityTable, emag, mu)) {
+    mu = HoleMobility(emag);
+  }
 
   if (fabs(bx) < Small && fabs(by) < Small && fabs(bz) < Small) {
     vx = mu * ex;
@@ -264,7 +278,7 @@ bool MediumSilicon::HoleTownsend(const double ex, const double ey,
                                  const double by, const double bz,
                                  double& alpha) {
   alpha = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleTownsend")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::HoleTownsend:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -279,7 +293,9 @@ bool MediumSilicon::HoleTownsend(const double ex, const double ey,
   }
 
   const double emag = sqrt(ex * ex + ey * ey + ez * ez);
-  alpha = HoleAlpha(emag);
+  if (!LookupFieldTable(m_hAlphaTable, emag, alpha)) {
+    alpha = HoleAlpha(emag);
+  }
   return true;
 }
 
@@ -288,7 +304,7 @@ bool MediumSilicon::HoleAttachment(const double ex, const double ey,
                                    const double by, const double bz,
                                    double& eta) {
   eta = 0.;
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("HoleAttachment")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::HoleAttachment:\n"
                 << "    Error calculating the transport parameters.\n";
@@ -330,36 +346,42 @@ void MediumSilicon::SetLowFieldMobility(const double mue, const double muh) {
   m_eMobility = mue;
   m_hMobility = muh;
   m_hasUserMobility = true;
+  CheckFrozen("SetLowFieldMobility");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetLatticeMobilityModelMinimos() {
   m_latticeMobilityModel = LatticeMobility::Minimos;
   m_hasUserMobility = false;
+  CheckFrozen("SetLatticeMobilityModelMinimos");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetLatticeMobilityModelSentaurus() {
   m_latticeMobilityModel = LatticeMobility::Sentaurus;
   m_hasUserMobility = false;
+  CheckFrozen("SetLatticeMobilityModelSentaurus");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetLatticeMobilityModelReggiani() {
   m_latticeMobilityModel = LatticeMobility::Reggiani;
   m_hasUserMobility = false;
+  CheckFrozen("SetLatticeMobilityModelReggiani");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetDopingMobilityModelMinimos() {
   m_dopingMobilityModel = DopingMobility::Minimos;
   m_hasUserMobility = false;
+  CheckFrozen("SetDopingMobilityModelMinimos");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetDopingMobilityModelMasetti() {
   m_dopingMobilityModel = DopingMobility::Masetti;
   m_hasUserMobility = false;
+  CheckFrozen("SetDopingMobilityModelMasetti");
   m_isChanged = true;
 }
 
@@ -375,63 +397,76 @@ void MediumSilicon::SetSaturationVelocity(const double vsate,
     m_hasUserSaturationVelocity = true;
   }
 
+  CheckFrozen("SetSaturationVelocity");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetSaturationVelocityModelMinimos() {
   m_saturationVelocityModel = SaturationVelocity::Minimos;
   m_hasUserSaturationVelocity = false;
+  CheckFrozen("SetSaturationVelocityModelMinimos");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetSaturationVelocityModelCanali() {
   m_saturationVelocityModel = SaturationVelocity::Canali;
   m_hasUserSaturationVelocity = false;
+  CheckFrozen("SetSaturationVelocityModelCanali");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetSaturationVelocityModelReggiani() {
   m_saturationVelocityModel = SaturationVelocity::Reggiani;
   m_hasUserSaturationVelocity = false;
+  CheckFrozen("SetSaturationVelocityModelReggiani");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetHighFieldMobilityModelMinimos() {
   m_highFieldMobilityModel = HighFieldMobility::Minimos;
+  CheckFrozen("SetHighFieldMobilityModelMinimos");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetHighFieldMobilityModelCanali() {
   m_highFieldMobilityModel = HighFieldMobility::Canali;
+  CheckFrozen("SetHighFieldMobilityModelCanali");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetHighFieldMobilityModelReggiani() {
   m_highFieldMobilityModel = HighFieldMobility::Reggiani;
+  CheckFrozen("SetHighFieldMobilityModelReggiani");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetHighFieldMobilityModelConstant() {
   m_highFieldMobilityModel = HighFieldMobility::Constant;
+  CheckFrozen("SetHighFieldMobilityModelConstant");
+  m_isChanged = true;
 }
 
 void MediumSilicon::SetImpactIonisationModelVanOverstraetenDeMan() {
   m_impactIonisationModel = ImpactIonisation::VanOverstraeten;
+  CheckFrozen("SetImpactIonisationModelVanOverstraetenDeMan");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetImpactIonisationModelGrant() {
   m_impactIonisationModel = ImpactIonisation::Grant;
+  CheckFrozen("SetImpactIonisationModelGrant");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetImpactIonisationModelMassey() {
   m_impactIonisationModel = ImpactIonisation::Massey;
+  CheckFrozen("SetImpactIonisationModelMassey");
   m_isChanged = true;
 }
 
 void MediumSilicon::SetImpactIonisationModelOkutoCrowell() {
   m_impactIonisationModel = ImpactIonisation::Okuto;
+  CheckFrozen("SetImpactIonisationModelOkutoCrowell");
   m_isChanged = true;
 }
 
@@ -447,6 +482,7 @@ bool MediumSilicon::SetMaxElectronEnergy(const double e) {
   // Determine the energy interval size.
   m_eStepG = m_eFinalG / nEnergyStepsG;
 
+  CheckFrozen("SetMaxElectronEnergy");
   m_isChanged = true;
 
   return true;
@@ -641,7 +677,7 @@ void MediumSilicon::GetElectronMomentum(const double e, double& px, double& py,
 }
 
 double MediumSilicon::GetElectronNullCollisionRate(const int band) {
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("GetElectronNullCollisionRate")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::GetElectronNullCollisionRate:\n"
                 << "    Error calculating the collision rates table.\n";
@@ -662,6 +698,41 @@ double MediumSilicon::GetElectronNullCollisionRate(const int band) {
   return 0.;
 }
 
+double MediumSilicon::GetElectronNullCollisionRateWindow(const double e,
+    const int band, double& emin, double& emax) {
+  if (m_isChanged && UpdateAllowed("GetElectronNullCollisionRateWindow")) {
+    if (!UpdateTransportParameters()) {
+      std::cerr << m_className << "::GetElectronNullCollisionRateWindow:\n"
+                << "    Error calculating the collision rates table.\n";
+      return 0.;
+    }
+    m_isChanged = false;
+  }
+
+  const std::vector<double>* cfNull = nullptr;
+  double step = m_eStepXL;
+  if (band >= 0 && band < m_nValleysX) {
+    cfNull = &m_cfNullWindowElectronsX;
+  } else if (band >= m_nValleysX && band < m_nValleysX + m_nValleysL) {
+    cfNull = &m_cfNullWindowElectronsL;
+  } else if (band == m_nValleysX + m_nValleysL) {
+    cfNull = &m_cfNullWindowElectronsG;
+    step = m_eStepG;
+  } else {
+    std::cerr << m_className << "::GetElectronNullCollisionRateWindow:\n"
+              << "    Band index (" << band << ") out of range.\n";
+    return 0.;
+  }
+  const int nWindows = cfNull->size();
+  int k = e > 0. ? int(e / (nStepsNullWindow * step)) : 0;
+  if (k >= nWindows) k = nWindows - 1;
+  emin = k * nStepsNullWindow * step;
+  // The last window extends to infinity (the rates are clamped).
+  emax = k == nWindows - 1 ? std::numeric_limits<double>::max()
+                           : (k + 1) * nStepsNullWindow * step;
+  return (*cfNull)[k];
+}
+
 double MediumSilicon::GetElectronCollisionRate(const double e, const int band) {
   if (e <= 0.) {
     std::cerr << m_className << "::GetElectronCollisionRate:\n"
@@ -677,7 +748,7 @@ double MediumSilicon::GetElectronCollisionRate(const double e, const int band) {
     SetMaxElectronEnergy(1.05 * e);
   }
 
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("GetElectronCollisionRate")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::GetElectronCollisionRate:\n"
                 << "    Error calculating the collision rates table.\n";
@@ -730,7 +801,7 @@ bool MediumSilicon::ElectronCollision(const double e, int& type,
     return false;
   }
 
-  if (m_isChanged) {
+  if (m_isChanged && UpdateAllowed("ElectronCollision")) {
     if (!UpdateTransportParameters()) {
       std::cerr << m_className << "::ElectronCollision:\n"
                 << "    Error calculating the collision rates table.\n";
@@ -749,15 +820,7 @@ bool MediumSilicon::ElectronCollision(const double e, int& type,
     if (iE >= nEnergyStepsXL) iE = nEnergyStepsXL - 1;
     if (iE < 0) iE = 0;
     // Select the scattering process.
-    const double r = RndmUniform();
-    if (r <= m_cfElectronsX[iE][0]) {
-      level = 0;
-    } else if (r >= m_cfElectronsX[iE][m_nLevelsX - 1]) {
-      level = m_nLevelsX - 1;
-    } else {
-      const auto begin = m_cfElectronsX[iE].cbegin();
-      level = std::lower_bound(begin, begin + m_nLevelsX, r) - begin;
-    }
+    level = m_aliasElectronsX.Sample(iE, RndmUniform());
 
     // Get the collision type.
     type = m_scatTypeElectronsX[level];
@@ -840,15 +903,7 @@ bool MediumSilicon::ElectronCollision(const double e, int& type,
     if (iE >= nEnergyStepsXL) iE = nEnergyStepsXL - 1;
     if (iE < m_ieMinL) iE = m_ieMinL;
     // Select the scattering process.
-    const double r = RndmUniform();
-    if (r <= m_cfElectronsL[iE][0]) {
-      level = 0;
-    } else if (r >= m_cfElectronsL[iE][m_nLevelsL - 1]) {
-      level = m_nLevelsL - 1;
-    } else {
-      const auto begin = m_cfElectronsL[iE].cbegin();
-      level = std::lower_bound(begin, begin + m_nLevelsL, r) - begin;
-    }
+    level = m_aliasElectronsL.Sample(iE, RndmUniform());
 
     // Get the collision type.
     type = m_scatTypeElectronsL[level];
@@ -894,15 +949,7 @@ bool MediumSilicon::ElectronCollision(const double e, int& type,
     if (iE >= nEnergyStepsG) iE = nEnergyStepsG - 1;
     if (iE < m_ieMinG) iE = m_ieMinG;
     // Select the scattering process.
-    const double r = RndmUniform();
-    if (r <= m_cfElectronsG[iE][0]) {
-      level = 0;
-    } else if (r >= m_cfElectronsG[iE][m_nLevelsG - 1]) {
-      level = m_nLevelsG - 1;
-    } else {
-      const auto begin = m_cfElectronsG[iE].cbegin();
-      level = std::lower_bound(begin, begin + m_nLevelsG, r) - begin;
-    }
+    level = m_aliasElectronsG.Sample(iE, RndmUniform());
 
     // Get the collision type.
     type = m_scatTypeElectronsG[level];
@@ -1179,7 +1226,20 @@ bool MediumSilicon::Initialise() {
   return true;
 }
 
+bool MediumSilicon::Prepare() {
+  if (m_isChanged) {
+    if (!UpdateTransportParameters()) {
+      std::cerr << m_className << "::Prepare:\n"
+                << "    Error calculating the transport parameters.\n";
+      return false;
+    }
+    m_isChanged = false;
+  }
+  return true;
+}
+
 bool MediumSilicon::UpdateTransportParameters() {
+  CheckFrozen("UpdateTransportParameters");
   std::lock_guard<std::mutex> guard(m_mutex);
 
   // Calculate impact ionisation coefficients.
@@ -1214,6 +1274,9 @@ bool MediumSilicon::UpdateTransportParameters() {
     UpdateHighFieldMobilityCanali();
   }
 
+  // Tabulate the field dependence (if requested).
+  UpdateFieldTables();
+
   if (m_debug) {
     std::cout << m_className << "::UpdateTransportParameters:\n"
               << "    Low-field mobility [cm2 V-1 ns-1]\n"
@@ -1450,6 +1513,34 @@ void MediumSilicon::UpdateImpactIonisation() {
   }
 }
 
+void MediumSilicon::UpdateFieldTables() {
+  if (!m_useFieldTables) {
+    m_eMobilityTable.values.clear();
+    m_hMobilityTable.values.clear();
+    m_eAlphaTable.values.clear();
+    m_hAlphaTable.values.clear();
+    return;
+  }
+  FillFieldTable([this](const double e) { return ElectronMobility(e); },
+                 m_eMobilityTable);
+  FillFieldTable([this](const double e) { return HoleMobility(e); },
+                 m_hMobilityTable);
+  // Fields at which the impact ionisation parameters change.
+  std::vector<double> eBreaks;
+  std::vector<double> hBreaks;
+  if (m_impactIonisationModel == ImpactIonisation::VanOverstraeten) {
+    eBreaks = {4e5};
+    hBreaks = {4e5};
+  } else if (m_impactIonisationModel == ImpactIonisation::Grant) {
+    eBreaks = {2.4e5, 5.3e5};
+    hBreaks = {5.3e5};
+  }
+  FillFieldTable([this](const double e) { return ElectronAlpha(e); },
+                 m_eAlphaTable, eBreaks);
+  FillFieldTable([this](const double e) { return HoleAlpha(e); },
+                 m_hAlphaTable, hBreaks);
+}
+
 double MediumSilicon::ElectronMobility(const double emag) const {
 
   if (emag < Small) return 0.;
@@ -1723,24 +1814,11 @@ bool MediumSilicon::ElectronScatteringRates() {
                 << "scattering rate at " << i * m_eStepXL << " eV <= 0.\n";
       return false;
     }
-    // Normalise the rates.
-    for (int j = 0; j < m_nLevelsX; ++j) {
-      m_cfElectronsX[i][j] /= m_cfTotElectronsX[i];
-      if (j > 0) m_cfElectronsX[i][j] += m_cfElectronsX[i][j - 1];
-    }
-
-    // Make sure the total scattering rate is positive.
-    if (m_cfTotElectronsL[i] <= 0.) {
-      if (i < m_ieMinL) continue;
+    if (m_cfTotElectronsL[i] <= 0. && i >= m_ieMinL) {
       std::cerr << m_className << "::ElectronScatteringRates:\n    L-valley "
                 << "scattering rate at " << i * m_eStepXL << " eV <= 0.\n";
       return false;
     }
-    // Normalise the rates.
-    for (int j = 0; j < m_nLevelsL; ++j) {
-      m_cfElectronsL[i][j] /= m_cfTotElectronsL[i];
-      if (j > 0) m_cfElectronsL[i][j] += m_cfElectronsL[i][j - 1];
-    }
   }
 
   if (m_cfOutput) {
@@ -1775,20 +1853,92 @@ bool MediumSilicon::ElectronScatteringRates() {
       std::cerr << m_className << "::ElectronScatteringRates:\n    Higher "
                 << "band scattering rate at " << i * m_eStepG << " eV <= 0.\n";
     }
-    // Normalise the rates.
-    for (int j = 0; j < m_nLevelsG; ++j) {
-      m_cfElectronsG[i][j] /= m_cfTotElectronsG[i];
-      if (j > 0) m_cfElectronsG[i][j] += m_cfElectronsG[i][j - 1];
-    }
   }
 
   if (m_cfOutput) {
     outfileG.close();
   }
 
+  // Set up the sampling tables and the windowed null-collision rates.
+  SetupAliasTable(m_cfElectronsX, m_cfTotElectronsX, m_nLevelsX,
+                  m_aliasElectronsX);
+  SetupAliasTable(m_cfElectronsL, m_cfTotElectronsL, m_nLevelsL,
+                  m_aliasElectronsL);
+  SetupAliasTable(m_cfElectronsG, m_cfTotElectronsG, m_nLevelsG,
+                  m_aliasElectronsG);
+  SetupNullWindows(m_cfTotElectronsX, 0, m_cfNullWindowElectronsX);
+  SetupNullWindows(m_cfTotElectronsL, m_ieMinL, m_cfNullWindowElectronsL);
+  SetupNullWindows(m_cfTotElectronsG, m_ieMinG, m_cfNullWindowElectronsG);
+  // The per-process rates are no longer needed.
+  std::vector<std::vector<double> >().swap(m_cfElectronsX);
+  std::vector<std::vector<double> >().swap(m_cfElectronsL);
+  std::vector<std::vector<double> >().swap(m_cfElectronsG);
   return true;
 }
 
+void MediumSilicon::SetupAliasTable(
+    const std::vector<std::vector<double> >& cf,
+    const std::vector<double>& cfTot, const int nLevels, AliasTable& table) {
+  const int nSteps = cfTot.size();
+  table.nLevels = nLevels;
+  table.prob.assign(nSteps * nLevels, 1.);
+  table.alias.resize(nSteps * nLevels);
+  std::vector<double> q(nLevels, 0.);
+  std::vector<unsigned int> small;
+  std::vector<unsigned int> large;
+  small.reserve(nLevels);
+  large.reserve(nLevels);
+  for (int i = 0; i < nSteps; ++i) {
+    double* prob = table.prob.data() + i * nLevels;
+    unsigned int* alias = table.alias.data() + i * nLevels;
+    for (int j = 0; j < nLevels; ++j) alias[j] = j;
+    // Steps without any scattering (e. g. below the band minimum)
+    // are never sampled.
+    if (cfTot[i] <= 0.) continue;
+    small.clear();
+    large.clear();
+    for (int j = 0; j < nLevels; ++j) {
+      q[j] = nLevels * cf[i][j] / cfTot[i];
+      if (q[j] < 1.) {
+        small.push_back(j);
+      } else {
+        large.push_back(j);
+      }
+    }
+    while (!small.empty() && !large.empty()) {
+      const unsigned int s = small.back();
+      small.pop_back();
+      const unsigned int l = large.back();
+      prob[s] = q[s];
+      alias[s] = l;
+      q[l] += q[s] - 1.;
+      if (q[l] < 1.) {
+        large.pop_back();
+        small.push_back(l);
+      }
+    }
+    // Whatever is left (up to round-off) has probability one.
+  }
+}
+
+void MediumSilicon::SetupNullWindows(const std::vector<double>& cfTot,
+                                     const int iMin,
+                                     std::vector<double>& cfNull) {
+  const int nSteps = cfTot.size();
+  const int nWindows = (nSteps + nStepsNullWindow - 1) / nStepsNullWindow;
+  cfNull.assign(nWindows, 0.);
+  for (int k = 0; k < nWindows; ++k) {
+    // Include the neighbouring steps to be safe against round-off
+    // in the energy binning.
+    const int i0 = std::max(k * nStepsNullWindow - 1, 0);
+    const int i1 = std::min((k + 1) * nStepsNullWindow + 1, nSteps);
+    for (int i = i0; i < i1; ++i) {
+      // The rates are clamped at the band minimum.
+      cfNull[k] = std::max(cfNull[k], cfTot[std::max(i, iMin)]);
+    }
+  }
+}
+
 bool MediumSilicon::ElectronAcousticScatteringRates() {
   // Reference:
   //  - C. Jacoboni and L. Reggiani,
@@ -101,6 +101,17 @@ double lngamma(const double xx) {
 }  // namespace
 namespace Garfield {
 
+#if defined(__GNUC__) || defined(__clang__)
+__thread ThreadRandomState threadRandomState;
+#else
+thread_local ThreadRandomState threadRandomState;
+#endif
+
+void SetThreadRandomEngine(RandomEngine* engine) {
+  threadRandomState.engine = engine;
+  threadRandomState.gaussianCached = false;
+}
+
 double RndmLandau() {
   constexpr double f[] = {
       0,         0,         0,         0,         0,         -2.244733,
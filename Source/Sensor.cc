@@ -10,6 +10,7 @@
 
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Numerics.hh"
 #include "Garfield/Random.hh"
 #include "Garfield/ViewBase.hh"
@@ -70,6 +71,7 @@ namespace Garfield {
 void Sensor::ElectricField(const double x, const double y, const double z,
                            double &ex, double &ey, double &ez, double &v,
                            Medium *&medium, int &status) {
+  GARFIELD_COUNT(SensorElectricField);
   ex = ey = ez = v = 0.;
   status = -10;
   medium = nullptr;
@@ -80,6 +82,14 @@ void Sensor::ElectricField(const double x, const double y, const double z,
   for (const auto &cmp : m_components) {
     if (!std::get<1>(cmp)) continue;
     std::get<0>(cmp)->ElectricField(x, y, z, fx, fy, fz, p, med, stat);
+    if (stat == 0 && std::get<0>(cmp)->IsOverlay()) {
+      // Overlay component (e. g. space charge), only add the field.
+      ex += fx;
+      ey += fy;
+      ez += fz;
+      v += p;
+      continue;
+    }
     if (status != 0) {
       status = stat;
       medium = med;
@@ -96,6 +106,7 @@ void Sensor::ElectricField(const double x, const double y, const double z,
 void Sensor::ElectricField(const double x, const double y, const double z,
                            double &ex, double &ey, double &ez, Medium *&medium,
                            int &status) {
+  GARFIELD_COUNT(SensorElectricField);
   ex = ey = ez = 0.;
   status = -10;
   medium = nullptr;
@@ -106,6 +117,13 @@ void Sensor::ElectricField(const double x, const double y, const double z,
   for (const auto &cmp : m_components) {
     if (!std::get<1>(cmp)) continue;
     std::get<0>(cmp)->ElectricField(x, y, z, fx, fy, fz, med, stat);
+    if (stat == 0 && std::get<0>(cmp)->IsOverlay()) {
+      // Overlay component (e. g. space charge), only add the field.
+      ex += fx;
+      ey += fy;
+      ez += fz;
+      continue;
+    }
     if (status != 0) {
       status = stat;
       medium = med;
@@ -120,12 +138,14 @@ void Sensor::ElectricField(const double x, const double y, const double z,
 
 void Sensor::MagneticField(const double x, const double y, const double z,
                            double &bx, double &by, double &bz, int &status) {
+  GARFIELD_COUNT(SensorMagneticField);
   bx = by = bz = 0.;
+  status = 0;
+  if (ComponentListsOutdated()) UpdateComponentLists();
   double fx = 0., fy = 0., fz = 0.;
   // Add up contributions.
-  for (const auto &cmp : m_components) {
-    if (!std::get<2>(cmp)) continue;
-    std::get<0>(cmp)->MagneticField(x, y, z, fx, fy, fz, status);
+  for (auto cmp : m_magneticComponents) {
+    cmp->MagneticField(x, y, z, fx, fy, fz, status);
     if (status != 0) continue;
     bx += fx;
     by += fy;
@@ -136,6 +156,7 @@ void Sensor::MagneticField(const double x, const double y, const double z,
 void Sensor::WeightingField(const double x, const double y, const double z,
                             double &wx, double &wy, double &wz,
                             const std::string &label) {
+  GARFIELD_COUNT(SensorWeightingField);
   wx = wy = wz = 0.;
   // Add up field contributions from all components.
   for (const auto &electrode : m_electrodes) {
@@ -151,6 +172,7 @@ void Sensor::WeightingField(const double x, const double y, const double z,
 
 double Sensor::WeightingPotential(const double x, const double y,
                                   const double z, const std::string &label) {
+  GARFIELD_COUNT(SensorWeightingPotential);
   double v = 0.;
   // Add up contributions from all components.
   for (const auto &electrode : m_electrodes) {
@@ -359,6 +381,7 @@ void Sensor::AddComponent(Component *cmp) {
   }
 
   m_components.push_back(std::make_tuple(cmp, true, true));
+  m_componentsChanged = true;
 }
 
 Component *Sensor::GetComponent(const unsigned int i) {
@@ -375,6 +398,7 @@ void Sensor::EnableComponent(const unsigned int i, const bool on) {
     return;
   };
   std::get<1>(m_components[i]) = on;
+  m_componentsChanged = true;
 }
 
 void Sensor::EnableMagneticField(const unsigned int i, const bool on) {
@@ -383,16 +407,137 @@ void Sensor::EnableMagneticField(const unsigned int i, const bool on) {
     return;
   };
   std::get<2>(m_components[i]) = on;
+  m_componentsChanged = true;
 }
 
-bool Sensor::HasMagneticField() const {
-  for (const auto &cmp : m_components) {
-    if (!std::get<1>(cmp) || !std::get<2>(cmp)) continue;
-    if (std::get<0>(cmp)->HasMagneticField()) return true;
+bool Sensor::HasMagneticField() {
+  if (ComponentListsOutdated()) UpdateComponentLists();
+  for (auto cmp : m_magneticComponents) {
+    if (cmp->HasMagneticField()) return true;
+  }
+  return false;
+}
+
+bool Sensor::HasVelocityMap() {
+  if (ComponentListsOutdated()) UpdateComponentLists();
+  return !m_velocityMaps.empty();
+}
+
+bool Sensor::HasAttachmentMap() {
+  if (ComponentListsOutdated()) UpdateComponentLists();
+  return !m_attachmentMaps.empty();
+}
+
+bool Sensor::HasTownsendMap() {
+  if (ComponentListsOutdated()) UpdateComponentLists();
+  return !m_townsendMaps.empty();
+}
+
+template <typename F>
+bool Sensor::FromMap(const std::vector<ComponentRegion> &maps, const double x,
+                     const double y, const double z, F f) {
+  if (ComponentListsOutdated()) UpdateComponentLists();
+  // Try the components whose bounding box contains the point.
+  for (const auto &map : maps) {
+    if (map.Contains(x, y, z) && f(map.comp)) return true;
+  }
+  return false;
+}
+
+bool Sensor::ElectronVelocity(const double x, const double y, const double z,
+                              double &vx, double &vy, double &vz) {
+  return FromMap(m_velocityMaps, x, y, z, [&](Component *cmp) {
+    return cmp->ElectronVelocity(x, y, z, vx, vy, vz);
+  });
+}
+
+bool Sensor::HoleVelocity(const double x, const double y, const double z,
+                          double &vx, double &vy, double &vz) {
+  return FromMap(m_velocityMaps, x, y, z, [&](Component *cmp) {
+    return cmp->HoleVelocity(x, y, z, vx, vy, vz);
+  });
+}
+
+bool Sensor::ElectronAttachment(const double x, const double y,
+                                const double z, double &eta) {
+  return FromMap(m_attachmentMaps, x, y, z, [&](Component *cmp) {
+    return cmp->ElectronAttachment(x, y, z, eta);
+  });
+}
+
+bool Sensor::HoleAttachment(const double x, const double y, const double z,
+                            double &eta) {
+  return FromMap(m_attachmentMaps, x, y, z, [&](Component *cmp) {
+    return cmp->HoleAttachment(x, y, z, eta);
+  });
+}
+
+bool Sensor::ElectronTownsend(const double x, const double y, const double z,
+                              double &alpha) {
+  return FromMap(m_townsendMaps, x, y, z, [&](Component *cmp) {
+    return cmp->ElectronTownsend(x, y, z, alpha);
+  });
+}
+
+bool Sensor::HoleTownsend(const double x, const double y, const double z,
+                          double &alpha) {
+  return FromMap(m_townsendMaps, x, y, z, [&](Component *cmp) {
+    return cmp->HoleTownsend(x, y, z, alpha);
+  });
+}
+
+bool Sensor::ComponentListsOutdated() const {
+  if (m_componentsChanged) return true;
+  const size_t n = m_components.size();
+  if (m_componentRevisions.size() != n) return true;
+  for (size_t i = 0; i < n; ++i) {
+    if (std::get<0>(m_components[i])->GetRevision() !=
+        m_componentRevisions[i]) {
+      return true;
+    }
   }
   return false;
 }
 
+void Sensor::UpdateComponentLists() {
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (!ComponentListsOutdated()) return;
+  m_componentRevisions.clear();
+  for (const auto &cmp : m_components) {
+    m_componentRevisions.push_back(std::get<0>(cmp)->GetRevision());
+  }
+  m_velocityMaps.clear();
+  m_attachmentMaps.clear();
+  m_townsendMaps.clear();
+  m_magneticComponents.clear();
+  for (const auto &cmp : m_components) {
+    if (!std::get<1>(cmp)) continue;
+    Component *component = std::get<0>(cmp);
+    if (std::get<2>(cmp)) m_magneticComponents.push_back(component);
+    if (!component->HasVelocityMap() && !component->HasAttachmentMap() &&
+        !component->HasTownsendMap()) {
+      continue;
+    }
+    // Components without a bounding box are tried everywhere.
+    ComponentRegion region;
+    region.comp = component;
+    region.xmin.fill(-INFINITY);
+    region.xmax.fill(+INFINITY);
+    // Axes along which the bounding box is not set (e. g. z for a 2D map
+    // without a z range) remain unbounded.
+    double x0 = -INFINITY, y0 = -INFINITY, z0 = -INFINITY;
+    double x1 = +INFINITY, y1 = +INFINITY, z1 = +INFINITY;
+    if (component->GetBoundingBox(x0, y0, z0, x1, y1, z1)) {
+      region.xmin = {x0, y0, z0};
+      region.xmax = {x1, y1, z1};
+    }
+    if (component->HasVelocityMap()) m_velocityMaps.push_back(region);
+    if (component->HasAttachmentMap()) m_attachmentMaps.push_back(region);
+    if (component->HasTownsendMap()) m_townsendMaps.push_back(region);
+  }
+  m_componentsChanged = false;
+}
+
 void Sensor::AddElectrode(Component *cmp, const std::string &label) {
   if (!cmp) {
     std::cerr << m_className << "::AddElectrode: Null pointer.\n";
@@ -426,6 +571,7 @@ void Sensor::AddElectrode(Component *cmp, const std::string &label) {
 void Sensor::Clear() {
   std::lock_guard<std::mutex> guard(m_mutex);
   m_components.clear();
+  m_componentsChanged = true;
   m_electrodes.clear();
   m_nTimeBins = 200;
   m_tStart = 0.;
@@ -439,6 +585,35 @@ void Sensor::Clear() {
   m_fTransferFFT.clear();
 }
 
+void Sensor::CopySettings(const Sensor &other) {
+  if (&other == this) return;
+  std::lock_guard<std::mutex> guard(m_mutex);
+  m_components = other.m_components;
+  m_componentsChanged = true;
+  m_tStart = other.m_tStart;
+  m_tStep = other.m_tStep;
+  m_nTimeBins = other.m_nTimeBins;
+  m_delayedSignal = other.m_delayedSignal;
+  m_delayedSignalTimes = other.m_delayedSignalTimes;
+  m_nAvgDelayedSignal = other.m_nAvgDelayedSignal;
+  m_xMinUser = other.m_xMinUser;
+  m_yMinUser = other.m_yMinUser;
+  m_zMinUser = other.m_zMinUser;
+  m_xMaxUser = other.m_xMaxUser;
+  m_yMaxUser = other.m_yMaxUser;
+  m_zMaxUser = other.m_zMaxUser;
+  m_hasUserArea = other.m_hasUserArea;
+  m_electrodes.clear();
+  for (const auto &electrode : other.m_electrodes) {
+    Electrode copy;
+    copy.comp = electrode.comp;
+    copy.label = electrode.label;
+    m_electrodes.push_back(std::move(copy));
+  }
+  m_debug = other.m_debug;
+  ClearSignal();
+}
+
 bool Sensor::GetVoltageRange(double &vmin, double &vmax) {
   // We don't know the range yet.
   bool set = false;
@@ -486,6 +661,43 @@ void Sensor::ClearSignal() {
   m_nEvents = 0;
 }
 
+bool Sensor::AddSignals(const Sensor &other) {
+  if (&other == this) return false;
+  const size_t nElectrodes = m_electrodes.size();
+  if (other.m_electrodes.size() != nElectrodes ||
+      other.m_nTimeBins != m_nTimeBins) {
+    std::cerr << m_className << "::AddSignals:\n"
+              << "    Electrodes or time window do not match.\n";
+    return false;
+  }
+  for (size_t i = 0; i < nElectrodes; ++i) {
+    if (other.m_electrodes[i].label != m_electrodes[i].label) {
+      std::cerr << m_className << "::AddSignals:\n"
+                << "    Electrode labels do not match.\n";
+      return false;
+    }
+  }
+  std::lock_guard<std::mutex> guard(m_mutex);
+  auto add = [](std::vector<double> &a, const std::vector<double> &b) {
+    const size_t n = std::min(a.size(), b.size());
+    for (size_t j = 0; j < n; ++j) a[j] += b[j];
+  };
+  for (size_t i = 0; i < nElectrodes; ++i) {
+    auto &electrode = m_electrodes[i];
+    const auto &src = other.m_electrodes[i];
+    add(electrode.signal, src.signal);
+    add(electrode.delayedSignal, src.delayedSignal);
+    add(electrode.electronSignal, src.electronSignal);
+    add(electrode.ionSignal, src.ionSignal);
+    add(electrode.delayedElectronSignal, src.delayedElectronSignal);
+    add(electrode.delayedIonSignal, src.delayedIonSignal);
+    electrode.charge += src.charge;
+    electrode.integrated = false;
+  }
+  m_nEvents += other.m_nEvents;
+  return true;
+}
+
 void Sensor::SetDelayedSignalTimes(const std::vector<double> &ts) {
   if (!std::is_sorted(ts.begin(), ts.end())) {
     std::cerr << m_className << "::SetDelayedSignalTimes:\n"
@@ -500,6 +712,7 @@ void Sensor::AddSignal(const double q, const double t0, const double t1,
                        const double x1, const double y1, const double z1,
                        const bool integrateWeightingField,
                        const bool useWeightingPotential) {
+  GARFIELD_COUNT(SensorAddSignal);
   if (m_debug) std::cout << m_className << "::AddSignal: ";
   // Get the time bin.
   if (t0 < m_tStart) {
@@ -616,19 +829,27 @@ void Sensor::AddSignal(const double q, const double t0, const double t1,
       double chargeHolder = 0.;
       double currentHolder = 0.;
       int binHolder = 0;
+      // Evaluate the delayed weighting potentials at the start and end 
+      // point for all (non-negative) delayed times in one go.
+      const size_t i0 = std::lower_bound(m_delayedSignalTimes.cbegin(),
+                                         m_delayedSignalTimes.cend(), t0) -
+                        m_delayedSignalTimes.cbegin();
+      std::vector<double> delayedtimes;
+      for (size_t i = i0; i < nd; ++i) {
+        delayedtimes.push_back(m_delayedSignalTimes[i] - t0);  // t - t0
+      }
+      std::vector<double> dp0;
+      std::vector<double> dp1;
+      electrode.comp->DelayedWeightingPotentials(x0, y0, z0, delayedtimes, 
+                                                 dp0, lbl);
+      electrode.comp->DelayedWeightingPotentials(x1, y1, z1, delayedtimes,
+                                                 dp1, lbl);
       // Loop over each time in the given vector of delayed times.
-      for (size_t i = 0; i < nd; ++i) {
-        double delayedtime = m_delayedSignalTimes[i] - t0;  // t - t0
-        if (delayedtime < 0) continue;
+      for (size_t i = i0; i < nd; ++i) {
         // Find bin that needs to be filled.
         int bin2 = int((m_delayedSignalTimes[i] - m_tStart) / m_tStep);
         // Compute induced charge
-        double dp0 = electrode.comp->DelayedWeightingPotential(
-            x0, y0, z0, delayedtime, lbl);
-        double dp1 = electrode.comp->DelayedWeightingPotential(
-            x1, y1, z1, delayedtime, lbl);
-
-        double charge = q * (dp1 - dp0);
+        double charge = q * (dp1[i - i0] - dp0[i - i0]);
         // In very rare cases the result is infinity. We do not let this
         // contribute.
         if (std::isnan(charge)) {
@@ -672,25 +893,8 @@ void Sensor::AddSignal(const double q, const double t0, const double t1,
       }
     } else {
       // Using the weighting field.
-      for (size_t i = 0; i < nd; ++i) {
-        // Integrate over the drift line segment.
-        const double step = std::min(m_delayedSignalTimes[i], dt);
-        const double scale = step / dt;
-        double sum = 0.;
-        for (size_t j = 0; j < 6; ++j) {
-          double s = 0.5 * (1. + tg[j]);
-          const double t = m_delayedSignalTimes[i] - s * step;
-          s *= scale;
-          const double x = x0 + s * dx;
-          const double y = y0 + s * dy;
-          const double z = z0 + s * dz;
-          // Calculate the delayed weighting field.
-          double wx = 0., wy = 0., wz = 0.;
-          electrode.comp->DelayedWeightingField(x, y, z, t, wx, wy, wz, lbl);
-          sum += (wx * vx + wy * vy + wz * vz) * wg[j];
-        }
-        id[i] = -q * 0.5 * sum * step;
-      }
+      DelayedCurrents(electrode, q, dt, {x0, y0, z0}, {x1, y1, z1}, 
+                      {vx, vy, vz}, id);
       FillSignal(electrode, q, td, id, m_nAvgDelayedSignal, true);
     }
   }
@@ -701,6 +905,7 @@ void Sensor::AddSignal(const double q, const std::vector<double> &ts,
                        const std::vector<std::array<double, 3>> &vs,
                        const std::vector<double> &ns, const int navg,
                        const bool useWeightingPotential) {
+  GARFIELD_COUNT(SensorAddSignal);
   // Don't do anything if there are no points on the signal.
   if (ts.size() < 2) return;
   if (ts.size() != xs.size() || ts.size() != vs.size()) {
@@ -756,53 +961,81 @@ void Sensor::AddSignal(const double q, const std::vector<double> &ts,
 
   if (!m_delayedSignal) return;
   if (m_delayedSignalTimes.empty()) return;
-  // Locations and weights for 6-point Gaussian integration
-  constexpr size_t nG = 6;
-  auto tg = Numerics::GaussLegendreNodes6();
-  auto wg = Numerics::GaussLegendreWeights6();
-
   const size_t nd = m_delayedSignalTimes.size();
+  std::vector<double> td(nd);
+  std::vector<double> id(nd);
   for (size_t k = 0; k < nPoints - 1; ++k) {
     const double t0 = ts[k];
     const double t1 = ts[k + 1];
     const double dt = t1 - t0;
     if (dt < Small) continue;
-    const auto &x0 = xs[k];
-    const auto &x1 = xs[k + 1];
-    const auto &v = vs[k];
-    std::vector<double> td(nd);
     for (size_t i = 0; i < nd; ++i) {
       td[i] = t0 + m_delayedSignalTimes[i];
     }
     // Calculate the signals for each electrode.
     for (auto &electrode : m_electrodes) {
-      const std::string lbl = electrode.label;
-      std::vector<double> id(nd, 0.);
-      for (size_t i = 0; i < nd; ++i) {
-        // Integrate over the drift line segment.
-        const double step = std::min(m_delayedSignalTimes[i], dt);
-        const double scale = step / dt;
-        const double dx = scale * (x1[0] - x0[0]);
-        const double dy = scale * (x1[1] - x0[1]);
-        const double dz = scale * (x1[2] - x0[2]);
-        double sum = 0.;
-        for (size_t j = 0; j < nG; ++j) {
-          const double f = 0.5 * (1. + tg[j]);
-          const double t = m_delayedSignalTimes[i] - f * step;
-          // Calculate the delayed weighting field.
-          double wx = 0., wy = 0., wz = 0.;
-          electrode.comp->DelayedWeightingField(x0[0] + f * dx, x0[1] + f * dy,
-                                                x0[2] + f * dz, t, wx, wy, wz,
-                                                lbl);
-          sum += (wx * v[0] + wy * v[1] + wz * v[2]) * wg[j];
-        }
-        id[i] = -q * 0.5 * sum * step;
-      }
+      DelayedCurrents(electrode, q, dt, xs[k], xs[k + 1], vs[k], id);
       FillSignal(electrode, q, td, id, m_nAvgDelayedSignal, true);
     }
   }
 }
 
+void Sensor::DelayedCurrents(const Electrode &electrode, const double q,
+                             const double dt,
+                             const std::array<double, 3> &x0,
+                             const std::array<double, 3> &x1,
+                             const std::array<double, 3> &v,
+                             std::vector<double> &id) {
+  // Locations and weights for 6-point Gaussian integration
+  constexpr size_t nG = 6;
+  auto tg = Numerics::GaussLegendreNodes6();
+  auto wg = Numerics::GaussLegendreWeights6();
+
+  const size_t nd = m_delayedSignalTimes.size();
+  id.assign(nd, 0.);
+  // For delay times longer than the step, the integration runs over 
+  // the full segment and the Gauss points are the same for all of them.
+  const size_t i0 = std::lower_bound(m_delayedSignalTimes.cbegin(),
+                                     m_delayedSignalTimes.cend(), dt) -
+                    m_delayedSignalTimes.cbegin();
+  std::vector<double> tw(nd - i0);
+  std::vector<std::array<double, 3> > ws;
+  const auto cmp = electrode.comp;
+  const std::string &lbl = electrode.label;
+  const double dx = x1[0] - x0[0];
+  const double dy = x1[1] - x0[1];
+  const double dz = x1[2] - x0[2];
+  for (size_t j = 0; j < nG; ++j) {
+    const double f = 0.5 * (1. + tg[j]);
+    if (i0 < nd) {
+      // Evaluate the delayed weighting field at all times at once.
+      for (size_t i = i0; i < nd; ++i) {
+        tw[i - i0] = m_delayedSignalTimes[i] - f * dt;
+      }
+      cmp->DelayedWeightingFields(x0[0] + f * dx, x0[1] + f * dy,
+                                  x0[2] + f * dz, tw, ws, lbl);
+      for (size_t i = i0; i < nd; ++i) {
+        const auto &w = ws[i - i0];
+        id[i] += (w[0] * v[0] + w[1] * v[1] + w[2] * v[2]) * wg[j];
+      }
+    }
+    // Delay times shorter than the step.
+    for (size_t i = 0; i < i0; ++i) {
+      const double step = m_delayedSignalTimes[i];
+      const double s = f * step / dt;
+      const double t = m_delayedSignalTimes[i] - f * step;
+      double wx = 0., wy = 0., wz = 0.;
+      cmp->DelayedWeightingField(x0[0] + s * dx, x0[1] + s * dy,
+                                 x0[2] + s * dz, t, wx, wy, wz, lbl);
+      id[i] += (wx * v[0] + wy * v[1] + wz * v[2]) * wg[j];
+    }
+  }
+  for (size_t i = 0; i < nd; ++i) {
+    const double step = std::min(m_delayedSignalTimes[i], dt);
+    id[i] *= -q * 0.5 * step;
+  }
+}
+
 void Sensor::FillSignal(Electrode &electrode, const double q,
                         const std::vector<double> &ts,
                         const std::vector<double> &is, const int navg,
@@ -1177,6 +1410,7 @@ void Sensor::PrintTransferFunction() {
 }
 
 bool Sensor::ConvoluteSignal(const std::string &label, const bool fft) {
+  GARFIELD_TIME(SignalConvolution);
   if (!m_fTransfer && !m_shaper && m_fTransferTab.empty()) {
     std::cerr << m_className << "::ConvoluteSignal: "
               << "Transfer function not set.\n";
@@ -1200,6 +1434,7 @@ bool Sensor::ConvoluteSignal(const std::string &label, const bool fft) {
 }
 
 bool Sensor::ConvoluteSignals(const bool fft) {
+  GARFIELD_TIME(SignalConvolution);
   if (!m_fTransfer && !m_shaper && m_fTransferTab.empty()) {
     std::cerr << m_className << "::ConvoluteSignals: "
               << "Transfer function not set.\n";
@@ -19,6 +19,7 @@
 
 #include "Garfield/FundamentalConstants.hh"
 #include "Garfield/GarfieldConstants.hh"
+#include "Garfield/Instrumentation.hh"
 #include "Garfield/Random.hh"
 #include "Garfield/Sensor.hh"
 #include "Garfield/ViewDrift.hh"
@@ -87,6 +88,7 @@ TrackHeed::~TrackHeed() {}
 bool TrackHeed::NewTrack(const double x0, const double y0, const double z0,
                          const double t0, const double dx0, const double dy0,
                          const double dz0) {
+  GARFIELD_TIME(TrackHeed);
   m_hasActiveTrack = false;
 
   // Make sure the sensor has been set.
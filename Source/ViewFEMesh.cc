@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -300,93 +301,99 @@ void ViewFEMesh::DrawElements2d() {
   bool cst = false;
   if (dynamic_cast<ComponentCST*>(m_cmp)) cst = true;
 
-  // Loop over all elements.
-  const auto nElements = m_cmp->GetNumberOfElements();
-  for (size_t i = 0; i < nElements; ++i) {
-    size_t mat = 0;
-    bool driftmedium = false;
-    std::vector<size_t> nodes;
-    if (!m_cmp->GetElement(i, mat, driftmedium, nodes)) continue;
-    // Do not plot the drift medium.
-    if (driftmedium && !m_plotMeshBorders) continue;
-    // Do not create polygons for disabled materials.
-    if (m_disabledMaterial.count(mat) > 0 && m_disabledMaterial[mat]) {
-      continue;
-    }
-    TGraph gr;
-    const short col = m_colorMap.count(mat) != 0 ? m_colorMap[mat] : 1;
-    gr.SetLineColor(col);
-    if (m_colorMap_fill.count(mat) != 0) {
-      gr.SetFillColor(m_colorMap_fill[mat]);
-    } else {
-      gr.SetFillColor(col);
-    }
-    gr.SetLineWidth(3);
-    std::string opt = "";
-    if (m_plotMeshBorders || !m_fillMesh) opt += "l";
-    if (m_fillMesh) opt += "f";
-    opt += "same";
-    // Get the vertex coordinates in the basic cell.
-    std::vector<double> vx0;
-    std::vector<double> vy0;
-    std::vector<double> vz0;
-    const size_t nNodes = nodes.size();
-    for (size_t j = 0; j < nNodes; ++j) {
-      double xn = 0., yn = 0., zn = 0.;
-      if (!m_cmp->GetNode(nodes[j], xn, yn, zn)) continue;
-      vx0.push_back(xn);
-      vy0.push_back(yn);
-      vz0.push_back(zn);
-    }
-    if (vx0.size() != nNodes) {
-      std::cerr << m_className << "::DrawElements2d:\n"
-                << "    Error retrieving nodes of element " << i << ".\n";
-      continue;
-    }
-    // Coordinates of vertices
-    std::vector<double> vx(nNodes, 0.);
-    std::vector<double> vy(nNodes, 0.);
-    std::vector<double> vz(nNodes, 0.);
-    // Loop over the periodicities in x.
-    for (int nx = nMinX; nx <= nMaxX; nx++) {
-      const double dx = sx * nx;
-      // Determine the x-coordinates of the vertices.
-      if (m_cmp->m_mirrorPeriodic[0] && nx != 2 * (nx / 2)) {
-        for (size_t j = 0; j < nNodes; ++j) {
-          vx[j] = mapxmin + (mapxmax - vx0[j]) + dx;
-        }
-      } else {
-        for (size_t j = 0; j < nNodes; ++j) {
-          vx[j] = vx0[j] + dx;
-        }
-      }
-
-      // Loop over the periodicities in y.
-      for (int ny = nMinY; ny <= nMaxY; ny++) {
-        const double dy = sy * ny;
-        // Determine the y-coordinates of the vertices.
-        if (m_cmp->m_mirrorPeriodic[1] && ny != 2 * (ny / 2)) {
-          for (size_t j = 0; j < nNodes; ++j) {
-            vy[j] = mapymin + (mapymax - vy0[j]) + dy;
+  // Tolerance for the comparison with the viewing area.
+  const double tolBox = 1.e-6 * std::max({std::abs(m_xMaxBox - m_xMinBox),
+                                          std::abs(m_yMaxBox - m_yMinBox),
+                                          std::abs(m_zMaxBox - m_zMinBox)});
+  const bool bb = m_cmp->m_bbMin.size() == m_cmp->GetNumberOfElements() &&
+                  m_cmp->m_bbMax.size() == m_cmp->GetNumberOfElements();
+
+  // Cut polygons (in planar coordinates), sorted by material.
+  std::map<size_t, std::vector<Polygon> > polygons;
+  // Elements intersecting the plane.
+  std::vector<size_t> elements;
+  std::vector<size_t> nodes;
+  std::vector<double> vx;
+  std::vector<double> vy;
+  std::vector<double> vz;
+  // Loop over the periodicities in x.
+  for (int nx = nMinX; nx <= nMaxX; nx++) {
+    const double dx = sx * nx;
+    // Skip copies of the cell which are outside the viewing area.
+    if (mapxmax + dx < m_xMinBox - tolBox || 
+        mapxmin + dx > m_xMaxBox + tolBox) continue;
+    // Transformation x -> ax * x + bx of the x-coordinates.
+    const bool mx = m_cmp->m_mirrorPeriodic[0] && nx != 2 * (nx / 2);
+    const double ax = mx ? -1. : 1.;
+    const double bx = mx ? mapxmin + mapxmax + dx : dx;
+    // Loop over the periodicities in y.
+    for (int ny = nMinY; ny <= nMaxY; ny++) {
+      const double dy = sy * ny;
+      if (mapymax + dy < m_yMinBox - tolBox || 
+          mapymin + dy > m_yMaxBox + tolBox) continue;
+      const bool my = m_cmp->m_mirrorPeriodic[1] && ny != 2 * (ny / 2);
+      const double ay = my ? -1. : 1.;
+      const double by = my ? mapymin + mapymax + dy : dy;
+      // Loop over the periodicities in z.
+      for (int nz = nMinZ; nz <= nMaxZ; nz++) {
+        const double dz = sz * nz;
+        if (mapzmax + dz < m_zMinBox - tolBox || 
+            mapzmin + dz > m_zMaxBox + tolBox) continue;
+        const bool mz = m_cmp->m_mirrorPeriodic[2] && nz != 2 * (nz / 2);
+        const double az = mz ? -1. : 1.;
+        const double bz = mz ? mapzmin + mapzmax + dz : dz;
+        // Retrieve the elements crossed by the viewing plane,
+        // transformed to the coordinates of the basic cell.
+        m_cmp->GetElementsInPlane(ax * fx, ay * fy, az * fz, 
+                                  dist - fx * bx - fy * by - fz * bz,
+                                  elements);
+        for (const auto i : elements) {
+          if (bb) {
+            // Skip elements outside the viewing area.
+            const auto& bbmin = m_cmp->m_bbMin[i];
+            const auto& bbmax = m_cmp->m_bbMax[i];
+            const double x0 = ax * bbmin[0] + bx;
+            const double x1 = ax * bbmax[0] + bx;
+            if (std::max(x0, x1) < m_xMinBox - tolBox || 
+                std::min(x0, x1) > m_xMaxBox + tolBox) continue;
+            const double y0 = ay * bbmin[1] + by;
+            const double y1 = ay * bbmax[1] + by;
+            if (std::max(y0, y1) < m_yMinBox - tolBox || 
+                std::min(y0, y1) > m_yMaxBox + tolBox) continue;
+            const double z0 = az * bbmin[2] + bz;
+            const double z1 = az * bbmax[2] + bz;
+            if (std::max(z0, z1) < m_zMinBox - tolBox || 
+                std::min(z0, z1) > m_zMaxBox + tolBox) continue;
           }
-        } else {
-          for (size_t j = 0; j < nNodes; ++j) {
-            vy[j] = vy0[j] + dy;
+          size_t mat = 0;
+          bool driftmedium = false;
+          if (!m_cmp->GetElement(i, mat, driftmedium, nodes)) continue;
+          // Do not plot the drift medium.
+          if (driftmedium && !m_plotMeshBorders) continue;
+          // Do not create polygons for disabled materials.
+          if (m_disabledMaterial.count(mat) > 0 && m_disabledMaterial[mat]) {
+            continue;
           }
-        }
-
-        // Loop over the periodicities in z.
-        for (int nz = nMinZ; nz <= nMaxZ; nz++) {
-          const double dz = sz * nz;
-          // Determine the z-coordinates of the vertices.
-          if (m_cmp->m_mirrorPeriodic[2] && nz != 2 * (nz / 2)) {
-            for (size_t j = 0; j < nNodes; ++j) {
-              vz[j] = mapzmin + (mapzmax - vz0[j]) + dz;
-            }
-          } else {
-            for (size_t j = 0; j < nNodes; ++j) {
-              vz[j] = vz0[j] + dz;
+          // Get the vertex coordinates.
+          const size_t nNodes = nodes.size();
+          vx.resize(nNodes);
+          vy.resize(nNodes);
+          vz.resize(nNodes);
+          bool ok = true;
+          for (size_t j = 0; j < nNodes; ++j) {
+            double xn = 0., yn = 0., zn = 0.;
+            if (!m_cmp->GetNode(nodes[j], xn, yn, zn)) {
+              ok = false;
+              break;
             }
+            vx[j] = ax * xn + bx;
+            vy[j] = ay * yn + by;
+            vz[j] = az * zn + bz;
+          }
+          if (!ok) {
+            std::cerr << m_className << "::DrawElements2d:\n"
+                      << "    Error retrieving nodes of element " << i << ".\n";
+            continue;
           }
 
           // Store the x and y coordinates of the relevant mesh vertices.
@@ -467,16 +474,140 @@ void ViewFEMesh::DrawElements2d() {
           if (cX.size() <= 2) continue;
           // Again eliminate crossings of the polygon lines.
           RemoveCrossings(cX, cY);
-  
-          // Draw the polygon.
-          std::vector<float> xgr(cX.begin(), cX.end());
-          std::vector<float> ygr(cY.begin(), cY.end());
-          gr.DrawGraph(xgr.size(), xgr.data(), ygr.data(), opt.c_str());
-        }  // end z-periodicity loop
-      }    // end y-periodicity loop
-    }      // end x-periodicity loop
-  }        // end loop over elements
+          const size_t nC = cX.size();
+          Polygon polygon(nC);
+          for (size_t j = 0; j < nC; ++j) polygon[j] = {cX[j], cY[j]};
+          polygons[mat].push_back(std::move(polygon));
+        }  // end loop over elements
+      }  // end z-periodicity loop
+    }    // end y-periodicity loop
+  }      // end x-periodicity loop
+
+  // Draw one fill area and a set of merged outlines per material.
+  for (const auto& entry : polygons) {
+    const size_t mat = entry.first;
+    const auto& polys = entry.second;
+    const short col = m_colorMap.count(mat) != 0 ? m_colorMap[mat] : 1;
+    if (m_fillMesh) {
+      // Concatenate the polygons to a single fill area. Consecutive 
+      // polygons are connected by bridges which are traversed back 
+      // and forth, and thus do not contribute to the filled area.
+      std::vector<double> xf;
+      std::vector<double> yf;
+      for (const auto& polygon : polys) {
+        for (const auto& p : polygon) {
+          xf.push_back(p[0]);
+          yf.push_back(p[1]);
+        }
+        xf.push_back(polygon[0][0]);
+        yf.push_back(polygon[0][1]);
+      }
+      for (auto it = polys.rbegin() + 1; it != polys.rend(); ++it) {
+        xf.push_back((*it)[0][0]);
+        yf.push_back((*it)[0][1]);
+      }
+      TGraph gr;
+      gr.SetLineColor(col);
+      if (m_colorMap_fill.count(mat) != 0) {
+        gr.SetFillColor(m_colorMap_fill[mat]);
+      } else {
+        gr.SetFillColor(col);
+      }
+      gr.DrawGraph(xf.size(), xf.data(), yf.data(), "fsame");
+    }
+    if (m_plotMeshBorders || !m_fillMesh) {
+      std::vector<std::vector<std::array<double, 2> > > lines;
+      MergeEdges(polys, lines);
+      TGraph gr;
+      gr.SetLineColor(col);
+      gr.SetLineWidth(3);
+      std::vector<double> xl;
+      std::vector<double> yl;
+      for (const auto& line : lines) {
+        xl.clear();
+        yl.clear();
+        for (const auto& p : line) {
+          xl.push_back(p[0]);
+          yl.push_back(p[1]);
+        }
+        gr.DrawGraph(xl.size(), xl.data(), yl.data(), "lsame");
+      }
+    }
+  }
+}
 
+void ViewFEMesh::MergeEdges(const std::vector<Polygon>& polygons,
+    std::vector<std::vector<std::array<double, 2> > >& lines) const {
+
+  lines.clear();
+  // Vertices closer than this distance are merged.
+  const double eps = 1.e-6 * std::max(std::abs(m_xMaxPlot - m_xMinPlot),
+                                      std::abs(m_yMaxPlot - m_yMinPlot));
+  if (eps <= 0.) return;
+  std::map<std::pair<long long, long long>, size_t> index;
+  std::vector<std::array<double, 2> > vertices;
+  auto vertex = [&](const std::array<double, 2>& p) {
+    const auto key = std::make_pair(std::llround(p[0] / eps), 
+                                    std::llround(p[1] / eps));
+    auto it = index.find(key);
+    if (it != index.end()) return it->second;
+    index[key] = vertices.size();
+    vertices.push_back(p);
+    return vertices.size() - 1;
+  };
+  // Collect the edges, dropping duplicates (shared between elements)
+  // and edges shorter than the merging distance.
+  std::vector<std::pair<size_t, size_t> > edges;
+  for (const auto& polygon : polygons) {
+    const size_t n = polygon.size();
+    for (size_t j = 0; j < n; ++j) {
+      const size_t a = vertex(polygon[j]);
+      const size_t b = vertex(polygon[(j + 1) % n]);
+      if (a == b) continue;
+      edges.emplace_back(std::min(a, b), std::max(a, b));
+    }
+  }
+  std::sort(edges.begin(), edges.end());
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  const size_t nEdges = edges.size();
+  // Chain the edges to polylines.
+  std::vector<std::vector<size_t> > adjacent(vertices.size());
+  for (size_t k = 0; k < nEdges; ++k) {
+    adjacent[edges[k].first].push_back(k);
+    adjacent[edges[k].second].push_back(k);
+  }
+  std::vector<bool> used(nEdges, false);
+  auto chain = [&](size_t v) {
+    std::vector<std::array<double, 2> > line = {vertices[v]};
+    while (true) {
+      bool found = false;
+      for (const auto k : adjacent[v]) {
+        if (used[k]) continue;
+        used[k] = true;
+        v = edges[k].first == v ? edges[k].second : edges[k].first;
+        line.push_back(vertices[v]);
+        found = true;
+        break;
+      }
+      if (!found) break;
+    }
+    lines.push_back(std::move(line));
+  };
+  // Start with the open ends, then close the remaining loops.
+  const size_t nVertices = vertices.size();
+  for (size_t v = 0; v < nVertices; ++v) {
+    if (adjacent[v].size() % 2 == 0) continue;
+    while (std::any_of(adjacent[v].begin(), adjacent[v].end(),
+                       [&](const size_t k) { return !used[k]; })) {
+      chain(v);
+    }
+  }
+  for (size_t v = 0; v < nVertices; ++v) {
+    while (std::any_of(adjacent[v].begin(), adjacent[v].end(),
+                       [&](const size_t k) { return !used[k]; })) {
+      chain(v);
+    }
+  }
 }
 
 void ViewFEMesh::DrawElements3d() {
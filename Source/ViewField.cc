@@ -5,48 +5,37 @@
 #include <iostream>
 #include <limits>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <TAxis.h>
 #include <TROOT.h>
-#include <TF1.h>
-#include <TF2.h>
+#include <TGraph.h>
 #include <TH1F.h>
+#include <TH2D.h>
+#include <TStyle.h>
 
 #include "Garfield/Component.hh"
 #include "Garfield/Plotting.hh"
-#include "Garfield/Random.hh"
 #include "Garfield/Sensor.hh"
 #include "Garfield/DriftLineRKF.hh"
 #include "Garfield/ViewField.hh"
 
 namespace {
 
-void SampleRange(const double xmin, const double ymin, const double xmax,
-                 const double ymax, TF2* f, double& zmin, double& zmax) {
-  constexpr unsigned int n = 1000;
-  const double dx = xmax - xmin;
-  const double dy = ymax - ymin;
-  zmin = std::numeric_limits<double>::max();
-  zmax = -zmin;
-  for (unsigned int i = 0; i < n; ++i) {
-    const double z = f->Eval(xmin + Garfield::RndmUniform() * dx,
-                             ymin + Garfield::RndmUniform() * dy);
-    if (z < zmin) zmin = z;
-    if (z > zmax) zmax = z;
+void SampleRange(const std::vector<double>& values, 
+                 double& vmin, double& vmax) {
+  vmin = std::numeric_limits<double>::max();
+  vmax = -vmin;
+  for (const double v : values) {
+    if (!std::isfinite(v)) continue;
+    if (v < vmin) vmin = v;
+    if (v > vmax) vmax = v;
   }
-}
-
-void SampleRange(TF1* f, double& ymin, double& ymax) {
-  constexpr unsigned int n = 1000;
-  ymin = std::numeric_limits<double>::max();
-  ymax = -ymin;
-  double xmin = 0.;
-  double xmax = 1.;
-  f->GetRange(xmin, xmax);
-  const double dx = xmax - xmin;
-  for (unsigned int i = 0; i < n; ++i) {
-    const double y = f->Eval(xmin + dx * Garfield::RndmUniform());
-    if (y < ymin) ymin = y;
-    if (y > ymax) ymax = y;
+  if (vmin > vmax) {
+    vmin = 0.;
+    vmax = 1.;
   }
 }
 
@@ -232,19 +221,8 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
   bool bfield = false;
   const Parameter par = GetPar(option, title, bfield);
 
-  auto eval = [this, par, wfield, bfield, electrode, t](double* u, double* /*p*/) {
-      // Transform to global coordinates.
-      const double x = m_proj[0][0] * u[0] + m_proj[1][0] * u[1] + m_proj[2][0];
-      const double y = m_proj[0][1] * u[0] + m_proj[1][1] * u[1] + m_proj[2][1];
-      const double z = m_proj[0][2] * u[0] + m_proj[1][2] * u[1] + m_proj[2][2];
-      return wfield ? Wfield(x, y, z, par, electrode, t) :
-             bfield ? Bfield(x, y, z, par) : Efield(x, y, z, par);
-  };
-  const std::string fname = FindUnusedFunctionName("f2D");
-  TF2 f2(fname.c_str(), eval, m_xMinPlot, m_xMaxPlot, m_yMinPlot, m_yMaxPlot, 0);
-
-  // Set the x-y range.
-  f2.SetRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot);
+  // Evaluate the function at the centres of the grid cells.
+  const auto& values = Sample2d(par, wfield, bfield, electrode, t);
 
   // Set the z-range.
   double zmin = m_vmin;
@@ -256,8 +234,7 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
       title = "Weighting " + title;
     }
     if (m_useAutoRange) {
-      SampleRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot, &f2, 
-                  zmin, zmax);
+      SampleRange(values, zmin, zmax);
     } else if (par == Parameter::Potential) {
       zmin = 0.;
       zmax = 1.;
@@ -272,8 +249,7 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
       title = "Magnetic " + title;
     }
     if (m_useAutoRange) {
-      SampleRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot, 
-                  &f2, zmin, zmax);
+      SampleRange(values, zmin, zmax);
     } else {
       zmin = m_bmin;
       zmax = m_bmax;
@@ -288,13 +264,11 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
       if (m_useAutoRange) {
         if (m_component) {
           if (m_samplePotential || !m_component->GetVoltageRange(zmin, zmax)) {
-            SampleRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot, 
-                        &f2, zmin, zmax);
+            SampleRange(values, zmin, zmax);
           }
         } else if (m_sensor) {
           if (m_samplePotential || !m_sensor->GetVoltageRange(zmin, zmax)) {
-            SampleRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot, 
-                        &f2, zmin, zmax);
+            SampleRange(values, zmin, zmax);
           }
         }
       } else {
@@ -303,16 +277,29 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
       }
     } else {
       if (m_useAutoRange) {
-        SampleRange(m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot, 
-                    &f2, zmin, zmax);
+        SampleRange(values, zmin, zmax);
       } else {
         zmin = m_emin;
         zmax = m_emax;
       }
     }
   }
-  f2.SetMinimum(zmin);
-  f2.SetMaximum(zmax);
+  // Fill the histogram.
+  const unsigned int nx = m_nSamples2dX;
+  const unsigned int ny = m_nSamples2dY;
+  std::string labels = ";" + LabelX() + ";" + LabelY();
+  const auto hname = FindUnusedHistogramName("hField2D_");
+  TH2D h2(hname.c_str(), labels.c_str(), nx, m_xMinPlot, m_xMaxPlot,
+          ny, m_yMinPlot, m_yMaxPlot);
+  h2.SetDirectory(nullptr);
+  h2.SetStats(0);
+  for (unsigned int j = 0; j < ny; ++j) {
+    for (unsigned int i = 0; i < nx; ++i) {
+      h2.SetBinContent(i + 1, j + 1, values[j * nx + i]);
+    }
+  }
+  h2.SetMinimum(zmin);
+  h2.SetMaximum(zmax);
 
   // Set the contours if requested.
   if (contour) {
@@ -332,21 +319,13 @@ void ViewField::Draw2d(const std::string& option, const bool contour,
         std::cout << "        Level " << i << " = " << level[i] << "\n";
       }
     }
-    f2.SetContour(m_nContours, level.data());
+    h2.SetContour(m_nContours, level.data());
   }
 
-  // Set the resolution.
-  f2.SetNpx(m_nSamples2dX);
-  f2.SetNpy(m_nSamples2dY);
-
-  // Set the labels.
-  std::string labels = ";" + LabelX() + ";" + LabelY();
-  f2.SetTitle(labels.c_str());
-
   auto pad = GetCanvas();
   pad->cd();
   pad->SetTitle(title.c_str());
-  f2.DrawCopy(drawopt.c_str());
+  h2.DrawCopy(drawopt.c_str());
   gPad->SetRightMargin(0.15);
   gPad->Update();
 }
@@ -399,24 +378,22 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
     dz /= t1; 
   }
 
-  auto eval = [this, par, wfield, bfield, electrode, dir, 
-               x0, y0, z0, dx, dy, dz](double* u, double* /*p*/) {
-    // Get the position.
-    const double t = u[0];
-    double x = dir == 0 ? t : x0;
-    double y = dir == 1 ? t : y0;
-    double z = dir == 2 ? t : z0;
+  // Evaluate the function at equidistant points along the line.
+  const unsigned int nPoints = m_nSamples1d + 1;
+  std::vector<double> ts(nPoints, 0.);
+  std::vector<std::array<double, 3> > points(nPoints);
+  for (unsigned int i = 0; i < nPoints; ++i) {
+    const double t = t0 + i * (t1 - t0) / m_nSamples1d;
+    ts[i] = t;
+    points[i] = {dir == 0 ? t : x0, dir == 1 ? t : y0, dir == 2 ? t : z0};
     if (dir > 2) {
-      x += t * dx;
-      y += t * dy;
-      z += t * dz;
+      points[i][0] += t * dx;
+      points[i][1] += t * dy;
+      points[i][2] += t * dz;
     }
-    return wfield ? Wfield(x, y, z, par, electrode) : 
-           bfield ? Bfield(x, y, z, par) : Efield(x, y, z, par);
-  };
-
-  const std::string fname = FindUnusedFunctionName("fProfile");
-  TF1 f1(fname.c_str(), eval, t0, t1, 0);
+  }
+  std::vector<double> values;
+  Sample1d(points, par, wfield, bfield, electrode, values);
 
   double fmin = m_vmin;
   double fmax = m_vmax;
@@ -424,14 +401,14 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
     title = "weighting " + title;
     if (par == Parameter::Potential) {
       if (m_useAutoRange && m_samplePotential) {
-        SampleRange(&f1, fmin, fmax);
+        SampleRange(values, fmin, fmax);
       } else {
         fmin = 0.;
         fmax = 1.;
       }
     } else {
       if (m_useAutoRange) {
-        SampleRange(&f1, fmin, fmax);
+        SampleRange(values, fmin, fmax);
       } else {
         fmin = m_wmin;
         fmax = m_wmax;
@@ -440,7 +417,7 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
   } else if (bfield) {
     title = "magnetic " + title;
     if (m_useAutoRange) {
-      SampleRange(&f1, fmin, fmax);
+      SampleRange(values, fmin, fmax);
     } else {
       fmin = m_bmin;
       fmax = m_bmax;
@@ -451,11 +428,11 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
       if (m_useAutoRange) {
         if (m_component) {
           if (m_samplePotential || !m_component->GetVoltageRange(fmin, fmax)) {
-            SampleRange(&f1, fmin, fmax);
+            SampleRange(values, fmin, fmax);
           }
         } else if (m_sensor) {
           if (m_samplePotential || !m_sensor->GetVoltageRange(fmin, fmax)) {
-            SampleRange(&f1, fmin, fmax);
+            SampleRange(values, fmin, fmax);
           }
         }
       } else {
@@ -464,16 +441,13 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
       }
     } else {
       if (m_useAutoRange) {
-        SampleRange(&f1, fmin, fmax);
+        SampleRange(values, fmin, fmax);
       } else {
         fmin = m_emin;
         fmax = m_emax;
       }
     }
   }
-  f1.SetMinimum(fmin);
-  f1.SetMaximum(fmax);
-
   std::string labels = ";normalised distance;";
   if (dir == 0) {
     labels = ";#it{x} [cm];";
@@ -523,17 +497,80 @@ void ViewField::DrawProfile(const double x0, const double y0, const double z0,
       labels += " [V/cm]";
     }
   }
-  f1.SetTitle(labels.c_str());
-  f1.SetNpx(m_nSamples1d);
 
   auto pad = GetCanvas();
   pad->cd();
   title = "Profile plot of the " + title;
   pad->SetTitle(title.c_str());
-  f1.DrawCopy();
+  pad->DrawFrame(std::min(t0, t1), fmin, std::max(t0, t1), fmax, 
+                 labels.c_str());
+  TGraph gr;
+  gr.SetLineColor(gStyle->GetFuncColor());
+  gr.SetLineWidth(gStyle->GetFuncWidth());
+  gr.DrawGraph(nPoints, ts.data(), values.data(), "Lsame");
   gPad->Update();
 }
 
+const std::vector<double>& ViewField::Sample2d(
+    const Parameter par, const bool wfield, const bool bfield, 
+    const std::string& electrode, const double t) {
+
+  const unsigned int nx = m_nSamples2dX;
+  const unsigned int ny = m_nSamples2dY;
+  SampleSettings settings;
+  settings.source = m_sensor ? static_cast<const void*>(m_sensor) : 
+                               static_cast<const void*>(m_component);
+  settings.par = par;
+  settings.wfield = wfield;
+  settings.bfield = bfield;
+  settings.electrode = electrode;
+  settings.t = t;
+  settings.area = {m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot};
+  settings.proj = m_proj;
+  settings.nx = nx;
+  settings.ny = ny;
+  settings.useStatus = m_useStatus;
+  settings.vBkg = m_vBkg;
+  if (m_useSampleCache && m_samples.size() == nx * ny && 
+      settings == m_sampleSettings) {
+    return m_samples;
+  }
+
+  const double dx = (m_xMaxPlot - m_xMinPlot) / nx;
+  const double dy = (m_yMaxPlot - m_yMinPlot) / ny;
+  m_samples.assign(nx * ny, 0.);
+  const int n = nx * ny;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) if (m_parallel)
+#endif
+  for (int k = 0; k < n; ++k) {
+    const double u = m_xMinPlot + (k % nx + 0.5) * dx;
+    const double v = m_yMinPlot + (k / nx + 0.5) * dy;
+    // Transform to global coordinates.
+    const double x = m_proj[0][0] * u + m_proj[1][0] * v + m_proj[2][0];
+    const double y = m_proj[0][1] * u + m_proj[1][1] * v + m_proj[2][1];
+    const double z = m_proj[0][2] * u + m_proj[1][2] * v + m_proj[2][2];
+    m_samples[k] = Evaluate(x, y, z, par, wfield, bfield, electrode, t);
+  }
+  m_sampleSettings = settings;
+  return m_samples;
+}
+
+void ViewField::Sample1d(const std::vector<std::array<double, 3> >& points,
+                         const Parameter par, const bool wfield, 
+                         const bool bfield, const std::string& electrode,
+                         std::vector<double>& values) {
+  const int n = points.size();
+  values.assign(n, 0.);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) if (m_parallel)
+#endif
+  for (int i = 0; i < n; ++i) {
+    const auto& p = points[i];
+    values[i] = Evaluate(p[0], p[1], p[2], par, wfield, bfield, electrode, 0.);
+  }
+}
+
 bool ViewField::SetPlotLimits() {
 
   if (m_userPlotLimits) return true;
@@ -706,11 +743,8 @@ void ViewField::PlotFieldLines(const std::vector<double>& x0,
     SetRange(pad, m_xMinPlot, m_yMinPlot, m_xMaxPlot, m_yMaxPlot);
   } 
 
-  DriftLineRKF drift;
   Sensor sensor;
-  if (m_sensor) {
-    drift.SetSensor(m_sensor);
-  } else {
+  if (!m_sensor) {
     double xmin = 0., ymin = 0., zmin = 0.;
     double xmax = 0., ymax = 0., zmax = 0.;
     if (!m_component->GetBoundingBox(xmin, ymin, zmin, xmax, ymax, zmax)) {
@@ -720,19 +754,63 @@ void ViewField::PlotFieldLines(const std::vector<double>& x0,
       }
     }
     sensor.AddComponent(m_component);
-    drift.SetSensor(&sensor);
   }
+  Sensor* s = m_sensor ? m_sensor : &sensor;
   const double lx = 0.01 * fabs(m_xMaxPlot - m_xMinPlot);
   const double ly = 0.01 * fabs(m_yMaxPlot - m_yMinPlot);
-  drift.SetMaximumStepSize(std::min(lx, ly));
-  for (size_t i = 0; i < nLines; ++i) {
-    std::vector<std::array<float, 3> > xl;
-    if (!drift.FieldLine(x0[i], y0[i], z0[i], xl, electron)) continue;
+  // Compute the field lines first (in parallel if requested), 
+  // then draw them in the original order.
+  const int n = nLines;
+  std::vector<std::vector<std::array<float, 3> > > lines(n);
+#ifdef _OPENMP
+#pragma omp parallel if (m_parallel)
+#endif
+  {
+    DriftLineRKF drift;
+    drift.SetSensor(s);
+    drift.SetMaximumStepSize(std::min(lx, ly));
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int i = 0; i < n; ++i) {
+      if (!drift.FieldLine(x0[i], y0[i], z0[i], lines[i], electron)) {
+        lines[i].clear();
+      }
+    }
+  }
+  for (const auto& xl : lines) {
+    if (xl.empty()) continue;
     DrawLine(xl, col, 1);
   }
   pad->Update();
 }
 
+void ViewField::SegmentFluxes(
+    const double x0, const double y0, const double z0,
+    const double dx, const double dy, const double dz,
+    const double xp, const double yp, const double zp,
+    const unsigned int nV, const int isign, std::vector<double>& q) const {
+
+  // Integrate the flux over 1000 consecutive segments of the line.
+  constexpr int nSteps = 1000;
+  q.assign(nSteps, 0.);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 10) if (m_parallel)
+#endif
+  for (int i = 0; i < nSteps; ++i) {
+    const double x = x0 + i * dx;
+    const double y = y0 + i * dy;
+    const double z = z0 + i * dz;
+    if (m_component) {
+      q[i] = m_component->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz,
+                                            xp, yp, zp, nV, isign);
+    } else {
+      q[i] = m_sensor->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz,
+                                         xp, yp, zp, nV, isign);
+    }
+  }
+}
+
 bool ViewField::EqualFluxIntervals(
     const double x0, const double y0, const double z0,
     const double x1, const double y1, const double z1,
@@ -778,17 +856,10 @@ bool ViewField::EqualFluxIntervals(
   const double dx = (x1 - x0) * ds;
   const double dy = (y1 - y0) * ds;
   const double dz = (z1 - z0) * ds;
+  std::vector<double> qTab;
+  SegmentFluxes(x0, y0, z0, dx, dy, dz, xp, yp, zp, nV, isign, qTab);
   for (size_t i = 0; i < nSteps; ++i) {
-    const double x = x0 + i * dx;
-    const double y = y0 + i * dy;
-    const double z = z0 + i * dz;
-    if (m_component) {
-      q = m_component->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz, 
-                                         xp, yp, zp, nV, isign);
-    } else {
-      q = m_sensor->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz, 
-                                      xp, yp, zp, nV, isign);
-    }
+    q = qTab[i];
     sTab[i] = (i + 1) * ds;
     if (q > 0) {
       fsum += q;
@@ -872,17 +943,10 @@ bool ViewField::FixedFluxIntervals(
   const double dx = (x1 - x0) * ds;
   const double dy = (y1 - y0) * ds;
   const double dz = (z1 - z0) * ds;
+  std::vector<double> qTab;
+  SegmentFluxes(x0, y0, z0, dx, dy, dz, xp, yp, zp, nV, isign, qTab);
   for (size_t i = 0; i < nSteps; ++i) {
-    const double x = x0 + i * dx;
-    const double y = y0 + i * dy;
-    const double z = z0 + i * dz;
-    if (m_component) {
-      q = m_component->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz, 
-                                         xp, yp, zp, nV, isign);
-    } else {
-      q = m_sensor->IntegrateFluxLine(x, y, z, x + dx, y + dy, z + dz, 
-                                      xp, yp, zp, nV, isign);
-    }
+    q = qTab[i];
     sTab[i] = (i + 1) * ds;
     if (q > 0) {
       fsum += q;
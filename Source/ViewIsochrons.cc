@@ -3,6 +3,10 @@
 #include <iostream>
 #include <set>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <TAxis.h>
 #include <TROOT.h>
 #include <TGraph.h>
@@ -427,82 +431,101 @@ void ViewIsochrons::ComputeDriftLines(const double tstep,
   std::vector<std::array<double, 3> >& endPoints,
   std::vector<int>& statusCodes, const bool rev) {
 
-  DriftLineRKF drift;
   Sensor sensor;
-  if (m_sensor) {
-    drift.SetSensor(m_sensor);
-  } else {
+  if (!m_sensor) {
     sensor.AddComponent(m_component);
     if (m_userBox) {
       sensor.SetArea(m_xMinBox, m_yMinBox, m_zMinBox,
                      m_xMaxBox, m_yMaxBox, m_zMaxBox);
     }
-    drift.SetSensor(&sensor);
   }
+  Sensor* s = m_sensor ? m_sensor : &sensor;
   const double lx = 0.1 * fabs(m_xMaxPlot - m_xMinPlot);
   const double ly = 0.1 * fabs(m_yMaxPlot - m_yMinPlot);
-  drift.SetMaximumStepSize(std::min(lx, ly));
-  drift.EnableSignalCalculation(false);
-  for (const auto& point : points) {
-    if (m_particle == Particle::Electron) {
-      if (m_positive) {
-        drift.DriftPositron(point[0], point[1], point[2], 0.);
+  // Compute the drift lines (in parallel if requested) and store
+  // the results by index of the starting point.
+  const int nPoints = points.size();
+  std::vector<std::vector<std::array<double, 3> > > tabs(nPoints);
+  std::vector<std::array<double, 3> > starts(nPoints);
+  std::vector<std::array<double, 3> > ends(nPoints);
+  std::vector<int> stats(nPoints, 0);
+  std::vector<int> valid(nPoints, 0);
+#ifdef _OPENMP
+#pragma omp parallel if (m_parallel)
+#endif
+  {
+    DriftLineRKF drift;
+    drift.SetSensor(s);
+    drift.SetMaximumStepSize(std::min(lx, ly));
+    drift.EnableSignalCalculation(false);
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int j = 0; j < nPoints; ++j) {
+      const auto& point = points[j];
+      if (m_particle == Particle::Electron) {
+        if (m_positive) {
+          drift.DriftPositron(point[0], point[1], point[2], 0.);
+        } else {
+          drift.DriftElectron(point[0], point[1], point[2], 0.);
+        }
       } else {
-        drift.DriftElectron(point[0], point[1], point[2], 0.);
+        if (m_positive) {
+          drift.DriftIon(point[0], point[1], point[2], 0.);
+        } else {
+          drift.DriftNegativeIon(point[0], point[1], point[2], 0.);
+        }
       }
-    } else {
-      if (m_positive) {
-        drift.DriftIon(point[0], point[1], point[2], 0.);
-      } else {
-        drift.DriftNegativeIon(point[0], point[1], point[2], 0.);
+      const unsigned int nu = drift.GetNumberOfDriftLinePoints();
+      // Check that the drift line has enough points.
+      if (nu < 3) continue;
+      int status = 0;
+      double xf = 0., yf = 0., zf = 0., tf = 0.;
+      drift.GetEndPoint(xf, yf, zf, tf, status);
+      // Find the number of points to be stored.
+      const unsigned int nSteps = static_cast<unsigned int>(tf / tstep);
+      if (nSteps == 0) continue;
+      std::vector<double> xu(nu, 0.);
+      std::vector<double> yu(nu, 0.);
+      std::vector<double> zu(nu, 0.);
+      std::vector<double> tu(nu, 0.);
+      for (unsigned int i = 0; i < nu; ++i) {
+        drift.GetDriftLinePoint(i, xu[i], yu[i], zu[i], tu[i]);
       }
+      if (rev) {
+        for (auto& t : tu) t = tf - t;
+        std::reverse(std::begin(xu), std::end(xu)); 
+        std::reverse(std::begin(yu), std::end(yu)); 
+        std::reverse(std::begin(zu), std::end(zu)); 
+        std::reverse(std::begin(tu), std::end(tu)); 
+      }
+      std::vector<std::array<double, 3> > tab;
+      // Interpolate at regular time intervals.
+      for (unsigned int i = 0; i < nSteps; ++i) {
+        const double t = (i + 1) * tstep;
+        // tab.push_back(PLACO3(Interpolate(xu, tu, t),
+        //                      Interpolate(yu, tu, t),
+        //                      Interpolate(zu, tu, t)));
+        std::array<double, 3> step = {Interpolate(xu, tu, t),
+                                      Interpolate(yu, tu, t),
+                                      Interpolate(zu, tu, t)};
+        tab.push_back(step);
+      }
+      tabs[j] = std::move(tab);
+      starts[j] = {xu[0], yu[0], zu[0]};
+      ends[j] = {xu[nu - 1], yu[nu - 1], zu[nu - 1]};
+      // Store the drift line return code.
+      stats[j] = rev ? status : 0;
+      valid[j] = 1;
     }
-    const unsigned int nu = drift.GetNumberOfDriftLinePoints();
-    // Check that the drift line has enough points.
-    if (nu < 3) continue;
-    int status = 0;
-    double xf = 0., yf = 0., zf = 0., tf = 0.;
-    drift.GetEndPoint(xf, yf, zf, tf, status);
-    // Find the number of points to be stored.
-    const unsigned int nSteps = static_cast<unsigned int>(tf / tstep);
-    if (nSteps == 0) continue;
-    std::vector<double> xu(nu, 0.);
-    std::vector<double> yu(nu, 0.);
-    std::vector<double> zu(nu, 0.);
-    std::vector<double> tu(nu, 0.);
-    for (unsigned int i = 0; i < nu; ++i) {
-      drift.GetDriftLinePoint(i, xu[i], yu[i], zu[i], tu[i]);
-    }
-    if (rev) {
-      for (auto& t : tu) t = tf - t;
-      std::reverse(std::begin(xu), std::end(xu)); 
-      std::reverse(std::begin(yu), std::end(yu)); 
-      std::reverse(std::begin(zu), std::end(zu)); 
-      std::reverse(std::begin(tu), std::end(tu)); 
-    }
-    std::vector<std::array<double, 3> > tab;
-    // Interpolate at regular time intervals.
-    for (unsigned int i = 0; i < nSteps; ++i) {
-      const double t = (i + 1) * tstep;
-      // tab.push_back(PLACO3(Interpolate(xu, tu, t),
-      //                      Interpolate(yu, tu, t),
-      //                      Interpolate(zu, tu, t)));
-      std::array<double, 3> step = {Interpolate(xu, tu, t),
-                                    Interpolate(yu, tu, t),
-                                    Interpolate(zu, tu, t)};
-      tab.push_back(step);
-    }
-    driftLines.push_back(std::move(tab));
-    std::array<double, 3> start = {xu[0], yu[0], zu[0]};
-    std::array<double, 3> end = {xu[nu - 1], yu[nu - 1], zu[nu - 1]};
-    startPoints.push_back(std::move(start));
-    endPoints.push_back(std::move(end));
-    // Store the drift line return code.
-    if (rev) {
-      statusCodes.push_back(status);
-    } else {
-      statusCodes.push_back(0);
-    }
+  }
+  // Collect the results in the order of the starting points.
+  for (int j = 0; j < nPoints; ++j) {
+    if (!valid[j]) continue;
+    driftLines.push_back(std::move(tabs[j]));
+    startPoints.push_back(starts[j]);
+    endPoints.push_back(ends[j]);
+    statusCodes.push_back(stats[j]);
   }
 }
 